@@ -246,6 +246,18 @@ golubets_example_package_golub_message_codec_new() {
   return self;
 }
 
+static GolubetsExamplePackageGolubMessageCodec*
+golubets_example_package_golub_message_codec_get_instance() {
+  static gsize instance = 0;
+  if (g_once_init_enter(&instance)) {
+    g_once_init_leave(
+        &instance,
+        GPOINTER_TO_SIZE(golubets_example_package_golub_message_codec_new()));
+  }
+  return GOLUBETS_EXAMPLE_PACKAGE_GOLUB_MESSAGE_CODEC(
+      GSIZE_TO_POINTER(instance));
+}
+
 struct _GolubetsExamplePackageExampleHostApiResponseHandle {
   GObject parent_instance;
 
@@ -794,8 +806,8 @@ void golubets_example_package_example_host_api_set_method_handlers(
       golubets_example_package_example_host_api_new(vtable, user_data,
                                                     user_data_free_func);
 
-  g_autoptr(GolubetsExamplePackageGolubMessageCodec) codec =
-      golubets_example_package_golub_message_codec_new();
+  GolubetsExamplePackageGolubMessageCodec* codec =
+      golubets_example_package_golub_message_codec_get_instance();
   g_autofree gchar* get_host_language_channel_name = g_strdup_printf(
       "dev.bayori.golubets.golubets_example_package.ExampleHostApi."
       "getHostLanguage%s",
@@ -858,8 +870,8 @@ void golubets_example_package_example_host_api_clear_method_handlers(
   g_autofree gchar* dot_suffix =
       suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");
 
-  g_autoptr(GolubetsExamplePackageGolubMessageCodec) codec =
-      golubets_example_package_golub_message_codec_new();
+  GolubetsExamplePackageGolubMessageCodec* codec =
+      golubets_example_package_golub_message_codec_get_instance();
   g_autofree gchar* get_host_language_channel_name = g_strdup_printf(
       "dev.bayori.golubets.golubets_example_package.ExampleHostApi."
       "getHostLanguage%s",
@@ -1009,6 +1021,7 @@ struct _GolubetsExamplePackageMessageFlutterApi {
 
   FlBinaryMessenger* messenger;
   gchar* suffix;
+  FlBasicMessageChannel* flutter_method_channel;
 };
 
 G_DEFINE_TYPE(GolubetsExamplePackageMessageFlutterApi,
@@ -1020,6 +1033,7 @@ static void golubets_example_package_message_flutter_api_dispose(
       GOLUBETS_EXAMPLE_PACKAGE_MESSAGE_FLUTTER_API(object);
   g_clear_object(&self->messenger);
   g_clear_pointer(&self->suffix, g_free);
+  g_clear_object(&self->flutter_method_channel);
   G_OBJECT_CLASS(golubets_example_package_message_flutter_api_parent_class)
       ->dispose(object);
 }
@@ -1172,18 +1186,19 @@ void golubets_example_package_message_flutter_api_flutter_method(
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, a_string != nullptr ? fl_value_new_string(a_string)
                                                  : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_example_package.MessageFlutterApi."
-      "flutterMethod%s",
-      self->suffix);
-  g_autoptr(GolubetsExamplePackageGolubMessageCodec) codec =
-      golubets_example_package_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->flutter_method_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_example_package.MessageFlutterApi."
+        "flutterMethod%s",
+        self->suffix);
+    GolubetsExamplePackageGolubMessageCodec* codec =
+        golubets_example_package_golub_message_codec_get_instance();
+    self->flutter_method_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->flutter_method_channel, args, cancellable,
       golubets_example_package_message_flutter_api_flutter_method_cb, task);
 }
 
@@ -1193,10 +1208,8 @@ golubets_example_package_message_flutter_api_flutter_method_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->flutter_method_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
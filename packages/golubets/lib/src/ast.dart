@@ -104,6 +104,9 @@ class Method extends Node {
     this.taskQueueType = TaskQueueType.serial,
     this.documentationComments = const <String>[],
     this.asynchronousType = AsynchronousType.none,
+    this.isFfiSync = false,
+    this.largeBlobThreshold,
+    this.chunkFrameSize,
   });
 
   /// The name of the method.
@@ -152,6 +155,20 @@ class Method extends Node {
   /// Whether this method is asynchronous.
   bool get isAsynchronous => !asynchronousType.isNone;
 
+  /// Whether this host method is also exported as a C function that Dart
+  /// calls synchronously through `dart:ffi`.
+  bool isFfiSync;
+
+  /// The size in bytes from which the GObject host returns the `Uint8List`
+  /// of this method in a sealed memfd that Dart maps, or null if it always
+  /// copies the bytes into the reply.
+  int? largeBlobThreshold;
+
+  /// The largest number of encoded bytes the C++ and GObject hosts send Dart
+  /// in one frame of the reply to this method, or null if the reply is sent
+  /// in one message.
+  int? chunkFrameSize;
+
   @override
   String toString() {
     final objcSelectorStr = objcSelector.isEmpty
@@ -160,7 +177,7 @@ class Method extends Node {
     final swiftFunctionStr = swiftFunction.isEmpty
         ? ''
         : ' swiftFunction:$swiftFunction';
-    return '(Method name:$name returnType:$returnType parameters:$parameters asynchronousType:$asynchronousType$objcSelectorStr$swiftFunctionStr documentationComments:$documentationComments)';
+    return '(Method name:$name returnType:$returnType parameters:$parameters asynchronousType:$asynchronousType isFfiSync:$isFfiSync largeBlobThreshold:$largeBlobThreshold chunkFrameSize:$chunkFrameSize$objcSelectorStr$swiftFunctionStr documentationComments:$documentationComments)';
   }
 }
 
@@ -173,14 +190,19 @@ class AstHostApi extends Api {
     required super.methods,
     super.documentationComments = const <String>[],
     this.dartHostTestHandler,
+    this.multiplexed = false,
   });
 
   /// The name of the Dart test interface to generate to help with testing.
   String? dartHostTestHandler;
 
+  /// Whether all methods share a single channel, with the method index sent
+  /// as the first element of each message.
+  bool multiplexed;
+
   @override
   String toString() {
-    return '(HostApi name:$name methods:$methods documentationComments:$documentationComments dartHostTestHandler:$dartHostTestHandler)';
+    return '(HostApi name:$name methods:$methods documentationComments:$documentationComments dartHostTestHandler:$dartHostTestHandler multiplexed:$multiplexed)';
   }
 }
 
@@ -548,6 +570,7 @@ class TypeDeclaration {
     this.associatedClass,
     this.associatedProxyApi,
     this.typeArguments = const <TypeDeclaration>[],
+    this.typedListOf,
   });
 
   /// Void constructor.
@@ -557,7 +580,8 @@ class TypeDeclaration {
       associatedEnum = null,
       associatedClass = null,
       associatedProxyApi = null,
-      typeArguments = const <TypeDeclaration>[];
+      typeArguments = const <TypeDeclaration>[],
+      typedListOf = null;
 
   /// The base name of the [TypeDeclaration] (ex 'Foo' to 'Foo<Bar>?').
   final String baseName;
@@ -589,6 +613,10 @@ class TypeDeclaration {
   /// Associated [AstProxyApi], if any.
   final AstProxyApi? associatedProxyApi;
 
+  /// The element type of the `List` this typed list was declared as (ex
+  /// 'double' for a `List<double>` sent as a `Float64List`), if any.
+  final String? typedListOf;
+
   @override
   int get hashCode {
     // This has to be implemented because TypeDeclaration is used as a Key to a
@@ -596,6 +624,7 @@ class TypeDeclaration {
     var hash = 17;
     hash = hash * 37 + baseName.hashCode;
     hash = hash * 37 + isNullable.hashCode;
+    hash = hash * 37 + typedListOf.hashCode;
     for (final TypeDeclaration typeArgument in typeArguments) {
       hash = hash * 37 + typeArgument.hashCode;
     }
@@ -614,7 +643,8 @@ class TypeDeclaration {
           isEnum == other.isEnum &&
           isClass == other.isClass &&
           associatedClass == other.associatedClass &&
-          associatedEnum == other.associatedEnum;
+          associatedEnum == other.associatedEnum &&
+          typedListOf == other.typedListOf;
     }
   }
 
@@ -626,6 +656,7 @@ class TypeDeclaration {
       isNullable: isNullable,
       associatedEnum: enumDefinition,
       typeArguments: typeArguments,
+      typedListOf: typedListOf,
     );
   }
 
@@ -637,6 +668,7 @@ class TypeDeclaration {
       isNullable: isNullable,
       associatedClass: classDefinition,
       typeArguments: typeArguments,
+      typedListOf: typedListOf,
     );
   }
 
@@ -648,6 +680,7 @@ class TypeDeclaration {
       isNullable: isNullable,
       associatedProxyApi: proxyApiDefinition,
       typeArguments: typeArguments,
+      typedListOf: typedListOf,
     );
   }
 
@@ -660,6 +693,7 @@ class TypeDeclaration {
       associatedClass: associatedClass,
       associatedEnum: associatedEnum,
       associatedProxyApi: associatedProxyApi,
+      typedListOf: typedListOf,
     );
   }
 
@@ -668,7 +702,10 @@ class TypeDeclaration {
     final typeArgumentsStr = typeArguments.isEmpty
         ? ''
         : ' typeArguments:$typeArguments';
-    return '(TypeDeclaration baseName:$baseName isNullable:$isNullable$typeArgumentsStr isEnum:$isEnum isClass:$isClass isProxyApi:$isProxyApi)';
+    final typedListOfStr = typedListOf == null
+        ? ''
+        : ' typedListOf:$typedListOf';
+    return '(TypeDeclaration baseName:$baseName isNullable:$isNullable$typeArgumentsStr$typedListOfStr isEnum:$isEnum isClass:$isClass isProxyApi:$isProxyApi)';
   }
 }
 
@@ -811,6 +848,11 @@ class Class extends Node {
     this.isSealed = false,
     this.isReferenced = true,
     this.isSwiftClass = false,
+    this.isCompact = false,
+    this.isPacked = false,
+    this.isColumnar = false,
+    this.columnsOf,
+    this.ringBufferCapacity,
     this.documentationComments = const <String>[],
     this.isImmutable = false,
     this.typeArguments = const <TypeDeclaration>[],
@@ -845,6 +887,26 @@ class Class extends Node {
   /// Defaults to false, which would represent a struct.
   bool isSwiftClass;
 
+  /// Whether the class is encoded with the compact wire format, which writes
+  /// its fields positionally without type tags.
+  bool isCompact;
+
+  /// Whether the class is encoded as a fixed-layout record that the host
+  /// copies to and from a struct.
+  bool isPacked;
+
+  /// Whether lists of the class are sent as a `<Class>Columns` class, which
+  /// holds a typed list per field.
+  bool isColumnar;
+
+  /// The `@Columnar()` class this class holds the columns of, or null if it
+  /// isn't a `<Class>Columns` class.
+  Class? columnsOf;
+
+  /// The number of records in the shared-memory ring buffer the host streams
+  /// instances of the class through, or null if it has none.
+  int? ringBufferCapacity;
+
   /// List of documentation comments, separated by line.
   ///
   /// Lines should not include the comment marker itself, but should include any
@@ -860,7 +922,7 @@ class Class extends Node {
 
   @override
   String toString() {
-    return '(Class name:$name fields:$fields superClass:$superClassName children:$children isSealed:$isSealed isReferenced:$isReferenced documentationComments:$documentationComments)';
+    return '(Class name:$name fields:$fields superClass:$superClassName children:$children isSealed:$isSealed isReferenced:$isReferenced isCompact:$isCompact isPacked:$isPacked isColumnar:$isColumnar columnsOf:${columnsOf?.name} ringBufferCapacity:$ringBufferCapacity documentationComments:$documentationComments)';
   }
 }
 
@@ -27,6 +27,9 @@ const String _codecSerializerName = 'GolubetsCodecSerializer';
 
 const String _overflowClassName = 'GolubetsCodecOverflow';
 
+/// The type byte of a list in the standard codec.
+const int _standardListTypeId = 12;
+
 final NamedType _overflowType = NamedType(
   name: 'type',
   type: const TypeDeclaration(baseName: 'int', isNullable: false),
@@ -58,6 +61,10 @@ class CppOptions {
     this.namespace,
     this.copyrightHeader,
     this.headerOutPath,
+    this.includeInstrumentation = false,
+    this.unboxedEnums = false,
+    this.parallelEncodeThreshold,
+    this.encodedSizes = false,
   });
 
   /// The path to the header that will get placed in the source file (example:
@@ -73,6 +80,24 @@ class CppOptions {
   /// The path to the output header file location.
   final String? headerOutPath;
 
+  /// Whether to generate the `GolubetsInstrumentation` observer interface and
+  /// the calls that notify it.
+  final bool includeInstrumentation;
+
+  /// Whether the codec serializer writes and reads enum fields of data classes
+  /// directly as integers instead of wrapping each one in a
+  /// `CustomEncodableValue`.
+  final bool unboxedEnums;
+
+  /// The number of elements at which the codec serializer encodes and decodes
+  /// the elements of a list on worker threads, or null to always encode and
+  /// decode on the calling thread.
+  final int? parallelEncodeThreshold;
+
+  /// Whether to generate `EncodedSize()` for data classes, and encode
+  /// messages into buffers reserved at their exact size.
+  final bool encodedSizes;
+
   /// Creates a [CppOptions] from a Map representation where:
   /// `x = CppOptions.fromMap(x.toMap())`.
   static CppOptions fromMap(Map<String, Object> map) {
@@ -81,6 +106,10 @@ class CppOptions {
       namespace: map['namespace'] as String?,
       copyrightHeader: map['copyrightHeader'] as Iterable<String>?,
       headerOutPath: map['cppHeaderOut'] as String?,
+      includeInstrumentation: map['includeInstrumentation'] as bool? ?? false,
+      unboxedEnums: map['unboxedEnums'] as bool? ?? false,
+      parallelEncodeThreshold: map['parallelEncodeThreshold'] as int?,
+      encodedSizes: map['encodedSizes'] as bool? ?? false,
     );
   }
 
@@ -91,6 +120,11 @@ class CppOptions {
       if (headerIncludePath != null) 'headerIncludePath': headerIncludePath!,
       if (namespace != null) 'namespace': namespace!,
       if (copyrightHeader != null) 'copyrightHeader': copyrightHeader!,
+      'includeInstrumentation': includeInstrumentation,
+      'unboxedEnums': unboxedEnums,
+      if (parallelEncodeThreshold != null)
+        'parallelEncodeThreshold': parallelEncodeThreshold!,
+      'encodedSizes': encodedSizes,
     };
     return result;
   }
@@ -111,9 +145,14 @@ class InternalCppOptions extends InternalOptions {
     required this.headerIncludePath,
     required this.cppHeaderOut,
     required this.cppSourceOut,
+    this.cppBenchOut,
     this.namespace,
     this.copyrightHeader,
     this.headerOutPath,
+    this.includeInstrumentation = false,
+    this.unboxedEnums = false,
+    this.parallelEncodeThreshold,
+    this.encodedSizes = false,
   });
 
   /// Creates InternalCppOptions from CppOptions.
@@ -121,12 +160,17 @@ class InternalCppOptions extends InternalOptions {
     CppOptions options, {
     required this.cppHeaderOut,
     required this.cppSourceOut,
+    this.cppBenchOut,
     Iterable<String>? copyrightHeader,
   }) : headerIncludePath =
            options.headerIncludePath ?? path.basename(cppHeaderOut),
        namespace = options.namespace,
        copyrightHeader = options.copyrightHeader ?? copyrightHeader,
-       headerOutPath = options.headerOutPath;
+       headerOutPath = options.headerOutPath,
+       includeInstrumentation = options.includeInstrumentation,
+       unboxedEnums = options.unboxedEnums,
+       parallelEncodeThreshold = options.parallelEncodeThreshold,
+       encodedSizes = options.encodedSizes;
 
   /// The path to the header that will get placed in the source file (example:
   /// "foo.h").
@@ -138,6 +182,10 @@ class InternalCppOptions extends InternalOptions {
   /// Path to the ".cpp" C++ file that will be generated.
   final String cppSourceOut;
 
+  /// Path to the standalone ".cpp" C++ benchmark that will be generated, if
+  /// any.
+  final String? cppBenchOut;
+
   /// The namespace where the generated class will live.
   final String? namespace;
 
@@ -146,6 +194,24 @@ class InternalCppOptions extends InternalOptions {
 
   /// The path to the output header file location.
   final String? headerOutPath;
+
+  /// Whether to generate the `GolubetsInstrumentation` observer interface and
+  /// the calls that notify it.
+  final bool includeInstrumentation;
+
+  /// Whether the codec serializer writes and reads enum fields of data classes
+  /// directly as integers instead of wrapping each one in a
+  /// `CustomEncodableValue`.
+  final bool unboxedEnums;
+
+  /// The number of elements at which the codec serializer encodes and decodes
+  /// the elements of a list on worker threads, or null to always encode and
+  /// decode on the calling thread.
+  final int? parallelEncodeThreshold;
+
+  /// Whether to generate `EncodedSize()` for data classes, and encode
+  /// messages into buffers reserved at their exact size.
+  final bool encodedSizes;
 }
 
 /// Class that manages all Cpp code generation.
@@ -286,6 +352,9 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
             .map((Api api) => api.name),
       );
     }
+    if (generatorOptions.includeInstrumentation) {
+      _writeInstrumentation(indent);
+    }
   }
 
   @override
@@ -377,7 +446,7 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
         // copy constructor, so declare the rule-of-five group of functions.
         if (orderedFields.any(
           (NamedType field) => _isPointerField(
-            getFieldHostDatatype(field, _baseCppTypeForBuiltinDartType),
+            _cppFieldHostDatatype(field, _baseCppTypeForBuiltinDartType),
           ),
         )) {
           final String className = classDefinition.name;
@@ -418,12 +487,12 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
         }
 
         for (final field in orderedFields) {
-          addDocumentationComments(
-            indent,
-            field.documentationComments,
-            _docCommentSpec,
-          );
-          final HostDatatype baseDatatype = getFieldHostDatatype(
+          addDocumentationComments(indent, <String>[
+            ...field.documentationComments,
+            if (field.type.typedListOf == 'bool')
+              ' Holds one byte, 0 or 1, per element of the declared List<bool>.',
+          ], _docCommentSpec);
+          final HostDatatype baseDatatype = _cppFieldHostDatatype(
             field,
             _baseCppTypeForBuiltinDartType,
           );
@@ -459,6 +528,55 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
           }
           indent.newln();
         }
+
+        if (generatorOptions.encodedSizes && !isOverflowClass) {
+          addDocumentationComments(indent, <String>[
+            ' The number of bytes this object is encoded as when it starts',
+            ' `offset` bytes into a message, which decides the padding before',
+            ' doubles and typed lists.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'EncodedSize',
+            returnType: 'size_t',
+            parameters: <String>['size_t offset = 0'],
+            isConst: true,
+          );
+          indent.newln();
+        }
+
+        final Class? rowClass = classDefinition.columnsOf;
+        if (rowClass != null) {
+          addDocumentationComments(indent, <String>[
+            ' The number of rows, which is the size of the shortest column.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'RowCount',
+            returnType: 'size_t',
+            isConst: true,
+          );
+          addDocumentationComments(indent, <String>[
+            ' Returns the row at `index`, which must be less than `RowCount()`.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'Row',
+            returnType: rowClass.name,
+            parameters: <String>['size_t index'],
+            isConst: true,
+          );
+          addDocumentationComments(indent, <String>[
+            ' Appends `row` to the columns.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'AddRow',
+            returnType: _voidType,
+            parameters: <String>['const ${rowClass.name}& row'],
+          );
+          indent.newln();
+        }
       });
 
       _writeAccessBlock(indent, _ClassAccess.private, () {
@@ -484,6 +602,47 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
             returnType: 'flutter::EncodableValue',
           );
         }
+        if (classDefinition.isCompact) {
+          _writeFunctionDeclaration(
+            indent,
+            'ReadCompact',
+            returnType: classDefinition.name,
+            parameters: <String>['flutter::ByteStreamReader* stream'],
+            isStatic: true,
+          );
+          _writeFunctionDeclaration(
+            indent,
+            'WriteCompact',
+            returnType: _voidType,
+            parameters: <String>['flutter::ByteStreamWriter* stream'],
+            isConst: true,
+          );
+          if (generatorOptions.encodedSizes) {
+            _writeFunctionDeclaration(
+              indent,
+              'CompactEncodedEnd',
+              returnType: 'size_t',
+              parameters: <String>['size_t offset'],
+              isConst: true,
+            );
+          }
+        }
+        if (classDefinition.isPacked) {
+          _writeFunctionDeclaration(
+            indent,
+            'ReadPacked',
+            returnType: classDefinition.name,
+            parameters: <String>['flutter::ByteStreamReader* stream'],
+            isStatic: true,
+          );
+          _writeFunctionDeclaration(
+            indent,
+            'WritePacked',
+            returnType: _voidType,
+            parameters: <String>['flutter::ByteStreamWriter* stream'],
+            isConst: true,
+          );
+        }
         if (!isOverflowClass && root.requiresOverflowClass) {
           indent.writeln('friend class $_overflowClassName;');
         }
@@ -509,7 +668,7 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
         }
 
         for (final field in orderedFields) {
-          final HostDatatype hostDatatype = getFieldHostDatatype(
+          final HostDatatype hostDatatype = _cppFieldHostDatatype(
             field,
             _baseCppTypeForBuiltinDartType,
           );
@@ -520,6 +679,24 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
       });
     }, nestCount: 0);
     indent.newln();
+    final int? ringBufferCapacity = classDefinition.ringBufferCapacity;
+    if (ringBufferCapacity != null) {
+      final String name = classDefinition.name;
+      indent.format('''
+// A single-producer, single-consumer ring of `$name` records in memory shared
+// with Dart, which reads them with the generated `${name}RingBuffer`.
+class ${name}RingBuffer {
+ public:
+	// The number of records the ring holds.
+	static constexpr uint64_t kCapacity = $ringBufferCapacity;
+
+	// Appends `value` to the ring, or returns false if it is full because Dart
+	// hasn't read enough records yet. Only one thread may push at a time.
+	static bool Push(const $name& value);
+};
+''');
+      indent.newln();
+    }
   }
 
   @override
@@ -562,6 +739,75 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
           isConst: true,
           isOverride: true,
         );
+        if (generatorOptions.encodedSizes) {
+          indent.newln();
+          addDocumentationComments(indent, <String>[
+            ' The number of bytes `value` is encoded as when it starts `offset`',
+            ' bytes into a message.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'EncodedSize',
+            returnType: 'size_t',
+            parameters: <String>[
+              'const flutter::EncodableValue& value',
+              'size_t offset = 0',
+            ],
+            isStatic: true,
+          );
+          _writeFunctionDeclaration(
+            indent,
+            'EncodedSize',
+            returnType: 'size_t',
+            parameters: <String>[
+              'const flutter::EncodableList& list',
+              'size_t offset',
+            ],
+            isStatic: true,
+          );
+          _writeFunctionDeclaration(
+            indent,
+            'EncodedSize',
+            returnType: 'size_t',
+            parameters: <String>[
+              'const flutter::EncodableMap& map',
+              'size_t offset',
+            ],
+            isStatic: true,
+          );
+        }
+        if (_hasUnboxedEnumMethods(generatorOptions, root)) {
+          indent.newln();
+          addDocumentationComments(indent, <String>[
+            ' Reads the arguments of a host method, reading the enum arguments',
+            ' whose custom type is given in `enum_types` as their index.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'ReadArguments',
+            returnType: 'flutter::EncodableValue',
+            parameters: <String>[
+              'flutter::ByteStreamReader* stream',
+              'const std::vector<uint8_t>& enum_types',
+            ],
+            isConst: true,
+          );
+          addDocumentationComments(indent, <String>[
+            ' Writes the reply of a host method, writing a returned enum index',
+            ' as the enum with custom type `enum_type`.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'WriteResult',
+            returnType: _voidType,
+            parameters: <String>[
+              'const flutter::EncodableValue& result',
+              'uint8_t enum_type',
+              'flutter::ByteStreamWriter* stream',
+            ],
+            isConst: true,
+          );
+        }
       });
       indent.writeScoped(' protected:', '', () {
         _writeFunctionDeclaration(
@@ -576,6 +822,40 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
           isOverride: true,
         );
       });
+      if (generatorOptions.parallelEncodeThreshold != null) {
+        _writeAccessBlock(indent, _ClassAccess.private, () {
+          addDocumentationComments(indent, <String>[
+            ' Writes `list` with its elements encoded on worker threads, or',
+            ' returns false without writing anything if they have to be',
+            ' encoded in place.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'WriteListInParallel',
+            returnType: 'bool',
+            parameters: <String>[
+              'const flutter::EncodableList& list',
+              'flutter::ByteStreamWriter* stream',
+            ],
+            isConst: true,
+          );
+          addDocumentationComments(indent, <String>[
+            ' Reads a list whose type byte has been read into `list`, with its',
+            ' elements decoded on worker threads, or returns false without',
+            ' reading anything if they have to be decoded in place.',
+          ], _docCommentSpec);
+          _writeFunctionDeclaration(
+            indent,
+            'ReadListInParallel',
+            returnType: 'bool',
+            parameters: <String>[
+              'flutter::ByteStreamReader* stream',
+              'flutter::EncodableList* list',
+            ],
+            isConst: true,
+          );
+        });
+      }
     }, nestCount: 0);
     indent.newln();
   }
@@ -620,7 +900,7 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
           isStatic: true,
         );
         for (final Method func in api.methods) {
-          final HostDatatype returnType = getHostDatatype(
+          final HostDatatype returnType = _cppHostDatatype(
             func.returnType,
             _baseCppTypeForBuiltinDartType,
           );
@@ -633,7 +913,7 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
           final Iterable<String> argTypes = func.parameters.map((
             NamedType arg,
           ) {
-            final HostDatatype hostType = getFieldHostDatatype(
+            final HostDatatype hostType = _cppFieldHostDatatype(
               arg,
               _baseCppTypeForBuiltinDartType,
             );
@@ -705,7 +985,7 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
           inlineNoop: true,
         );
         for (final Method method in api.methods) {
-          final HostDatatype returnType = getHostDatatype(
+          final HostDatatype returnType = _cppHostDatatype(
             method.returnType,
             _baseCppTypeForBuiltinDartType,
           );
@@ -716,7 +996,7 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
             final Iterable<String> argTypes = method.parameters.map((
               NamedType arg,
             ) {
-              final HostDatatype hostType = getFieldHostDatatype(
+              final HostDatatype hostType = _cppFieldHostDatatype(
                 arg,
                 _baseCppTypeForBuiltinDartType,
               );
@@ -814,7 +1094,7 @@ class CppHeaderGenerator extends StructuredGenerator<InternalCppOptions> {
     String docComment,
   ) {
     final List<String> paramStrings = params.map((NamedType param) {
-      final HostDatatype hostDatatype = getFieldHostDatatype(
+      final HostDatatype hostDatatype = _cppFieldHostDatatype(
         param,
         _baseCppTypeForBuiltinDartType,
       );
@@ -853,6 +1133,42 @@ class FlutterError {
 };''');
   }
 
+  void _writeInstrumentation(Indent indent) {
+    indent.format('''
+
+// Observer notified about the messages of the generated APIs.
+//
+// All methods are called on the platform thread, and do nothing by default.
+class GolubetsInstrumentation {
+ public:
+\tvirtual ~GolubetsInstrumentation() = default;
+
+\t// Called when a message of `message_size` bytes arrives on `channel_name`,
+\t// before it is decoded. For Flutter APIs the message is the reply.
+\tvirtual void OnDecodeStart(const std::string& channel_name, size_t message_size) {}
+\t// Called when a decoded message is about to be handled. For Flutter APIs
+\t// the handler is the `on_success` or `on_error` callback.
+\tvirtual void OnHandlerStart(const std::string& channel_name) {}
+\t// Called when a host API sends a reply of `reply_size` bytes.
+\tvirtual void OnReply(const std::string& channel_name, size_t reply_size) {}
+\t// Called when a call on `channel_name` fails with `error`.
+\tvirtual void OnError(const std::string& channel_name, const FlutterError& error) {}
+};
+
+// Sets the observer for the APIs in this file, or removes it if
+// `instrumentation` is null. The observer is not owned, and must remain valid
+// until it is removed.
+void SetGolubetsInstrumentation(GolubetsInstrumentation* instrumentation);
+
+#ifdef GOLUBETS_ENABLE_TRACE
+// Writes the spans recorded for the decode, handler, encode and reply-send
+// phases of the calls on each thread to `path` as Chrome trace event JSON,
+// which can be opened in Perfetto or chrome://tracing. Only the most recent
+// spans of each thread are kept. Returns false if `path` can't be written.
+bool DumpTrace(const std::string& path);
+#endif  // GOLUBETS_ENABLE_TRACE''');
+  }
+
   void _writeErrorOr(
     Indent indent, {
     Iterable<String> friends = const <String>[],
@@ -936,12 +1252,51 @@ class CppSourceGenerator extends StructuredGenerator<InternalCppOptions> {
       'flutter/standard_message_codec.h',
     ]);
     indent.newln();
+    final bool hasUnboxedEnumMethods = _hasUnboxedEnumMethods(
+      generatorOptions,
+      root,
+    );
     _writeSystemHeaderIncludeBlock(indent, <String>[
+      if (_hasChunkedReplies(root) ||
+          _hasColumnsClasses(root) ||
+          generatorOptions.parallelEncodeThreshold != null ||
+          hasUnboxedEnumMethods)
+        'algorithm',
+      if (_hasRingBuffers(root)) 'atomic',
+      if (_hasPackedClasses(root)) 'cstddef',
+      if (_hasChunkedReplies(root)) 'deque',
+      if (hasUnboxedEnumMethods ||
+          generatorOptions.parallelEncodeThreshold != null)
+        'cstring',
+      if (generatorOptions.parallelEncodeThreshold != null ||
+          root.apis.any(hasFfiSyncMethods))
+        'future',
       'map',
+      if (_hasChunkedReplies(root) || root.apis.any(hasFfiSyncMethods))
+        'memory',
+      if (root.apis.any(hasFfiSyncMethods)) 'mutex',
+      if (root.apis.any(hasFfiSyncMethods)) 'shared_mutex',
       'string',
       'optional',
+      if (generatorOptions.parallelEncodeThreshold != null) 'thread',
+      if (_hasPackedClasses(root)) 'type_traits',
     ]);
     indent.newln();
+    if (generatorOptions.includeInstrumentation) {
+      indent.writeln('#ifdef GOLUBETS_ENABLE_TRACE');
+      _writeSystemHeaderIncludeBlock(indent, <String>[
+        'algorithm',
+        'array',
+        'atomic',
+        'chrono',
+        'fstream',
+        'memory',
+        'mutex',
+        'vector',
+      ]);
+      indent.writeln('#endif  // GOLUBETS_ENABLE_TRACE');
+      indent.newln();
+    }
   }
 
   @override
@@ -988,137 +1343,1628 @@ class CppSourceGenerator extends StructuredGenerator<InternalCppOptions> {
       EncodableValue(""));''');
       },
     );
-  }
-
-  @override
-  void writeDataClass(
-    InternalCppOptions generatorOptions,
-    Root root,
-    Indent indent,
-    Class classDefinition, {
-    required String dartPackageName,
-  }) {
-    indent.writeln('$_commentPrefix ${classDefinition.name}');
-    indent.newln();
-
-    final Iterable<NamedType> orderedFields = getFieldsInSerializationOrder(
-      classDefinition,
-    );
-    final Iterable<NamedType> requiredFields = orderedFields.where(
-      (NamedType type) => !type.type.isNullable,
-    );
-    // Minimal constructor, if needed.
-    if (requiredFields.length != orderedFields.length) {
-      _writeClassConstructor(root, indent, classDefinition, requiredFields);
+    if (generatorOptions.includeInstrumentation) {
+      _writeInstrumentation(
+        indent,
+        hasHostApis: root.apis.any((Api api) => api is AstHostApi),
+      );
     }
-    // All-field constructor.
-    _writeClassConstructor(root, indent, classDefinition, orderedFields);
-
-    // Custom copy/assign to handle pointer fields, if necessary.
-    if (orderedFields.any(
-      (NamedType field) => _isPointerField(
-        getFieldHostDatatype(field, _baseCppTypeForBuiltinDartType),
-      ),
+    if (root.classes.any(
+      (Class classDefinition) => classDefinition.isCompact,
     )) {
-      _writeCopyConstructor(root, indent, classDefinition, orderedFields);
-      _writeAssignmentOperator(root, indent, classDefinition, orderedFields);
-    }
-
-    // Getters and setters.
-    for (final field in orderedFields) {
-      _writeCppSourceClassField(
-        generatorOptions,
+      _writeCompactUtilities(
         root,
         indent,
-        classDefinition,
-        field,
+        encodedSizes: generatorOptions.encodedSizes,
       );
     }
-
-    // Serialization.
-    writeClassEncode(
-      generatorOptions,
-      root,
-      indent,
-      classDefinition,
-      dartPackageName: dartPackageName,
-    );
-
-    // Deserialization.
-    writeClassDecode(
+    if (_hasChunkedReplies(root)) {
+      _writeChunkedReplyUtilities(indent);
+    }
+    final int? parallelEncodeThreshold =
+        generatorOptions.parallelEncodeThreshold;
+    final bool hasUnboxedEnumMethods = _hasUnboxedEnumMethods(
       generatorOptions,
       root,
-      indent,
-      classDefinition,
-      dartPackageName: dartPackageName,
     );
+    if (generatorOptions.encodedSizes ||
+        hasUnboxedEnumMethods ||
+        parallelEncodeThreshold != null) {
+      _writeMessageStreams(
+        indent,
+        reader: hasUnboxedEnumMethods || parallelEncodeThreshold != null,
+      );
+    }
+    if (parallelEncodeThreshold != null) {
+      _writeParallelEncodeUtilities(root, indent, parallelEncodeThreshold);
+    }
+    if (generatorOptions.encodedSizes) {
+      _writeEncodedSizeUtilities(
+        indent,
+        parallelDecode: parallelEncodeThreshold != null,
+      );
+    }
+    if (hasUnboxedEnumMethods) {
+      _writeUnboxedEnumCodec(indent);
+    }
+    if (root.apis.any(hasFfiSyncMethods) || _hasRingBuffers(root)) {
+      indent.newln();
+      indent.format('''
+#ifndef GOLUBETS_FFI_EXPORT
+#if defined(_WIN32)
+#define GOLUBETS_FFI_EXPORT __declspec(dllexport)
+#else
+#define GOLUBETS_FFI_EXPORT __attribute__((visibility("default")))
+#endif
+#endif''');
+    }
   }
 
-  @override
-  void writeClassEncode(
-    InternalCppOptions generatorOptions,
-    Root root,
-    Indent indent,
-    Class classDefinition, {
-    required String dartPackageName,
-  }) {
-    _writeFunctionDefinition(
-      indent,
-      'ToEncodableList',
-      scope: classDefinition.name,
-      returnType: 'EncodableList',
-      isConst: true,
-      body: () {
-        indent.writeln('EncodableList list;');
-        indent.writeln('list.reserve(${classDefinition.fields.length});');
-        for (final NamedType field in getFieldsInSerializationOrder(
-          classDefinition,
-        )) {
-          final HostDatatype hostDatatype = getFieldHostDatatype(
-            field,
-            _shortBaseCppTypeForBuiltinDartType,
-          );
-          final String encodableValue = _wrappedHostApiArgumentExpression(
-            root,
-            _makeInstanceVariableName(field),
-            field.type,
-            hostDatatype,
-            true,
-          );
-          indent.writeln('list.push_back($encodableValue);');
-        }
-        indent.writeln('return list;');
-      },
-    );
+  // Writes the helpers that send the replies of `@Chunked()` methods in
+  // frames on a side channel.
+  void _writeChunkedReplyUtilities(Indent indent) {
+    indent.newln();
+    indent.format('''
+namespace {
+
+// Splits an encoded reply into frames of at most `frame_size` bytes as it is
+// written, each starting with its little-endian 32-bit sequence number, so the
+// encoded reply never exists in one piece.
+class ChunkedReplyWriter : public flutter::ByteStreamWriter {
+ public:
+	ChunkedReplyWriter(std::deque<std::vector<uint8_t>>* frames, size_t frame_size)
+		: frames_(frames), frame_size_(frame_size) {
+		StartFrame();
+	}
+
+	void WriteByte(uint8_t byte) override { WriteBytes(&byte, 1); }
+
+	void WriteBytes(const uint8_t* bytes, size_t length) override {
+		while (length > 0) {
+			const size_t count = std::min(length, kHeaderSize + frame_size_ - frame_.size());
+			frame_.insert(frame_.end(), bytes, bytes + count);
+			position_ += count;
+			bytes += count;
+			length -= count;
+			if (frame_.size() == kHeaderSize + frame_size_) {
+				AddFrame();
+			}
+		}
+	}
+
+	// Alignment is relative to the start of the reassembled reply.
+	void WriteAlignment(uint8_t alignment) override {
+		while (position_ % alignment != 0) {
+			WriteByte(0);
+		}
+	}
+
+	// Adds the last frame, and returns the number of frames.
+	int64_t Finish() {
+		if (frame_.size() > kHeaderSize) {
+			AddFrame();
+		}
+		return sequence_;
+	}
+
+ private:
+	static constexpr size_t kHeaderSize = 4;
+
+	void StartFrame() {
+		frame_.clear();
+		frame_.reserve(kHeaderSize + frame_size_);
+		for (size_t i = 0; i < kHeaderSize; i++) {
+			frame_.push_back(static_cast<uint8_t>(sequence_ >> (8 * i)));
+		}
+	}
+
+	void AddFrame() {
+		frames_->push_back(std::move(frame_));
+		sequence_++;
+		StartFrame();
+	}
+
+	std::deque<std::vector<uint8_t>>* frames_;
+	size_t frame_size_;
+	std::vector<uint8_t> frame_;
+	size_t position_ = 0;
+	uint32_t sequence_ = 0;
+};
+
+// The frames of a reply that are still to be sent.
+struct PendingChunkedReply {
+	flutter::BinaryMessenger* messenger;
+	std::string channel;
+	std::deque<std::vector<uint8_t>> frames;
+	int64_t frame_count = 0;
+	flutter::MessageReply<EncodableValue> reply;
+};
+
+// Sends the next frame of `pending`, or the number of frames once they have
+// all been sent. Each frame is sent when Dart acknowledges the previous one, so
+// the platform thread handles other messages between frames.
+void SendNextFrame(std::shared_ptr<PendingChunkedReply> pending) {
+	if (pending->frames.empty()) {
+		pending->reply(EncodableValue(EncodableList{EncodableValue(pending->frame_count)}));
+		return;
+	}
+	const std::vector<uint8_t> frame = std::move(pending->frames.front());
+	pending->frames.pop_front();
+	pending->messenger->Send(pending->channel, frame.data(), frame.size(), [pending](const uint8_t*, size_t) {
+		SendNextFrame(pending);
+	});
+}
+
+// Sends `value` to `channel` in frames encoded with `serializer`, and then
+// replies with the number of frames Dart reassembles.
+void SendChunkedReply(flutter::BinaryMessenger* messenger, const std::string& channel, size_t frame_size, const flutter::StandardCodecSerializer& serializer, const EncodableValue& value, const flutter::MessageReply<EncodableValue>& reply) {
+	auto pending = std::make_shared<PendingChunkedReply>();
+	pending->messenger = messenger;
+	pending->channel = channel;
+	pending->reply = reply;
+	ChunkedReplyWriter writer(&pending->frames, frame_size);
+	serializer.WriteValue(value, &writer);
+	pending->frame_count = writer.Finish();
+	SendNextFrame(std::move(pending));
+}
+
+}  // namespace''');
   }
 
-  @override
-  void writeClassDecode(
-    InternalCppOptions generatorOptions,
-    Root root,
-    Indent indent,
-    Class classDefinition, {
-    required String dartPackageName,
-  }) {
-    // Returns the expression to convert the given EncodableValue to a field
-    // value.
-    String getValueExpression(NamedType field, String encodable) {
-      if (field.type.baseName == 'Object') {
-        return encodable;
-      } else {
-        final HostDatatype hostDatatype = getFieldHostDatatype(
-          field,
-          _shortBaseCppTypeForBuiltinDartType,
-        );
-        if (field.type.isClass || field.type.isEnum) {
-          return _classReferenceFromEncodableValue(hostDatatype, encodable);
-        } else {
-          return 'std::get<${hostDatatype.datatype}>($encodable)';
-        }
-      }
-    }
+  // Writes the streams that codecs with their own message framing encode
+  // into and decode from.
+  void _writeMessageStreams(Indent indent, {required bool reader}) {
+    indent.newln();
+    indent.format('''
+namespace {
 
-    _writeFunctionDefinition(
+// Appends to a vector, padding relative to its start like the standard codec.
+class VectorStreamWriter : public flutter::ByteStreamWriter {
+ public:
+	explicit VectorStreamWriter(std::vector<uint8_t>* buffer) : buffer_(buffer) {}
+
+	void WriteByte(uint8_t byte) override { buffer_->push_back(byte); }
+
+	void WriteBytes(const uint8_t* bytes, size_t length) override {
+		buffer_->insert(buffer_->end(), bytes, bytes + length);
+	}
+
+	void WriteAlignment(uint8_t alignment) override {
+		while (buffer_->size() % alignment != 0) {
+			buffer_->push_back(0);
+		}
+	}
+
+ private:
+	std::vector<uint8_t>* buffer_;
+};''');
+    if (reader) {
+      indent.newln();
+      indent.format('''
+// Reads from a message, padding relative to its start like the standard
+// codec. Reads past the end return zeros.
+class BufferStreamReader : public flutter::ByteStreamReader {
+ public:
+	BufferStreamReader(const uint8_t* bytes, size_t size, size_t position = 0)
+		: bytes_(bytes), size_(size), position_(position) {}
+
+	uint8_t ReadByte() override {
+		return position_ < size_ ? bytes_[position_++] : 0;
+	}
+
+	void ReadBytes(uint8_t* buffer, size_t length) override {
+		const size_t available = position_ < size_ ? std::min(length, size_ - position_) : 0;
+		std::memcpy(buffer, bytes_ + position_, available);
+		std::memset(buffer + available, 0, length - available);
+		position_ += length;
+	}
+
+	void ReadAlignment(uint8_t alignment) override {
+		position_ = (position_ + alignment - 1) / alignment * alignment;
+	}
+
+	const uint8_t* bytes() const { return bytes_; }
+	size_t size() const { return size_; }
+	size_t position() const { return position_; }
+
+	// Moves past `length` bytes without reading them.
+	void Skip(size_t length) { position_ += length; }
+
+	// Moves to `position` in the message without reading.
+	void Seek(size_t position) { position_ = position; }
+
+ private:
+	const uint8_t* bytes_;
+	size_t size_;
+	size_t position_;
+};''');
+    }
+    indent.newln();
+    indent.writeln('}  // namespace');
+  }
+
+  // Writes the codec of host method channels whose enum arguments and return
+  // values are not wrapped in CustomEncodableValue.
+  void _writeUnboxedEnumCodec(Indent indent) {
+    indent.newln();
+    indent.format('''
+namespace {
+
+// Decodes the arguments of a host method with its enum arguments as their
+// index, and encodes an enum return value from its index, so that neither is
+// wrapped in a CustomEncodableValue.
+class UnboxedEnumCodec : public flutter::MessageCodec<EncodableValue> {
+ public:
+	// `argument_types` holds the custom type of each enum argument, and 0 for
+	// the other arguments. `return_type` is the custom type of an enum return
+	// value, or 0.
+	UnboxedEnumCodec(std::vector<uint8_t> argument_types, uint8_t return_type)
+		: argument_types_(std::move(argument_types)), return_type_(return_type) {}
+
+ protected:
+	std::unique_ptr<EncodableValue> DecodeMessageInternal(const uint8_t* binary_message, size_t message_size) const override {
+		if (binary_message == nullptr) {
+			return std::make_unique<EncodableValue>();
+		}
+		BufferStreamReader reader(binary_message, message_size);
+		return std::make_unique<EncodableValue>($_codecSerializerName::GetInstance().ReadArguments(&reader, argument_types_));
+	}
+
+	std::unique_ptr<std::vector<uint8_t>> EncodeMessageInternal(const EncodableValue& message) const override {
+		auto encoded = std::make_unique<std::vector<uint8_t>>();
+		VectorStreamWriter writer(encoded.get());
+		$_codecSerializerName::GetInstance().WriteResult(message, return_type_, &writer);
+		return encoded;
+	}
+
+ private:
+	std::vector<uint8_t> argument_types_;
+	uint8_t return_type_;
+};
+
+}  // namespace''');
+  }
+
+  // Writes the helpers that compute encoded sizes, and the codec that reserves
+  // them. With [parallelDecode], the codec decodes like ParallelMessageCodec.
+  void _writeEncodedSizeUtilities(
+    Indent indent, {
+    required bool parallelDecode,
+  }) {
+    final String decode = parallelDecode
+        ? 'ParallelMessageCodec::GetInstance()'
+        : 'flutter::StandardMessageCodec::GetInstance(&$_codecSerializerName::GetInstance())';
+    indent.newln();
+    indent.format('''
+namespace {
+
+// Returns `end` plus the number of bytes the standard codec writes `size` as.
+size_t AddEncodedSizeSize(size_t end, size_t size) {
+	return end + (size < 254 ? 1 : size <= 0xffff ? 3 : 5);
+}
+
+// Returns `end` padded to a multiple of `alignment`.
+size_t AlignEncodedEnd(size_t end, size_t alignment) {
+	return (end + alignment - 1) / alignment * alignment;
+}
+
+// Returns where a typed list that starts at `offset` ends. Empty lists have
+// no padding.
+template <typename T>
+size_t TypedListEncodedEnd(const std::vector<T>& list, size_t offset) {
+	const size_t end = AddEncodedSizeSize(offset + 1, list.size());
+	return list.empty() ? end : AlignEncodedEnd(end, sizeof(T)) + list.size() * sizeof(T);
+}
+
+// Counts the bytes of values that have their own encoding.
+class EncodedSizeCounter : public flutter::ByteStreamWriter {
+ public:
+	explicit EncodedSizeCounter(size_t offset) : end(offset) {}
+
+	void WriteByte(uint8_t) override { end++; }
+
+	void WriteBytes(const uint8_t*, size_t length) override { end += length; }
+
+	void WriteAlignment(uint8_t alignment) override {
+		end = AlignEncodedEnd(end, alignment);
+	}
+
+	size_t end;
+};
+
+// Encodes messages into a buffer reserved at their exact size, so that it
+// never grows while a message is written.
+class ReservingMessageCodec : public flutter::MessageCodec<EncodableValue> {
+ public:
+	static const ReservingMessageCodec& GetInstance() {
+		static ReservingMessageCodec instance;
+		return instance;
+	}
+
+ protected:
+	std::unique_ptr<EncodableValue> DecodeMessageInternal(const uint8_t* binary_message, size_t message_size) const override {
+		return $decode.DecodeMessage(binary_message, message_size);
+	}
+
+	std::unique_ptr<std::vector<uint8_t>> EncodeMessageInternal(const EncodableValue& message) const override {
+		auto encoded = std::make_unique<std::vector<uint8_t>>();
+		encoded->reserve($_codecSerializerName::EncodedSize(message));
+		VectorStreamWriter writer(encoded.get());
+		$_codecSerializerName::GetInstance().WriteValue(message, &writer);
+		return encoded;
+	}
+};
+
+}  // namespace''');
+  }
+
+  // Writes the EncodedSize function of [classDefinition], which mirrors
+  // ToEncodableList, or the packed or compact encoding, field by field.
+  // Wrapped classes are counted as they are written instead.
+  void _writeEncodedSize(Root root, Indent indent, Class classDefinition) {
+    final String name = classDefinition.name;
+    final bool isWrapped = getEnumeratedTypes(
+      root,
+      excludeSealedClasses: true,
+    ).any(
+      (EnumeratedType customType) =>
+          customType.associatedClass == classDefinition &&
+          customType.enumeration >= maximumCodecFieldKey,
+    );
+    _writeFunctionDefinition(
+      indent,
+      'EncodedSize',
+      scope: name,
+      returnType: 'size_t',
+      parameters: <String>['size_t offset'],
+      isConst: true,
+      body: () {
+        if (classDefinition.isPacked && !isWrapped) {
+          final int recordSize = getPackedLayout(classDefinition).size;
+          indent.writeln(
+            '// The type byte and the packed kind, then the record.',
+          );
+          indent.writeln('return ${2 + recordSize};');
+          return;
+        }
+        if (classDefinition.isCompact && !isWrapped) {
+          indent.writeln(
+            '// The type byte, then the fields in the compact format.',
+          );
+          indent.writeln('return CompactEncodedEnd(offset + 1) - offset;');
+          return;
+        }
+        if (isWrapped) {
+          indent.writeln('EncodedSizeCounter counter(offset);');
+          indent.writeln(
+            '$_codecSerializerName::GetInstance().WriteValue(CustomEncodableValue(*this), &counter);',
+          );
+          indent.writeln('return counter.end - offset;');
+          return;
+        }
+        final List<NamedType> fields = getFieldsInSerializationOrder(
+          classDefinition,
+        ).toList();
+        indent.writeln('// The type byte, then the fields as a list.');
+        indent.writeln(
+          'size_t end = AddEncodedSizeSize(offset + 2, ${fields.length});',
+        );
+        for (final field in fields) {
+          final HostDatatype hostDatatype = _cppFieldHostDatatype(
+            field,
+            _shortBaseCppTypeForBuiltinDartType,
+          );
+          final String member = _makeInstanceVariableName(field);
+          final String value =
+              hostDatatype.isNullable ||
+                  (!hostDatatype.isBuiltin && !hostDatatype.isEnum)
+              ? '*$member'
+              : member;
+          final String statement = _encodedSizeStatement(field.type, value);
+          if (hostDatatype.isNullable) {
+            indent.writeScoped('if ($member) {', '} ', () {
+              indent.writeln(statement);
+            }, addTrailingNewline: false);
+            indent.addScoped('else {', '}', () {
+              indent.writeln('end += 1;');
+            });
+          } else {
+            indent.writeln(statement);
+          }
+        }
+        indent.writeln('return end - offset;');
+      },
+    );
+  }
+
+  // Returns the statement that advances `end` past the encoding of [value].
+  String _encodedSizeStatement(TypeDeclaration type, String value) {
+    // Members are called through the pointer or optional [value] dereferences.
+    final String access = value.startsWith('*')
+        ? '${value.substring(1)}->'
+        : '$value.';
+    final Class? packedClass = _packedListClass(type);
+    if (packedClass != null) {
+      // The type byte, the packed kind and the count, then the records.
+      return 'end = AddEncodedSizeSize(end + 2, ${access}size()) + ${access}size() * ${getPackedLayout(packedClass).size};';
+    } else if (type.isClass) {
+      return 'end += ${access}EncodedSize(end);';
+    } else if (type.isEnum) {
+      return 'end += $_codecSerializerName::EncodedSize(CustomEncodableValue($value), end);';
+    }
+    return switch (type.baseName) {
+      'bool' => 'end += 1;',
+      'int' => 'end += 9;',
+      'double' => 'end = AlignEncodedEnd(end + 1, 8) + 8;',
+      'String' =>
+        'end = AddEncodedSizeSize(end + 1, ${access}size()) + ${access}size();',
+      'Uint8List' ||
+      'Int32List' ||
+      'Int64List' ||
+      'Float32List' ||
+      'Float64List' => 'end = TypedListEncodedEnd($value, end);',
+      _ => 'end += $_codecSerializerName::EncodedSize($value, end);',
+    };
+  }
+
+  // Writes the helpers that encode and decode the elements of long lists on
+  // worker threads, and the codec that decodes with them.
+  void _writeParallelEncodeUtilities(Root root, Indent indent, int threshold) {
+    // The custom types whose encoding never pads, so that lists of them can
+    // be encoded by workers.
+    final unalignedTypes = <String>[];
+    for (final EnumeratedType customType in getEnumeratedTypes(
+      root,
+      excludeSealedClasses: true,
+    )) {
+      final Class? classDefinition = customType.associatedClass;
+      if (customType.enumeration >= maximumCodecFieldKey ||
+          (classDefinition != null &&
+              _classMayAlign(classDefinition, <Class>{}))) {
+        continue;
+      }
+      unalignedTypes.add(customType.name);
+      if (_isPackedListType(customType)) {
+        unalignedTypes.add('std::vector<${customType.name}>');
+      }
+    }
+    final String customAlignment = unalignedTypes.isEmpty
+        ? '\t\treturn true;'
+        : '\t\treturn !(${unalignedTypes.map((String type) => 'custom_value->type() == typeid($type)').join(' || ')});';
+    // The custom types that can be skipped without decoding them. Packed
+    // records have a fixed size, and other classes and enums are followed by
+    // one standard value. Compact classes have to be decoded to be skipped.
+    final skippedTypes = <String>[];
+    final valueTypes = <String>[];
+    for (final EnumeratedType customType in getEnumeratedTypes(
+      root,
+      excludeSealedClasses: true,
+    )) {
+      final Class? classDefinition = customType.associatedClass;
+      if (customType.enumeration >= maximumCodecFieldKey ||
+          (classDefinition?.isCompact ?? false)) {
+        continue;
+      }
+      if (classDefinition?.isPacked ?? false) {
+        final int recordSize = getPackedLayout(classDefinition!).size;
+        skippedTypes.add('''
+\t\tcase ${customType.enumeration}: {
+\t\t\tconst size_t count = reader->ReadByte() == 0 ? 1 : ReadSkippedSize(reader);
+\t\t\treader->Skip(count * $recordSize);
+\t\t\tbreak;
+\t\t}''');
+      } else {
+        valueTypes.add('\t\tcase ${customType.enumeration}:');
+      }
+    }
+    if (root.requiresOverflowClass) {
+      valueTypes.add('\t\tcase $maximumCodecFieldKey:');
+    }
+    if (valueTypes.isNotEmpty) {
+      skippedTypes.add('''
+${valueTypes.join('\n')}
+\t\t\tif (!SkipValue(reader)) {
+\t\t\t\treturn false;
+\t\t\t}
+\t\t\tbreak;''');
+    }
+    final String customSkips = skippedTypes.isEmpty
+        ? ''
+        : '${skippedTypes.join('\n')}\n';
+    indent.newln();
+    indent.format('''
+namespace {
+
+// The number of elements at which a list is encoded or decoded in parallel.
+constexpr size_t kParallelEncodeThreshold = $threshold;
+
+// Collects the encoding of the elements handled by one worker.
+class ParallelEncodeBuffer : public flutter::ByteStreamWriter {
+ public:
+	void WriteByte(uint8_t byte) override { bytes.push_back(byte); }
+
+	void WriteBytes(const uint8_t* data, size_t length) override {
+		bytes.insert(bytes.end(), data, data + length);
+	}
+
+	// Padding is relative to the start of the message, which this buffer
+	// doesn't know. MayAlign() keeps such lists from being sent to workers,
+	// so this only marks values it couldn't rule out.
+	void WriteAlignment(uint8_t alignment) override {
+		aligned = true;
+		while (bytes.size() % alignment != 0) {
+			bytes.push_back(0);
+		}
+	}
+
+	std::vector<uint8_t> bytes;
+	bool aligned = false;
+};
+
+// Whether this thread is a worker of a parallel encode or decode, which
+// handles nested lists itself instead of starting more workers.
+thread_local bool in_parallel_worker = false;
+
+// Marks the current thread as a worker of a parallel encode or decode while
+// in scope, since std::async may run later tasks on the same thread.
+class ParallelWorkerScope {
+ public:
+	ParallelWorkerScope() { in_parallel_worker = true; }
+	~ParallelWorkerScope() { in_parallel_worker = false; }
+
+	ParallelWorkerScope(const ParallelWorkerScope&) = delete;
+	ParallelWorkerScope& operator=(const ParallelWorkerScope&) = delete;
+};
+
+// Whether encoding `value` may pad to an alignment. Padding depends on the
+// offset in the message, which workers don't know, so lists holding such
+// values are encoded in place without starting workers.
+bool MayAlign(const EncodableValue& value) {
+	if (std::holds_alternative<double>(value) ||
+			std::holds_alternative<std::vector<int32_t>>(value) ||
+			std::holds_alternative<std::vector<int64_t>>(value) ||
+			std::holds_alternative<std::vector<float>>(value) ||
+			std::holds_alternative<std::vector<double>>(value)) {
+		return true;
+	}
+	if (const EncodableList* list = std::get_if<EncodableList>(&value)) {
+		return std::any_of(list->begin(), list->end(), MayAlign);
+	}
+	if (const EncodableMap* map = std::get_if<EncodableMap>(&value)) {
+		return std::any_of(map->begin(), map->end(), [](const auto& entry) {
+			return MayAlign(entry.first) || MayAlign(entry.second);
+		});
+	}
+	if (const CustomEncodableValue* custom_value = std::get_if<CustomEncodableValue>(&value)) {
+$customAlignment
+	}
+	return false;
+}
+
+// Reads a size written by the standard codec.
+size_t ReadSkippedSize(BufferStreamReader* reader) {
+	const uint8_t byte = reader->ReadByte();
+	if (byte < 254) {
+		return byte;
+	}
+	if (byte == 254) {
+		uint16_t size = 0;
+		reader->ReadBytes(reinterpret_cast<uint8_t*>(&size), sizeof(size));
+		return size;
+	}
+	uint32_t size = 0;
+	reader->ReadBytes(reinterpret_cast<uint8_t*>(&size), sizeof(size));
+	return size;
+}
+
+// Moves past a typed list with elements of `element_size` bytes, which are
+// aligned to their size unless the list is empty.
+void SkipTypedList(BufferStreamReader* reader, size_t element_size) {
+	const size_t count = ReadSkippedSize(reader);
+	if (count > 0) {
+		reader->ReadAlignment(static_cast<uint8_t>(element_size));
+		reader->Skip(count * element_size);
+	}
+}
+
+// Moves past the value at the position of `reader` without decoding it, so
+// that the elements of a list can be divided among workers. Returns false if
+// the value runs past the end of the message, or if its length is only known
+// by decoding it.
+bool SkipValue(BufferStreamReader* reader) {
+	if (reader->position() >= reader->size()) {
+		return false;
+	}
+	const uint8_t type = reader->ReadByte();
+	switch (type) {
+		// Null, true and false.
+		case 0:
+		case 1:
+		case 2:
+			break;
+		case 3:
+			reader->Skip(4);
+			break;
+		case 4:
+			reader->Skip(8);
+			break;
+		case 6:
+			reader->ReadAlignment(8);
+			reader->Skip(8);
+			break;
+		// Large ints, strings and Uint8Lists.
+		case 5:
+		case 7:
+		case 8:
+			reader->Skip(ReadSkippedSize(reader));
+			break;
+		// Int32Lists and Float32Lists.
+		case 9:
+		case 14:
+			SkipTypedList(reader, 4);
+			break;
+		// Int64Lists and Float64Lists.
+		case 10:
+		case 11:
+			SkipTypedList(reader, 8);
+			break;
+		// Lists and maps.
+		case 12:
+		case 13: {
+			const size_t count = ReadSkippedSize(reader) * (type == 13 ? 2 : 1);
+			for (size_t i = 0; i < count; ++i) {
+				if (!SkipValue(reader)) {
+					return false;
+				}
+			}
+			break;
+		}
+$customSkips		default:
+			return false;
+	}
+	return reader->position() <= reader->size();
+}
+
+// Decodes messages with a BufferStreamReader, whose position lets the
+// serializer decode the elements of long lists on worker threads.
+class ParallelMessageCodec : public flutter::MessageCodec<EncodableValue> {
+ public:
+	static const ParallelMessageCodec& GetInstance() {
+		static ParallelMessageCodec instance;
+		return instance;
+	}
+
+ protected:
+	std::unique_ptr<EncodableValue> DecodeMessageInternal(const uint8_t* binary_message, size_t message_size) const override {
+		if (binary_message == nullptr) {
+			return std::make_unique<EncodableValue>();
+		}
+		BufferStreamReader reader(binary_message, message_size);
+		return std::make_unique<EncodableValue>($_codecSerializerName::GetInstance().ReadValue(&reader));
+	}
+
+	std::unique_ptr<std::vector<uint8_t>> EncodeMessageInternal(const EncodableValue& message) const override {
+		auto encoded = std::make_unique<std::vector<uint8_t>>();
+		VectorStreamWriter writer(encoded.get());
+		$_codecSerializerName::GetInstance().WriteValue(message, &writer);
+		return encoded;
+	}
+};
+
+}  // namespace''');
+  }
+
+  // Writes the helpers used by the compact encoding of data classes. Only the
+  // helpers needed by the fields of compact classes are written.
+  void _writeCompactUtilities(
+    Root root,
+    Indent indent, {
+    required bool encodedSizes,
+  }) {
+    final Iterable<TypeDeclaration> types = root.classes
+        .where((Class classDefinition) => classDefinition.isCompact)
+        .expand((Class classDefinition) => classDefinition.fields)
+        .map((NamedType field) => field.type);
+    final bool hasVarints = types.any(
+      (TypeDeclaration type) =>
+          !type.isClass && type.baseName != 'bool' && type.baseName != 'double',
+    );
+    final bool hasStrings = types.any(
+      (TypeDeclaration type) => type.baseName == 'String',
+    );
+    final bool hasLists = types.any(
+      (TypeDeclaration type) => type.baseName.endsWith('List'),
+    );
+    if (!hasVarints) {
+      return;
+    }
+
+    indent.newln();
+    indent.writeln('namespace {');
+    indent.newln();
+    indent.format('''
+// Writes [value] as a zigzag LEB128 varint.
+void WriteCompactVarint(int64_t value, flutter::ByteStreamWriter* stream) {
+\tuint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+\twhile (zigzag >= 0x80) {
+\t\tstream->WriteByte(static_cast<uint8_t>(zigzag | 0x80));
+\t\tzigzag >>= 7;
+\t}
+\tstream->WriteByte(static_cast<uint8_t>(zigzag));
+}
+
+int64_t ReadCompactVarint(flutter::ByteStreamReader* stream) {
+\tuint64_t zigzag = 0;
+\tfor (int shift = 0; shift < 64; shift += 7) {
+\t\tconst uint8_t byte = stream->ReadByte();
+\t\tzigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+\t\tif ((byte & 0x80) == 0) {
+\t\t\tbreak;
+\t\t}
+\t}
+\treturn static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+}''');
+    if (encodedSizes) {
+      indent.newln();
+      indent.format('''
+size_t CompactVarintSize(int64_t value) {
+\tuint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+\tsize_t size = 1;
+\twhile (zigzag >= 0x80) {
+\t\tzigzag >>= 7;
+\t\tsize++;
+\t}
+\treturn size;
+}''');
+    }
+    if (hasStrings) {
+      indent.newln();
+      indent.format('''
+void WriteCompactString(const std::string& value, flutter::ByteStreamWriter* stream) {
+\tWriteCompactVarint(static_cast<int64_t>(value.size()), stream);
+\tstream->WriteBytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+std::string ReadCompactString(flutter::ByteStreamReader* stream) {
+\tstd::string value(static_cast<size_t>(ReadCompactVarint(stream)), '\\0');
+\tstream->ReadBytes(reinterpret_cast<uint8_t*>(value.data()), value.size());
+\treturn value;
+}''');
+    }
+    if (hasLists) {
+      indent.newln();
+      indent.format('''
+// Writes the length of [value], followed by its elements aligned to their
+// size.
+template <typename T>
+void WriteCompactList(const std::vector<T>& value, flutter::ByteStreamWriter* stream) {
+\tWriteCompactVarint(static_cast<int64_t>(value.size()), stream);
+\tstream->WriteAlignment(sizeof(T));
+\tstream->WriteBytes(reinterpret_cast<const uint8_t*>(value.data()), value.size() * sizeof(T));
+}
+
+template <typename T>
+std::vector<T> ReadCompactList(flutter::ByteStreamReader* stream) {
+\tstd::vector<T> value(static_cast<size_t>(ReadCompactVarint(stream)));
+\tstream->ReadAlignment(sizeof(T));
+\tstream->ReadBytes(reinterpret_cast<uint8_t*>(value.data()), value.size() * sizeof(T));
+\treturn value;
+}''');
+    }
+    indent.newln();
+    indent.writeln('}  // namespace');
+  }
+
+  // Writes the instrumentation state and hooks. The handler end hook is only
+  // called by host API handlers, so it is left out when there are none.
+  void _writeInstrumentation(Indent indent, {required bool hasHostApis}) {
+    const notifyHandlerEnd = '''
+
+void NotifyHandlerEnd(const std::string& channel_name, int64_t handler_start) {
+#ifdef GOLUBETS_ENABLE_TRACE
+\tRecordTraceSpan("handler", channel_name, handler_start);
+#endif  // GOLUBETS_ENABLE_TRACE
+}''';
+    indent.format('''
+namespace {
+
+GolubetsInstrumentation* golubets_instrumentation = nullptr;
+
+#ifdef GOLUBETS_ENABLE_TRACE
+// A completed span of a call on a channel. The fields are atomics so that
+// DumpTrace can copy a slot while its thread overwrites it.
+struct TraceEvent {
+\t// Twice the index of the span in its buffer, plus one while the span is
+\t// written and plus two once it is complete.
+\tstd::atomic<uint64_t> sequence{0};
+\tstd::atomic<const char*> name{nullptr};
+\tstd::array<std::atomic<char>, 128> channel_name;
+\tstd::atomic<int64_t> start_us{0};
+\tstd::atomic<int64_t> duration_us{0};
+};
+
+// Ring buffer of the most recent spans recorded by one thread. Only the
+// owning thread writes to it, and it never waits for readers: each slot is
+// published through its sequence as in a seqlock, so DumpTrace skips slots it
+// read while they were written.
+struct TraceBuffer {
+\tstatic constexpr size_t kCapacity = 4096;
+
+\texplicit TraceBuffer(size_t thread_index) : thread_index(thread_index) {}
+
+\tsize_t thread_index;
+\tstd::atomic<uint64_t> count{0};
+\tstd::array<TraceEvent, kCapacity> events;
+};
+
+std::mutex trace_buffers_mutex;
+std::vector<std::shared_ptr<TraceBuffer>> trace_buffers;
+
+// Start of the current span on this thread.
+thread_local int64_t trace_span_start = 0;
+
+int64_t TraceNow() {
+\treturn std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceBuffer& CurrentTraceBuffer() {
+\tthread_local std::shared_ptr<TraceBuffer> buffer = [] {
+\t\tstd::lock_guard<std::mutex> lock(trace_buffers_mutex);
+\t\tauto new_buffer = std::make_shared<TraceBuffer>(trace_buffers.size());
+\t\ttrace_buffers.push_back(new_buffer);
+\t\treturn new_buffer;
+\t}();
+\treturn *buffer;
+}
+
+// Records the span `name` from `start_us` until now, and starts the next span
+// of this thread.
+void RecordTraceSpan(const char* name, const std::string& channel_name, int64_t start_us) {
+\tconst int64_t now = TraceNow();
+\tTraceBuffer& buffer = CurrentTraceBuffer();
+\tconst uint64_t index = buffer.count.load(std::memory_order_relaxed);
+\tTraceEvent& event = buffer.events[index % TraceBuffer::kCapacity];
+\tevent.sequence.store(2 * index + 1, std::memory_order_relaxed);
+\tstd::atomic_thread_fence(std::memory_order_release);
+\tevent.name.store(name, std::memory_order_relaxed);
+\tconst size_t length = std::min(channel_name.size(), event.channel_name.size() - 1);
+\tfor (size_t i = 0; i < length; i++) {
+\t\tevent.channel_name[i].store(channel_name[i], std::memory_order_relaxed);
+\t}
+\tevent.channel_name[length].store('\\0', std::memory_order_relaxed);
+\tevent.start_us.store(start_us, std::memory_order_relaxed);
+\tevent.duration_us.store(now - start_us, std::memory_order_relaxed);
+\tevent.sequence.store(2 * index + 2, std::memory_order_release);
+\tbuffer.count.store(index + 1, std::memory_order_release);
+\ttrace_span_start = now;
+}
+#endif  // GOLUBETS_ENABLE_TRACE
+
+void NotifyDecodeStart(const std::string& channel_name, size_t message_size) {
+#ifdef GOLUBETS_ENABLE_TRACE
+\ttrace_span_start = TraceNow();
+#endif  // GOLUBETS_ENABLE_TRACE
+\tif (golubets_instrumentation != nullptr) {
+\t\tgolubets_instrumentation->OnDecodeStart(channel_name, message_size);
+\t}
+}
+
+// Returns the start of the handler span, to be passed to NotifyHandlerEnd.
+int64_t NotifyHandlerStart(const std::string& channel_name) {
+\tint64_t handler_start = 0;
+#ifdef GOLUBETS_ENABLE_TRACE
+\thandler_start = TraceNow();
+\tRecordTraceSpan("decode", channel_name, trace_span_start);
+#endif  // GOLUBETS_ENABLE_TRACE
+\tif (golubets_instrumentation != nullptr) {
+\t\tgolubets_instrumentation->OnHandlerStart(channel_name);
+\t}
+\treturn handler_start;
+}${hasHostApis ? notifyHandlerEnd : ''}
+
+void NotifyReply(const std::string& channel_name, size_t reply_size) {
+#ifdef GOLUBETS_ENABLE_TRACE
+\tRecordTraceSpan("encode", channel_name, trace_span_start);
+#endif  // GOLUBETS_ENABLE_TRACE
+\tif (golubets_instrumentation != nullptr) {
+\t\tgolubets_instrumentation->OnReply(channel_name, reply_size);
+\t}
+}
+
+void NotifyReplySent(const std::string& channel_name) {
+#ifdef GOLUBETS_ENABLE_TRACE
+\tRecordTraceSpan("reply", channel_name, trace_span_start);
+#endif  // GOLUBETS_ENABLE_TRACE
+}
+
+void NotifyError(const std::string& channel_name, const FlutterError& error) {
+\tif (golubets_instrumentation != nullptr) {
+\t\tgolubets_instrumentation->OnError(channel_name, error);
+\t}
+}
+
+// A BinaryMessenger that reports the size of the messages and replies of the
+// handlers set through it to the current GolubetsInstrumentation.
+class InstrumentedBinaryMessenger : public flutter::BinaryMessenger {
+ public:
+\texplicit InstrumentedBinaryMessenger(flutter::BinaryMessenger* messenger)
+\t\t: messenger_(messenger) {}
+
+\tvoid Send(const std::string& channel, const uint8_t* message, size_t message_size, flutter::BinaryReply reply = nullptr) const override {
+\t\tmessenger_->Send(channel, message, message_size, std::move(reply));
+\t}
+
+\tvoid SetMessageHandler(const std::string& channel, flutter::BinaryMessageHandler handler) override {
+\t\tif (!handler) {
+\t\t\tmessenger_->SetMessageHandler(channel, nullptr);
+\t\t\treturn;
+\t\t}
+\t\tmessenger_->SetMessageHandler(channel, [channel, handler = std::move(handler)](const uint8_t* message, size_t message_size, flutter::BinaryReply reply) {
+#ifndef GOLUBETS_ENABLE_TRACE
+\t\t\tif (golubets_instrumentation == nullptr) {
+\t\t\t\thandler(message, message_size, std::move(reply));
+\t\t\t\treturn;
+\t\t\t}
+#endif  // GOLUBETS_ENABLE_TRACE
+\t\t\tNotifyDecodeStart(channel, message_size);
+\t\t\thandler(message, message_size, [channel, reply = std::move(reply)](const uint8_t* reply_message, size_t reply_size) {
+\t\t\t\tNotifyReply(channel, reply_size);
+\t\t\t\treply(reply_message, reply_size);
+\t\t\t\tNotifyReplySent(channel);
+\t\t\t});
+\t\t});
+\t}
+
+ private:
+\tflutter::BinaryMessenger* messenger_;
+};
+
+}  // namespace
+
+void SetGolubetsInstrumentation(GolubetsInstrumentation* instrumentation) {
+\tgolubets_instrumentation = instrumentation;
+}
+
+#ifdef GOLUBETS_ENABLE_TRACE
+bool DumpTrace(const std::string& path) {
+\tstd::ofstream out(path);
+\tif (!out) {
+\t\treturn false;
+\t}
+\tout << "{\\\"traceEvents\\\":[";
+\tbool first = true;
+\tstd::lock_guard<std::mutex> lock(trace_buffers_mutex);
+\tfor (const auto& buffer : trace_buffers) {
+\t\tconst uint64_t count = buffer->count.load(std::memory_order_acquire);
+\t\tconst uint64_t begin = count > TraceBuffer::kCapacity ? count - TraceBuffer::kCapacity : 0;
+\t\tfor (uint64_t i = begin; i < count; i++) {
+\t\t\tconst TraceEvent& event = buffer->events[i % TraceBuffer::kCapacity];
+\t\t\t// Skips the slot if its thread is writing it or has reused it for a
+\t\t\t// later span, either before or while it is copied.
+\t\t\tconst uint64_t sequence = event.sequence.load(std::memory_order_acquire);
+\t\t\tif (sequence != 2 * i + 2) {
+\t\t\t\tcontinue;
+\t\t\t}
+\t\t\tconst char* name = event.name.load(std::memory_order_relaxed);
+\t\t\tstd::array<char, 128> channel_name{};
+\t\t\tfor (size_t j = 0; j + 1 < channel_name.size(); j++) {
+\t\t\t\tchannel_name[j] = event.channel_name[j].load(std::memory_order_relaxed);
+\t\t\t\tif (channel_name[j] == '\\0') {
+\t\t\t\t\tbreak;
+\t\t\t\t}
+\t\t\t}
+\t\t\tconst int64_t start_us = event.start_us.load(std::memory_order_relaxed);
+\t\t\tconst int64_t duration_us = event.duration_us.load(std::memory_order_relaxed);
+\t\t\tstd::atomic_thread_fence(std::memory_order_acquire);
+\t\t\tif (event.sequence.load(std::memory_order_relaxed) != sequence) {
+\t\t\t\tcontinue;
+\t\t\t}
+\t\t\tout << (first ? "" : ",") << "{\\\"name\\\":\\\"" << name << "\\\",\\\"cat\\\":\\\"golubets\\\",\\\"ph\\\":\\\"X\\\",\\\"ts\\\":" << start_us << ",\\\"dur\\\":" << duration_us << ",\\\"pid\\\":0,\\\"tid\\\":" << buffer->thread_index << ",\\\"args\\\":{\\\"channel\\\":\\\"" << channel_name.data() << "\\\"}}";
+\t\t\tfirst = false;
+\t\t}
+\t}
+\tout << "]}";
+\treturn out.good();
+}
+#endif  // GOLUBETS_ENABLE_TRACE''');
+  }
+
+  @override
+  void writeDataClass(
+    InternalCppOptions generatorOptions,
+    Root root,
+    Indent indent,
+    Class classDefinition, {
+    required String dartPackageName,
+  }) {
+    indent.writeln('$_commentPrefix ${classDefinition.name}');
+    indent.newln();
+
+    final Iterable<NamedType> orderedFields = getFieldsInSerializationOrder(
+      classDefinition,
+    );
+    final Iterable<NamedType> requiredFields = orderedFields.where(
+      (NamedType type) => !type.type.isNullable,
+    );
+    // Minimal constructor, if needed.
+    if (requiredFields.length != orderedFields.length) {
+      _writeClassConstructor(root, indent, classDefinition, requiredFields);
+    }
+    // All-field constructor.
+    _writeClassConstructor(root, indent, classDefinition, orderedFields);
+
+    // Custom copy/assign to handle pointer fields, if necessary.
+    if (orderedFields.any(
+      (NamedType field) => _isPointerField(
+        _cppFieldHostDatatype(field, _baseCppTypeForBuiltinDartType),
+      ),
+    )) {
+      _writeCopyConstructor(root, indent, classDefinition, orderedFields);
+      _writeAssignmentOperator(root, indent, classDefinition, orderedFields);
+    }
+
+    // Getters and setters.
+    for (final field in orderedFields) {
+      _writeCppSourceClassField(
+        generatorOptions,
+        root,
+        indent,
+        classDefinition,
+        field,
+      );
+    }
+
+    // Serialization.
+    writeClassEncode(
+      generatorOptions,
+      root,
+      indent,
+      classDefinition,
+      dartPackageName: dartPackageName,
+    );
+
+    // Deserialization.
+    writeClassDecode(
+      generatorOptions,
+      root,
+      indent,
+      classDefinition,
+      dartPackageName: dartPackageName,
+    );
+
+    if (classDefinition.isCompact) {
+      _writeCompactEncode(indent, classDefinition);
+      _writeCompactDecode(indent, classDefinition);
+      if (generatorOptions.encodedSizes) {
+        _writeCompactEncodedEnd(indent, classDefinition);
+      }
+    }
+
+    if (classDefinition.isPacked) {
+      _writePackedRecord(indent, classDefinition);
+    }
+
+    if (classDefinition.columnsOf != null) {
+      _writeColumnsRows(indent, classDefinition);
+    }
+
+    if (generatorOptions.encodedSizes) {
+      _writeEncodedSize(root, indent, classDefinition);
+    }
+
+    if (classDefinition.ringBufferCapacity != null) {
+      _writeRingBuffer(
+        indent,
+        classDefinition,
+        dartPackageName: dartPackageName,
+      );
+    }
+  }
+
+  // Writes the functions that read and append the rows of the columns class
+  // [classDefinition].
+  void _writeColumnsRows(Indent indent, Class classDefinition) {
+    final String name = classDefinition.name;
+    final String rowName = classDefinition.columnsOf!.name;
+    final List<NamedType> fields = classDefinition.fields;
+    bool isBool(NamedType field) => field.type.baseName == 'Uint8List';
+    _writeFunctionDefinition(
+      indent,
+      'RowCount',
+      scope: name,
+      returnType: 'size_t',
+      isConst: true,
+      body: () {
+        final Iterable<String> sizes = fields.map(
+          (NamedType field) => '${_makeInstanceVariableName(field)}.size()',
+        );
+        indent.writeln(
+          sizes.length == 1
+              ? 'return ${sizes.single};'
+              : 'return std::min({${sizes.join(', ')}});',
+        );
+      },
+    );
+    _writeFunctionDefinition(
+      indent,
+      'Row',
+      scope: name,
+      returnType: rowName,
+      parameters: <String>['size_t index'],
+      isConst: true,
+      body: () {
+        final String arguments = fields
+            .map((NamedType field) {
+              final value = '${_makeInstanceVariableName(field)}[index]';
+              return isBool(field) ? '$value != 0' : value;
+            })
+            .join(', ');
+        indent.writeln('return $rowName($arguments);');
+      },
+    );
+    _writeFunctionDefinition(
+      indent,
+      'AddRow',
+      scope: name,
+      returnType: _voidType,
+      parameters: <String>['const $rowName& row'],
+      body: () {
+        for (final field in fields) {
+          final value = 'row.${_makeGetterName(field)}()';
+          indent.writeln(
+            '${_makeInstanceVariableName(field)}.push_back(${isBool(field) ? '$value ? 1 : 0' : value});',
+          );
+        }
+      },
+    );
+  }
+
+  // Writes the struct [classDefinition] is packed as, and the functions that
+  // copy it to and from the stream.
+  void _writePackedRecord(Indent indent, Class classDefinition) {
+    final String name = classDefinition.name;
+    final ({List<int> offsets, int size}) layout = getPackedLayout(
+      classDefinition,
+    );
+    final String recordFields = classDefinition.fields
+        .map((NamedType field) {
+          final HostDatatype hostDatatype = _cppFieldHostDatatype(
+            field,
+            _baseCppTypeForBuiltinDartType,
+          );
+          return '\t${hostDatatype.datatype} ${_makeVariableName(field)};';
+        })
+        .join('\n');
+    final String offsetAsserts = classDefinition.fields.indexed
+        .map(
+          ((int, NamedType) field) =>
+              'static_assert(offsetof(${name}Packed, ${_makeVariableName(field.$2)}) == ${layout.offsets[field.$1]}, "${name}Packed must match the Dart layout.");',
+        )
+        .join('\n');
+    final String recordAssignments = classDefinition.fields
+        .map(
+          (NamedType field) =>
+              '\trecord.${_makeVariableName(field)} = ${_makeInstanceVariableName(field)};',
+        )
+        .join('\n');
+    final String constructorArguments = classDefinition.fields
+        .map((NamedType field) => 'record.${_makeVariableName(field)}')
+        .join(', ');
+    indent.newln();
+    indent.format('''
+namespace {
+
+// The layout `$name` is packed as, which the Dart codec mirrors.
+struct ${name}Packed {
+$recordFields
+};
+static_assert(std::is_standard_layout_v<${name}Packed>, "${name}Packed must have a fixed layout.");
+$offsetAsserts
+static_assert(sizeof(${name}Packed) == ${layout.size}, "${name}Packed must match the Dart layout.");
+
+}  // namespace
+
+$name $name::ReadPacked(flutter::ByteStreamReader* stream) {
+\t${name}Packed record;
+\tstream->ReadBytes(reinterpret_cast<uint8_t*>(&record), sizeof(record));
+\treturn $name($constructorArguments);
+}
+
+void $name::WritePacked(flutter::ByteStreamWriter* stream) const {
+\t${name}Packed record = {};
+$recordAssignments
+\tstream->WriteBytes(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+}
+''');
+  }
+
+  // Writes the shared state and Push function of the ring buffer of
+  // [classDefinition], and the C functions the Dart reader calls.
+  void _writeRingBuffer(
+    Indent indent,
+    Class classDefinition, {
+    required String dartPackageName,
+  }) {
+    final String name = classDefinition.name;
+    final stateName = '${_snakeCaseFromCamelCase(name)}_ring_state';
+    String symbol(String function) =>
+        makeRingBufferSymbolName(classDefinition, function, dartPackageName);
+    final String recordFields = classDefinition.fields
+        .map((NamedType field) {
+          final HostDatatype hostDatatype = _cppFieldHostDatatype(
+            field,
+            _baseCppTypeForBuiltinDartType,
+          );
+          return '\t${hostDatatype.datatype} ${_makeVariableName(field)};';
+        })
+        .join('\n');
+    final String recordAssignments = classDefinition.fields
+        .map(
+          (NamedType field) =>
+              '\trecord.${_makeVariableName(field)} = value.${_makeGetterName(field)}();',
+        )
+        .join('\n');
+    indent.newln();
+    indent.format('''
+namespace {
+
+// The layout of a `$name` record in the ring, which the Dart reader mirrors.
+struct ${name}RingRecord {
+$recordFields
+};
+
+// The positions count records since the start, and are kept on separate cache
+// lines so the producer and consumer don't contend.
+struct ${name}RingState {
+\talignas(64) std::atomic<uint64_t> head{0};
+\talignas(64) std::atomic<uint64_t> tail{0};
+\tstd::atomic<bool> consumer_idle{false};
+\tstd::atomic<void (*)()> wakeup{nullptr};
+\t${name}RingRecord records[${name}RingBuffer::kCapacity];
+};
+
+${name}RingState $stateName;
+
+}  // namespace
+
+bool ${name}RingBuffer::Push(const $name& value) {
+\t${name}RingState& ring = $stateName;
+\tconst uint64_t head = ring.head.load(std::memory_order_relaxed);
+\tif (head - ring.tail.load(std::memory_order_acquire) == kCapacity) {
+\t\treturn false;
+\t}
+\t${name}RingRecord& record = ring.records[head & (kCapacity - 1)];
+$recordAssignments
+\t// Publishing the record must not be reordered with checking whether the
+\t// consumer is idle, or a wakeup could be lost.
+\tring.head.store(head + 1, std::memory_order_seq_cst);
+\tif (ring.consumer_idle.load(std::memory_order_seq_cst) && ring.consumer_idle.exchange(false)) {
+\t\tvoid (*wakeup)() = ring.wakeup.load(std::memory_order_acquire);
+\t\tif (wakeup != nullptr) {
+\t\t\twakeup();
+\t\t}
+\t}
+\treturn true;
+}
+
+extern "C" GOLUBETS_FFI_EXPORT void* ${symbol('records')}() {
+\treturn $stateName.records;
+}
+
+extern "C" GOLUBETS_FFI_EXPORT uint64_t ${symbol('tail')}() {
+\treturn $stateName.tail.load(std::memory_order_relaxed);
+}
+
+extern "C" GOLUBETS_FFI_EXPORT uint64_t ${symbol('acquire')}() {
+\t${name}RingState& ring = $stateName;
+\tconst uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+\tuint64_t head = ring.head.load(std::memory_order_acquire);
+\tif (head == tail) {
+\t\t// Ask for a wakeup, then check for records pushed in the meantime.
+\t\tring.consumer_idle.store(true, std::memory_order_seq_cst);
+\t\thead = ring.head.load(std::memory_order_seq_cst);
+\t\tif (head != tail) {
+\t\t\tring.consumer_idle.store(false, std::memory_order_relaxed);
+\t\t}
+\t}
+\treturn head;
+}
+
+extern "C" GOLUBETS_FFI_EXPORT void ${symbol('release')}(uint64_t tail) {
+\t$stateName.tail.store(tail, std::memory_order_release);
+}
+
+extern "C" GOLUBETS_FFI_EXPORT void ${symbol('set_wakeup')}(void (*wakeup)()) {
+\t$stateName.wakeup.store(wakeup, std::memory_order_release);
+}
+''');
+  }
+
+  // Writes WriteCompact, which writes the fields of [classDefinition] in the
+  // compact wire format.
+  void _writeCompactEncode(Indent indent, Class classDefinition) {
+    final List<NamedType> fields = getFieldsInSerializationOrder(
+      classDefinition,
+    ).toList();
+    final List<NamedType> nullableFields = fields
+        .where((NamedType field) => field.type.isNullable)
+        .toList();
+    _writeFunctionDefinition(
+      indent,
+      'WriteCompact',
+      scope: classDefinition.name,
+      returnType: _voidType,
+      parameters: <String>['flutter::ByteStreamWriter* stream'],
+      isConst: true,
+      body: () {
+        for (var i = 0; i < nullableFields.length; i += 8) {
+          final String presentBits = nullableFields
+              .skip(i)
+              .take(8)
+              .indexed
+              .map(
+                ((int, NamedType) bit) =>
+                    '(${_makeInstanceVariableName(bit.$2)} ? ${1 << bit.$1} : 0)',
+              )
+              .join(' | ');
+          indent.writeln('stream->WriteByte($presentBits);');
+        }
+        for (final field in fields) {
+          final String member = _makeInstanceVariableName(field);
+          if (field.type.isNullable) {
+            indent.writeScoped('if ($member) {', '}', () {
+              _writeCompactFieldEncode(indent, field.type, member);
+            });
+          } else {
+            _writeCompactFieldEncode(indent, field.type, member);
+          }
+        }
+      },
+    );
+  }
+
+  void _writeCompactFieldEncode(
+    Indent indent,
+    TypeDeclaration type,
+    String member,
+  ) {
+    // Class fields are always pointers, and nullable fields are optionals.
+    final value = type.isNullable ? '*$member' : member;
+    if (type.isClass) {
+      indent.writeln('$member->WriteCompact(stream);');
+    } else if (type.isEnum) {
+      indent.writeln(
+        'WriteCompactVarint(static_cast<int64_t>($value), stream);',
+      );
+    } else if (type.baseName == 'bool') {
+      indent.writeln('stream->WriteByte($value ? 1 : 0);');
+    } else if (type.baseName == 'int') {
+      indent.writeln('WriteCompactVarint($value, stream);');
+    } else if (type.baseName == 'double') {
+      indent.writeln('stream->WriteAlignment(8);');
+      indent.writeln('stream->WriteDouble($value);');
+    } else if (type.baseName == 'String') {
+      indent.writeln('WriteCompactString($value, stream);');
+    } else {
+      indent.writeln('WriteCompactList($value, stream);');
+    }
+  }
+
+  // Writes CompactEncodedEnd, which mirrors WriteCompact field by field to
+  // find where the compact encoding of [classDefinition] ends.
+  void _writeCompactEncodedEnd(Indent indent, Class classDefinition) {
+    final List<NamedType> fields = getFieldsInSerializationOrder(
+      classDefinition,
+    ).toList();
+    final int presentLength =
+        (fields.where((NamedType field) => field.type.isNullable).length + 7) ~/
+        8;
+    _writeFunctionDefinition(
+      indent,
+      'CompactEncodedEnd',
+      scope: classDefinition.name,
+      returnType: 'size_t',
+      parameters: <String>['size_t offset'],
+      isConst: true,
+      body: () {
+        if (presentLength > 0) {
+          indent.writeln('// The presence bits of the nullable fields.');
+          indent.writeln('size_t end = offset + $presentLength;');
+        } else {
+          indent.writeln('size_t end = offset;');
+        }
+        for (final field in fields) {
+          final String member = _makeInstanceVariableName(field);
+          final String statement = _compactEncodedEndStatement(
+            field.type,
+            member,
+          );
+          if (field.type.isNullable) {
+            indent.writeScoped('if ($member) {', '}', () {
+              indent.writeln(statement);
+            });
+          } else {
+            indent.writeln(statement);
+          }
+        }
+        indent.writeln('return end;');
+      },
+    );
+  }
+
+  // Returns the statement that advances `end` past the compact encoding of
+  // the field [member] of [type].
+  String _compactEncodedEndStatement(TypeDeclaration type, String member) {
+    // Class fields are always pointers, and nullable fields are optionals.
+    final value = type.isNullable ? '*$member' : member;
+    final access = type.isNullable ? '$member->' : '$member.';
+    if (type.isClass) {
+      return 'end = $member->CompactEncodedEnd(end);';
+    } else if (type.isEnum) {
+      return 'end += CompactVarintSize(static_cast<int64_t>($value));';
+    } else if (type.baseName == 'bool') {
+      return 'end += 1;';
+    } else if (type.baseName == 'int') {
+      return 'end += CompactVarintSize($value);';
+    } else if (type.baseName == 'double') {
+      return 'end = AlignEncodedEnd(end, 8) + 8;';
+    }
+    final String length =
+        'CompactVarintSize(static_cast<int64_t>(${access}size()))';
+    if (type.baseName == 'String') {
+      return 'end += $length + ${access}size();';
+    }
+    final String elementType = _compactListElementType(type);
+    return 'end = AlignEncodedEnd(end + $length, sizeof($elementType)) + ${access}size() * sizeof($elementType);';
+  }
+
+  // Writes ReadCompact, which reads [classDefinition] from the compact wire
+  // format.
+  void _writeCompactDecode(Indent indent, Class classDefinition) {
+    final List<NamedType> fields = getFieldsInSerializationOrder(
+      classDefinition,
+    ).toList();
+    final List<NamedType> nullableFields = fields
+        .where((NamedType field) => field.type.isNullable)
+        .toList();
+    _writeFunctionDefinition(
+      indent,
+      'ReadCompact',
+      scope: classDefinition.name,
+      returnType: classDefinition.name,
+      parameters: <String>['flutter::ByteStreamReader* stream'],
+      body: () {
+        for (var i = 0; i < (nullableFields.length + 7) ~/ 8; i++) {
+          indent.writeln('const uint8_t present$i = stream->ReadByte();');
+        }
+        for (final field in fields) {
+          final decodedName = 'decoded_${_makeVariableName(field)}';
+          if (!field.type.isNullable) {
+            if (field.type.baseName == 'double') {
+              indent.writeln('stream->ReadAlignment(8);');
+            }
+            indent.writeln(
+              'const auto $decodedName = ${_compactFieldDecode(field.type)};',
+            );
+            continue;
+          }
+          final HostDatatype hostDatatype = _cppFieldHostDatatype(
+            field,
+            _baseCppTypeForBuiltinDartType,
+          );
+          final int index = nullableFields.indexOf(field);
+          indent.writeln('${_fieldType(hostDatatype)} $decodedName;');
+          indent.writeScoped(
+            'if ((present${index ~/ 8} & ${1 << (index % 8)}) != 0) {',
+            '}',
+            () {
+              final String value = _compactFieldDecode(field.type);
+              if (field.type.isClass) {
+                indent.writeln(
+                  '$decodedName = std::make_unique<${hostDatatype.datatype}>($value);',
+                );
+              } else {
+                if (field.type.baseName == 'double') {
+                  indent.writeln('stream->ReadAlignment(8);');
+                }
+                indent.writeln('$decodedName = $value;');
+              }
+            },
+          );
+        }
+
+        const instanceVariable = 'decoded';
+        String constructorArgs = fields
+            .where((NamedType field) => !field.type.isNullable)
+            .map((NamedType field) => 'decoded_${_makeVariableName(field)}')
+            .join(',\n\t');
+        if (constructorArgs.isNotEmpty) {
+          constructorArgs = '(\n\t$constructorArgs)';
+        }
+        indent.format(
+          '${classDefinition.name} $instanceVariable$constructorArgs;',
+        );
+        for (final field in nullableFields) {
+          indent.writeln(
+            '$instanceVariable.${_makeInstanceVariableName(field)} = std::move(decoded_${_makeVariableName(field)});',
+          );
+        }
+        indent.writeln('return $instanceVariable;');
+      },
+    );
+  }
+
+  String _compactFieldDecode(TypeDeclaration type) {
+    if (type.isClass) {
+      return '${type.baseName}::ReadCompact(stream)';
+    } else if (type.isEnum) {
+      return 'static_cast<${type.baseName}>(ReadCompactVarint(stream))';
+    } else if (type.baseName == 'bool') {
+      return 'stream->ReadByte() != 0';
+    } else if (type.baseName == 'int') {
+      return 'ReadCompactVarint(stream)';
+    } else if (type.baseName == 'double') {
+      return 'stream->ReadDouble()';
+    } else if (type.baseName == 'String') {
+      return 'ReadCompactString(stream)';
+    } else {
+      return 'ReadCompactList<${_compactListElementType(type)}>(stream)';
+    }
+  }
+
+  // Returns the element type of the typed list [type].
+  String _compactListElementType(TypeDeclaration type) {
+    final String listType = _baseCppTypeForBuiltinDartType(type)!;
+    return listType.substring('std::vector<'.length, listType.length - 1);
+  }
+
+  @override
+  void writeClassEncode(
+    InternalCppOptions generatorOptions,
+    Root root,
+    Indent indent,
+    Class classDefinition, {
+    required String dartPackageName,
+  }) {
+    _writeFunctionDefinition(
+      indent,
+      'ToEncodableList',
+      scope: classDefinition.name,
+      returnType: 'EncodableList',
+      isConst: true,
+      body: () {
+        indent.writeln('EncodableList list;');
+        indent.writeln('list.reserve(${classDefinition.fields.length});');
+        for (final NamedType field in getFieldsInSerializationOrder(
+          classDefinition,
+        )) {
+          final HostDatatype hostDatatype = _cppFieldHostDatatype(
+            field,
+            _shortBaseCppTypeForBuiltinDartType,
+          );
+          final String encodableValue = _wrappedHostApiArgumentExpression(
+            root,
+            _makeInstanceVariableName(field),
+            field.type,
+            hostDatatype,
+            true,
+          );
+          indent.writeln('list.push_back($encodableValue);');
+        }
+        indent.writeln('return list;');
+      },
+    );
+  }
+
+  @override
+  void writeClassDecode(
+    InternalCppOptions generatorOptions,
+    Root root,
+    Indent indent,
+    Class classDefinition, {
+    required String dartPackageName,
+  }) {
+    _writeFunctionDefinition(
       indent,
       'FromEncodableList',
       scope: classDefinition.name,
@@ -1141,7 +2987,7 @@ class CppSourceGenerator extends StructuredGenerator<InternalCppOptions> {
         String constructorArgs = nonNullableFields
             .map(
               (_IndexedField param) =>
-                  getValueExpression(param.field, 'list[${param.index}]'),
+                  _fieldValueFromEncodable(param.field, 'list[${param.index}]'),
             )
             .join(',\n\t');
         if (constructorArgs.isNotEmpty) {
@@ -1151,31 +2997,245 @@ class CppSourceGenerator extends StructuredGenerator<InternalCppOptions> {
           '${classDefinition.name} $instanceVariable$constructorArgs;',
         );
 
-        // Add the nullable fields via setters, since converting the encodable
-        // values to the pointer types that the convenience constructor uses for
-        // nullable fields is non-trivial.
-        for (final entry in nullableFields) {
-          final NamedType field = entry.field;
-          final String setterName = _makeSetterName(field);
-          final encodableFieldName =
-              '${_encodablePrefix}_${_makeVariableName(field)}';
-          indent.writeln('auto& $encodableFieldName = list[${entry.index}];');
+        // Add the nullable fields via setters, since converting the encodable
+        // values to the pointer types that the convenience constructor uses for
+        // nullable fields is non-trivial.
+        for (final entry in nullableFields) {
+          final NamedType field = entry.field;
+          final String setterName = _makeSetterName(field);
+          final encodableFieldName =
+              '${_encodablePrefix}_${_makeVariableName(field)}';
+          indent.writeln('auto& $encodableFieldName = list[${entry.index}];');
+
+          final String valueExpression = _fieldValueFromEncodable(
+            field,
+            encodableFieldName,
+          );
+          indent.writeScoped('if (!$encodableFieldName.IsNull()) {', '}', () {
+            indent.writeln('$instanceVariable.$setterName($valueExpression);');
+          });
+        }
+
+        // This returns by value, relying on copy elision, since it makes the
+        // usage more convenient during deserialization than it would be with
+        // explicit transfer via unique_ptr.
+        indent.writeln('return $instanceVariable;');
+      },
+    );
+  }
+
+  // Returns the expression to convert the given EncodableValue to a field
+  // value.
+  String _fieldValueFromEncodable(NamedType field, String encodable) {
+    if (field.type.baseName == 'Object') {
+      return encodable;
+    } else {
+      final HostDatatype hostDatatype = _cppFieldHostDatatype(
+        field,
+        _shortBaseCppTypeForBuiltinDartType,
+      );
+      if (!hostDatatype.isBuiltin) {
+        return _classReferenceFromEncodableValue(hostDatatype, encodable);
+      } else {
+        return 'std::get<${hostDatatype.datatype}>($encodable)';
+      }
+    }
+  }
+
+  // Returns the enumerated type of [type] if it is an enum that the codec
+  // serializer can write without wrapping it in a CustomEncodableValue.
+  EnumeratedType? _unboxedEnumType(
+    List<EnumeratedType> enumeratedTypes,
+    TypeDeclaration type,
+  ) {
+    if (!type.isEnum) {
+      return null;
+    }
+    final EnumeratedType enumType = enumeratedTypes.firstWhere(
+      (EnumeratedType t) => t.associatedEnum == type.associatedEnum,
+    );
+    // Overflow enums are written through the wrapper class.
+    return enumType.enumeration < maximumCodecFieldKey ? enumType : null;
+  }
+
+  // Returns true if the codec serializer writes and reads [customType] itself
+  // so that its enum fields are not wrapped.
+  bool _hasUnboxedEnumFields(
+    InternalCppOptions generatorOptions,
+    List<EnumeratedType> enumeratedTypes,
+    EnumeratedType customType,
+  ) {
+    return generatorOptions.unboxedEnums &&
+        customType.type == CustomTypes.customClass &&
+        customType.enumeration < maximumCodecFieldKey &&
+        customType.associatedClass!.fields.any(
+          (NamedType field) =>
+              _unboxedEnumType(enumeratedTypes, field.type) != null,
+        );
+  }
+
+  // Writes the serializer code that writes the `custom_value` holding
+  // [classDefinition] as a list of its fields, with enum fields written as the
+  // enum type byte followed by the index.
+  void _writeUnboxedClassEncode(
+    Root root,
+    Indent indent,
+    List<EnumeratedType> enumeratedTypes,
+    Class classDefinition,
+  ) {
+    final Iterable<NamedType> fields = getFieldsInSerializationOrder(
+      classDefinition,
+    );
+    indent.writeln(
+      'const auto& object = std::any_cast<const ${classDefinition.name}&>(*custom_value);',
+    );
+    indent.writeln('stream->WriteByte($_standardListTypeId);');
+    indent.writeln('WriteSize(${fields.length}, stream);');
+    for (final field in fields) {
+      final member = 'object.${_makeInstanceVariableName(field)}';
+      final EnumeratedType? enumType = _unboxedEnumType(
+        enumeratedTypes,
+        field.type,
+      );
+      if (enumType == null) {
+        final HostDatatype hostDatatype = _cppFieldHostDatatype(
+          field,
+          _shortBaseCppTypeForBuiltinDartType,
+        );
+        final String encodableValue = _wrappedHostApiArgumentExpression(
+          root,
+          member,
+          field.type,
+          hostDatatype,
+          true,
+        );
+        indent.writeln('WriteValue($encodableValue, stream);');
+      } else if (field.type.isNullable) {
+        indent.writeScoped('if ($member) {', '} ', () {
+          indent.writeln('stream->WriteByte(${enumType.enumeration});');
+          indent.writeln(
+            'WriteValue(EncodableValue(static_cast<int>(*$member)), stream);',
+          );
+        }, addTrailingNewline: false);
+        indent.addScoped('else {', '}', () {
+          indent.writeln('WriteValue(EncodableValue(), stream);');
+        });
+      } else {
+        indent.writeln('stream->WriteByte(${enumType.enumeration});');
+        indent.writeln(
+          'WriteValue(EncodableValue(static_cast<int>($member)), stream);',
+        );
+      }
+    }
+  }
+
+  // Writes the serializer code that reads [classDefinition] from a list of its
+  // fields, reading enum fields directly as integers.
+  void _writeUnboxedClassDecode(
+    Indent indent,
+    List<EnumeratedType> enumeratedTypes,
+    Class classDefinition,
+  ) {
+    final List<NamedType> fields = getFieldsInSerializationOrder(
+      classDefinition,
+    ).toList();
+    indent.addScoped('{', '}', () {
+      indent.writeScoped(
+        'if (stream->ReadByte() != $_standardListTypeId) {',
+        '}',
+        () {
+          indent.writeln('return EncodableValue();');
+        },
+      );
+      indent.writeScoped(
+        'if (ReadSize(stream) != ${fields.length}) {',
+        '}',
+        () {
+          indent.writeln('return EncodableValue();');
+        },
+      );
+      final decodedNames = <NamedType, String>{};
+      for (final field in fields) {
+        final String variableName = _makeVariableName(field);
+        final EnumeratedType? enumType = _unboxedEnumType(
+          enumeratedTypes,
+          field.type,
+        );
+        if (enumType == null) {
+          final encodableName = '${_encodablePrefix}_$variableName';
+          decodedNames[field] = encodableName;
+          indent.writeln(
+            'const EncodableValue $encodableName = ReadValue(stream);',
+          );
+          continue;
+        }
+        final decodedName = 'decoded_$variableName';
+        decodedNames[field] = decodedName;
+        final String enumValue =
+            'static_cast<${enumType.name}>(ReadValue(stream).LongValue())';
+        if (field.type.isNullable) {
+          indent.writeln('std::optional<${enumType.name}> $decodedName;');
+          indent.writeln(
+            'const uint8_t ${decodedName}_type = stream->ReadByte();',
+          );
+          indent.writeScoped(
+            'if (${decodedName}_type == ${enumType.enumeration}) {',
+            '} ',
+            () {
+              indent.writeln('$decodedName = $enumValue;');
+            },
+            addTrailingNewline: false,
+          );
+          indent.addScoped('else if (${decodedName}_type != 0) {', '}', () {
+            indent.writeln('return EncodableValue();');
+          });
+        } else {
+          indent.writeScoped(
+            'if (stream->ReadByte() != ${enumType.enumeration}) {',
+            '}',
+            () {
+              indent.writeln('return EncodableValue();');
+            },
+          );
+          indent.writeln('const auto $decodedName = $enumValue;');
+        }
+      }
+
+      String valueExpression(NamedType field) {
+        return _unboxedEnumType(enumeratedTypes, field.type) == null
+            ? _fieldValueFromEncodable(field, decodedNames[field]!)
+            : decodedNames[field]!;
+      }
 
-          final String valueExpression = getValueExpression(
-            field,
-            encodableFieldName,
+      const instanceVariable = 'decoded';
+      String constructorArgs = fields
+          .where((NamedType field) => !field.type.isNullable)
+          .map(valueExpression)
+          .join(',\n\t');
+      if (constructorArgs.isNotEmpty) {
+        constructorArgs = '(\n\t$constructorArgs)';
+      }
+      indent.format(
+        '${classDefinition.name} $instanceVariable$constructorArgs;',
+      );
+      for (final NamedType field in fields.where(
+        (NamedType field) => field.type.isNullable,
+      )) {
+        final String decodedName = decodedNames[field]!;
+        if (_unboxedEnumType(enumeratedTypes, field.type) != null) {
+          indent.writeln(
+            '$instanceVariable.${_makeInstanceVariableName(field)} = $decodedName;',
           );
-          indent.writeScoped('if (!$encodableFieldName.IsNull()) {', '}', () {
-            indent.writeln('$instanceVariable.$setterName($valueExpression);');
+        } else {
+          indent.writeScoped('if (!$decodedName.IsNull()) {', '}', () {
+            indent.writeln(
+              '$instanceVariable.${_makeSetterName(field)}(${valueExpression(field)});',
+            );
           });
         }
-
-        // This returns by value, relying on copy elision, since it makes the
-        // usage more convenient during deserialization than it would be with
-        // explicit transfer via unique_ptr.
-        indent.writeln('return $instanceVariable;');
-      },
-    );
+      }
+      indent.writeln('return CustomEncodableValue($instanceVariable);');
+    });
   }
 
   void _writeCodecOverflowUtilities(
@@ -1261,6 +3321,25 @@ EncodableValue $_overflowClassName::FromEncodableList(
     });
   }
 
+  // Writes the decoding of a packed record of class [name], or of a
+  // `std::vector` of them when the byte after the type is 1.
+  void _writePackedDecode(Indent indent, String name) {
+    indent.addScoped('{', '}', () {
+      indent.writeScoped('if (stream->ReadByte() == 0) {', '}', () {
+        indent.writeln(
+          'return CustomEncodableValue($name::ReadPacked(stream));',
+        );
+      });
+      indent.writeln('const size_t count = ReadSize(stream);');
+      indent.writeln('std::vector<$name> list;');
+      indent.writeln('list.reserve(count);');
+      indent.writeScoped('for (size_t i = 0; i < count; ++i) {', '}', () {
+        indent.writeln('list.push_back($name::ReadPacked(stream));');
+      });
+      indent.writeln('return CustomEncodableValue(std::move(list));');
+    });
+  }
+
   @override
   void writeGeneralCodec(
     InternalCppOptions generatorOptions,
@@ -1289,86 +3368,508 @@ EncodableValue $_overflowClassName::FromEncodableList(
     );
     _writeFunctionDefinition(
       indent,
-      'ReadValueOfType',
+      'ReadValueOfType',
+      scope: _codecSerializerName,
+      returnType: 'EncodableValue',
+      parameters: <String>['uint8_t type', 'flutter::ByteStreamReader* stream'],
+      isConst: true,
+      body: () {
+        if (generatorOptions.parallelEncodeThreshold != null) {
+          indent.writeScoped(
+            'if (type == $_standardListTypeId && !in_parallel_worker) {',
+            '}',
+            () {
+              indent.writeln('EncodableList list;');
+              indent.writeScoped(
+                'if (ReadListInParallel(stream, &list)) {',
+                '}',
+                () {
+                  indent.writeln('return list;');
+                },
+              );
+            },
+          );
+        }
+        if (enumeratedTypes.isNotEmpty) {
+          indent.writeln('switch (type) {');
+          indent.inc();
+          for (final customType in enumeratedTypes) {
+            if (customType.enumeration < maximumCodecFieldKey) {
+              indent.write('case ${customType.enumeration}: ');
+              indent.nest(1, () {
+                if (customType.associatedClass?.isCompact ?? false) {
+                  indent.addScoped('{', '}', () {
+                    indent.writeln(
+                      'return CustomEncodableValue(${customType.name}::ReadCompact(stream));',
+                    );
+                  });
+                } else if (customType.associatedClass?.isPacked ?? false) {
+                  _writePackedDecode(indent, customType.name);
+                } else if (_hasUnboxedEnumFields(
+                  generatorOptions,
+                  enumeratedTypes,
+                  customType,
+                )) {
+                  _writeUnboxedClassDecode(
+                    indent,
+                    enumeratedTypes,
+                    customType.associatedClass!,
+                  );
+                } else {
+                  _writeCodecDecode(indent, customType, 'ReadValue(stream)');
+                }
+              });
+            }
+          }
+          if (root.requiresOverflowClass) {
+            indent.write('case $maximumCodecFieldKey:');
+            _writeCodecDecode(indent, _enumeratedOverflow, 'ReadValue(stream)');
+          }
+          indent.writeln('default:');
+          indent.inc();
+        }
+        indent.writeln(
+          'return $_standardCodecSerializer::ReadValueOfType(type, stream);',
+        );
+        if (enumeratedTypes.isNotEmpty) {
+          indent.dec();
+          indent.writeln('}');
+          indent.dec();
+        }
+      },
+    );
+    _writeFunctionDefinition(
+      indent,
+      'WriteValue',
+      scope: _codecSerializerName,
+      returnType: _voidType,
+      parameters: <String>[
+        'const EncodableValue& value',
+        'flutter::ByteStreamWriter* stream',
+      ],
+      isConst: true,
+      body: () {
+        if (generatorOptions.parallelEncodeThreshold != null) {
+          indent.writeScoped(
+            'if (const EncodableList* list = std::get_if<EncodableList>(&value)) {',
+            '}',
+            () {
+              indent.writeScoped(
+                'if (list->size() >= kParallelEncodeThreshold && !in_parallel_worker && WriteListInParallel(*list, stream)) {',
+                '}',
+                () {
+                  indent.writeln('return;');
+                },
+              );
+            },
+          );
+        }
+        if (enumeratedTypes.isNotEmpty) {
+          indent.write(
+            'if (const CustomEncodableValue* custom_value = std::get_if<CustomEncodableValue>(&value)) ',
+          );
+          indent.addScoped('{', '}', () {
+            // Lists of a packed class are written as one array of records.
+            for (final customType in enumeratedTypes.where(_isPackedListType)) {
+              indent.writeScoped(
+                'if (custom_value->type() == typeid(std::vector<${customType.name}>)) {',
+                '}',
+                () {
+                  indent.writeln(
+                    'const auto& list = std::any_cast<const std::vector<${customType.name}>&>(*custom_value);',
+                  );
+                  indent.writeln(
+                    'stream->WriteByte(${customType.enumeration});',
+                  );
+                  indent.writeln('stream->WriteByte(1);');
+                  indent.writeln('WriteSize(list.size(), stream);');
+                  indent.writeScoped(
+                    'for (const ${customType.name}& element : list) {',
+                    '}',
+                    () {
+                      indent.writeln('element.WritePacked(stream);');
+                    },
+                  );
+                  indent.writeln('return;');
+                },
+              );
+            }
+            for (final customType in enumeratedTypes) {
+              final encodeString = customType.type == CustomTypes.customClass
+                  ? 'std::any_cast<${customType.name}>(*custom_value).ToEncodableList()'
+                  : 'static_cast<int>(std::any_cast<${customType.name}>(*custom_value))';
+              final valueString = customType.enumeration < maximumCodecFieldKey
+                  ? encodeString
+                  : 'wrap.ToEncodableList()';
+              final int enumeration =
+                  customType.enumeration < maximumCodecFieldKey
+                  ? customType.enumeration
+                  : maximumCodecFieldKey;
+              indent.write(
+                'if (custom_value->type() == typeid(${customType.name})) ',
+              );
+              indent.addScoped('{', '}', () {
+                indent.writeln('stream->WriteByte($enumeration);');
+                if (enumeration == customType.enumeration &&
+                    (customType.associatedClass?.isCompact ?? false)) {
+                  indent.writeln(
+                    'std::any_cast<const ${customType.name}&>(*custom_value).WriteCompact(stream);',
+                  );
+                  indent.writeln('return;');
+                  return;
+                }
+                if (enumeration == customType.enumeration &&
+                    (customType.associatedClass?.isPacked ?? false)) {
+                  indent.writeln('stream->WriteByte(0);');
+                  indent.writeln(
+                    'std::any_cast<const ${customType.name}&>(*custom_value).WritePacked(stream);',
+                  );
+                  indent.writeln('return;');
+                  return;
+                }
+                if (_hasUnboxedEnumFields(
+                  generatorOptions,
+                  enumeratedTypes,
+                  customType,
+                )) {
+                  _writeUnboxedClassEncode(
+                    root,
+                    indent,
+                    enumeratedTypes,
+                    customType.associatedClass!,
+                  );
+                  indent.writeln('return;');
+                  return;
+                }
+                if (enumeration == maximumCodecFieldKey) {
+                  indent.writeln(
+                    'const auto wrap = $_overflowClassName(${customType.enumeration - maximumCodecFieldKey}, $encodeString);',
+                  );
+                }
+                indent.writeln(
+                  'WriteValue(EncodableValue($valueString), stream);',
+                );
+                indent.writeln('return;');
+              });
+            }
+          });
+        }
+        indent.writeln('$_standardCodecSerializer::WriteValue(value, stream);');
+      },
+    );
+    if (generatorOptions.parallelEncodeThreshold != null) {
+      _writeWriteListInParallel(indent);
+      _writeReadListInParallel(indent);
+    }
+    if (generatorOptions.encodedSizes) {
+      _writeSerializerEncodedSizes(indent, enumeratedTypes);
+    }
+    if (_hasUnboxedEnumMethods(generatorOptions, root)) {
+      _writeSerializerUnboxedEnumMethods(indent);
+    }
+  }
+
+  void _writeSerializerUnboxedEnumMethods(Indent indent) {
+    _writeFunctionDefinition(
+      indent,
+      'ReadArguments',
+      scope: _codecSerializerName,
+      returnType: 'EncodableValue',
+      parameters: <String>[
+        'flutter::ByteStreamReader* stream',
+        'const std::vector<uint8_t>& enum_types',
+      ],
+      isConst: true,
+      body: () {
+        indent.format('''
+const uint8_t type = stream->ReadByte();
+if (type != $_standardListTypeId) {
+	return ReadValueOfType(type, stream);
+}
+EncodableList arguments(ReadSize(stream));
+for (size_t i = 0; i < arguments.size(); ++i) {
+	const uint8_t argument_type = stream->ReadByte();
+	if (i < enum_types.size() && enum_types[i] != 0 && argument_type == enum_types[i]) {
+		arguments[i] = ReadValue(stream);
+	} else {
+		arguments[i] = ReadValueOfType(argument_type, stream);
+	}
+}
+return EncodableValue(std::move(arguments));''');
+      },
+    );
+    _writeFunctionDefinition(
+      indent,
+      'WriteResult',
+      scope: _codecSerializerName,
+      returnType: _voidType,
+      parameters: <String>[
+        'const EncodableValue& result',
+        'uint8_t enum_type',
+        'flutter::ByteStreamWriter* stream',
+      ],
+      isConst: true,
+      body: () {
+        indent.format('''
+const auto* list = std::get_if<EncodableList>(&result);
+if (enum_type == 0 || list == nullptr || list->size() != 1 || !std::holds_alternative<int32_t>(list->front())) {
+	WriteValue(result, stream);
+	return;
+}
+stream->WriteByte($_standardListTypeId);
+WriteSize(1, stream);
+stream->WriteByte(enum_type);
+WriteValue(list->front(), stream);''');
+      },
+    );
+  }
+
+  void _writeSerializerEncodedSizes(
+    Indent indent,
+    List<EnumeratedType> enumeratedTypes,
+  ) {
+    final Iterable<EnumeratedType> unwrappedTypes = enumeratedTypes.where(
+      (EnumeratedType customType) =>
+          customType.enumeration < maximumCodecFieldKey,
+    );
+    _writeFunctionDefinition(
+      indent,
+      'EncodedSize',
+      scope: _codecSerializerName,
+      returnType: 'size_t',
+      parameters: <String>['const EncodableValue& value', 'size_t offset'],
+      body: () {
+        indent.format('''
+if (std::holds_alternative<int32_t>(value)) {
+	return 5;
+}
+if (std::holds_alternative<int64_t>(value)) {
+	return 9;
+}
+if (std::holds_alternative<double>(value)) {
+	return AlignEncodedEnd(offset + 1, 8) + 8 - offset;
+}
+if (const auto* string_value = std::get_if<std::string>(&value)) {
+	return AddEncodedSizeSize(offset + 1, string_value->size()) + string_value->size() - offset;
+}''');
+        for (final elementType in <String>[
+          'uint8_t',
+          'int32_t',
+          'int64_t',
+          'float',
+          'double',
+        ]) {
+          indent.writeScoped(
+            'if (const auto* typed_list = std::get_if<std::vector<$elementType>>(&value)) {',
+            '}',
+            () {
+              indent.writeln(
+                'return TypedListEncodedEnd(*typed_list, offset) - offset;',
+              );
+            },
+          );
+        }
+        indent.format('''
+if (const auto* list = std::get_if<EncodableList>(&value)) {
+	return EncodedSize(*list, offset);
+}
+if (const auto* map = std::get_if<EncodableMap>(&value)) {
+	return EncodedSize(*map, offset);
+}''');
+        if (unwrappedTypes.isEmpty) {
+          indent.write(
+            'if (std::holds_alternative<CustomEncodableValue>(value)) ',
+          );
+        } else {
+          indent.write(
+            'if (const CustomEncodableValue* custom_value = std::get_if<CustomEncodableValue>(&value)) ',
+          );
+        }
+        indent.addScoped('{', '}', () {
+          for (final customType in unwrappedTypes.where(_isPackedListType)) {
+            indent.writeScoped(
+              'if (custom_value->type() == typeid(std::vector<${customType.name}>)) {',
+              '}',
+              () {
+                indent.writeln(
+                  'const size_t count = std::any_cast<const std::vector<${customType.name}>&>(*custom_value).size();',
+                );
+                indent.writeln(
+                  '// The type byte, the packed kind and the count, then the records.',
+                );
+                indent.writeln(
+                  'return AddEncodedSizeSize(offset + 2, count) + count * sizeof(${customType.name}Packed) - offset;',
+                );
+              },
+            );
+          }
+          for (final customType in unwrappedTypes) {
+            indent.writeScoped(
+              'if (custom_value->type() == typeid(${customType.name})) {',
+              '}',
+              () {
+                if (customType.type == CustomTypes.customClass) {
+                  indent.writeln(
+                    'return std::any_cast<const ${customType.name}&>(*custom_value).EncodedSize(offset);',
+                  );
+                } else {
+                  indent.writeln(
+                    '// The type byte, then the index as an int32.',
+                  );
+                  indent.writeln('return 6;');
+                }
+              },
+            );
+          }
+          indent.writeln('EncodedSizeCounter counter(offset);');
+          indent.writeln('GetInstance().WriteValue(value, &counter);');
+          indent.writeln('return counter.end - offset;');
+        });
+        indent.writeln('// Null and bools are only a type byte.');
+        indent.writeln('return 1;');
+      },
+    );
+    _writeFunctionDefinition(
+      indent,
+      'EncodedSize',
+      scope: _codecSerializerName,
+      returnType: 'size_t',
+      parameters: <String>['const EncodableList& list', 'size_t offset'],
+      body: () {
+        indent.format('''
+size_t end = AddEncodedSizeSize(offset + 1, list.size());
+for (const EncodableValue& element : list) {
+	end += EncodedSize(element, end);
+}
+return end - offset;''');
+      },
+    );
+    _writeFunctionDefinition(
+      indent,
+      'EncodedSize',
+      scope: _codecSerializerName,
+      returnType: 'size_t',
+      parameters: <String>['const EncodableMap& map', 'size_t offset'],
+      body: () {
+        indent.format('''
+size_t end = AddEncodedSizeSize(offset + 1, map.size());
+for (const auto& [key, value] : map) {
+	end += EncodedSize(key, end);
+	end += EncodedSize(value, end);
+}
+return end - offset;''');
+      },
+    );
+  }
+
+  void _writeWriteListInParallel(Indent indent) {
+    _writeFunctionDefinition(
+      indent,
+      'WriteListInParallel',
       scope: _codecSerializerName,
-      returnType: 'EncodableValue',
-      parameters: <String>['uint8_t type', 'flutter::ByteStreamReader* stream'],
+      returnType: 'bool',
+      parameters: <String>[
+        'const EncodableList& list',
+        'flutter::ByteStreamWriter* stream',
+      ],
       isConst: true,
       body: () {
-        if (enumeratedTypes.isNotEmpty) {
-          indent.writeln('switch (type) {');
-          indent.inc();
-          for (final customType in enumeratedTypes) {
-            if (customType.enumeration < maximumCodecFieldKey) {
-              indent.write('case ${customType.enumeration}: ');
-              indent.nest(1, () {
-                _writeCodecDecode(indent, customType, 'ReadValue(stream)');
-              });
-            }
-          }
-          if (root.requiresOverflowClass) {
-            indent.write('case $maximumCodecFieldKey:');
-            _writeCodecDecode(indent, _enumeratedOverflow, 'ReadValue(stream)');
-          }
-          indent.writeln('default:');
-          indent.inc();
-        }
-        indent.writeln(
-          'return $_standardCodecSerializer::ReadValueOfType(type, stream);',
-        );
-        if (enumeratedTypes.isNotEmpty) {
-          indent.dec();
-          indent.writeln('}');
-          indent.dec();
-        }
+        indent.format('''
+if (std::any_of(list.begin(), list.end(), MayAlign)) {
+	return false;
+}
+const size_t worker_count = std::max(2u, std::thread::hardware_concurrency());
+const size_t chunk_size = (list.size() + worker_count - 1) / worker_count;
+std::vector<std::future<ParallelEncodeBuffer>> chunks;
+for (size_t start = 0; start < list.size(); start += chunk_size) {
+	const size_t end = std::min(start + chunk_size, list.size());
+	chunks.push_back(std::async(std::launch::async, [this, &list, start, end]() {
+		ParallelWorkerScope scope;
+		ParallelEncodeBuffer buffer;
+		for (size_t i = start; i < end; ++i) {
+			WriteValue(list[i], &buffer);
+		}
+		return buffer;
+	}));
+}
+std::vector<ParallelEncodeBuffer> buffers;
+buffers.reserve(chunks.size());
+bool aligned = false;
+for (std::future<ParallelEncodeBuffer>& chunk : chunks) {
+	buffers.push_back(chunk.get());
+	aligned = aligned || buffers.back().aligned;
+}
+if (aligned) {
+	return false;
+}
+stream->WriteByte($_standardListTypeId);
+WriteSize(list.size(), stream);
+for (const ParallelEncodeBuffer& buffer : buffers) {
+	stream->WriteBytes(buffer.bytes.data(), buffer.bytes.size());
+}
+return true;''');
       },
     );
+  }
+
+  void _writeReadListInParallel(Indent indent) {
     _writeFunctionDefinition(
       indent,
-      'WriteValue',
+      'ReadListInParallel',
       scope: _codecSerializerName,
-      returnType: _voidType,
+      returnType: 'bool',
       parameters: <String>[
-        'const EncodableValue& value',
-        'flutter::ByteStreamWriter* stream',
+        'flutter::ByteStreamReader* stream',
+        'EncodableList* list',
       ],
       isConst: true,
       body: () {
-        if (enumeratedTypes.isNotEmpty) {
-          indent.write(
-            'if (const CustomEncodableValue* custom_value = std::get_if<CustomEncodableValue>(&value)) ',
-          );
-          indent.addScoped('{', '}', () {
-            for (final customType in enumeratedTypes) {
-              final encodeString = customType.type == CustomTypes.customClass
-                  ? 'std::any_cast<${customType.name}>(*custom_value).ToEncodableList()'
-                  : 'static_cast<int>(std::any_cast<${customType.name}>(*custom_value))';
-              final valueString = customType.enumeration < maximumCodecFieldKey
-                  ? encodeString
-                  : 'wrap.ToEncodableList()';
-              final int enumeration =
-                  customType.enumeration < maximumCodecFieldKey
-                  ? customType.enumeration
-                  : maximumCodecFieldKey;
-              indent.write(
-                'if (custom_value->type() == typeid(${customType.name})) ',
-              );
-              indent.addScoped('{', '}', () {
-                indent.writeln('stream->WriteByte($enumeration);');
-                if (enumeration == maximumCodecFieldKey) {
-                  indent.writeln(
-                    'const auto wrap = $_overflowClassName(${customType.enumeration - maximumCodecFieldKey}, $encodeString);',
-                  );
-                }
-                indent.writeln(
-                  'WriteValue(EncodableValue($valueString), stream);',
-                );
-                indent.writeln('return;');
-              });
-            }
-          });
-        }
-        indent.writeln('$_standardCodecSerializer::WriteValue(value, stream);');
+        indent.format('''
+BufferStreamReader* reader = dynamic_cast<BufferStreamReader*>(stream);
+if (reader == nullptr) {
+	return false;
+}
+BufferStreamReader scanner(reader->bytes(), reader->size(), reader->position());
+const size_t size = ReadSkippedSize(&scanner);
+if (size < kParallelEncodeThreshold) {
+	return false;
+}
+// Finds where the elements of each worker start, without decoding them.
+const size_t worker_count = std::max(2u, std::thread::hardware_concurrency());
+const size_t chunk_size = (size + worker_count - 1) / worker_count;
+std::vector<size_t> chunk_positions;
+for (size_t i = 0; i < size; ++i) {
+	if (i % chunk_size == 0) {
+		chunk_positions.push_back(scanner.position());
+	}
+	if (!SkipValue(&scanner)) {
+		return false;
+	}
+}
+// Each worker reads from the position of its first element in the message,
+// so values are aligned as they were written.
+std::vector<std::future<EncodableList>> chunks;
+for (size_t chunk = 0; chunk < chunk_positions.size(); ++chunk) {
+	const size_t count = std::min(chunk_size, size - chunk * chunk_size);
+	chunks.push_back(std::async(std::launch::async, [this, reader, position = chunk_positions[chunk], count]() {
+		ParallelWorkerScope scope;
+		BufferStreamReader chunk_reader(reader->bytes(), reader->size(), position);
+		EncodableList values;
+		values.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			values.push_back(ReadValue(&chunk_reader));
+		}
+		return values;
+	}));
+}
+list->reserve(size);
+for (std::future<EncodableList>& chunk : chunks) {
+	for (EncodableValue& value : chunk.get()) {
+		list->push_back(std::move(value));
+	}
+}
+reader->Seek(scanner.position());
+return true;''');
       },
     );
   }
@@ -1419,7 +3920,7 @@ EncodableValue $_overflowClassName::FromEncodableList(
       },
     );
     for (final Method func in api.methods) {
-      final HostDatatype returnType = getHostDatatype(
+      final HostDatatype returnType = _cppHostDatatype(
         func.returnType,
         _shortBaseCppTypeForBuiltinDartType,
       );
@@ -1429,7 +3930,7 @@ EncodableValue $_overflowClassName::FromEncodableList(
       final Iterable<_HostNamedType> hostParameters = indexMap(
         func.parameters,
         (int i, NamedType arg) {
-          final HostDatatype hostType = getFieldHostDatatype(
+          final HostDatatype hostType = _cppFieldHostDatatype(
             arg,
             _shortBaseCppTypeForBuiltinDartType,
           );
@@ -1459,7 +3960,7 @@ EncodableValue $_overflowClassName::FromEncodableList(
           );
           indent.writeln(
             'BasicMessageChannel<> channel(binary_messenger_, '
-            'channel_name, &GetCodec());',
+            'channel_name, ${_channelCodec(generatorOptions)});',
           );
 
           // Convert arguments to EncodableValue versions.
@@ -1490,22 +3991,39 @@ EncodableValue $_overflowClassName::FromEncodableList(
             '(const uint8_t* reply, size_t reply_size) ',
           );
           indent.addScoped('{', '});', () {
+            final bool instrumented = generatorOptions.includeInstrumentation;
             String successCallbackArgument;
             successCallbackArgument = 'return_value';
             final encodedReplyName = 'encodable_$successCallbackArgument';
             final listReplyName = 'list_$successCallbackArgument';
+            if (instrumented) {
+              indent.writeln('NotifyDecodeStart(channel_name, reply_size);');
+            }
+            final String replyCodec =
+                generatorOptions.parallelEncodeThreshold != null
+                ? 'ParallelMessageCodec::GetInstance()'
+                : 'GetCodec()';
             indent.writeln(
-              'std::unique_ptr<EncodableValue> response = GetCodec().DecodeMessage(reply, reply_size);',
+              'std::unique_ptr<EncodableValue> response = $replyCodec.DecodeMessage(reply, reply_size);',
             );
             indent.writeln('const auto& $encodedReplyName = *response;');
             indent.writeln(
               'const auto* $listReplyName = std::get_if<EncodableList>(&$encodedReplyName);',
             );
+            if (instrumented) {
+              indent.writeln('NotifyHandlerStart(channel_name);');
+            }
             indent.writeScoped('if ($listReplyName) {', '} ', () {
               indent.writeScoped('if ($listReplyName->size() > 1) {', '} ', () {
-                indent.writeln(
-                  'on_error(FlutterError(std::get<std::string>($listReplyName->at(0)), std::get<std::string>($listReplyName->at(1)), $listReplyName->at(2)));',
-                );
+                final errorArguments =
+                    'std::get<std::string>($listReplyName->at(0)), std::get<std::string>($listReplyName->at(1)), $listReplyName->at(2)';
+                if (instrumented) {
+                  indent.writeln('const FlutterError error($errorArguments);');
+                  indent.writeln('NotifyError(channel_name, error);');
+                  indent.writeln('on_error(error);');
+                } else {
+                  indent.writeln('on_error(FlutterError($errorArguments));');
+                }
               }, addTrailingNewline: false);
               indent.addScoped('else {', '}', () {
                 if (func.returnType.isVoid) {
@@ -1524,7 +4042,17 @@ EncodableValue $_overflowClassName::FromEncodableList(
               });
             }, addTrailingNewline: false);
             indent.addScoped('else {', '} ', () {
-              indent.writeln('on_error(CreateConnectionError(channel_name));');
+              if (instrumented) {
+                indent.writeln(
+                  'const FlutterError error = CreateConnectionError(channel_name);',
+                );
+                indent.writeln('NotifyError(channel_name, error);');
+                indent.writeln('on_error(error);');
+              } else {
+                indent.writeln(
+                  'on_error(CreateConnectionError(channel_name));',
+                );
+              }
             });
           });
         },
@@ -1540,6 +4068,39 @@ EncodableValue $_overflowClassName::FromEncodableList(
     AstHostApi api, {
     required String dartPackageName,
   }) {
+    final bool ffiSync = hasFfiSyncMethods(api);
+    final ffiInstanceName = '${_snakeCaseFromCamelCase(api.name)}_ffi_instance';
+    final ffiErrorName = '${_snakeCaseFromCamelCase(api.name)}_ffi_error';
+    if (ffiSync) {
+      indent.writeln('namespace {');
+      indent.newln();
+      indent.writeln(
+        '// The `${api.name}` set up without a message channel suffix, which the',
+      );
+      indent.writeln('// exported functions of its `@FfiSync()` methods call.');
+      indent.writeln(
+        '// Each call copies it under the mutex and runs without holding it.',
+      );
+      indent.writeln('std::shared_ptr<${api.name}> $ffiInstanceName;');
+      indent.writeln(
+        '// Ready once the last call using `$ffiInstanceName` returns, so that',
+      );
+      indent.writeln(
+        '// SetUp does not return while a call still uses the instance it',
+      );
+      indent.writeln('// replaces.');
+      indent.writeln('std::future<void> ${ffiInstanceName}_released;');
+      indent.writeln('std::shared_mutex ${ffiInstanceName}_mutex;');
+      indent.writeln(
+        '// The error returned by the last exported call on this thread, if any.',
+      );
+      indent.writeln(
+        'thread_local std::optional<FlutterError> $ffiErrorName;',
+      );
+      indent.newln();
+      indent.writeln('}  // namespace');
+      indent.newln();
+    }
     indent.writeln('/// The codec used by ${api.name}.');
     _writeFunctionDefinition(
       indent,
@@ -1579,113 +4140,132 @@ EncodableValue $_overflowClassName::FromEncodableList(
         'const std::string& message_channel_suffix',
       ],
       body: () {
+        final bool instrumented = generatorOptions.includeInstrumentation;
         indent.writeln(
           'const std::string prepended_suffix = message_channel_suffix.length() > 0 ? std::string(".") + message_channel_suffix : "";',
         );
-        for (final Method method in api.methods) {
-          final String channelName = makeChannelName(
-            api,
-            method,
-            dartPackageName,
-          );
-          indent.writeScoped('{', '}', () {
+        if (ffiSync) {
+          indent.writeScoped('if (message_channel_suffix.empty()) {', '}', () {
+            indent.writeln('std::shared_ptr<${api.name}> instance;');
+            indent.writeln('std::future<void> released;');
+            indent.writeScoped('if (api != nullptr) {', '}', () {
+              indent.writeln(
+                'auto promise = std::make_shared<std::promise<void>>();',
+              );
+              indent.writeln('released = promise->get_future();');
+              indent.writeln(
+                'instance = std::shared_ptr<${api.name}>(api, [promise](${api.name}*) { promise->set_value(); });',
+              );
+            });
+            indent.writeScoped('{', '}', () {
+              indent.writeln(
+                'std::unique_lock<std::shared_mutex> lock(${ffiInstanceName}_mutex);',
+              );
+              indent.writeln('$ffiInstanceName.swap(instance);');
+              indent.writeln('${ffiInstanceName}_released.swap(released);');
+            });
             indent.writeln(
-              'BasicMessageChannel<> channel(binary_messenger, '
-              '"$channelName" + prepended_suffix, &GetCodec());',
+              '// Waits for the calls still using the previous instance.',
             );
+            indent.writeln('instance.reset();');
+            indent.writeScoped('if (released.valid()) {', '}', () {
+              indent.writeln('released.wait();');
+            });
+          });
+        }
+        if (instrumented) {
+          indent.writeln(
+            'InstrumentedBinaryMessenger instrumented_messenger(binary_messenger);',
+          );
+        }
+        void writeChannel(
+          String channelName,
+          void Function() writeHandler, {
+          bool chunked = false,
+          Method? method,
+        }) {
+          indent.writeScoped('{', '}', () {
+            String codec = _channelCodec(generatorOptions);
+            if (method != null &&
+                _hasUnboxedEnums(generatorOptions, root, api, method)) {
+              final String argumentTypes = method.parameters
+                  .map(
+                    (Parameter parameter) =>
+                        _unboxedEnumTypeId(root, parameter.type),
+                  )
+                  .join(', ');
+              indent.writeln(
+                'static const UnboxedEnumCodec unboxed_enum_codec({$argumentTypes}, ${_unboxedEnumTypeId(root, method.returnType)});',
+              );
+              codec = '&unboxed_enum_codec';
+            }
+            if (chunked) {
+              indent.writeln(
+                'const std::string chunk_channel_name = "$channelName" + prepended_suffix + ".chunks";',
+              );
+            }
+            if (instrumented) {
+              indent.writeln(
+                'const std::string channel_name = "$channelName" + prepended_suffix;',
+              );
+              indent.writeln(
+                'BasicMessageChannel<> channel(&instrumented_messenger, '
+                'channel_name, $codec);',
+              );
+            } else {
+              indent.writeln(
+                'BasicMessageChannel<> channel(binary_messenger, '
+                '"$channelName" + prepended_suffix, $codec);',
+              );
+            }
             indent.writeScoped('if (api != nullptr) {', '} else {', () {
+              final captures = <String>[
+                'api',
+                if (instrumented) 'channel_name',
+                if (chunked) 'binary_messenger, chunk_channel_name',
+              ].join(', ');
               indent.write(
-                'channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) ',
+                'channel.SetMessageHandler([$captures](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) ',
               );
-              indent.addScoped('{', '});', () {
-                indent.writeScoped('try {', '}', () {
-                  final methodArgument = <String>[];
-                  if (method.parameters.isNotEmpty) {
-                    indent.writeln(
-                      'const auto& args = std::get<EncodableList>(message);',
-                    );
-
-                    enumerate(method.parameters, (int index, NamedType arg) {
-                      final HostDatatype hostType = getHostDatatype(
-                        arg.type,
-                        (TypeDeclaration x) =>
-                            _shortBaseCppTypeForBuiltinDartType(x),
-                      );
-                      final String argName = _getSafeArgumentName(index, arg);
-
-                      final encodableArgName = '${_encodablePrefix}_$argName';
-                      indent.writeln(
-                        'const auto& $encodableArgName = args.at($index);',
-                      );
-                      if (!arg.type.isNullable) {
-                        indent.writeScoped(
-                          'if ($encodableArgName.IsNull()) {',
-                          '}',
-                          () {
-                            indent.writeln(
-                              'reply(WrapError("$argName unexpectedly null."));',
-                            );
-                            indent.writeln('return;');
-                          },
-                        );
-                      }
-                      _writeEncodableValueArgumentUnwrapping(
-                        indent,
-                        root,
-                        hostType,
-                        argName: argName,
-                        encodableArgName: encodableArgName,
-                        apiType: ApiType.host,
-                      );
-                      final unwrapEnum = arg.type.isEnum && arg.type.isNullable
-                          ? ' ? &(*$argName) : nullptr'
-                          : '';
-                      methodArgument.add('$argName$unwrapEnum');
-                    });
-                  }
-
-                  final HostDatatype returnType = getHostDatatype(
-                    method.returnType,
-                    _shortBaseCppTypeForBuiltinDartType,
-                  );
-                  final String returnTypeName = _hostApiReturnType(returnType);
-                  if (method.isAsynchronous) {
-                    methodArgument.add(
-                      '[reply]($returnTypeName&& output) {${indent.newline}'
-                      '${_wrapResponse(indent, root, method.returnType, prefix: '\t')}${indent.newline}'
-                      '}',
-                    );
-                  }
-                  final call =
-                      'api->${_makeMethodName(method)}(${methodArgument.join(', ')})';
-                  if (method.isAsynchronous) {
-                    indent.format('$call;');
-                  } else {
-                    indent.writeln('$returnTypeName output = $call;');
-                    indent.format(
-                      _wrapResponse(indent, root, method.returnType),
-                    );
-                  }
-                }, addTrailingNewline: false);
-                indent.add(' catch (const std::exception& exception) ');
-                indent.addScoped('{', '}', () {
-                  // There is a potential here for `reply` to be called twice, which
-                  // is a violation of the API contract, because there's no way of
-                  // knowing whether or not the plugin code called `reply` before
-                  // throwing. Since use of `@async` suggests that the reply is
-                  // probably not sent within the scope of the stack, err on the
-                  // side of potential double-call rather than no call (which is
-                  // also an API violation) so that unexpected errors have a better
-                  // chance of being caught and handled in a useful way.
-                  indent.writeln('reply(WrapError(exception.what()));');
-                });
-              });
+              indent.addScoped('{', '});', writeHandler);
             });
             indent.addScoped(null, '}', () {
               indent.writeln('channel.SetMessageHandler(nullptr);');
             });
           });
         }
+
+        if (api.multiplexed && api.methods.isNotEmpty) {
+          writeChannel(
+            makeMultiplexedChannelName(api, dartPackageName),
+            () => _writeMultiplexedHandlerBody(
+              indent,
+              root,
+              api,
+              instrumented: instrumented,
+            ),
+          );
+        } else {
+          for (final Method method in api.methods) {
+            writeChannel(
+              makeChannelName(api, method, dartPackageName),
+              () => _writeHostMethodHandlerBody(
+                indent,
+                root,
+                method,
+                instrumented: instrumented,
+                unboxedEnums: _hasUnboxedEnums(
+                  generatorOptions,
+                  root,
+                  api,
+                  method,
+                ),
+              ),
+              chunked: isChunkedMethod(method),
+              method: method,
+            );
+          }
+        }
       },
     );
 
@@ -1719,6 +4299,107 @@ return EncodableValue(EncodableList{
 });''');
       },
     );
+
+    if (ffiSync) {
+      _writeFfiSyncFunctions(
+        indent,
+        api,
+        instanceName: ffiInstanceName,
+        errorName: ffiErrorName,
+        dartPackageName: dartPackageName,
+      );
+    }
+  }
+
+  // Writes the C functions exported for the `@FfiSync()` methods of [api],
+  // which call [instanceName] directly and keep the error of the last call in
+  // [errorName] for the functions that report it.
+  void _writeFfiSyncFunctions(
+    Indent indent,
+    AstHostApi api, {
+    required String instanceName,
+    required String errorName,
+    required String dartPackageName,
+  }) {
+    for (final Method method in api.methods.where(
+      (Method method) => method.isFfiSync,
+    )) {
+      final HostDatatype returnType = _cppHostDatatype(
+        method.returnType,
+        _baseCppTypeForBuiltinDartType,
+      );
+      final Iterable<String> parameters = method.parameters.map((
+        Parameter param,
+      ) {
+        final HostDatatype hostType = _cppFieldHostDatatype(
+          param,
+          _baseCppTypeForBuiltinDartType,
+        );
+        return '${hostType.datatype} ${_makeVariableName(param)}';
+      });
+      final String arguments = method.parameters
+          .map(_makeVariableName)
+          .join(', ');
+      final String channelName = api.multiplexed
+          ? makeMultiplexedChannelName(api, dartPackageName)
+          : makeChannelName(api, method, dartPackageName);
+      final failureReturn = switch (method.returnType.baseName) {
+        'bool' => 'return false;',
+        'int' => 'return 0;',
+        'double' => 'return 0.0;',
+        _ => 'return;',
+      };
+      indent.newln();
+      indent.writeScoped(
+        'extern "C" GOLUBETS_FFI_EXPORT ${returnType.datatype} ${makeFfiSymbolName(api, method.name, dartPackageName)}(${parameters.join(', ')}) {',
+        '}',
+        () {
+          indent.writeln('$errorName.reset();');
+          indent.writeln('std::shared_ptr<${api.name}> instance;');
+          indent.writeScoped('{', '}', () {
+            indent.writeln(
+              'std::shared_lock<std::shared_mutex> lock(${instanceName}_mutex);',
+            );
+            indent.writeln('instance = $instanceName;');
+          });
+          indent.writeScoped('if (instance == nullptr) {', '}', () {
+            indent.writeln(
+              '$errorName = CreateConnectionError("$channelName");',
+            );
+            indent.writeln(failureReturn);
+          });
+          final call = 'instance->${_makeMethodName(method)}($arguments)';
+          if (method.returnType.isVoid) {
+            indent.writeln('std::optional<FlutterError> error = $call;');
+            indent.writeScoped('if (error.has_value()) {', '}', () {
+              indent.writeln('$errorName = std::move(error);');
+            });
+          } else {
+            indent.writeln(
+              'ErrorOr<${returnType.datatype}> output = $call;',
+            );
+            indent.writeScoped('if (output.has_error()) {', '}', () {
+              indent.writeln('$errorName = output.error();');
+              indent.writeln(failureReturn);
+            });
+            indent.writeln('return output.value();');
+          }
+        },
+      );
+    }
+
+    for (final field in <String>['code', 'message']) {
+      indent.newln();
+      indent.writeScoped(
+        'extern "C" GOLUBETS_FFI_EXPORT const char* ${makeFfiSymbolName(api, 'ffi_error_$field', dartPackageName)}() {',
+        '}',
+        () {
+          indent.writeln(
+            'return $errorName.has_value() ? $errorName->$field().c_str() : nullptr;',
+          );
+        },
+      );
+    }
   }
 
   void _writeClassConstructor(
@@ -1730,7 +4411,7 @@ return EncodableValue(EncodableList{
     final Iterable<_HostNamedType> hostParams = params.map((NamedType param) {
       return _HostNamedType(
         _makeVariableName(param),
-        getFieldHostDatatype(param, _shortBaseCppTypeForBuiltinDartType),
+        _cppFieldHostDatatype(param, _shortBaseCppTypeForBuiltinDartType),
         param.type,
       );
     });
@@ -1764,7 +4445,7 @@ return EncodableValue(EncodableList{
   ) {
     final List<String> initializerStrings = fields.map((NamedType param) {
       final String fieldName = _makeInstanceVariableName(param);
-      final HostDatatype hostType = getFieldHostDatatype(
+      final HostDatatype hostType = _cppFieldHostDatatype(
         param,
         _shortBaseCppTypeForBuiltinDartType,
       );
@@ -1793,7 +4474,7 @@ return EncodableValue(EncodableList{
       parameters: <String>['const ${classDefinition.name}& other'],
       body: () {
         for (final field in fields) {
-          final HostDatatype hostDatatype = getFieldHostDatatype(
+          final HostDatatype hostDatatype = _cppFieldHostDatatype(
             field,
             _shortBaseCppTypeForBuiltinDartType,
           );
@@ -1824,7 +4505,7 @@ return EncodableValue(EncodableList{
     Class classDefinition,
     NamedType field,
   ) {
-    final HostDatatype hostDatatype = getFieldHostDatatype(
+    final HostDatatype hostDatatype = _cppFieldHostDatatype(
       field,
       _shortBaseCppTypeForBuiltinDartType,
     );
@@ -1908,11 +4589,210 @@ return EncodableValue(EncodableList{
         : variable;
   }
 
+  // Writes the body of the message handler shared by all methods of a
+  // multiplexed [api], which dispatches on the method index at the start of
+  // the message through a table of per-method handlers.
+  void _writeMultiplexedHandlerBody(
+    Indent indent,
+    Root root,
+    AstHostApi api, {
+    required bool instrumented,
+  }) {
+    final handlerParameters = <String>[
+      '${api.name}* api',
+      'const EncodableList& args',
+      if (instrumented) 'const std::string& channel_name',
+      'const flutter::MessageReply<EncodableValue>& reply',
+    ].join(', ');
+    indent.writeln('using MethodHandler = void (*)($handlerParameters);');
+    indent.writeScoped(
+      'static const MethodHandler method_handlers[] = {',
+      '};',
+      () {
+        for (final Method method in api.methods) {
+          indent.writeln('// ${method.name}');
+          indent.write('[]($handlerParameters) ');
+          indent.addScoped('{', '},', () {
+            _writeHostMethodHandlerBody(
+              indent,
+              root,
+              method,
+              instrumented: instrumented,
+              multiplexed: true,
+            );
+          });
+        }
+      },
+    );
+    // The method index is read inside the `try` so that a malformed message
+    // is answered with an error instead of throwing out of the handler.
+    indent.writeScoped('try {', '}', () {
+      indent.writeln(
+        'const auto* args = std::get_if<EncodableList>(&message);',
+      );
+      indent.writeScoped('if (args == nullptr || args->empty()) {', '}', () {
+        indent.writeln(
+          'reply(WrapError("Missing method index for ${api.name}."));',
+        );
+        indent.writeln('return;');
+      });
+      indent.writeln('const int64_t method_index = args->at(0).LongValue();');
+      indent.writeScoped(
+        'if (method_index < 0 || method_index >= ${api.methods.length}) {',
+        '}',
+        () {
+          indent.writeln(
+            'reply(WrapError("Unknown method index " + std::to_string(method_index) + " for ${api.name}."));',
+          );
+          indent.writeln('return;');
+        },
+      );
+      final handlerArguments = instrumented
+          ? 'api, *args, channel_name, reply'
+          : 'api, *args, reply';
+      indent.writeln('method_handlers[method_index]($handlerArguments);');
+    }, addTrailingNewline: false);
+    indent.add(' catch (const std::exception& exception) ');
+    indent.addScoped('{', '}', () {
+      if (instrumented) {
+        indent.writeln(
+          'NotifyError(channel_name, FlutterError(exception.what(), "Error"));',
+        );
+      }
+      indent.writeln('reply(WrapError(exception.what()));');
+    });
+  }
+
+  // Writes the body of the message handler for [method], which decodes the
+  // arguments from `args`, calls `api` and sends the result with `reply`.
+  //
+  // For multiplexed APIs `args` is declared by the caller and starts with the
+  // method index.
+  void _writeHostMethodHandlerBody(
+    Indent indent,
+    Root root,
+    Method method, {
+    required bool instrumented,
+    bool multiplexed = false,
+    bool unboxedEnums = false,
+  }) {
+    indent.writeScoped('try {', '}', () {
+      final methodArgument = <String>[];
+      if (method.parameters.isNotEmpty) {
+        if (!multiplexed) {
+          indent.writeln(
+            'const auto& args = std::get<EncodableList>(message);',
+          );
+        }
+
+        final argumentOffset = multiplexed ? 1 : 0;
+        enumerate(method.parameters, (int index, NamedType arg) {
+          final HostDatatype hostType = _cppHostDatatype(
+            arg.type,
+            (TypeDeclaration x) => _shortBaseCppTypeForBuiltinDartType(x),
+          );
+          final String argName = _getSafeArgumentName(index, arg);
+
+          final encodableArgName = '${_encodablePrefix}_$argName';
+          indent.writeln(
+            'const auto& $encodableArgName = args.at(${index + argumentOffset});',
+          );
+          if (!arg.type.isNullable) {
+            indent.writeScoped(
+              'if ($encodableArgName.IsNull()) {',
+              '}',
+              () {
+                indent.writeln(
+                  'reply(WrapError("$argName unexpectedly null."));',
+                );
+                indent.writeln('return;');
+              },
+            );
+          }
+          _writeEncodableValueArgumentUnwrapping(
+            indent,
+            root,
+            hostType,
+            argName: argName,
+            encodableArgName: encodableArgName,
+            apiType: ApiType.host,
+            unboxedEnum:
+                unboxedEnums && _unboxedEnumTypeId(root, arg.type) != 0,
+          );
+          final unwrapEnum = arg.type.isEnum && arg.type.isNullable
+              ? ' ? &(*$argName) : nullptr'
+              : '';
+          methodArgument.add('$argName$unwrapEnum');
+        });
+      }
+
+      final HostDatatype returnType = _cppHostDatatype(
+        method.returnType,
+        _shortBaseCppTypeForBuiltinDartType,
+      );
+      final String returnTypeName = _hostApiReturnType(returnType);
+      if (method.isAsynchronous) {
+        final String replyCaptures = <String>[
+          'reply',
+          if (instrumented) 'channel_name, handler_start',
+          if (isChunkedMethod(method)) 'binary_messenger, chunk_channel_name',
+        ].join(', ');
+        methodArgument.add(
+          '[$replyCaptures]($returnTypeName&& output) {${indent.newline}'
+          '${_wrapResponse(indent, root, method.returnType, prefix: '\t', instrumented: instrumented, chunkFrameSize: method.chunkFrameSize, unboxedEnum: unboxedEnums)}${indent.newline}'
+          '}',
+        );
+      }
+      if (instrumented) {
+        indent.writeln(
+          'const int64_t handler_start = NotifyHandlerStart(channel_name);',
+        );
+      }
+      final call =
+          'api->${_makeMethodName(method)}(${methodArgument.join(', ')})';
+      if (method.isAsynchronous) {
+        indent.format('$call;');
+      } else {
+        indent.writeln('$returnTypeName output = $call;');
+        indent.format(
+          _wrapResponse(
+            indent,
+            root,
+            method.returnType,
+            instrumented: instrumented,
+            chunkFrameSize: method.chunkFrameSize,
+            unboxedEnum: unboxedEnums,
+          ),
+        );
+      }
+    }, addTrailingNewline: false);
+    indent.add(' catch (const std::exception& exception) ');
+    indent.addScoped('{', '}', () {
+      // There is a potential here for `reply` to be called twice, which
+      // is a violation of the API contract, because there's no way of
+      // knowing whether or not the plugin code called `reply` before
+      // throwing. Since use of `@async` suggests that the reply is
+      // probably not sent within the scope of the stack, err on the
+      // side of potential double-call rather than no call (which is
+      // also an API violation) so that unexpected errors have a better
+      // chance of being caught and handled in a useful way.
+      if (instrumented) {
+        indent.writeln(
+          'NotifyError(channel_name, FlutterError(exception.what(), "Error"));',
+        );
+      }
+      indent.writeln('reply(WrapError(exception.what()));');
+    });
+  }
+
   String _wrapResponse(
     Indent indent,
     Root root,
     TypeDeclaration returnType, {
     String prefix = '',
+    bool instrumented = false,
+    int? chunkFrameSize,
+    bool unboxedEnum = false,
   }) {
     final String nonErrorPath;
     final String errorCondition;
@@ -1924,15 +4804,22 @@ return EncodableValue(EncodableList{
       errorCondition = 'output.has_value()';
       errorGetter = 'value';
     } else {
-      final HostDatatype hostType = getHostDatatype(
+      final HostDatatype hostType = _cppHostDatatype(
         returnType,
         _shortBaseCppTypeForBuiltinDartType,
       );
 
       const extractedValue = 'std::move(output).TakeValue()';
+      // Unboxed enums are sent as their index, which the channel's codec
+      // writes with the enum's type byte.
+      final bool isUnboxed =
+          unboxedEnum && _unboxedEnumTypeId(root, returnType) != 0;
       final wrapperType = hostType.isBuiltin
           ? 'EncodableValue'
           : 'CustomEncodableValue';
+      String wrap(String value) => isUnboxed
+          ? 'EncodableValue(static_cast<int>($value))'
+          : '$wrapperType($value)';
       if (returnType.isNullable) {
         // The value is a std::optional, so needs an extra layer of
         // handling.
@@ -1940,13 +4827,12 @@ return EncodableValue(EncodableList{
             '''
 ${prefix}auto output_optional = $extractedValue;
 ${prefix}if (output_optional) {
-$prefix\twrapped.push_back($wrapperType(std::move(output_optional).value()));
+$prefix\twrapped.push_back(${wrap('std::move(output_optional).value()')});
 $prefix} else {
 $prefix\twrapped.push_back($nullValue);
 $prefix}''';
       } else {
-        nonErrorPath =
-            '${prefix}wrapped.push_back($wrapperType($extractedValue));';
+        nonErrorPath = '${prefix}wrapped.push_back(${wrap(extractedValue)});';
       }
       errorCondition = 'output.has_error()';
       errorGetter = 'error';
@@ -1955,14 +4841,24 @@ $prefix}''';
     // an EncodableList inline, which would be less code. However,
     // that would always copy the element, so the slightly more
     // verbose create-and-push approach is used instead.
+    final String notifyError = instrumented
+        ? '$prefix\tNotifyError(channel_name, output.$errorGetter());\n'
+        : '';
+    final String notifyHandlerEnd = instrumented
+        ? '${prefix}NotifyHandlerEnd(channel_name, handler_start);\n'
+        : '';
+    // Chunked replies are sent in frames, followed by the number of frames.
+    final sendReply = chunkFrameSize == null
+        ? 'reply(EncodableValue(std::move(wrapped)));'
+        : 'SendChunkedReply(binary_messenger, chunk_channel_name, $chunkFrameSize, $_codecSerializerName::GetInstance(), EncodableValue(std::move(wrapped)), reply);';
     return '''
-${prefix}if ($errorCondition) {
-$prefix\treply(WrapError(output.$errorGetter()));
+$notifyHandlerEnd${prefix}if ($errorCondition) {
+$notifyError$prefix\treply(WrapError(output.$errorGetter()));
 $prefix\treturn;
 $prefix}
 ${prefix}EncodableList wrapped;
 $nonErrorPath
-${prefix}reply(EncodableValue(std::move(wrapped)));''';
+$prefix$sendReply''';
   }
 
   @override
@@ -2017,7 +4913,12 @@ ${prefix}reply(EncodableValue(std::move(wrapped)));''';
     required String argName,
     required String encodableArgName,
     required ApiType apiType,
+    bool unboxedEnum = false,
   }) {
+    // Unboxed enum arguments arrive as their index.
+    final String enumValue = unboxedEnum
+        ? 'static_cast<${hostType.datatype}>($encodableArgName.LongValue())'
+        : _classReferenceFromEncodableValue(hostType, encodableArgName);
     if (hostType.isNullable) {
       // Nullable arguments are always pointers, with nullptr corresponding to
       // null.
@@ -2033,7 +4934,7 @@ ${prefix}reply(EncodableValue(std::move(wrapped)));''';
 ${hostType.datatype} ${argName}_value;
 const ${hostType.datatype}* $argName = nullptr;
 if (!$encodableArgName.IsNull()) {
-  ${argName}_value = ${_classReferenceFromEncodableValue(hostType, encodableArgName)};
+  ${argName}_value = $enumValue;
   $argName = &${argName}_value;
 }''');
       } else {
@@ -2061,6 +4962,8 @@ if (!$encodableArgName.IsNull()) {
         indent.writeln(
           'const auto& $argName = std::get<${hostType.datatype}>($encodableArgName);',
         );
+      } else if (unboxedEnum) {
+        indent.writeln('const ${hostType.datatype} $argName = $enumValue;');
       } else {
         indent.writeln(
           'const auto& $argName = ${_classReferenceFromEncodableValue(hostType, encodableArgName)};',
@@ -2086,6 +4989,560 @@ if (!$encodableArgName.IsNull()) {
   }
 }
 
+/// Writes a standalone C++ benchmark (.cpp) for the generated code to sink.
+///
+/// The benchmark builds randomized instances of every data class and
+/// round-trips them through the generated codec, then dispatches every host
+/// API method through an in-process fake `flutter::BinaryMessenger`, so that
+/// message cost can be measured for a real schema.
+class CppBenchmarkGenerator extends Generator<InternalCppOptions> {
+  /// Constructor.
+  const CppBenchmarkGenerator();
+
+  @override
+  void generate(
+    InternalCppOptions generatorOptions,
+    Root root,
+    StringSink sink, {
+    required String dartPackageName,
+  }) {
+    final indent = Indent();
+    if (generatorOptions.copyrightHeader != null) {
+      addLines(indent, generatorOptions.copyrightHeader!, linePrefix: '// ');
+    }
+    indent.writeln('$_commentPrefix ${getGeneratedCodeWarning()}');
+    indent.writeln('$_commentPrefix $seeAlsoWarning');
+    indent.newln();
+    indent.writeln('#include "${generatorOptions.headerIncludePath}"');
+    indent.newln();
+    _writeSystemHeaderIncludeBlock(indent, <String>[
+      'flutter/binary_messenger.h',
+      'flutter/encodable_value.h',
+      'flutter/standard_message_codec.h',
+    ]);
+    indent.newln();
+    _writeSystemHeaderIncludeBlock(indent, <String>[
+      'chrono',
+      'cstdint',
+      'cstdio',
+      'cstdlib',
+      'map',
+      'memory',
+      'optional',
+      'random',
+      'string',
+      'vector',
+    ]);
+    indent.newln();
+    if (generatorOptions.namespace != null) {
+      indent.writeln('namespace ${generatorOptions.namespace} {');
+    }
+    indent.writeln('namespace {');
+    indent.newln();
+    _writeBenchmarkUtilities(indent);
+    indent.newln();
+
+    for (final Enum anEnum in root.enums) {
+      _writeFunctionDefinition(
+        indent,
+        'Random${anEnum.name}',
+        returnType: anEnum.name,
+        parameters: <String>['BenchRandom& rng'],
+        body: () {
+          indent.writeln(
+            'return static_cast<${anEnum.name}>(rng() % ${anEnum.members.length});',
+          );
+        },
+      );
+    }
+
+    final List<Class> classes = root.classes;
+    if (classes.isNotEmpty) {
+      for (final classDefinition in classes) {
+        _writeFunctionDeclaration(
+          indent,
+          'Random${classDefinition.name}',
+          returnType: classDefinition.name,
+          parameters: <String>['BenchRandom& rng', 'int depth'],
+        );
+      }
+      indent.newln();
+    }
+    for (final classDefinition in classes) {
+      _writeRandomClassFunction(indent, classDefinition);
+    }
+
+    final Iterable<AstHostApi> hostApis = root.apis.whereType<AstHostApi>();
+    for (final api in hostApis) {
+      _writeBenchmarkHostApi(indent, api);
+      indent.newln();
+    }
+
+    _writeFunctionDefinition(
+      indent,
+      'RunAllBenchmarks',
+      returnType: _voidType,
+      parameters: <String>['int iterations'],
+      body: () {
+        indent.writeln('BenchRandom rng(kSeed);');
+        indent.writeln(
+          'const flutter::StandardMessageCodec& codec = flutter::StandardMessageCodec::GetInstance(&$_codecSerializerName::GetInstance());',
+        );
+        for (final classDefinition in classes) {
+          indent.writeln(
+            'RunRoundTripBenchmark("${classDefinition.name}", iterations, codec, rng, ${_benchLambda('EncodableValue(CustomEncodableValue(Random${classDefinition.name}(rng, depth)))')});',
+          );
+        }
+        if (hostApis.isNotEmpty) {
+          indent.writeln('BenchBinaryMessenger messenger;');
+        }
+        for (final api in hostApis) {
+          final variableName = _snakeCaseFromCamelCase(api.name);
+          indent.writeln('Bench${api.name} $variableName(rng);');
+          indent.writeln('${api.name}::SetUp(&messenger, &$variableName);');
+          enumerate(api.methods, (int index, Method method) {
+            final String channelName = api.multiplexed
+                ? makeMultiplexedChannelName(api, dartPackageName)
+                : makeChannelName(api, method, dartPackageName);
+            final arguments = <String>[
+              if (api.multiplexed) 'EncodableValue($index)',
+              for (final Parameter parameter in method.parameters)
+                _benchEncodableExpression(parameter.type, depth: 'depth'),
+            ];
+            final String messageArguments = arguments.isEmpty
+                ? 'EncodableValue()'
+                : 'EncodableValue(EncodableList{${arguments.join(', ')}})';
+            indent.writeln(
+              'RunHostCallBenchmark("${api.name}.${method.name}", iterations, messenger, codec, "$channelName", rng, ${_benchLambda(messageArguments)});',
+            );
+          });
+        }
+      },
+    );
+    indent.writeln('}  // namespace');
+    if (generatorOptions.namespace != null) {
+      indent.writeln('}  // namespace ${generatorOptions.namespace}');
+    }
+    indent.newln();
+    final runAllBenchmarks = generatorOptions.namespace == null
+        ? 'RunAllBenchmarks'
+        : '${generatorOptions.namespace}::RunAllBenchmarks';
+    indent.format('''
+int main(int argc, char** argv) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 10000;
+  $runAllBenchmarks(iterations > 0 ? iterations : 1);
+  return 0;
+}''');
+    sink.write(indent.toString());
+  }
+
+  void _writeBenchmarkUtilities(Indent indent) {
+    indent.format('''
+using flutter::CustomEncodableValue;
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+using BenchRandom = std::mt19937_64;
+
+// Fixed seed so that runs are comparable with each other.
+constexpr uint64_t kSeed = 0x676f6c7562657473;
+// Number of randomized messages generated for each benchmark.
+constexpr size_t kSampleCount = 64;
+// Maximum nesting depth of randomized nullable fields and collections.
+constexpr int kMaxDepth = 3;
+// Maximum length of randomized strings, typed data and collections.
+constexpr size_t kMaxLength = 32;
+
+bool RandomBool(BenchRandom& rng) { return (rng() & 1) != 0; }
+
+int64_t RandomInt(BenchRandom& rng) { return static_cast<int64_t>(rng()); }
+
+double RandomDouble(BenchRandom& rng) {
+  return std::uniform_real_distribution<double>(-1e6, 1e6)(rng);
+}
+
+size_t RandomLength(BenchRandom& rng) { return rng() % (kMaxLength + 1); }
+
+// Returns whether a nullable value at [depth] should be populated.
+bool RandomPresent(BenchRandom& rng, int depth) {
+  return depth < kMaxDepth && RandomBool(rng);
+}
+
+std::string RandomString(BenchRandom& rng) {
+  std::string value(RandomLength(rng), 'a');
+  for (char& c : value) {
+    c = static_cast<char>('a' + rng() % 26);
+  }
+  return value;
+}
+
+template <typename T>
+std::vector<T> RandomVector(BenchRandom& rng) {
+  std::vector<T> value(RandomLength(rng));
+  for (T& element : value) {
+    element = static_cast<T>(rng());
+  }
+  return value;
+}
+
+EncodableValue RandomEncodableValue(BenchRandom& rng) {
+  switch (rng() % 4) {
+    case 0:
+      return EncodableValue(RandomBool(rng));
+    case 1:
+      return EncodableValue(RandomInt(rng));
+    case 2:
+      return EncodableValue(RandomDouble(rng));
+    default:
+      return EncodableValue(RandomString(rng));
+  }
+}
+
+template <typename F>
+EncodableList RandomList(BenchRandom& rng, int depth, F element) {
+  EncodableList value;
+  if (depth < kMaxDepth) {
+    const size_t length = RandomLength(rng);
+    value.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+      value.push_back(element(rng, depth + 1));
+    }
+  }
+  return value;
+}
+
+template <typename T, typename F>
+std::vector<T> RandomVectorOf(BenchRandom& rng, int depth, F element) {
+  std::vector<T> value;
+  if (depth < kMaxDepth) {
+    const size_t length = RandomLength(rng);
+    value.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+      value.push_back(element(rng, depth + 1));
+    }
+  }
+  return value;
+}
+
+template <typename K, typename V>
+EncodableMap RandomMap(BenchRandom& rng, int depth, K key, V value) {
+  EncodableMap map;
+  if (depth < kMaxDepth) {
+    const size_t length = RandomLength(rng);
+    for (size_t i = 0; i < length; i++) {
+      map.emplace(key(rng, depth + 1), value(rng, depth + 1));
+    }
+  }
+  return map;
+}
+
+// A BinaryMessenger that dispatches messages to registered handlers in-process,
+// standing in for the engine.
+class BenchBinaryMessenger : public flutter::BinaryMessenger {
+ public:
+  // Synchronously calls the handler registered for [channel] with [message],
+  // and returns the size of the reply.
+  size_t Dispatch(const std::string& channel,
+                  const std::vector<uint8_t>& message) {
+    size_t reply_size = 0;
+    handlers_.at(channel)(
+        message.data(), message.size(),
+        [&reply_size](const uint8_t*, size_t size) { reply_size = size; });
+    return reply_size;
+  }
+
+  // flutter::BinaryMessenger:
+  void Send(const std::string& channel, const uint8_t* message,
+            size_t message_size,
+            flutter::BinaryReply reply = nullptr) const override {}
+  void SetMessageHandler(const std::string& channel,
+                         flutter::BinaryMessageHandler handler) override {
+    if (handler) {
+      handlers_[channel] = std::move(handler);
+    } else {
+      handlers_.erase(channel);
+    }
+  }
+
+ private:
+  std::map<std::string, flutter::BinaryMessageHandler> handlers_;
+};
+
+// Calls [body] [iterations] times and prints the mean time and bytes per call.
+template <typename F>
+void RunBenchmark(const std::string& name, int iterations, F body) {
+  size_t bytes = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    bytes += body(static_cast<size_t>(i) % kSampleCount);
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  std::printf("%-64s %10d iterations %12.1f ns/op %10.1f bytes/op\\n",
+              name.c_str(), iterations,
+              static_cast<double>(elapsed.count()) / iterations,
+              static_cast<double>(bytes) / iterations);
+}
+
+// Benchmarks encoding and decoding values created by [make_sample].
+template <typename F>
+void RunRoundTripBenchmark(const std::string& name, int iterations,
+                           const flutter::StandardMessageCodec& codec,
+                           BenchRandom& rng, F make_sample) {
+  std::vector<EncodableValue> samples;
+  for (size_t i = 0; i < kSampleCount; i++) {
+    samples.push_back(make_sample(rng, 0));
+  }
+  RunBenchmark(name + " round trip", iterations, [&](size_t i) {
+    std::unique_ptr<std::vector<uint8_t>> encoded =
+        codec.EncodeMessage(samples[i]);
+    std::unique_ptr<EncodableValue> decoded = codec.DecodeMessage(*encoded);
+    return decoded ? encoded->size() : 0;
+  });
+}
+
+// Benchmarks dispatching messages created by [make_arguments] to the host API
+// handler registered for [channel].
+template <typename F>
+void RunHostCallBenchmark(const std::string& name, int iterations,
+                          BenchBinaryMessenger& messenger,
+                          const flutter::StandardMessageCodec& codec,
+                          const std::string& channel, BenchRandom& rng,
+                          F make_arguments) {
+  std::vector<std::vector<uint8_t>> messages;
+  for (size_t i = 0; i < kSampleCount; i++) {
+    messages.push_back(*codec.EncodeMessage(make_arguments(rng, 0)));
+  }
+  RunBenchmark(name + " host call", iterations, [&](size_t i) {
+    return messages[i].size() + messenger.Dispatch(channel, messages[i]);
+  });
+}''');
+  }
+
+  void _writeRandomClassFunction(Indent indent, Class classDefinition) {
+    final List<NamedType> fields = getFieldsInSerializationOrder(
+      classDefinition,
+    ).toList();
+    final String usedExpressions = fields
+        .map(
+          (NamedType field) => field.type.isNullable
+              ? 'RandomPresent(rng, depth)'
+              : _benchValueExpression(field.type, depth: 'depth'),
+        )
+        .join(' ');
+    _writeFunctionDefinition(
+      indent,
+      'Random${classDefinition.name}',
+      returnType: classDefinition.name,
+      parameters: _benchParameters(usedExpressions),
+      body: () {
+        final arguments = <String>[];
+        for (final NamedType field in fields) {
+          final String name = _makeVariableName(field);
+          final HostDatatype hostType = _cppFieldHostDatatype(
+            field,
+            _shortBaseCppTypeForBuiltinDartType,
+          );
+          final String value = _benchValueExpression(
+            field.type,
+            depth: 'depth',
+          );
+          if (field.type.isNullable) {
+            indent.writeln('std::optional<${hostType.datatype}> $name;');
+            indent.writeScoped('if (RandomPresent(rng, depth)) {', '}', () {
+              indent.writeln('$name = $value;');
+            });
+            arguments.add('$name ? &*$name : nullptr');
+          } else {
+            indent.writeln('const ${hostType.datatype} $name = $value;');
+            arguments.add(name);
+          }
+        }
+        indent.writeln(
+          'return ${classDefinition.name}(${arguments.join(', ')});',
+        );
+      },
+    );
+  }
+
+  void _writeBenchmarkHostApi(Indent indent, AstHostApi api) {
+    String returnVariableName(Method method) =>
+        '${_snakeCaseFromCamelCase(method.name)}_return_';
+    final Iterable<Method> valueMethods = api.methods.where(
+      (Method method) => !method.returnType.isVoid,
+    );
+
+    indent.writeln(
+      '$_commentPrefix An implementation of ${api.name} that replies with randomized values.',
+    );
+    indent.write('class Bench${api.name} : public ${api.name} ');
+    indent.addScoped('{', '};', () {
+      _writeAccessBlock(indent, _ClassAccess.public, () {
+        final String rngParameter = valueMethods.isEmpty
+            ? 'BenchRandom&'
+            : 'BenchRandom& rng';
+        indent.write('explicit Bench${api.name}($rngParameter) ');
+        indent.addScoped('{', '}', () {
+          for (final Method method in valueMethods) {
+            indent.writeln(
+              '${returnVariableName(method)} = ${_benchValueExpression(method.returnType, depth: '0')};',
+            );
+          }
+        });
+        for (final Method method in api.methods) {
+          final HostDatatype returnType = _cppHostDatatype(
+            method.returnType,
+            _baseCppTypeForBuiltinDartType,
+          );
+          final String returnTypeName = _hostApiReturnType(returnType);
+          final List<String> parameters = method.parameters.map((
+            NamedType arg,
+          ) {
+            final String argType = _hostApiArgumentType(
+              _cppFieldHostDatatype(arg, _baseCppTypeForBuiltinDartType),
+            );
+            return '$argType ${_makeVariableName(arg)}';
+          }).toList();
+          final String returnValue;
+          if (method.returnType.isVoid) {
+            returnValue = 'std::nullopt';
+          } else if (method.returnType.isNullable) {
+            returnValue = returnVariableName(method);
+          } else {
+            returnValue = '*${returnVariableName(method)}';
+          }
+          if (method.isAsynchronous) {
+            parameters.add('std::function<void($returnTypeName reply)> result');
+          }
+          _writeFunction(
+            indent,
+            _FunctionOutputType.definition,
+            name: _makeMethodName(method),
+            returnType: method.isAsynchronous ? _voidType : returnTypeName,
+            parameters: parameters,
+            trailingAnnotations: <String>['override'],
+            body: () {
+              if (method.isAsynchronous) {
+                indent.writeln('result($returnValue);');
+              } else {
+                indent.writeln('return $returnValue;');
+              }
+            },
+          );
+        }
+      });
+      if (valueMethods.isNotEmpty) {
+        _writeAccessBlock(indent, _ClassAccess.private, () {
+          for (final Method method in valueMethods) {
+            final HostDatatype returnType = _cppHostDatatype(
+              method.returnType,
+              _shortBaseCppTypeForBuiltinDartType,
+            );
+            indent.writeln(
+              'std::optional<${returnType.datatype}> ${returnVariableName(method)};',
+            );
+          }
+        });
+      }
+    }, nestCount: 0);
+  }
+
+  /// [_baseCppTypeForBuiltinDartType] without the `flutter::` namespace, which
+  /// the benchmark imports with using directives.
+  String? _shortBaseCppTypeForBuiltinDartType(TypeDeclaration type) {
+    return _baseCppTypeForBuiltinDartType(type, includeFlutterNamespace: false);
+  }
+
+  /// Returns an expression that creates a random non-null value of the host
+  /// type used for [type].
+  String _benchValueExpression(TypeDeclaration type, {required String depth}) {
+    final Class? packedClass = _packedListClass(type);
+    if (packedClass != null) {
+      return 'RandomVectorOf<${packedClass.name}>(rng, $depth, Random${packedClass.name})';
+    } else if (type.isClass) {
+      return 'Random${type.baseName}(rng, $depth + 1)';
+    } else if (type.isEnum) {
+      return 'Random${type.baseName}(rng)';
+    }
+    switch (type.baseName) {
+      case 'bool':
+        return 'RandomBool(rng)';
+      case 'int':
+        return 'RandomInt(rng)';
+      case 'double':
+        return 'RandomDouble(rng)';
+      case 'String':
+        return 'RandomString(rng)';
+      case 'Uint8List':
+        return 'RandomVector<uint8_t>(rng)';
+      case 'Int32List':
+        return 'RandomVector<int32_t>(rng)';
+      case 'Int64List':
+        return 'RandomVector<int64_t>(rng)';
+      case 'Float64List':
+        return 'RandomVector<double>(rng)';
+      case 'List':
+        final String element = type.typeArguments.isEmpty
+            ? _benchLambda('RandomEncodableValue(rng)')
+            : _benchElementFunction(type.typeArguments[0]);
+        return 'RandomList(rng, $depth, $element)';
+      case 'Map':
+        final String key = type.typeArguments.isEmpty
+            ? _benchLambda('RandomEncodableValue(rng)')
+            : _benchElementFunction(type.typeArguments[0]);
+        final String value = type.typeArguments.length < 2
+            ? _benchLambda('RandomEncodableValue(rng)')
+            : _benchElementFunction(type.typeArguments[1]);
+        return 'RandomMap(rng, $depth, $key, $value)';
+      default:
+        return 'RandomEncodableValue(rng)';
+    }
+  }
+
+  /// Returns an expression that creates a random `EncodableValue` holding a
+  /// value of [type], encoded the way the generated Dart code encodes it.
+  String _benchEncodableExpression(
+    TypeDeclaration type, {
+    required String depth,
+  }) {
+    final String value = _benchValueExpression(type, depth: depth);
+    final String encodable;
+    if (type.isClass || type.isEnum || _packedListClass(type) != null) {
+      encodable = 'EncodableValue(CustomEncodableValue($value))';
+    } else if (type.baseName == 'Object') {
+      encodable = value;
+    } else {
+      encodable = 'EncodableValue($value)';
+    }
+    return type.isNullable
+        ? 'RandomPresent(rng, $depth) ? $encodable : EncodableValue()'
+        : encodable;
+  }
+
+  /// Returns a lambda that creates random collection elements of [type].
+  String _benchElementFunction(TypeDeclaration type) {
+    return _benchLambda(_benchEncodableExpression(type, depth: 'depth'));
+  }
+
+  /// Returns a lambda taking `rng` and `depth` that returns [expression].
+  String _benchLambda(String expression) {
+    return '[](${_benchParameters(expression).join(', ')}) { return $expression; }';
+  }
+
+  /// Returns the parameters of a function taking `rng` and `depth`, leaving
+  /// unnamed those that [body] does not use.
+  List<String> _benchParameters(String body) {
+    return <String>[
+      if (RegExp(r'\brng\b').hasMatch(body))
+        'BenchRandom& rng'
+      else
+        'BenchRandom&',
+      if (RegExp(r'\bdepth\b').hasMatch(body)) 'int depth' else 'int',
+    ];
+  }
+}
+
 /// Contains information about a host function argument.
 ///
 /// This is comparable to a [NamedType], but has already gone through host type
@@ -2144,6 +5601,155 @@ String _pascalCaseFromSnakeCase(String snakeCase) {
 
 String _makeMethodName(Method method) => _pascalCaseFromCamelCase(method.name);
 
+// Whether any host method in [root] sends its reply in frames.
+bool _hasChunkedReplies(Root root) => root.apis.any(
+  (Api api) => api is AstHostApi && api.methods.any(isChunkedMethod),
+);
+
+// Whether any class in [root] holds the columns of a `@Columnar()` class.
+bool _hasColumnsClasses(Root root) => root.classes.any(
+  (Class classDefinition) => classDefinition.columnsOf != null,
+);
+
+// Returns the custom type byte that the unboxed enum [type] is sent with, or 0
+// if [type] is not an enum sent without its wrapper.
+int _unboxedEnumTypeId(Root root, TypeDeclaration type) {
+  if (!type.isEnum) {
+    return 0;
+  }
+  final EnumeratedType enumType = getEnumeratedTypes(
+    root,
+    excludeSealedClasses: true,
+  ).firstWhere((EnumeratedType t) => t.associatedEnum == type.associatedEnum);
+  // Overflow enums are written through the wrapper class.
+  return enumType.enumeration < maximumCodecFieldKey ? enumType.enumeration : 0;
+}
+
+// Whether the channel of host [method] uses UnboxedEnumCodec. Multiplexed and
+// chunked channels have their own framing, so they keep the wrapped enums.
+bool _hasUnboxedEnums(
+  InternalCppOptions generatorOptions,
+  Root root,
+  Api api,
+  Method method,
+) {
+  return generatorOptions.unboxedEnums &&
+      api is AstHostApi &&
+      !api.multiplexed &&
+      !isChunkedMethod(method) &&
+      (_unboxedEnumTypeId(root, method.returnType) != 0 ||
+          method.parameters.any(
+            (Parameter parameter) =>
+                _unboxedEnumTypeId(root, parameter.type) != 0,
+          ));
+}
+
+// Whether any host method channel uses UnboxedEnumCodec.
+bool _hasUnboxedEnumMethods(InternalCppOptions generatorOptions, Root root) {
+  return root.apis.any(
+    (Api api) => api.methods.any(
+      (Method method) => _hasUnboxedEnums(generatorOptions, root, api, method),
+    ),
+  );
+}
+
+// Returns the codec that generated message channels are created with.
+String _channelCodec(InternalCppOptions generatorOptions) =>
+    generatorOptions.encodedSizes
+    ? '&ReservingMessageCodec::GetInstance()'
+    : generatorOptions.parallelEncodeThreshold != null
+    ? '&ParallelMessageCodec::GetInstance()'
+    : '&GetCodec()';
+
+// Whether encoding a value of [type] may pad to an alignment, which the
+// parallel encode can't do. [visiting] holds the classes being checked, so
+// that recursive classes end.
+bool _mayAlign(TypeDeclaration type, Set<Class> visiting) {
+  if (type.isEnum) {
+    return false;
+  } else if (type.isClass) {
+    return _classMayAlign(type.associatedClass!, visiting);
+  }
+  return switch (type.baseName) {
+    'bool' || 'int' || 'String' || 'Uint8List' => false,
+    'List' || 'Map' =>
+      type.typeArguments.isEmpty ||
+          type.typeArguments.any(
+            (TypeDeclaration argument) => _mayAlign(argument, visiting),
+          ),
+    _ => true,
+  };
+}
+
+// Whether encoding an instance of [classDefinition] may pad to an alignment.
+bool _classMayAlign(Class classDefinition, Set<Class> visiting) {
+  // Packed records are written as raw bytes, and a class already being
+  // checked is decided by its other fields.
+  if (classDefinition.isPacked || !visiting.add(classDefinition)) {
+    return false;
+  }
+  return classDefinition.fields.any(
+    (NamedType field) => _mayAlign(field.type, visiting),
+  );
+}
+
+// Whether any class in [root] is encoded as a packed record.
+bool _hasPackedClasses(Root root) => root.classes.any(
+  (Class classDefinition) => classDefinition.isPacked,
+);
+
+// Whether lists of [customType] are written as one array of records.
+bool _isPackedListType(EnumeratedType customType) =>
+    customType.enumeration < maximumCodecFieldKey &&
+    (customType.associatedClass?.isPacked ?? false);
+
+// Returns the class of [type] if it is a list of a packed class, which the
+// host holds as a `std::vector` of the class.
+Class? _packedListClass(TypeDeclaration type) {
+  if (type.baseName != 'List' || type.typeArguments.length != 1) {
+    return null;
+  }
+  final TypeDeclaration element = type.typeArguments.first;
+  return element.isClass &&
+          !element.isNullable &&
+          element.associatedClass!.isPacked
+      ? element.associatedClass
+      : null;
+}
+
+// Returns the [HostDatatype] of [type], which for a list of a packed class is
+// a `std::vector` of the class held in a CustomEncodableValue.
+HostDatatype _cppHostDatatype(
+  TypeDeclaration type,
+  String? Function(TypeDeclaration) builtinResolver,
+) {
+  final Class? packedClass = _packedListClass(type);
+  if (packedClass != null) {
+    return HostDatatype(
+      datatype: 'std::vector<${packedClass.name}>',
+      isBuiltin: false,
+      isNullable: type.isNullable,
+      isEnum: false,
+    );
+  }
+  return getHostDatatype(type, builtinResolver);
+}
+
+// Returns the [HostDatatype] of [field], as [_cppHostDatatype] does.
+HostDatatype _cppFieldHostDatatype(
+  NamedType field,
+  String? Function(TypeDeclaration) builtinResolver,
+) {
+  return _packedListClass(field.type) != null
+      ? _cppHostDatatype(field.type, builtinResolver)
+      : getFieldHostDatatype(field, builtinResolver);
+}
+
+// Whether any class in [root] is streamed through a ring buffer.
+bool _hasRingBuffers(Root root) => root.classes.any(
+  (Class classDefinition) => classDefinition.ringBufferCapacity != null,
+);
+
 String _makeGetterName(NamedType field) => _snakeCaseFromCamelCase(field.name);
 
 String _makeSetterName(NamedType field) =>
@@ -222,12 +222,28 @@ class DartGenerator extends StructuredGenerator<InternalDartOptions> {
     required String dartPackageName,
   }) {
     indent.writeln("import 'dart:async';");
+    if (_usesCompactStrings(root) || _usesFfiSync(root)) {
+      indent.writeln("import 'dart:convert' show utf8;");
+    }
+    if (_usesFfiSync(root) || _usesRingBuffers(root) || _usesLargeBlobs(root)) {
+      indent.writeln("import 'dart:ffi' as ffi;");
+    }
     if (root.containsProxyApi) {
       indent.writeln("import 'dart:io' show Platform;");
     }
-    indent.writeln(
-      "import 'dart:typed_data' show Float64List, Int32List, Int64List;",
-    );
+    if (_usesChunkedReplies(root)) {
+      indent.writeln(
+        "import 'dart:typed_data' show ByteData, BytesBuilder, Endian, Float64List, Int32List, Int64List, Uint8List;",
+      );
+    } else if (_usesPackedClasses(root)) {
+      indent.writeln(
+        "import 'dart:typed_data' show ByteData, Endian, Float64List, Int32List, Int64List, Uint8List;",
+      );
+    } else {
+      indent.writeln(
+        "import 'dart:typed_data' show Float64List, Int32List, Int64List;",
+      );
+    }
     indent.newln();
 
     indent.writeln("import 'package:flutter/services.dart';");
@@ -340,6 +356,16 @@ class DartGenerator extends StructuredGenerator<InternalDartOptions> {
         classDefinition,
         dartPackageName: dartPackageName,
       );
+      if (classDefinition.isCompact) {
+        indent.newln();
+        _writeCompactEncode(indent, classDefinition);
+        indent.newln();
+        _writeCompactDecode(indent, classDefinition);
+      }
+      if (classDefinition.columnsOf != null) {
+        indent.newln();
+        _writeColumnsRows(indent, classDefinition);
+      }
       indent.newln();
       writeClassEquality(
         generatorOptions,
@@ -349,6 +375,362 @@ class DartGenerator extends StructuredGenerator<InternalDartOptions> {
         dartPackageName: dartPackageName,
       );
     });
+    if (classDefinition.isPacked) {
+      _writePackedLayout(indent, classDefinition);
+    }
+    if (classDefinition.ringBufferCapacity != null) {
+      _writeRingBufferReader(
+        indent,
+        classDefinition,
+        dartPackageName: dartPackageName,
+      );
+    }
+  }
+
+  /// Writes the functions that convert the columns class [classDefinition]
+  /// from and to a list of rows.
+  void _writeColumnsRows(Indent indent, Class classDefinition) {
+    final String name = classDefinition.name;
+    final String rowName = classDefinition.columnsOf!.name;
+    final List<NamedType> fields = classDefinition.fields;
+    bool isBool(NamedType field) => field.type.baseName == 'Uint8List';
+    final String columns = fields
+        .map(
+          (NamedType field) =>
+              '\t\t\t${field.name}: ${field.type.baseName}(rows.length),',
+        )
+        .join('\n');
+    final String assignments = fields
+        .map(
+          (NamedType field) => isBool(field)
+              ? '\t\t\tcolumns.${field.name}[index] = row.${field.name} ? 1 : 0;'
+              : '\t\t\tcolumns.${field.name}[index] = row.${field.name};',
+        )
+        .join('\n');
+    final String rowCount = fields.length == 1
+        ? '${fields.single.name}.length'
+        : '<int>[${fields.map((NamedType field) => '${field.name}.length').join(', ')}].reduce((int a, int b) => a < b ? a : b)';
+    final String rowArguments = fields
+        .map(
+          (NamedType field) => isBool(field)
+              ? '${field.name}: ${field.name}[index] != 0'
+              : '${field.name}: ${field.name}[index]',
+        )
+        .join(', ');
+    indent.format('''
+/// Transposes [rows] into columns.
+factory $name.fromRows(List<$rowName> rows) {
+\tfinal $name columns = $name(
+$columns
+\t);
+\tfor (int index = 0; index < rows.length; index++) {
+\t\tfinal $rowName row = rows[index];
+$assignments
+\t}
+\treturn columns;
+}
+
+/// The number of rows, which is the length of the shortest column.
+int get rowCount => $rowCount;
+
+/// Returns the rows the columns hold.
+List<$rowName> toRows() {
+\treturn List<$rowName>.generate(
+\t\trowCount,
+\t\t(int index) => $rowName($rowArguments),
+\t);
+}''');
+  }
+
+  /// Writes the class that copies [classDefinition] to and from the records
+  /// the host reads as a struct.
+  void _writePackedLayout(Indent indent, Class classDefinition) {
+    final String name = classDefinition.name;
+    final ({List<int> offsets, int size}) layout = getPackedLayout(
+      classDefinition,
+    );
+    String offset(int index) => layout.offsets[index] == 0
+        ? 'offset'
+        : 'offset + ${layout.offsets[index]}';
+    final String writes = classDefinition.fields.indexed
+        .map(((int, NamedType) field) {
+          final String at = offset(field.$1);
+          final String value = 'value.${field.$2.name}';
+          return switch (field.$2.type.baseName) {
+            'bool' => '\t\tdata.setUint8($at, $value ? 1 : 0);',
+            'int' => '\t\tdata.setInt64($at, $value, Endian.little);',
+            _ => '\t\tdata.setFloat64($at, $value, Endian.little);',
+          };
+        })
+        .join('\n');
+    final String reads = classDefinition.fields.indexed
+        .map(((int, NamedType) field) {
+          final String at = offset(field.$1);
+          final String value = switch (field.$2.type.baseName) {
+            'bool' => 'data.getUint8($at) != 0',
+            'int' => 'data.getInt64($at, Endian.little)',
+            _ => 'data.getFloat64($at, Endian.little)',
+          };
+          return '\t\t\t${field.$2.name}: $value,';
+        })
+        .join('\n');
+    indent.newln();
+    indent.format('''
+/// The packed records of [$name], which the host copies to and from a struct.
+abstract final class _${name}Packed {
+\tstatic const int size = ${layout.size};
+
+\tstatic Uint8List encode(List<$name> values) {
+\t\tfinal ByteData data = ByteData(values.length * size);
+\t\tfor (int index = 0; index < values.length; index++) {
+\t\t\twrite(data, index * size, values[index]);
+\t\t}
+\t\treturn data.buffer.asUint8List();
+\t}
+
+\tstatic List<$name> decode(Uint8List bytes) {
+\t\tfinal ByteData data = ByteData.sublistView(bytes);
+\t\treturn List<$name>.generate(
+\t\t\tbytes.length ~/ size,
+\t\t\t(int index) => read(data, index * size),
+\t\t);
+\t}
+
+\tstatic void write(ByteData data, int offset, $name value) {
+$writes
+\t}
+
+\tstatic $name read(ByteData data, int offset) {
+\t\treturn $name(
+$reads
+\t\t);
+\t}
+}''');
+  }
+
+  /// Writes the struct mirroring the ring buffer records of [classDefinition]
+  /// and the class that reads them from shared memory.
+  void _writeRingBufferReader(
+    Indent indent,
+    Class classDefinition, {
+    required String dartPackageName,
+  }) {
+    final String name = classDefinition.name;
+    const library = '${varNamePrefix}library';
+    String symbol(String function) =>
+        makeRingBufferSymbolName(classDefinition, function, dartPackageName);
+    final String recordFields = classDefinition.fields
+        .map((NamedType field) {
+          final String nativeType = switch (field.type.baseName) {
+            'bool' => 'Bool',
+            'int' => 'Int64',
+            _ => 'Double',
+          };
+          return '\t@ffi.$nativeType()\n'
+              '\texternal ${field.type.baseName} ${field.name};';
+        })
+        .join('\n\n');
+    final String recordArguments = classDefinition.fields
+        .map((NamedType field) => '${field.name}: record.${field.name}')
+        .join(', ');
+    const wakeupPointer =
+        'ffi.Pointer<ffi.NativeFunction<ffi.Void Function()>>';
+
+    indent.newln();
+    indent.format('''
+final class _${name}RingRecord extends ffi.Struct {
+$recordFields
+}
+
+/// Reads the [$name] records the host pushes into the ring buffer shared with
+/// it, from one isolate only.
+class ${name}RingBuffer {
+\t${name}RingBuffer._();
+
+\t/// The number of records the ring holds.
+\tstatic const int capacity = ${classDefinition.ringBufferCapacity};
+
+\tstatic final ffi.DynamicLibrary $library = ffi.DynamicLibrary.process();
+
+\tstatic final ffi.Pointer<_${name}RingRecord> ${varNamePrefix}records = $library.lookupFunction<ffi.Pointer<_${name}RingRecord> Function(), ffi.Pointer<_${name}RingRecord> Function()>('${symbol('records')}')();
+
+\tstatic final int Function() ${varNamePrefix}acquire = $library.lookupFunction<ffi.Uint64 Function(), int Function()>('${symbol('acquire')}');
+
+\tstatic final void Function(int) ${varNamePrefix}release = $library.lookupFunction<ffi.Void Function(ffi.Uint64), void Function(int)>('${symbol('release')}');
+
+\tstatic final void Function($wakeupPointer) ${varNamePrefix}setWakeup = $library.lookupFunction<ffi.Void Function($wakeupPointer), void Function($wakeupPointer)>('${symbol('set_wakeup')}');
+
+\tstatic int ${varNamePrefix}tail = $library.lookupFunction<ffi.Uint64 Function(), int Function()>('${symbol('tail')}')();
+
+\tstatic void Function()? ${varNamePrefix}onWakeup;
+
+\t// Never closed, since the host may call it at any time.
+\tstatic final ffi.NativeCallable<ffi.Void Function()> ${varNamePrefix}wakeup = ffi.NativeCallable<ffi.Void Function()>.listener(() => ${varNamePrefix}onWakeup?.call())..keepIsolateAlive = false;
+
+\t/// Whether the host exports the ring, which only the C++ and GObject output
+\t/// do.
+\tstatic bool get isAvailable => $library.providesSymbol('${symbol('records')}');
+
+\t/// Calls [onRecord] with each record pushed since the last call, and returns
+\t/// how many there were.
+\tstatic int drain(void Function($name value) onRecord) {
+\t\tfinal int head = ${varNamePrefix}acquire();
+\t\tfinal int tail = ${varNamePrefix}tail;
+\t\tfor (var position = tail; position != head; position++) {
+\t\t\tfinal _${name}RingRecord record = ${varNamePrefix}records[position & (capacity - 1)];
+\t\t\tonRecord($name($recordArguments));
+\t\t}
+\t\tif (head != tail) {
+\t\t\t${varNamePrefix}tail = head;
+\t\t\t${varNamePrefix}release(head);
+\t\t}
+\t\treturn head - tail;
+\t}
+
+\t/// Emits the records pushed by the host in batches.
+\t///
+\t/// The host only wakes the isolate up after it has drained the ring, so
+\t/// records pushed while batches are being read cost no messages.
+\tstatic Stream<List<$name>> batches() {
+\t\tlate final StreamController<List<$name>> controller;
+\t\tvoid read() {
+\t\t\tif (!controller.hasListener) {
+\t\t\t\treturn;
+\t\t\t}
+\t\t\tfinal records = <$name>[];
+\t\t\tif (drain(records.add) > 0) {
+\t\t\t\tcontroller.add(records);
+\t\t\t\t// Keep reading until the ring is empty, which asks for a wakeup.
+\t\t\t\tTimer.run(read);
+\t\t\t}
+\t\t}
+
+\t\tcontroller = StreamController<List<$name>>(
+\t\t\tonListen: () {
+\t\t\t\t${varNamePrefix}onWakeup = read;
+\t\t\t\t${varNamePrefix}setWakeup(${varNamePrefix}wakeup.nativeFunction);
+\t\t\t\tread();
+\t\t\t},
+\t\t\tonCancel: () {
+\t\t\t\t${varNamePrefix}onWakeup = null;
+\t\t\t},
+\t\t);
+\t\treturn controller.stream;
+\t}
+}
+''');
+  }
+
+  void _writeCompactEncode(Indent indent, Class classDefinition) {
+    final List<NamedType> fields = getFieldsInSerializationOrder(
+      classDefinition,
+    ).toList();
+    final List<NamedType> nullableFields = fields
+        .where((NamedType field) => field.type.isNullable)
+        .toList();
+    indent.writeScoped('void encodeCompact(WriteBuffer buffer) {', '}', () {
+      for (var i = 0; i < nullableFields.length; i += 8) {
+        final String presentBits = nullableFields
+            .skip(i)
+            .take(8)
+            .indexed
+            .map(
+              ((int, NamedType) bit) =>
+                  '(${bit.$2.name} != null ? ${1 << bit.$1} : 0)',
+            )
+            .join(' | ');
+        indent.writeln('buffer.putUint8($presentBits);');
+      }
+      for (final field in fields) {
+        if (field.type.isNullable) {
+          indent.writeScoped('if (${field.name} != null) {', '}', () {
+            _writeCompactFieldEncode(indent, field.type, '${field.name}!');
+          });
+        } else {
+          _writeCompactFieldEncode(indent, field.type, field.name);
+        }
+      }
+    });
+  }
+
+  void _writeCompactFieldEncode(
+    Indent indent,
+    TypeDeclaration type,
+    String value,
+  ) {
+    if (type.isClass) {
+      indent.writeln('$value.encodeCompact(buffer);');
+    } else if (type.isEnum) {
+      indent.writeln('_writeCompactVarint(buffer, $value.index);');
+    } else if (type.baseName == 'bool') {
+      indent.writeln('buffer.putUint8($value ? 1 : 0);');
+    } else if (type.baseName == 'int') {
+      indent.writeln('_writeCompactVarint(buffer, $value);');
+    } else if (type.baseName == 'double') {
+      indent.writeln('buffer.putFloat64($value);');
+    } else if (type.baseName == 'String') {
+      indent.writeln('_writeCompactString(buffer, $value);');
+    } else {
+      indent.writeln('_writeCompactVarint(buffer, $value.length);');
+      final String typedList = _toTypedList(type, value);
+      indent.writeln('buffer.put${type.baseName}($typedList);');
+    }
+  }
+
+  void _writeCompactDecode(Indent indent, Class classDefinition) {
+    final List<NamedType> fields = getFieldsInSerializationOrder(
+      classDefinition,
+    ).toList();
+    final List<NamedType> nullableFields = fields
+        .where((NamedType field) => field.type.isNullable)
+        .toList();
+    indent.writeScoped(
+      'static ${classDefinition.name} decodeCompact(ReadBuffer buffer) {',
+      '}',
+      () {
+        for (var i = 0; i < (nullableFields.length + 7) ~/ 8; i++) {
+          indent.writeln('final int present$i = buffer.getUint8();');
+        }
+        // Arguments are evaluated in order, so the fields are read in the
+        // order they were written.
+        indent.write('return ${classDefinition.name}');
+        indent.addScoped('(', ');', () {
+          for (final field in fields) {
+            final String value = _compactFieldDecode(field.type);
+            if (field.type.isNullable) {
+              final int index = nullableFields.indexOf(field);
+              indent.writeln(
+                '${field.name}: (present${index ~/ 8} & ${1 << (index % 8)}) != 0 ? $value : null,',
+              );
+            } else {
+              indent.writeln('${field.name}: $value,');
+            }
+          }
+        });
+      },
+    );
+  }
+
+  String _compactFieldDecode(TypeDeclaration type) {
+    if (type.isClass) {
+      return '${type.baseName}.decodeCompact(buffer)';
+    } else if (type.isEnum) {
+      return '${type.baseName}.values[_readCompactVarint(buffer)]';
+    } else if (type.baseName == 'bool') {
+      return 'buffer.getUint8() != 0';
+    } else if (type.baseName == 'int') {
+      return '_readCompactVarint(buffer)';
+    } else if (type.baseName == 'double') {
+      return 'buffer.getFloat64()';
+    } else if (type.baseName == 'String') {
+      return '_readCompactString(buffer)';
+    } else {
+      return _fromTypedList(
+        type,
+        'buffer.get${type.baseName}(_readCompactVarint(buffer))',
+        isNullable: false,
+      );
+    }
   }
 
   void _writeConstructor(Indent indent, Class classDefinition) {
@@ -387,7 +769,28 @@ class DartGenerator extends StructuredGenerator<InternalDartOptions> {
         for (final NamedType field in getFieldsInSerializationOrder(
           classDefinition,
         )) {
-          indent.writeln('${field.name},');
+          final Class? packedClass = _packedListClass(field.type);
+          if (packedClass != null) {
+            final String packedList = _toPackedList(
+              packedClass,
+              field.type.isNullable ? '${field.name}!' : field.name,
+            );
+            indent.writeln(
+              field.type.isNullable
+                  ? '${field.name} == null ? null : $packedList,'
+                  : '$packedList,',
+            );
+          } else if (field.type.typedListOf == null) {
+            indent.writeln('${field.name},');
+          } else if (field.type.isNullable) {
+            final String typedList = _toTypedList(
+              field.type,
+              '${field.name}!',
+            );
+            indent.writeln('${field.name} == null ? null : $typedList,');
+          } else {
+            indent.writeln('${_toTypedList(field.type, field.name)},');
+          }
         }
       });
     });
@@ -435,7 +838,13 @@ class DartGenerator extends StructuredGenerator<InternalDartOptions> {
           final NamedType field,
         ) {
           indent.write('${field.name}: ');
-          indent.add(_castValue('result[$index]', field.type));
+          indent.add(
+            _fromTypedList(
+              field.type,
+              _castValue('result[$index]', field.type),
+              isNullable: field.type.isNullable,
+            ),
+          );
           indent.addln(',');
         });
       });
@@ -487,6 +896,24 @@ class DartGenerator extends StructuredGenerator<InternalDartOptions> {
           ? ' && value.runtimeType == ${customType.name}<${_flattenTypeArguments(customType.typeArguments)}>'
           : '';
 
+      if (customType.offset(nonSerializedClassCount) < maximumCodecFieldKey &&
+          (customType.associatedClass?.isPacked ?? false)) {
+        indent.writeScoped(
+          'else if (value is _PackedList<${customType.name}>) {',
+          '}',
+          () {
+            indent.writeln(
+              'buffer.putUint8(${customType.offset(nonSerializedClassCount)});',
+            );
+            indent.writeln('buffer.putUint8(1);');
+            indent.writeln('writeSize(buffer, value.values.length);');
+            indent.writeln(
+              'buffer.putUint8List(_${customType.name}Packed.encode(value.values));',
+            );
+          },
+          addTrailingNewline: false,
+        );
+      }
       indent.writeScoped(
         'else if (value is ${customType.name}$typeArgumentsCheck) {',
         '}',
@@ -496,7 +923,14 @@ class DartGenerator extends StructuredGenerator<InternalDartOptions> {
             indent.writeln(
               'buffer.putUint8(${customType.offset(nonSerializedClassCount)});',
             );
-            if (customType.type == CustomTypes.customClass) {
+            if (customType.associatedClass?.isCompact ?? false) {
+              indent.writeln('value.encodeCompact(buffer);');
+            } else if (customType.associatedClass?.isPacked ?? false) {
+              indent.writeln('buffer.putUint8(0);');
+              indent.writeln(
+                'buffer.putUint8List(_${customType.name}Packed.encode(<${customType.name}>[value]));',
+              );
+            } else if (customType.type == CustomTypes.customClass) {
               indent.writeln('writeValue(buffer, value.encode());');
             } else if (customType.type == CustomTypes.customEnum) {
               indent.writeln('writeValue(buffer, value.index);');
@@ -531,6 +965,16 @@ class DartGenerator extends StructuredGenerator<InternalDartOptions> {
               'final $baseName wrapper = $baseName.decode(readValue(buffer)!);',
             );
             indent.writeln('return wrapper.unwrap();');
+          } else if (customType.associatedClass?.isCompact ?? false) {
+            indent.writeln('return ${customType.name}.decodeCompact(buffer);');
+          } else if (customType.associatedClass?.isPacked ?? false) {
+            final String name = customType.name;
+            indent.writeln('final bool isList = buffer.getUint8() == 1;');
+            indent.writeln('final int count = isList ? readSize(buffer) : 1;');
+            indent.writeln(
+              'final List<$name> values = _${name}Packed.decode(buffer.getUint8List(count * _${name}Packed.size));',
+            );
+            indent.writeln('return isList ? values : values.single;');
           } else {
             final String name = customType.name;
             final typeArguments = customType.isGeneric
@@ -776,7 +1220,8 @@ final BinaryMessenger? ${varNamePrefix}binaryMessenger;
       indent.newln();
       indent.writeln('final String $_suffixVarName;');
       indent.newln();
-      for (final Method func in api.methods) {
+      final bool multiplexed = isMultiplexedApi(api);
+      enumerate(api.methods, (int index, Method func) {
         if (!first) {
           indent.newln();
         } else {
@@ -788,10 +1233,112 @@ final BinaryMessenger? ${varNamePrefix}binaryMessenger;
           parameters: func.parameters,
           returnType: func.returnType,
           documentationComments: func.documentationComments,
-          channelName: makeChannelName(api, func, dartPackageName),
+          channelName: multiplexed
+              ? makeMultiplexedChannelName(api, dartPackageName)
+              : makeChannelName(api, func, dartPackageName),
           addSuffixVariable: true,
+          methodIndex: multiplexed ? index : null,
+          ffiClassName: func.isFfiSync ? '_${api.name}Ffi' : null,
+          mapsLargeBlob: isLargeBlobMethod(func),
+          chunkedReply: isChunkedMethod(func),
+        );
+      });
+    });
+    if (hasFfiSyncMethods(api)) {
+      _writeFfiFunctions(indent, api, dartPackageName: dartPackageName);
+    }
+  }
+
+  /// Writes the class that looks up the C functions exported by the host for
+  /// the `@FfiSync()` methods of [api].
+  void _writeFfiFunctions(
+    Indent indent,
+    AstHostApi api, {
+    required String dartPackageName,
+  }) {
+    String nativeType(TypeDeclaration type) {
+      return switch (type.baseName) {
+        'bool' => 'ffi.Bool',
+        'int' => 'ffi.Int64',
+        'double' => 'ffi.Double',
+        _ => 'ffi.Void',
+      };
+    }
+
+    String lookup(String symbol, String nativeSignature, String signature) {
+      return "${varNamePrefix}library.lookupFunction<$nativeSignature, $signature>('$symbol')";
+    }
+
+    const errorSignature = 'ffi.Pointer<ffi.Uint8> Function()';
+    indent.newln();
+    indent.writeln(
+      '/// The C functions exported by the host for the `@FfiSync()` methods of',
+    );
+    indent.writeln('/// [${api.name}].');
+    indent.writeScoped('class _${api.name}Ffi {', '}', () {
+      indent.writeln(
+        'static final ffi.DynamicLibrary ${varNamePrefix}library = ffi.DynamicLibrary.process();',
+      );
+      for (final Method method in api.methods.where(
+        (Method method) => method.isFfiSync,
+      )) {
+        final String symbol = makeFfiSymbolName(
+          api,
+          method.name,
+          dartPackageName,
         );
+        final String signature = _ffiFunctionSignature(
+          returnType: method.returnType,
+          parameters: method.parameters,
+        );
+        final String nativeParameters = method.parameters
+            .map((Parameter param) => nativeType(param.type))
+            .join(', ');
+        final nativeSignature =
+            '${nativeType(method.returnType)} Function($nativeParameters)';
+        indent.newln();
+        indent.writeln('static final $signature? ${method.name} =');
+        indent.nest(2, () {
+          indent.writeln("${varNamePrefix}library.providesSymbol('$symbol')");
+          indent.nest(2, () {
+            indent.writeln(
+              '? ${lookup(symbol, nativeSignature, signature)}',
+            );
+            indent.writeln(': null;');
+          });
+        });
       }
+      const errorFunctions = <String, String>{
+        'errorCode': 'ffi_error_code',
+        'errorMessage': 'ffi_error_message',
+      };
+      errorFunctions.forEach((String name, String function) {
+        final String symbol = makeFfiSymbolName(api, function, dartPackageName);
+        indent.newln();
+        indent.writeln(
+          'static final $errorSignature $varNamePrefix$name = ${lookup(symbol, errorSignature, errorSignature)};',
+        );
+      });
+      indent.newln();
+      indent.writeln(
+        '/// Throws the error reported by the last call on this thread, if any.',
+      );
+      indent.writeScoped('static void throwIfError() {', '}', () {
+        indent.writeln(
+          'final ffi.Pointer<ffi.Uint8> code = ${varNamePrefix}errorCode();',
+        );
+        indent.writeScoped('if (code != ffi.nullptr) {', '}', () {
+          indent.writeln(
+            'final ffi.Pointer<ffi.Uint8> message = ${varNamePrefix}errorMessage();',
+          );
+          indent.writeScoped('throw PlatformException(', ');', () {
+            indent.writeln('code: _ffiString(code),');
+            indent.writeln(
+              'message: message == ffi.nullptr ? null : _ffiString(message),',
+            );
+          });
+        });
+      });
     });
   }
 
@@ -1277,6 +1824,24 @@ final BinaryMessenger? ${varNamePrefix}binaryMessenger;
     if (root.classes.isNotEmpty) {
       _writeDeepEquals(indent);
     }
+    if (_usesPackedClasses(root)) {
+      _writePackedList(indent);
+    }
+    if (_usesCompactVarints(root)) {
+      _writeCompactVarints(indent);
+    }
+    if (_usesCompactStrings(root)) {
+      _writeCompactStrings(indent);
+    }
+    if (_usesFfiSync(root)) {
+      _writeFfiString(indent);
+    }
+    if (_usesLargeBlobs(root)) {
+      _writeLargeBlobMapping(indent, dartPackageName: dartPackageName);
+    }
+    if (_usesChunkedReplies(root)) {
+      _writeChunkedReply(indent);
+    }
     if (root.containsProxyApi) {
       proxy_api_helper.writeProxyApiPigeonOverrides(
         indent,
@@ -1324,6 +1889,218 @@ bool _deepEquals(Object? a, Object? b) {
 ''');
   }
 
+  /// Writes `_PackedList`, which marks the lists the codec writes as packed
+  /// records.
+  void _writePackedList(Indent indent) {
+    indent.newln();
+    indent.format(r'''
+/// A list at a position the schema declares as a list of a packed class,
+/// which the codec writes as one array of records.
+///
+/// Lists anywhere else, such as an `Object?` argument, use the standard list
+/// encoding, since the host only expects records where the schema says so.
+final class _PackedList<T> {
+  const _PackedList(this.values);
+
+  final List<T> values;
+
+  @override
+  bool operator ==(Object other) =>
+      other is _PackedList<T> && _deepEquals(values, other.values);
+
+  @override
+  int get hashCode => Object.hashAll(values);
+}
+''');
+  }
+
+  void _writeCompactVarints(Indent indent) {
+    indent.newln();
+    indent.format(r'''
+void _writeCompactVarint(WriteBuffer buffer, int value) {
+  int zigzag = (value << 1) ^ (value >> 63);
+  while ((zigzag & ~0x7f) != 0) {
+    buffer.putUint8((zigzag & 0x7f) | 0x80);
+    zigzag >>>= 7;
+  }
+  buffer.putUint8(zigzag);
+}
+
+int _readCompactVarint(ReadBuffer buffer) {
+  int zigzag = 0;
+  for (int shift = 0; ; shift += 7) {
+    final int byte = buffer.getUint8();
+    zigzag |= (byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+  }
+  return (zigzag >>> 1) ^ -(zigzag & 1);
+}
+''');
+  }
+
+  void _writeCompactStrings(Indent indent) {
+    indent.newln();
+    indent.format(r'''
+void _writeCompactString(WriteBuffer buffer, String value) {
+  final Uint8List bytes = utf8.encode(value);
+  _writeCompactVarint(buffer, bytes.length);
+  buffer.putUint8List(bytes);
+}
+
+String _readCompactString(ReadBuffer buffer) {
+  return utf8.decode(buffer.getUint8List(_readCompactVarint(buffer)));
+}
+''');
+  }
+
+  void _writeFfiString(Indent indent) {
+    indent.newln();
+    indent.format(r'''
+String _ffiString(ffi.Pointer<ffi.Uint8> pointer) {
+  var length = 0;
+  while (pointer[length] != 0) {
+    length++;
+  }
+  return utf8.decode(pointer.asTypedList(length));
+}
+''');
+  }
+
+  /// Writes `_mapLargeBlob`, which maps the `memfd` the host replies with in
+  /// place of a large `Uint8List`.
+  void _writeLargeBlobMapping(
+    Indent indent, {
+    required String dartPackageName,
+  }) {
+    const library = '${varNamePrefix}library';
+    final String mapSymbol = makeLargeBlobSymbolName('map', dartPackageName);
+    final String unmapSymbol = makeLargeBlobSymbolName(
+      'unmap',
+      dartPackageName,
+    );
+    const mapSignature = 'ffi.Pointer<_LargeBlobMapping> Function';
+    indent.newln();
+    indent.format('''
+/// The mapping of a `memfd` made by the host, which it unmaps when the
+/// finalizer of the `Uint8List` viewing [data] runs.
+final class _LargeBlobMapping extends ffi.Struct {
+	external ffi.Pointer<ffi.Uint8> data;
+
+	@ffi.Size()
+	external int length;
+}
+
+/// The C functions exported by the host for mapping large blobs.
+class _LargeBlobFfi {
+	static final ffi.DynamicLibrary $library = ffi.DynamicLibrary.process();
+
+	static final $mapSignature(int, int) map = $library.lookupFunction<$mapSignature(ffi.Int64, ffi.Int64), $mapSignature(int, int)>('$mapSymbol');
+
+	static final ffi.Pointer<ffi.NativeFinalizerFunction> unmap = $library.lookup<ffi.NativeFinalizerFunction>('$unmapSymbol');
+}
+
+/// Returns [value], or the bytes it describes if the host sent them in a
+/// sealed `memfd` as an [Int64List] of its file descriptor and length.
+///
+/// The descriptor is closed once mapped, and the mapping is released when
+/// the returned `Uint8List` is garbage collected.
+Object? _mapLargeBlob(Object? value) {
+	if (value is! Int64List) {
+		return value;
+	}
+	final int length = value[1];
+	final ffi.Pointer<_LargeBlobMapping> mapping = _LargeBlobFfi.map(value[0], length);
+	if (mapping == ffi.nullptr) {
+		throw PlatformException(
+			code: 'large-blob-error',
+			message: 'Unable to map a large blob of \$length bytes.',
+		);
+	}
+	return mapping.ref.data.asTypedList(
+		length,
+		finalizer: _LargeBlobFfi.unmap,
+		token: mapping.cast(),
+	);
+}
+''');
+  }
+
+  /// Writes `_ChunkedReply`, which reassembles the replies of `@Chunked()`
+  /// methods from the frames the host sends on a side channel.
+  void _writeChunkedReply(Indent indent) {
+    indent.newln();
+    indent.format('''
+/// Collects the frames of the reply to a `@Chunked()` method, which the host
+/// sends on [channelName] ahead of a reply holding the number of frames.
+class _ChunkedReply {
+	_ChunkedReply._(this.channelName, this.binaryMessenger);
+
+	// Frames don't identify their call, so a call waits for the reply to the
+	// previous call on the same channel.
+	static final Map<String, Future<void>> _pendingReplies = <String, Future<void>>{};
+
+	final String channelName;
+	final BinaryMessenger binaryMessenger;
+	final BytesBuilder _bytes = BytesBuilder(copy: false);
+	final Completer<void> _done = Completer<void>();
+	int _frameCount = 0;
+	bool _outOfOrder = false;
+
+	/// Starts collecting the frames sent on [channelName].
+	static Future<_ChunkedReply> listen(String channelName, BinaryMessenger? binaryMessenger) async {
+		while (_pendingReplies[channelName] case final Future<void> pending?) {
+			await pending;
+		}
+		final reply = _ChunkedReply._(
+			channelName,
+			binaryMessenger ?? ServicesBinding.instance.defaultBinaryMessenger,
+		);
+		_pendingReplies[channelName] = reply._done.future;
+		reply.binaryMessenger.setMessageHandler(channelName, reply._addFrame);
+		return reply;
+	}
+
+	// Each frame starts with its little-endian 32-bit sequence number.
+	Future<ByteData?> _addFrame(ByteData? frame) async {
+		if (frame!.getUint32(0, Endian.little) != _frameCount) {
+			_outOfOrder = true;
+		}
+		_frameCount++;
+		_bytes.add(frame.buffer.asUint8List(frame.offsetInBytes + 4, frame.lengthInBytes - 4));
+		return null;
+	}
+
+	/// Returns the reply list of [reply], decoded from the frames if the host
+	/// sent any.
+	Future<List<Object?>?> reassemble(Future<Object?> reply) async {
+		final List<Object?>? replyList;
+		try {
+			replyList = await reply as List<Object?>?;
+		} finally {
+			binaryMessenger.setMessageHandler(channelName, null);
+			_pendingReplies.remove(channelName);
+			_done.complete();
+		}
+		if (_frameCount == 0 || replyList == null || replyList.length != 1) {
+			return replyList;
+		}
+		if (_outOfOrder || replyList[0] != _frameCount) {
+			throw PlatformException(
+				code: 'chunk-error',
+				message: 'Expected \${replyList[0]} frames in order on "\$channelName", but received \$_frameCount.',
+			);
+		}
+		// A single frame is a view past its sequence number, which typed data in
+		// the reply may not be aligned in, so it is copied.
+		final Uint8List bytes = _frameCount == 1 ? Uint8List.fromList(_bytes.takeBytes()) : _bytes.takeBytes();
+		return const $_golubetsMessageCodec().decodeMessage(bytes.buffer.asByteData()) as List<Object?>?;
+	}
+}
+''');
+  }
+
   static void _writeExtractReplyValueOrThrow(Indent indent) {
     indent.newln();
     indent.format('''
@@ -1421,6 +2198,10 @@ if (wrapped == null) {
     required List<String> documentationComments,
     required String channelName,
     required bool addSuffixVariable,
+    int? methodIndex,
+    String? ffiClassName,
+    bool mapsLargeBlob = false,
+    bool chunkedReply = false,
   }) {
     addDocumentationComments(indent, documentationComments, docCommentSpec);
     final String argSignature = _getMethodParameterSignature(parameters);
@@ -1428,17 +2209,59 @@ if (wrapped == null) {
       'Future<${addGenericTypes(returnType)}> $name($argSignature) async ',
     );
     indent.addScoped('{', '}', () {
+      if (ffiClassName != null) {
+        // The exported function only serves the default messenger and the
+        // handler set up without a suffix.
+        const function = '${varNamePrefix}ffiFunction';
+        indent.writeln(
+          'final ${_ffiFunctionSignature(returnType: returnType, parameters: parameters)}? $function =',
+        );
+        indent.nest(2, () {
+          indent.writeln(
+            '${varNamePrefix}binaryMessenger == null && $_suffixVarName.isEmpty',
+          );
+          indent.nest(2, () {
+            indent.writeln('? $ffiClassName.$name');
+            indent.writeln(': null;');
+          });
+        });
+        indent.writeScoped('if ($function != null) {', '}', () {
+          final String arguments = indexMap(
+            parameters,
+            getParameterName,
+          ).join(', ');
+          if (returnType.isVoid) {
+            indent.writeln('$function($arguments);');
+            indent.writeln('$ffiClassName.throwIfError();');
+            indent.writeln('return;');
+          } else {
+            indent.writeln(
+              'final ${returnType.baseName} ${varNamePrefix}result = $function($arguments);',
+            );
+            indent.writeln('$ffiClassName.throwIfError();');
+            indent.writeln('return ${varNamePrefix}result;');
+          }
+        });
+      }
       writeHostMethodMessageCall(
         indent,
         channelName: channelName,
         parameters: parameters,
         returnType: returnType,
         addSuffixVariable: addSuffixVariable,
+        methodIndex: methodIndex,
+        mapsLargeBlob: mapsLargeBlob,
+        chunkedReply: chunkedReply,
       );
     });
   }
 
   /// Writes the message call to a host method to [indent].
+  ///
+  /// If [methodIndex] is given, the channel is shared by all methods of the
+  /// API and the index is sent ahead of the arguments. If [mapsLargeBlob] is
+  /// true, a reply sent in a `memfd` is mapped before it is returned. If
+  /// [chunkedReply] is true, a reply sent in frames is reassembled.
   static void writeHostMethodMessageCall(
     Indent indent, {
     required String channelName,
@@ -1446,17 +2269,24 @@ if (wrapped == null) {
     required TypeDeclaration returnType,
     required bool addSuffixVariable,
     bool insideAsyncMethod = true,
+    int? methodIndex,
+    bool mapsLargeBlob = false,
+    bool chunkedReply = false,
   }) {
     var sendArgument = 'null';
-    if (parameters.isNotEmpty) {
+    if (parameters.isNotEmpty || methodIndex != null) {
       final Iterable<String> argExpressions = indexMap(parameters, (
         int index,
         NamedType type,
       ) {
         final String name = getParameterName(index, type);
-        return name;
+        return _toPackedListExpression(type.type, name);
       });
-      sendArgument = '<Object?>[${argExpressions.join(', ')}]';
+      final sendExpressions = <String>[
+        if (methodIndex != null) '$methodIndex',
+        ...argExpressions,
+      ];
+      sendArgument = '<Object?>[${sendExpressions.join(', ')}]';
     }
     final channelSuffix = addSuffixVariable ? '\$$_suffixVarName' : '';
     final constOrFinal = addSuffixVariable ? 'final' : 'const';
@@ -1473,6 +2303,18 @@ if (wrapped == null) {
       },
     );
 
+    const chunksVar = '${varNamePrefix}chunks';
+    if (chunkedReply) {
+      indent.writeScoped(
+        'final _ChunkedReply $chunksVar = await _ChunkedReply.listen(',
+        ');',
+        () {
+          indent.writeln("'\${${varNamePrefix}channelName}.chunks',");
+          indent.writeln('${varNamePrefix}binaryMessenger,');
+        },
+      );
+    }
+
     const sendFutureVar = '${varNamePrefix}sendFuture';
     indent.writeln(
       'final Future<Object?> $sendFutureVar = ${varNamePrefix}channel.send($sendArgument);',
@@ -1485,9 +2327,15 @@ if (wrapped == null) {
       indent.inc();
     }
 
-    indent.format('''
+    if (chunkedReply) {
+      indent.writeln(
+        'final List<Object?>? ${varNamePrefix}replyList = await $chunksVar.reassemble($sendFutureVar);',
+      );
+    } else {
+      indent.format('''
 final ${varNamePrefix}replyList = await $sendFutureVar as List<Object?>?;
 ''');
+    }
     final extractCall =
         '''
 _extractReplyValueOrThrow(
@@ -1501,7 +2349,10 @@ _extractReplyValueOrThrow(
     } else {
       const accessor = '${varNamePrefix}replyValue';
       indent.format('final Object? $accessor = $extractCall;');
-      indent.format('return ${_castValue(accessor, returnType)};');
+      final String value = mapsLargeBlob
+          ? '_mapLargeBlob($accessor)'
+          : accessor;
+      indent.format('return ${_castValue(value, returnType)};');
     }
 
     if (!insideAsyncMethod) {
@@ -1594,7 +2445,10 @@ _extractReplyValueOrThrow(
                 indent.writeln('final $returnTypeString output = $call;');
               }
 
-              const returnExpression = 'output';
+              final String returnExpression = _toPackedListExpression(
+                returnType,
+                'output',
+              );
               final returnStatement = isMockHandler
                   ? 'return <Object?>[$returnExpression];'
                   : 'return wrapResponse(result: $returnExpression);';
@@ -1649,6 +2503,118 @@ String _makeGenericTypeArguments(TypeDeclaration type) {
   return addGenericTypes(type);
 }
 
+// Whether any compact class field is written as a varint, which includes the
+// lengths of strings and typed lists.
+bool _usesCompactVarints(Root root) {
+  return root.classes
+      .where((Class classDefinition) => classDefinition.isCompact)
+      .expand((Class classDefinition) => classDefinition.fields)
+      .any(
+        (NamedType field) =>
+            !field.type.isClass &&
+            field.type.baseName != 'bool' &&
+            field.type.baseName != 'double',
+      );
+}
+
+// Whether any compact class has a String field.
+bool _usesCompactStrings(Root root) {
+  return root.classes
+      .where((Class classDefinition) => classDefinition.isCompact)
+      .expand((Class classDefinition) => classDefinition.fields)
+      .any((NamedType field) => field.type.baseName == 'String');
+}
+
+// Whether any class is encoded as a packed record.
+bool _usesPackedClasses(Root root) => root.classes.any(
+  (Class classDefinition) => classDefinition.isPacked,
+);
+
+// Returns the class of [type] if it is a list of a packed class, which is sent
+// as one array of records.
+Class? _packedListClass(TypeDeclaration type) {
+  if (type.baseName != 'List' || type.typeArguments.length != 1) {
+    return null;
+  }
+  final TypeDeclaration element = type.typeArguments.first;
+  return element.isClass &&
+          !element.isNullable &&
+          element.associatedClass!.isPacked
+      ? element.associatedClass
+      : null;
+}
+
+/// Wraps the non-null [value] of a list of [packedClass] so that the codec
+/// writes it as packed records.
+String _toPackedList(Class packedClass, String value) {
+  return '_PackedList<${packedClass.name}>($value)';
+}
+
+/// Wraps the local variable [value] of [type] as [_toPackedList] does if
+/// [type] is a list of a packed class, and returns it unchanged otherwise.
+String _toPackedListExpression(TypeDeclaration type, String value) {
+  final Class? packedClass = _packedListClass(type);
+  if (packedClass == null) {
+    return value;
+  }
+  final String packedList = _toPackedList(packedClass, value);
+  return type.isNullable ? '$value == null ? null : $packedList' : packedList;
+}
+
+// Whether any host API has methods called through `dart:ffi`.
+bool _usesFfiSync(Root root) => root.apis.any(hasFfiSyncMethods);
+
+// Whether any host method may reply with a `memfd` mapped through `dart:ffi`.
+bool _usesLargeBlobs(Root root) => root.apis.any(
+  (Api api) => api is AstHostApi && api.methods.any(isLargeBlobMethod),
+);
+
+// Whether any host method may have its reply sent in frames.
+bool _usesChunkedReplies(Root root) => root.apis.any(
+  (Api api) => api is AstHostApi && api.methods.any(isChunkedMethod),
+);
+
+// Whether any class is read from a ring buffer through `dart:ffi`.
+bool _usesRingBuffers(Root root) => root.classes.any(
+  (Class classDefinition) => classDefinition.ringBufferCapacity != null,
+);
+
+// Returns the Dart type of the function that calls the C function exported
+// for a method with [returnType] and [parameters].
+String _ffiFunctionSignature({
+  required TypeDeclaration returnType,
+  required Iterable<Parameter> parameters,
+}) {
+  final String parameterTypes = parameters
+      .map((Parameter param) => param.type.baseName)
+      .join(', ');
+  return '${returnType.baseName} Function($parameterTypes)';
+}
+
+/// Converts the non-null [value] of a field declared as a `List` to the typed
+/// list [type] it is sent as.
+String _toTypedList(TypeDeclaration type, String value) {
+  return switch (type.typedListOf) {
+    null => value,
+    'bool' => 'Uint8List.fromList($value.map((bool bit) => bit ? 1 : 0).toList())',
+    _ => '${type.baseName}.fromList($value)',
+  };
+}
+
+/// Converts the typed list [value] of [type] to the `List` its field was
+/// declared as, which is only a copy for `List<bool>`.
+String _fromTypedList(
+  TypeDeclaration type,
+  String value, {
+  required bool isNullable,
+}) {
+  if (type.typedListOf != 'bool') {
+    return value;
+  }
+  final nullAwareOperator = isNullable ? '?' : '';
+  return '($value)$nullAwareOperator.map((int bit) => bit != 0).toList()';
+}
+
 /// Casts a value to the expected type, considering nullability, and generic
 /// types.
 String _castValue(String value, TypeDeclaration type) {
@@ -1782,6 +2748,7 @@ String addGenericTypes(TypeDeclaration type) {
       typeArguments.isEmpty
           ? 'Map<Object?, Object?>'
           : 'Map<${_flattenTypeArguments(typeArguments)}>',
+    _ when type.typedListOf != null => 'List<${type.typedListOf}>',
     _ when type.typeArguments.isNotEmpty =>
       '${type.baseName}<${_flattenTypeArguments(type.typeArguments)}>',
     _ => type.baseName,
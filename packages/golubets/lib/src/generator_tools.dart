@@ -195,11 +195,179 @@ class Indent {
 
 /// Create the generated channel name for a [method] on an [api].
 String makeChannelName(Api api, Method method, String dartPackageName) {
-  return makeChannelNameWithStrings(
+  final String channelName = makeChannelNameWithStrings(
     apiName: api.name,
     methodName: method.name,
     dartPackageName: dartPackageName,
   );
+  return '$channelName${_compactSchemaSuffix(<Method>[method])}';
+}
+
+/// Create the generated channel name shared by all methods of a multiplexed
+/// [api].
+String makeMultiplexedChannelName(Api api, String dartPackageName) {
+  return 'dev.bayori.golubets.$dartPackageName.${api.name}'
+      '${_compactSchemaSuffix(api.methods)}';
+}
+
+/// Whether [type] can be a field of a compact class.
+bool isCompactFieldType(TypeDeclaration type) {
+  if (type.isClass) {
+    return type.associatedClass!.isCompact;
+  }
+  return type.isEnum ||
+      const <String>{
+        'bool',
+        'int',
+        'double',
+        'String',
+        'Uint8List',
+        'Int32List',
+        'Int64List',
+        'Float64List',
+      }.contains(type.baseName);
+}
+
+/// Returns a hash of the layouts of the compact and packed classes reachable
+/// from the signatures of [methods], or null if there are none.
+///
+/// The hash is part of the channel names of those methods, so that code
+/// generated from schemas with different layouts does not connect.
+int? compactSchemaHash(Iterable<Method> methods) {
+  final visited = <Class>{};
+  void visit(TypeDeclaration type) {
+    type.typeArguments.forEach(visit);
+    final Class? classDefinition = type.associatedClass;
+    if (classDefinition == null || !visited.add(classDefinition)) {
+      return;
+    }
+    for (final NamedType field in classDefinition.fields) {
+      visit(field.type);
+    }
+    for (final Class child in classDefinition.children) {
+      visit(
+        TypeDeclaration(
+          baseName: child.name,
+          isNullable: false,
+          associatedClass: child,
+        ),
+      );
+    }
+  }
+
+  for (final method in methods) {
+    visit(method.returnType);
+    for (final Parameter parameter in method.parameters) {
+      visit(parameter.type);
+    }
+  }
+  final List<Class> compactClasses = visited
+      .where(
+        (Class classDefinition) =>
+            classDefinition.isCompact || classDefinition.isPacked,
+      )
+      .toList();
+  if (compactClasses.isEmpty) {
+    return null;
+  }
+  compactClasses.sort((Class a, Class b) => a.name.compareTo(b.name));
+
+  final String layout = compactClasses
+      .map(
+        (Class classDefinition) =>
+            '${classDefinition.isPacked ? 'packed ' : ''}${classDefinition.name}(${classDefinition.fields.map((NamedType field) => '${field.type.baseName}${field.type.isNullable ? '?' : ''}').join(',')})',
+      )
+      .join(';');
+  // 32-bit FNV-1a.
+  var hash = 0x811c9dc5;
+  for (final int unit in layout.codeUnits) {
+    hash = ((hash ^ unit) * 0x01000193) & 0xffffffff;
+  }
+  return hash;
+}
+
+String _compactSchemaSuffix(Iterable<Method> methods) {
+  final int? hash = compactSchemaHash(methods);
+  return hash == null
+      ? ''
+      : '.compact_${hash.toRadixString(16).padLeft(8, '0')}';
+}
+
+/// Returns the offset of each field of the `@Packed()` class
+/// [classDefinition] in its record, and the size of the record.
+///
+/// Fields are laid out like a C struct, in declaration order at their natural
+/// alignment, and the size is padded to the largest alignment.
+({List<int> offsets, int size}) getPackedLayout(Class classDefinition) {
+  final offsets = <int>[];
+  var size = 0;
+  var alignment = 1;
+  for (final NamedType field in classDefinition.fields) {
+    final int fieldSize = field.type.baseName == 'bool' ? 1 : 8;
+    size = (size + fieldSize - 1) ~/ fieldSize * fieldSize;
+    offsets.add(size);
+    size += fieldSize;
+    alignment = max(alignment, fieldSize);
+  }
+  return (
+    offsets: offsets,
+    size: (size + alignment - 1) ~/ alignment * alignment,
+  );
+}
+
+/// Whether all methods of [api] are sent over a single channel.
+bool isMultiplexedApi(Api api) => api is AstHostApi && api.multiplexed;
+
+/// Whether [type] can be an argument or return value of a method annotated
+/// with `@FfiSync()`.
+bool isFfiSyncType(TypeDeclaration type) {
+  return !type.isNullable &&
+      const <String>{'bool', 'int', 'double'}.contains(type.baseName);
+}
+
+/// Whether any method of [api] is annotated with `@FfiSync()`.
+bool hasFfiSyncMethods(Api api) {
+  return api is AstHostApi &&
+      api.methods.any((Method method) => method.isFfiSync);
+}
+
+/// Create the name of the C function [function] exported by the host for
+/// [api] when it has methods annotated with `@FfiSync()`.
+///
+/// [function] is the name of the method, or of one of the functions that
+/// report the error of the last call.
+String makeFfiSymbolName(Api api, String function, String dartPackageName) {
+  return 'golubets_${dartPackageName}_${api.name}_$function';
+}
+
+/// The default size in bytes from which `@LargeBlob()` values are sent in a
+/// `memfd`.
+const int defaultLargeBlobThreshold = 1024 * 1024;
+
+/// Create the name of the C function [function] exported by the host for
+/// mapping the `memfd` of `@LargeBlob()` values.
+String makeLargeBlobSymbolName(String function, String dartPackageName) {
+  return 'golubets_${dartPackageName}_large_blob_$function';
+}
+
+/// Whether [method] returns a `Uint8List` that may be sent in a `memfd`.
+bool isLargeBlobMethod(Method method) => method.largeBlobThreshold != null;
+
+/// The default largest number of encoded bytes in a frame of a `@Chunked()`
+/// reply.
+const int defaultChunkFrameSize = 1024 * 1024;
+
+/// Whether the reply to [method] is sent in frames on a side channel.
+bool isChunkedMethod(Method method) => method.chunkFrameSize != null;
+
+/// Create the name of the C function [function] exported by the host for the
+/// ring buffer of [classDefinition].
+String makeRingBufferSymbolName(
+  Class classDefinition,
+  String function,
+  String dartPackageName,
+) {
+  return 'golubets_${dartPackageName}_${classDefinition.name}_ring_$function';
 }
 
 /// Create the generated channel name for a method on an api.
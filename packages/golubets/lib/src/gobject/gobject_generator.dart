@@ -19,9 +19,16 @@ const DocumentCommentSpecification _docCommentSpec =
 /// Name for codec class.
 const String _codecBaseName = 'GolubMessageCodec';
 
+/// Name of the response type shared by all host API methods when
+/// sharedHostApiResponses is enabled.
+const String _sharedHostApiResponseName = 'HostApiResponse';
+
 /// Name of the standard codec from the Flutter SDK.
 const String _standardCodecName = 'FlStandardMessageCodec';
 
+/// Name for the instrumentation function table.
+const String _instrumentationBaseName = 'Instrumentation';
+
 /// Options that control how GObject code will be generated.
 class GObjectOptions {
   /// Creates a [GObjectOptions] object
@@ -30,6 +37,15 @@ class GObjectOptions {
     this.module,
     this.copyrightHeader,
     this.headerOutPath,
+    this.includeInstrumentation = false,
+    this.unboxedEnums = false,
+    this.boxedDataClasses = false,
+    this.sharedHostApiResponses = false,
+    this.zeroCopyTypedLists = false,
+    this.includeTakeConstructors = false,
+    this.inlineNullablePrimitives = false,
+    this.directClassWriters = false,
+    this.encodedSizes = false,
   });
 
   /// The path to the header that will get placed in the source file (example:
@@ -45,6 +61,58 @@ class GObjectOptions {
   /// The path to the output header file location.
   final String? headerOutPath;
 
+  /// Whether to generate the instrumentation function table and the calls
+  /// that notify it.
+  final bool includeInstrumentation;
+
+  /// Whether the codec writes and reads enum fields of data classes directly
+  /// as integers instead of boxing each one in a custom `FlValue`.
+  final bool unboxedEnums;
+
+  /// Whether data classes are generated as immutable reference counted boxed
+  /// structs instead of GObjects.
+  ///
+  /// The constructors and getters are unchanged, but instances are released
+  /// with `<class>_unref` rather than `g_object_unref`.
+  final bool boxedDataClasses;
+
+  /// Whether host API methods return a single reference counted
+  /// `<Module>HostApiResponse` type shared by all methods, instead of a
+  /// separate response GObject type per method.
+  ///
+  /// The per-method `_response_new` and `_response_new_error` constructors
+  /// are unchanged, but their results are released with
+  /// `<module>_host_api_response_unref`.
+  final bool sharedHostApiResponses;
+
+  /// Whether typed numeric list fields of data classes keep the `FlValue`
+  /// they were decoded from instead of a copy of its elements.
+  ///
+  /// Getters return pointers into the retained value and encoding the class
+  /// references it, so the elements are not copied when a message is decoded
+  /// or encoded.
+  final bool zeroCopyTypedLists;
+
+  /// Whether to generate a `_new_take` constructor for each data class that
+  /// adopts the strings, typed lists, objects and `FlValue`s passed to it
+  /// instead of copying them.
+  final bool includeTakeConstructors;
+
+  /// Whether nullable bool, int, double and enum fields of data classes are
+  /// stored inside the object with a bitmask of the fields that are set,
+  /// instead of in a separate allocation per field.
+  ///
+  /// Getters still return a pointer, which points into the object.
+  final bool inlineNullablePrimitives;
+
+  /// Whether the codec writes data classes directly to the output buffer
+  /// instead of first converting them to a list of `FlValue`s.
+  final bool directClassWriters;
+
+  /// Whether to generate `*_encoded_size()` for data classes, and encode
+  /// messages into buffers allocated at their exact size.
+  final bool encodedSizes;
+
   /// Creates a [GObjectOptions] from a Map representation where:
   /// `x = GObjectOptions.fromMap(x.toMap())`.
   static GObjectOptions fromMap(Map<String, Object> map) {
@@ -54,6 +122,16 @@ class GObjectOptions {
       module: map['module'] as String?,
       copyrightHeader: copyrightHeader?.cast<String>(),
       headerOutPath: map['gobjectHeaderOut'] as String?,
+      includeInstrumentation: map['includeInstrumentation'] as bool? ?? false,
+      unboxedEnums: map['unboxedEnums'] as bool? ?? false,
+      boxedDataClasses: map['boxedDataClasses'] as bool? ?? false,
+      sharedHostApiResponses: map['sharedHostApiResponses'] as bool? ?? false,
+      zeroCopyTypedLists: map['zeroCopyTypedLists'] as bool? ?? false,
+      includeTakeConstructors: map['includeTakeConstructors'] as bool? ?? false,
+      inlineNullablePrimitives:
+          map['inlineNullablePrimitives'] as bool? ?? false,
+      directClassWriters: map['directClassWriters'] as bool? ?? false,
+      encodedSizes: map['encodedSizes'] as bool? ?? false,
     );
   }
 
@@ -64,6 +142,15 @@ class GObjectOptions {
       if (headerIncludePath != null) 'header': headerIncludePath!,
       if (module != null) 'module': module!,
       if (copyrightHeader != null) 'copyrightHeader': copyrightHeader!,
+      'includeInstrumentation': includeInstrumentation,
+      'unboxedEnums': unboxedEnums,
+      'boxedDataClasses': boxedDataClasses,
+      'sharedHostApiResponses': sharedHostApiResponses,
+      'zeroCopyTypedLists': zeroCopyTypedLists,
+      'includeTakeConstructors': includeTakeConstructors,
+      'inlineNullablePrimitives': inlineNullablePrimitives,
+      'directClassWriters': directClassWriters,
+      'encodedSizes': encodedSizes,
     };
     return result;
   }
@@ -82,9 +169,19 @@ class InternalGObjectOptions extends InternalOptions {
     required this.headerIncludePath,
     required this.gobjectHeaderOut,
     required this.gobjectSourceOut,
+    this.gobjectBenchOut,
     this.module,
     this.copyrightHeader,
     this.headerOutPath,
+    this.includeInstrumentation = false,
+    this.unboxedEnums = false,
+    this.boxedDataClasses = false,
+    this.sharedHostApiResponses = false,
+    this.zeroCopyTypedLists = false,
+    this.includeTakeConstructors = false,
+    this.inlineNullablePrimitives = false,
+    this.directClassWriters = false,
+    this.encodedSizes = false,
   });
 
   /// Creates InternalGObjectOptions from GObjectOptions.
@@ -92,12 +189,22 @@ class InternalGObjectOptions extends InternalOptions {
     GObjectOptions options, {
     required this.gobjectHeaderOut,
     required this.gobjectSourceOut,
+    this.gobjectBenchOut,
     Iterable<String>? copyrightHeader,
   }) : headerIncludePath =
            options.headerIncludePath ?? path.basename(gobjectHeaderOut),
        module = options.module,
        copyrightHeader = options.copyrightHeader ?? copyrightHeader,
-       headerOutPath = options.headerOutPath;
+       headerOutPath = options.headerOutPath,
+       includeInstrumentation = options.includeInstrumentation,
+       unboxedEnums = options.unboxedEnums,
+       boxedDataClasses = options.boxedDataClasses,
+       sharedHostApiResponses = options.sharedHostApiResponses,
+       zeroCopyTypedLists = options.zeroCopyTypedLists,
+       includeTakeConstructors = options.includeTakeConstructors,
+       inlineNullablePrimitives = options.inlineNullablePrimitives,
+       directClassWriters = options.directClassWriters,
+       encodedSizes = options.encodedSizes;
 
   /// The path to the header that will get placed in the source file (example:
   /// "foo.h").
@@ -109,6 +216,10 @@ class InternalGObjectOptions extends InternalOptions {
   /// Path to the ".cc" GObject file that will be generated.
   final String gobjectSourceOut;
 
+  /// Path to the standalone ".cc" GObject benchmark that will be generated, if
+  /// any.
+  final String? gobjectBenchOut;
+
   /// The module where the generated class will live.
   final String? module;
 
@@ -117,6 +228,58 @@ class InternalGObjectOptions extends InternalOptions {
 
   /// The path to the output header file location.
   final String? headerOutPath;
+
+  /// Whether to generate the instrumentation function table and the calls
+  /// that notify it.
+  final bool includeInstrumentation;
+
+  /// Whether the codec writes and reads enum fields of data classes directly
+  /// as integers instead of boxing each one in a custom `FlValue`.
+  final bool unboxedEnums;
+
+  /// Whether data classes are generated as immutable reference counted boxed
+  /// structs instead of GObjects.
+  ///
+  /// The constructors and getters are unchanged, but instances are released
+  /// with `<class>_unref` rather than `g_object_unref`.
+  final bool boxedDataClasses;
+
+  /// Whether host API methods return a single reference counted
+  /// `<Module>HostApiResponse` type shared by all methods, instead of a
+  /// separate response GObject type per method.
+  ///
+  /// The per-method `_response_new` and `_response_new_error` constructors
+  /// are unchanged, but their results are released with
+  /// `<module>_host_api_response_unref`.
+  final bool sharedHostApiResponses;
+
+  /// Whether typed numeric list fields of data classes keep the `FlValue`
+  /// they were decoded from instead of a copy of its elements.
+  ///
+  /// Getters return pointers into the retained value and encoding the class
+  /// references it, so the elements are not copied when a message is decoded
+  /// or encoded.
+  final bool zeroCopyTypedLists;
+
+  /// Whether to generate a `_new_take` constructor for each data class that
+  /// adopts the strings, typed lists, objects and `FlValue`s passed to it
+  /// instead of copying them.
+  final bool includeTakeConstructors;
+
+  /// Whether nullable bool, int, double and enum fields of data classes are
+  /// stored inside the object with a bitmask of the fields that are set,
+  /// instead of in a separate allocation per field.
+  ///
+  /// Getters still return a pointer, which points into the object.
+  final bool inlineNullablePrimitives;
+
+  /// Whether the codec writes data classes directly to the output buffer
+  /// instead of first converting them to a list of `FlValue`s.
+  final bool directClassWriters;
+
+  /// Whether to generate `*_encoded_size()` for data classes, and encode
+  /// messages into buffers allocated at their exact size.
+  final bool encodedSizes;
 }
 
 /// Class that manages all GObject code generation.
@@ -266,7 +429,39 @@ class GObjectHeaderGenerator
     ], _docCommentSpec);
 
     indent.newln();
-    _writeDeclareFinalType(indent, module, classDefinition.name);
+    if (generatorOptions.boxedDataClasses) {
+      indent.writeln('typedef struct _$className $className;');
+      indent.newln();
+      indent.writeln('GType ${methodPrefix}_get_type();');
+
+      indent.newln();
+      addDocumentationComments(indent, <String>[
+        '${methodPrefix}_ref:',
+        '@object: a #$className.',
+        '',
+        'Increases the reference count of @object.',
+        '',
+        'Returns: @object.',
+      ], _docCommentSpec);
+      indent.writeln('$className* ${methodPrefix}_ref($className* object);');
+
+      indent.newln();
+      addDocumentationComments(indent, <String>[
+        '${methodPrefix}_unref:',
+        '@object: a #$className.',
+        '',
+        'Decreases the reference count of @object, freeing it when the count '
+            'reaches zero.',
+      ], _docCommentSpec);
+      indent.writeln('void ${methodPrefix}_unref($className* object);');
+
+      indent.newln();
+      indent.writeln(
+        'G_DEFINE_AUTOPTR_CLEANUP_FUNC($className, ${methodPrefix}_unref)',
+      );
+    } else {
+      _writeDeclareFinalType(indent, module, classDefinition.name);
+    }
 
     indent.newln();
     final constructorArgs = <String>[];
@@ -301,6 +496,42 @@ class GObjectHeaderGenerator
       "$className* ${methodPrefix}_new(${constructorArgs.join(', ')});",
     );
 
+    if (generatorOptions.includeTakeConstructors &&
+        _hasTakeableFields(generatorOptions, classDefinition)) {
+      final takeFieldCommentLines = <String>[];
+      for (final NamedType field in classDefinition.fields) {
+        final String fieldName = _getFieldName(field.name);
+        final bool taken = _isTakenField(generatorOptions, field);
+        takeFieldCommentLines.add(
+          '$fieldName: ${taken ? '(transfer full): ' : ''}field in this object.',
+        );
+        if (_isNumericListType(field.type)) {
+          takeFieldCommentLines.add(
+            '${fieldName}_length: length of @$fieldName.',
+          );
+        }
+      }
+      indent.newln();
+      addDocumentationComments(indent, <String>[
+        '${methodPrefix}_new_take:',
+        ...takeFieldCommentLines,
+        '',
+        'Creates a new #${classDefinition.name} object that takes ownership of '
+            'the strings, typed lists (allocated with g_malloc()), objects and '
+            '#FlValue fields passed to it instead of copying them.',
+        '',
+        'Returns: a new #$className',
+      ], _docCommentSpec);
+      final List<String> takeArgs = _getTakeConstructorArgs(
+        module,
+        generatorOptions,
+        classDefinition,
+      );
+      indent.writeln(
+        "$className* ${methodPrefix}_new_take(${takeArgs.join(', ')});",
+      );
+    }
+
     for (final NamedType field in classDefinition.fields) {
       final String fieldName = _getFieldName(field.name);
       final String returnType = _getType(module, field.type);
@@ -316,6 +547,10 @@ class GObjectHeaderGenerator
           ...field.documentationComments
         else
           'Gets the value of the ${field.name} field of @object.',
+        if (field.type.typedListOf == 'bool') ...<String>[
+          '',
+          'Holds one byte, 0 or 1, per element of the declared `List<bool>`.',
+        ],
         '',
         'Returns: the field value.',
       ], _docCommentSpec);
@@ -327,6 +562,73 @@ class GObjectHeaderGenerator
         '$returnType ${methodPrefix}_get_$fieldName(${getterArgs.join(', ')});',
       );
     }
+
+    if (generatorOptions.encodedSizes) {
+      indent.newln();
+      addDocumentationComments(indent, <String>[
+        '${methodPrefix}_encoded_size:',
+        '@object: a #$className.',
+        '@offset: the offset in the message that @object starts at, which',
+        'decides the padding before doubles and typed lists.',
+        '',
+        'Gets the number of bytes @object is encoded as.',
+        '',
+        'Returns: the encoded size in bytes.',
+      ], _docCommentSpec);
+      indent.writeln(
+        'size_t ${methodPrefix}_encoded_size($className* object, size_t offset);',
+      );
+    }
+
+    final Class? rowClass = classDefinition.columnsOf;
+    if (rowClass != null) {
+      final String rowClassName = _getClassName(module, rowClass.name);
+      indent.newln();
+      addDocumentationComments(indent, <String>[
+        '${methodPrefix}_get_row_count:',
+        '@object: a #$className.',
+        '',
+        'Gets the number of rows, which is the length of the shortest column.',
+        '',
+        'Returns: the number of rows.',
+      ], _docCommentSpec);
+      indent.writeln(
+        'size_t ${methodPrefix}_get_row_count($className* object);',
+      );
+      indent.newln();
+      addDocumentationComments(indent, <String>[
+        '${methodPrefix}_get_row:',
+        '@object: a #$className.',
+        '@index: the index of the row, which must be less than the row count.',
+        '',
+        'Gets a row of the columns.',
+        '',
+        'Returns: a new #$rowClassName.',
+      ], _docCommentSpec);
+      indent.writeln(
+        '$rowClassName* ${methodPrefix}_get_row($className* object, size_t index);',
+      );
+    }
+
+    final int? ringBufferCapacity = classDefinition.ringBufferCapacity;
+    if (ringBufferCapacity != null) {
+      indent.newln();
+      addDocumentationComments(indent, <String>[
+        '${methodPrefix}_ring_buffer_push:',
+        '@value: a #$className.',
+        '',
+        'Appends @value to the single-producer, single-consumer ring of',
+        '$ringBufferCapacity records in memory shared with Dart, which reads them with',
+        'the generated `${classDefinition.name}RingBuffer`. Only one thread may push at',
+        'a time.',
+        '',
+        'Returns: %TRUE if @value was appended, or %FALSE if the ring is full',
+        "because Dart hasn't read enough records yet.",
+      ], _docCommentSpec);
+      indent.writeln(
+        'gboolean ${methodPrefix}_ring_buffer_push($className* value);',
+      );
+    }
   }
 
   @override
@@ -365,6 +667,141 @@ class GObjectHeaderGenerator
       final String customTypeId = _getCustomTypeId(module, customType);
       indent.writeln('extern const int $customTypeId;');
     }
+
+    for (final Class classDefinition in root.classes.where(
+      (Class classDefinition) => classDefinition.isPacked,
+    )) {
+      _writePackedListDeclarations(indent, module, classDefinition);
+    }
+
+    if (generatorOptions.includeInstrumentation) {
+      _writeInstrumentation(indent, module);
+    }
+  }
+
+  // Writes the record the packed class [classDefinition] is copied to and the
+  // functions that create and read lists of them.
+  void _writePackedListDeclarations(
+    Indent indent,
+    String module,
+    Class classDefinition,
+  ) {
+    final String className = _getClassName(module, classDefinition.name);
+    final String methodPrefix = _getMethodPrefix(module, classDefinition.name);
+    final recordName = '${className}Packed';
+
+    indent.newln();
+    addDocumentationComments(indent, <String>[
+      '$recordName:',
+      '',
+      'The record a #$className is packed into. Lists of ${classDefinition.name} are',
+      'sent as one contiguous array of these records.',
+    ], _docCommentSpec);
+    indent.writeScoped('typedef struct {', '} $recordName;', () {
+      for (final NamedType field in classDefinition.fields) {
+        indent.writeln(
+          '${_getPackedFieldType(module, field)} ${_getFieldName(field.name)};',
+        );
+      }
+    });
+
+    indent.newln();
+    indent.writeln('extern const int ${methodPrefix}_packed_list_type_id;');
+
+    indent.newln();
+    addDocumentationComments(indent, <String>[
+      '${methodPrefix}_packed_list_new:',
+      '@records: (array length=length): records to copy.',
+      '@length: the number of records in @records.',
+      '',
+      'Creates a list of ${classDefinition.name} that is sent as one packed array.',
+      '',
+      'Returns: a new #FlValue.',
+    ], _docCommentSpec);
+    indent.writeln(
+      'FlValue* ${methodPrefix}_packed_list_new(const $recordName* records, size_t length);',
+    );
+
+    indent.newln();
+    addDocumentationComments(indent, <String>[
+      '${methodPrefix}_packed_list_get_records:',
+      '@value: a #FlValue.',
+      '@length: location to write the number of records.',
+      '',
+      'Gets the records of a list of ${classDefinition.name} received as one packed',
+      'array. The records remain valid as long as @value.',
+      '',
+      'Returns: (array length=length): the records, or %NULL if @value is not a',
+      'packed list.',
+    ], _docCommentSpec);
+    indent.writeln(
+      'const $recordName* ${methodPrefix}_packed_list_get_records(FlValue* value, size_t* length);',
+    );
+  }
+
+  // Writes the instrumentation function table and the function that installs
+  // it.
+  void _writeInstrumentation(Indent indent, String module) {
+    final String instrumentationName = _getClassName(
+      module,
+      _instrumentationBaseName,
+    );
+    final String modulePrefix = _snakeCaseFromCamelCase(module);
+
+    indent.newln();
+    addDocumentationComments(indent, <String>[
+      '$instrumentationName:',
+      '',
+      'Table of functions called as messages pass through the generated channels.',
+      'Any entry may be %NULL. @decode_start is called before a message is decoded,',
+      '@handler_start once it has been decoded, @reply after a host API reply has',
+      'been encoded and @error when a reply carries an error.',
+    ], _docCommentSpec);
+    indent.writeScoped('typedef struct {', '} $instrumentationName;', () {
+      indent.writeln(
+        'void (*decode_start)(const gchar* channel_name, size_t message_size, gpointer user_data);',
+      );
+      indent.writeln(
+        'void (*handler_start)(const gchar* channel_name, gpointer user_data);',
+      );
+      indent.writeln(
+        'void (*reply)(const gchar* channel_name, size_t reply_size, gpointer user_data);',
+      );
+      indent.writeln(
+        'void (*error)(const gchar* channel_name, const gchar* code, const gchar* message, gpointer user_data);',
+      );
+    });
+
+    indent.newln();
+    addDocumentationComments(indent, <String>[
+      '${modulePrefix}_set_instrumentation:',
+      '@instrumentation: (allow-none): table of functions to call or %NULL to disable instrumentation.',
+      '@user_data: (closure): user data to pass to the functions in @instrumentation.',
+      '',
+      'Sets the functions notified by all channels of this module. The table must',
+      'remain valid until it is replaced or cleared.',
+    ], _docCommentSpec);
+    indent.writeln(
+      'void ${modulePrefix}_set_instrumentation(const $instrumentationName* instrumentation, gpointer user_data);',
+    );
+
+    indent.newln();
+    indent.addln('#ifdef GOLUBETS_ENABLE_TRACE');
+    addDocumentationComments(indent, <String>[
+      '${modulePrefix}_dump_trace:',
+      '@path: file to write the trace to.',
+      '@error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.',
+      '',
+      'Writes the decode, handler, encode and reply spans recorded for the calls',
+      'on each thread as Chrome trace event JSON, which can be opened in Perfetto',
+      'or chrome://tracing. Only the most recent spans of each thread are kept.',
+      '',
+      'Returns: %TRUE on success.',
+    ], _docCommentSpec);
+    indent.writeln(
+      'gboolean ${modulePrefix}_dump_trace(const gchar* path, GError** error);',
+    );
+    indent.addln('#endif  // GOLUBETS_ENABLE_TRACE');
   }
 
   @override
@@ -581,6 +1018,11 @@ class GObjectHeaderGenerator
     final String methodPrefix = _getMethodPrefix(module, api.name);
     final String vtableName = _getVTableName(module, api.name);
 
+    final bool sharedResponses = generatorOptions.sharedHostApiResponses;
+    if (sharedResponses && _isFirstHostApi(root, api)) {
+      _writeSharedHostApiResponse(indent, module);
+    }
+
     indent.newln();
     _writeDeclareFinalType(indent, module, api.name);
 
@@ -595,11 +1037,22 @@ class GObjectHeaderGenerator
     for (final Method method in api.methods.where(
       (Method method) => !method.isAsynchronous,
     )) {
-      _writeHostApiRespondClass(indent, module, api, method);
+      _writeHostApiRespondClass(
+        indent,
+        module,
+        api,
+        method,
+        sharedHostApiResponses: sharedResponses,
+      );
     }
 
     indent.newln();
-    _writeApiVTable(indent, module, api);
+    _writeApiVTable(
+      indent,
+      module,
+      api,
+      sharedHostApiResponses: sharedResponses,
+    );
 
     indent.newln();
     addDocumentationComments(indent, <String>[
@@ -637,19 +1090,77 @@ class GObjectHeaderGenerator
     }
   }
 
+  // Writes the reference counted response type shared by all host API
+  // methods.
+  void _writeSharedHostApiResponse(Indent indent, String module) {
+    final String className = _getClassName(module, _sharedHostApiResponseName);
+    final String methodPrefix = _getMethodPrefix(
+      module,
+      _sharedHostApiResponseName,
+    );
+
+    indent.newln();
+    addDocumentationComments(indent, <String>[
+      '$className:',
+      '',
+      'A response to a host API method, shared by all methods.',
+    ], _docCommentSpec);
+
+    indent.newln();
+    indent.writeln('typedef struct _$className $className;');
+    indent.newln();
+    indent.writeln('GType ${methodPrefix}_get_type();');
+
+    indent.newln();
+    addDocumentationComments(indent, <String>[
+      '${methodPrefix}_ref:',
+      '@response: a #$className.',
+      '',
+      'Increases the reference count of @response.',
+      '',
+      'Returns: @response.',
+    ], _docCommentSpec);
+    indent.writeln('$className* ${methodPrefix}_ref($className* response);');
+
+    indent.newln();
+    addDocumentationComments(indent, <String>[
+      '${methodPrefix}_unref:',
+      '@response: a #$className.',
+      '',
+      'Decreases the reference count of @response, freeing it when the count '
+          'reaches zero.',
+    ], _docCommentSpec);
+    indent.writeln('void ${methodPrefix}_unref($className* response);');
+
+    indent.newln();
+    indent.writeln(
+      'G_DEFINE_AUTOPTR_CLEANUP_FUNC($className, ${methodPrefix}_unref)',
+    );
+  }
+
   // Write the API response classes.
   void _writeHostApiRespondClass(
     Indent indent,
     String module,
     Api api,
-    Method method,
-  ) {
+    Method method, {
+    required bool sharedHostApiResponses,
+  }) {
     final String responseName = _getResponseName(api.name, method.name);
-    final String responseClassName = _getClassName(module, responseName);
+    final String responseClassName = _getClassName(
+      module,
+      _getHostApiResponseName(
+        api.name,
+        method.name,
+        sharedHostApiResponses: sharedHostApiResponses,
+      ),
+    );
     final String responseMethodPrefix = _getMethodPrefix(module, responseName);
 
-    indent.newln();
-    _writeDeclareFinalType(indent, module, responseName);
+    if (!sharedHostApiResponses) {
+      indent.newln();
+      _writeDeclareFinalType(indent, module, responseName);
+    }
 
     final String returnType = _getType(module, method.returnType);
     indent.newln();
@@ -685,7 +1196,12 @@ class GObjectHeaderGenerator
   }
 
   // Write the vtable for an API.
-  void _writeApiVTable(Indent indent, String module, Api api) {
+  void _writeApiVTable(
+    Indent indent,
+    String module,
+    Api api, {
+    required bool sharedHostApiResponses,
+  }) {
     final String className = _getClassName(module, api.name);
     final String vtableName = _getVTableName(module, api.name);
 
@@ -697,8 +1213,14 @@ class GObjectHeaderGenerator
     indent.writeScoped('typedef struct {', '} $vtableName;', () {
       for (final Method method in api.methods) {
         final String methodName = _getMethodName(method.name);
-        final String responseName = _getResponseName(api.name, method.name);
-        final String responseClassName = _getClassName(module, responseName);
+        final String responseClassName = _getClassName(
+          module,
+          _getHostApiResponseName(
+            api.name,
+            method.name,
+            sharedHostApiResponses: sharedHostApiResponses,
+          ),
+        );
 
         final methodArgs = <String>[];
         for (final Parameter param in method.parameters) {
@@ -819,6 +1341,159 @@ class GObjectSourceGenerator
   }) {
     indent.newln();
     indent.writeln('#include "${generatorOptions.headerIncludePath}"');
+    if (_usesLargeBlobs(root)) {
+      indent.newln();
+      indent.writeln('#include <fcntl.h>');
+      indent.writeln('#include <sys/mman.h>');
+      indent.writeln('#include <sys/stat.h>');
+      indent.writeln('#include <unistd.h>');
+    }
+  }
+
+  @override
+  void writeGeneralUtilities(
+    InternalGObjectOptions generatorOptions,
+    Root root,
+    Indent indent, {
+    required String dartPackageName,
+  }) {
+    if (_usesLargeBlobs(root)) {
+      _writeLargeBlobSupport(
+        indent,
+        _getModule(generatorOptions, dartPackageName),
+        dartPackageName: dartPackageName,
+      );
+    }
+  }
+
+  // Writes the function that puts large `Uint8List` replies in a sealed
+  // memfd, and the C functions Dart calls to map and unmap it.
+  void _writeLargeBlobSupport(
+    Indent indent,
+    String module, {
+    required String dartPackageName,
+  }) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final String mappingName = _getClassName(
+      module,
+      '${_codecBaseName}LargeBlobMapping',
+    );
+    const export = 'extern "C" __attribute__((visibility("default")))';
+    indent.newln();
+    indent.format('''
+// The memfds of large blob replies that Dart has not mapped yet, each with the
+// timeout that closes it if Dart never does. This covers replies that are not
+// sent, fail to send, or are dropped before they are decoded.
+static GMutex ${codecMethodPrefix}_large_blob_mutex;
+static GHashTable* ${codecMethodPrefix}_large_blob_fds = nullptr;
+
+static gboolean ${codecMethodPrefix}_large_blob_expire(gpointer user_data) {
+	int fd = GPOINTER_TO_INT(user_data);
+	guint source_id = g_source_get_id(g_main_current_source());
+	g_mutex_lock(&${codecMethodPrefix}_large_blob_mutex);
+	// The descriptor may have been claimed and reused by a newer blob.
+	gboolean expired = GPOINTER_TO_UINT(g_hash_table_lookup(${codecMethodPrefix}_large_blob_fds, GINT_TO_POINTER(fd))) == source_id;
+	if (expired) {
+		g_hash_table_remove(${codecMethodPrefix}_large_blob_fds, GINT_TO_POINTER(fd));
+	}
+	g_mutex_unlock(&${codecMethodPrefix}_large_blob_mutex);
+	if (expired) {
+		close(fd);
+	}
+	return G_SOURCE_REMOVE;
+}
+
+// Returns whether `fd` was a pending blob, which the caller now owns.
+static gboolean ${codecMethodPrefix}_large_blob_claim(int fd) {
+	g_mutex_lock(&${codecMethodPrefix}_large_blob_mutex);
+	guint source_id = ${codecMethodPrefix}_large_blob_fds != nullptr ? GPOINTER_TO_UINT(g_hash_table_lookup(${codecMethodPrefix}_large_blob_fds, GINT_TO_POINTER(fd))) : 0;
+	if (source_id != 0) {
+		g_hash_table_remove(${codecMethodPrefix}_large_blob_fds, GINT_TO_POINTER(fd));
+	}
+	g_mutex_unlock(&${codecMethodPrefix}_large_blob_mutex);
+	if (source_id == 0) {
+		return FALSE;
+	}
+	g_source_remove(source_id);
+	return TRUE;
+}
+
+// Returns the value of a large Uint8List reply, which is an Int64List of the
+// file descriptor and length of a sealed memfd holding the bytes. The bytes are
+// copied straight into a shared mapping of the memfd, which is unmapped before
+// it is sealed. The memfd stays pending until Dart maps it, or is closed after
+// a minute. Falls back to copying the bytes into the reply if the memfd can't
+// be created.
+static FlValue* ${codecMethodPrefix}_large_blob_new(const uint8_t* data, size_t length) {
+	int fd = memfd_create("golubets-large-blob", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (fd < 0) {
+		return fl_value_new_uint8_list(data, length);
+	}
+	if (ftruncate(fd, length) != 0) {
+		close(fd);
+		return fl_value_new_uint8_list(data, length);
+	}
+	void* mapped = mmap(nullptr, length, PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mapped == MAP_FAILED) {
+		close(fd);
+		return fl_value_new_uint8_list(data, length);
+	}
+	memcpy(mapped, data, length);
+	// F_SEAL_WRITE fails while a writable shared mapping exists.
+	munmap(mapped, length);
+	if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+		close(fd);
+		return fl_value_new_uint8_list(data, length);
+	}
+	g_mutex_lock(&${codecMethodPrefix}_large_blob_mutex);
+	if (${codecMethodPrefix}_large_blob_fds == nullptr) {
+		${codecMethodPrefix}_large_blob_fds = g_hash_table_new(g_direct_hash, g_direct_equal);
+	}
+	guint source_id = g_timeout_add_seconds(60, ${codecMethodPrefix}_large_blob_expire, GINT_TO_POINTER(fd));
+	g_hash_table_insert(${codecMethodPrefix}_large_blob_fds, GINT_TO_POINTER(fd), GUINT_TO_POINTER(source_id));
+	g_mutex_unlock(&${codecMethodPrefix}_large_blob_mutex);
+	int64_t descriptor[] = {fd, static_cast<int64_t>(length)};
+	return fl_value_new_int64_list(descriptor, 2);
+}
+
+// A private, copy-on-write mapping of a large blob, which the Dart reader
+// mirrors, so that Dart can write to the bytes it views.
+typedef struct {
+	const uint8_t* data;
+	size_t length;
+} $mappingName;
+
+$export $mappingName* ${makeLargeBlobSymbolName('map', dartPackageName)}(int64_t fd, int64_t length) {
+	// Only pending blobs are mapped, so an expired or unknown descriptor is
+	// never closed here.
+	if (!${codecMethodPrefix}_large_blob_claim(fd)) {
+		return nullptr;
+	}
+	// The length comes from the message, so it is checked against the sealed
+	// memfd rather than trusted.
+	struct stat status;
+	if (fstat(fd, &status) != 0 || length <= 0 || status.st_size != length) {
+		close(fd);
+		return nullptr;
+	}
+	void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return nullptr;
+	}
+	$mappingName* mapping = g_new($mappingName, 1);
+	mapping->data = static_cast<const uint8_t*>(data);
+	mapping->length = length;
+	return mapping;
+}
+
+// Called by the finalizer of the Uint8List viewing the mapping.
+$export void ${makeLargeBlobSymbolName('unmap', dartPackageName)}(void* token) {
+	$mappingName* mapping = static_cast<$mappingName*>(token);
+	munmap(const_cast<uint8_t*>(mapping->data), mapping->length);
+	g_free(mapping);
+}
+''');
   }
 
   @override
@@ -837,27 +1512,49 @@ class GObjectSourceGenerator
     final String methodPrefix = _getMethodPrefix(module, classDefinition.name);
     final String testMacro = '${snakeModule}_IS_$snakeClassName'.toUpperCase();
 
-    indent.newln();
-    _writeObjectStruct(indent, module, classDefinition.name, () {
+    final bool boxed = generatorOptions.boxedDataClasses;
+    bool isRetained(NamedType field) =>
+        _isRetainedListField(generatorOptions, field);
+    bool hasLength(NamedType field) =>
+        _isNumericListType(field.type) && !isRetained(field);
+    bool isInline(NamedType field) => _isInlineField(generatorOptions, field);
+    final int inlineFieldCount = classDefinition.fields.where(isInline).length;
+    void writeFields() {
       for (final NamedType field in classDefinition.fields) {
         final String fieldName = _getFieldName(field.name);
-        final String fieldType = _getType(module, field.type, isOutput: true);
+        final String fieldType;
+        if (isRetained(field)) {
+          fieldType = 'FlValue*';
+        } else if (isInline(field)) {
+          fieldType = _getType(module, field.type, primitive: true);
+        } else {
+          fieldType = _getType(module, field.type, isOutput: true);
+        }
         indent.writeln('$fieldType $fieldName;');
-        if (_isNumericListType(field.type)) {
+        if (hasLength(field)) {
           indent.writeln('size_t ${fieldName}_length;');
         }
       }
-    });
-
-    indent.newln();
-    _writeDefineType(indent, module, classDefinition.name);
+      if (inlineFieldCount > 0) {
+        indent.writeln('uint32_t present_[${(inlineFieldCount + 31) ~/ 32}];');
+      }
+    }
 
-    indent.newln();
-    _writeDispose(indent, module, classDefinition.name, () {
-      var haveSelf = false;
+    void writeClearFields({required bool castSelf}) {
+      var haveSelf = !castSelf;
       for (final NamedType field in classDefinition.fields) {
         final String fieldName = _getFieldName(field.name);
-        final String? clear = _getClearFunction(field.type, 'self->$fieldName');
+        if (isInline(field)) {
+          continue;
+        }
+        final String? clear = isRetained(field)
+            ? 'g_clear_pointer(&self->$fieldName, fl_value_unref)'
+            : _getClearFunction(
+                module,
+                field.type,
+                'self->$fieldName',
+                boxedDataClasses: boxed,
+              );
         if (clear != null) {
           if (!haveSelf) {
             _writeCastSelf(indent, module, classDefinition.name, 'object');
@@ -866,80 +1563,238 @@ class GObjectSourceGenerator
           indent.writeln('$clear;');
         }
       }
-    });
+    }
 
     indent.newln();
-    _writeInit(indent, module, classDefinition.name, () {});
+    if (boxed) {
+      indent.writeScoped('struct _$className {', '};', writeFields);
 
-    indent.newln();
-    _writeClassInit(indent, module, classDefinition.name, () {});
+      indent.newln();
+      indent.writeScoped(
+        'static void ${methodPrefix}_clear($className* self) {',
+        '}',
+        () => writeClearFields(castSelf: false),
+      );
 
-    final constructorArgs = <String>[];
-    for (final NamedType field in classDefinition.fields) {
-      final String fieldName = _getFieldName(field.name);
-      constructorArgs.add('${_getType(module, field.type)} $fieldName');
-      if (_isNumericListType(field.type)) {
+      indent.newln();
+      indent.writeScoped(
+        '$className* ${methodPrefix}_ref($className* self) {',
+        '}',
+        () {
+          indent.writeln(
+            'return static_cast<$className*>(g_atomic_rc_box_acquire(self));',
+          );
+        },
+      );
+
+      indent.newln();
+      indent.writeScoped(
+        'void ${methodPrefix}_unref($className* self) {',
+        '}',
+        () {
+          indent.writeln(
+            'g_atomic_rc_box_release_full(self, (GDestroyNotify)${methodPrefix}_clear);',
+          );
+        },
+      );
+
+      indent.newln();
+      indent.writeln(
+        'G_DEFINE_BOXED_TYPE($className, $methodPrefix, ${methodPrefix}_ref, ${methodPrefix}_unref)',
+      );
+    } else {
+      _writeObjectStruct(indent, module, classDefinition.name, writeFields);
+
+      indent.newln();
+      _writeDefineType(indent, module, classDefinition.name);
+
+      indent.newln();
+      _writeDispose(
+        indent,
+        module,
+        classDefinition.name,
+        () => writeClearFields(castSelf: true),
+      );
+
+      indent.newln();
+      _writeInit(indent, module, classDefinition.name, () {});
+
+      indent.newln();
+      _writeClassInit(indent, module, classDefinition.name, () {});
+    }
+
+    // With retained typed lists the fields are set by a constructor that
+    // references the FlValues, which _new creates from the elements.
+    final bool hasRetainedFields = _hasRetainedListFields(
+      generatorOptions,
+      classDefinition,
+    );
+    final String fieldsConstructor = hasRetainedFields
+        ? '${methodPrefix}_new_with_values'
+        : '${methodPrefix}_new';
+    final constructorArgs = <String>[];
+    for (final NamedType field in classDefinition.fields) {
+      final String fieldName = _getFieldName(field.name);
+      final String type = isRetained(field)
+          ? 'FlValue*'
+          : _getType(module, field.type);
+      constructorArgs.add('$type $fieldName');
+      if (hasLength(field)) {
         constructorArgs.add('size_t ${fieldName}_length');
       }
     }
-    indent.newln();
-    indent.writeScoped(
-      "$className* ${methodPrefix}_new(${constructorArgs.join(', ')}) {",
-      '}',
-      () {
+    // Writes the body of a constructor, which adopts its arguments instead of
+    // copying them if [take] is set.
+    void writeConstructorBody({required bool take}) {
+      if (boxed) {
+        indent.writeln('$className* self = g_atomic_rc_box_new0($className);');
+      } else {
         _writeObjectNew(indent, module, classDefinition.name);
-        for (final NamedType field in classDefinition.fields) {
-          final String fieldName = _getFieldName(field.name);
-          final String value = _referenceValue(
+      }
+      for (final NamedType field in classDefinition.fields) {
+        final String fieldName = _getFieldName(field.name);
+        final String value;
+        if (take && _isTakenField(generatorOptions, field)) {
+          value = fieldName;
+        } else if (take && isRetained(field)) {
+          value = _makeFlValue(
+            root,
+            module,
+            TypeDeclaration(baseName: field.type.baseName, isNullable: false),
+            fieldName,
+            lengthVariableName: '${fieldName}_length',
+            boxedDataClasses: boxed,
+          );
+        } else if (isRetained(field)) {
+          value = 'fl_value_ref($fieldName)';
+        } else {
+          value = _referenceValue(
             module,
             field.type,
             fieldName,
             lengthVariableName: '${fieldName}_length',
+            boxedDataClasses: boxed,
           );
+        }
 
-          if (_isNullablePrimitiveType(field.type)) {
-            final String primitiveType = _getType(
-              module,
-              field.type,
-              primitive: true,
+        if (isInline(field)) {
+          final int index = _getInlineFieldIndex(
+            generatorOptions,
+            classDefinition,
+            field,
+          );
+          indent.writeScoped('if ($value != nullptr) {', '}', () {
+            indent.writeln('self->$fieldName = *$value;');
+            indent.writeln(
+              'self->present_[${index ~/ 32}] |= 1u << ${index % 32};',
             );
-            indent.writeScoped('if ($value != nullptr) {', '}', () {
-              indent.writeln(
-                'self->$fieldName = static_cast<$primitiveType*>(malloc(sizeof($primitiveType)));',
-              );
-              indent.writeln('*self->$fieldName = *$value;');
-            });
-            indent.writeScoped('else {', '}', () {
-              indent.writeln('self->$fieldName = nullptr;');
-            });
-          } else if (field.type.isNullable) {
-            indent.writeScoped('if ($fieldName != nullptr) {', '}', () {
-              indent.writeln('self->$fieldName = $value;');
-              if (_isNumericListType(field.type)) {
-                indent.writeln(
-                  'self->${fieldName}_length = ${fieldName}_length;',
-                );
-              }
-            });
-            indent.writeScoped('else {', '}', () {
-              indent.writeln('self->$fieldName = nullptr;');
-              if (_isNumericListType(field.type)) {
-                indent.writeln('self->${fieldName}_length = 0;');
-              }
-            });
-          } else {
+          });
+        } else if (_isNullablePrimitiveType(field.type)) {
+          final String primitiveType = _getType(
+            module,
+            field.type,
+            primitive: true,
+          );
+          indent.writeScoped('if ($value != nullptr) {', '}', () {
+            indent.writeln(
+              'self->$fieldName = static_cast<$primitiveType*>(malloc(sizeof($primitiveType)));',
+            );
+            indent.writeln('*self->$fieldName = *$value;');
+          });
+          indent.writeScoped('else {', '}', () {
+            indent.writeln('self->$fieldName = nullptr;');
+          });
+        } else if (field.type.isNullable) {
+          indent.writeScoped('if ($fieldName != nullptr) {', '}', () {
             indent.writeln('self->$fieldName = $value;');
-            if (_isNumericListType(field.type)) {
+            if (hasLength(field)) {
               indent.writeln(
                 'self->${fieldName}_length = ${fieldName}_length;',
               );
             }
+          });
+          indent.writeScoped('else {', '}', () {
+            indent.writeln('self->$fieldName = nullptr;');
+            if (hasLength(field)) {
+              indent.writeln('self->${fieldName}_length = 0;');
+            }
+          });
+        } else {
+          indent.writeln('self->$fieldName = $value;');
+          if (hasLength(field)) {
+            indent.writeln('self->${fieldName}_length = ${fieldName}_length;');
           }
         }
-        indent.writeln('return self;');
-      },
+      }
+      indent.writeln('return self;');
+    }
+
+    indent.newln();
+    indent.writeScoped(
+      "${hasRetainedFields ? 'static ' : ''}$className* $fieldsConstructor(${constructorArgs.join(', ')}) {",
+      '}',
+      () => writeConstructorBody(take: false),
     );
 
+    if (hasRetainedFields) {
+      final publicArgs = <String>[];
+      for (final NamedType field in classDefinition.fields) {
+        final String fieldName = _getFieldName(field.name);
+        publicArgs.add('${_getType(module, field.type)} $fieldName');
+        if (_isNumericListType(field.type)) {
+          publicArgs.add('size_t ${fieldName}_length');
+        }
+      }
+      indent.newln();
+      indent.writeScoped(
+        "$className* ${methodPrefix}_new(${publicArgs.join(', ')}) {",
+        '}',
+        () {
+          final args = <String>[];
+          for (final NamedType field in classDefinition.fields) {
+            final String fieldName = _getFieldName(field.name);
+            if (!isRetained(field)) {
+              args.add(fieldName);
+              if (_isNumericListType(field.type)) {
+                args.add('${fieldName}_length');
+              }
+              continue;
+            }
+            final String value = _makeFlValue(
+              root,
+              module,
+              TypeDeclaration(baseName: field.type.baseName, isNullable: false),
+              fieldName,
+              lengthVariableName: '${fieldName}_length',
+              boxedDataClasses: boxed,
+            );
+            indent.writeln(
+              field.type.isNullable
+                  ? 'g_autoptr(FlValue) ${fieldName}_value = $fieldName != nullptr ? $value : nullptr;'
+                  : 'g_autoptr(FlValue) ${fieldName}_value = $value;',
+            );
+            args.add('${fieldName}_value');
+          }
+          indent.writeln('return $fieldsConstructor(${args.join(', ')});');
+        },
+      );
+    }
+
+    if (generatorOptions.includeTakeConstructors &&
+        _hasTakeableFields(generatorOptions, classDefinition)) {
+      final List<String> takeArgs = _getTakeConstructorArgs(
+        module,
+        generatorOptions,
+        classDefinition,
+      );
+      indent.newln();
+      indent.writeScoped(
+        "$className* ${methodPrefix}_new_take(${takeArgs.join(', ')}) {",
+        '}',
+        () => writeConstructorBody(take: true),
+      );
+    }
+
     for (final NamedType field in classDefinition.fields) {
       final String fieldName = _getFieldName(field.name);
       final String returnType = _getType(module, field.type);
@@ -953,9 +1808,33 @@ class GObjectSourceGenerator
         '$returnType ${methodPrefix}_get_$fieldName(${getterArgs.join(', ')}) {',
         '}',
         () {
+          final String check = boxed ? 'self != nullptr' : '$testMacro(self)';
           indent.writeln(
-            'g_return_val_if_fail($testMacro(self), ${_getDefaultValue(module, field.type)});',
+            'g_return_val_if_fail($check, ${_getDefaultValue(module, field.type)});',
           );
+          if (isInline(field)) {
+            final String present = _inlineFieldPresent(
+              generatorOptions,
+              classDefinition,
+              field,
+              'self',
+            );
+            indent.writeln('return $present ? &self->$fieldName : nullptr;');
+            return;
+          }
+          if (isRetained(field)) {
+            if (field.type.isNullable) {
+              indent.writeScoped('if (self->$fieldName == nullptr) {', '}', () {
+                indent.writeln('*length = 0;');
+                indent.writeln('return nullptr;');
+              });
+            }
+            indent.writeln('*length = fl_value_get_length(self->$fieldName);');
+            indent.writeln(
+              'return ${_fromFlValue(module, field.type, 'self->$fieldName', boxedDataClasses: boxed)};',
+            );
+            return;
+          }
           if (_isNumericListType(field.type)) {
             indent.writeln('*length = self->${fieldName}_length;');
           }
@@ -964,21 +1843,86 @@ class GObjectSourceGenerator
       );
     }
 
-    indent.newln();
-    indent.writeScoped(
-      'static FlValue* ${methodPrefix}_to_list($className* self) {',
-      '}',
-      () {
-        indent.writeln('FlValue* values = fl_value_new_list();');
-        for (final NamedType field in classDefinition.fields) {
-          final String fieldName = _getFieldName(field.name);
+    final Class? rowClass = classDefinition.columnsOf;
+    if (rowClass != null) {
+      final String rowClassName = _getClassName(module, rowClass.name);
+      final String rowMethodPrefix = _getMethodPrefix(module, rowClass.name);
+      final String check = boxed ? 'self != nullptr' : '$testMacro(self)';
+      indent.newln();
+      indent.writeScoped(
+        'size_t ${methodPrefix}_get_row_count($className* self) {',
+        '}',
+        () {
+          indent.writeln('g_return_val_if_fail($check, 0);');
+          indent.writeln('size_t count = G_MAXSIZE;');
+          indent.writeln('size_t length;');
+          for (final NamedType field in classDefinition.fields) {
+            indent.writeln(
+              '${methodPrefix}_get_${_getFieldName(field.name)}(self, &length);',
+            );
+            indent.writeln('count = MIN(count, length);');
+          }
+          indent.writeln('return count;');
+        },
+      );
+      indent.newln();
+      indent.writeScoped(
+        '$rowClassName* ${methodPrefix}_get_row($className* self, size_t index) {',
+        '}',
+        () {
           indent.writeln(
-            'fl_value_append_take(values, ${_makeFlValue(root, module, field.type, 'self->$fieldName', lengthVariableName: 'self->${fieldName}_length')});',
+            'g_return_val_if_fail(index < ${methodPrefix}_get_row_count(self), nullptr);',
           );
-        }
-        indent.writeln('return values;');
-      },
-    );
+          indent.writeln('size_t length;');
+          final String arguments = classDefinition.fields
+              .map((NamedType field) {
+                final value =
+                    '${methodPrefix}_get_${_getFieldName(field.name)}(self, &length)[index]';
+                return field.type.baseName == 'Uint8List'
+                    ? '$value != 0'
+                    : value;
+              })
+              .join(', ');
+          indent.writeln('return ${rowMethodPrefix}_new($arguments);');
+        },
+      );
+    }
+
+    if (classDefinition.ringBufferCapacity != null) {
+      _writeRingBuffer(
+        indent,
+        module,
+        classDefinition,
+        dartPackageName: dartPackageName,
+      );
+    }
+
+    // With unboxed enums, the compact format or packed records the codec
+    // serializes this class itself, so the list conversions would be unused.
+    if (classDefinition.isCompact ||
+        classDefinition.isPacked ||
+        _hasUnboxedEnumFields(generatorOptions, classDefinition)) {
+      return;
+    }
+
+    // Direct class writers encode the fields without converting the class to
+    // a list.
+    if (!generatorOptions.directClassWriters) {
+      indent.newln();
+      indent.writeScoped(
+        'static FlValue* ${methodPrefix}_to_list($className* self) {',
+        '}',
+        () {
+          indent.writeln('FlValue* values = fl_value_new_list();');
+          for (final NamedType field in classDefinition.fields) {
+            indent.writeln(
+              'fl_value_append_take(values, ${_fieldFlValue(root, module, classDefinition, field, 'self', generatorOptions)});',
+            );
+          }
+          indent.writeln('return values;');
+        },
+      );
+    }
 
     indent.newln();
     indent.writeScoped(
@@ -987,56 +1931,20 @@ class GObjectSourceGenerator
       () {
         final args = <String>[];
         for (var i = 0; i < classDefinition.fields.length; i++) {
-          final NamedType field = classDefinition.fields[i];
-          final String fieldName = _getFieldName(field.name);
-          final String fieldType = _getType(module, field.type);
-          final String fieldValue = _fromFlValue(module, field.type, 'value$i');
           indent.writeln(
             'FlValue* value$i = fl_value_get_list_value(values, $i);',
           );
-          args.add(fieldName);
-          if (_isNullablePrimitiveType(field.type)) {
-            indent.writeln('$fieldType $fieldName = nullptr;');
-            indent.writeln(
-              '${_getType(module, field.type, isOutput: true, primitive: true)} ${fieldName}_value;',
-            );
-            indent.writeScoped(
-              'if (fl_value_get_type(value$i) != FL_VALUE_TYPE_NULL) {',
-              '}',
-              () {
-                indent.writeln('${fieldName}_value = $fieldValue;');
-                indent.writeln('$fieldName = &${fieldName}_value;');
-              },
-            );
-          } else if (field.type.isNullable) {
-            indent.writeln('$fieldType $fieldName = nullptr;');
-            if (_isNumericListType(field.type)) {
-              indent.writeln('size_t ${fieldName}_length = 0;');
-              args.add('${fieldName}_length');
-            }
-            indent.writeScoped(
-              'if (fl_value_get_type(value$i) != FL_VALUE_TYPE_NULL) {',
-              '}',
-              () {
-                indent.writeln('$fieldName = $fieldValue;');
-                if (_isNumericListType(field.type)) {
-                  indent.writeln(
-                    '${fieldName}_length = fl_value_get_length(value$i);',
-                  );
-                }
-              },
-            );
-          } else {
-            indent.writeln('$fieldType $fieldName = $fieldValue;');
-            if (_isNumericListType(field.type)) {
-              indent.writeln(
-                'size_t ${fieldName}_length = fl_value_get_length(value$i);',
-              );
-              args.add('${fieldName}_length');
-            }
-          }
+          _writeFieldFromFlValue(
+            indent,
+            module,
+            classDefinition.fields[i],
+            'value$i',
+            args,
+            boxedDataClasses: generatorOptions.boxedDataClasses,
+            zeroCopyTypedLists: generatorOptions.zeroCopyTypedLists,
+          );
         }
-        indent.writeln('return ${methodPrefix}_new(${args.join(', ')});');
+        indent.writeln('return $fieldsConstructor(${args.join(', ')});');
       },
     );
   }
@@ -1062,7 +1970,13 @@ class GObjectSourceGenerator
       indent,
       module,
       _codecBaseName,
-      () {},
+      () {
+        if (generatorOptions.includeInstrumentation) {
+          indent.writeln('gchar* channel_name;');
+          indent.writeln('gboolean is_host_api;');
+          indent.writeln('gint64 handler_start;');
+        }
+      },
       parentClassName: _standardCodecName,
     );
 
@@ -1080,6 +1994,41 @@ class GObjectSourceGenerator
       indent.writeln('const int $customTypeId = ${customType.enumeration};');
     }
 
+    final bool hasUnboxedEnumFields = root.classes.any(
+      (Class classDefinition) =>
+          _hasUnboxedEnumFields(generatorOptions, classDefinition),
+    );
+    final bool directClassWriters =
+        generatorOptions.directClassWriters &&
+        root.classes.any(
+          (Class classDefinition) =>
+              !classDefinition.isCompact && !classDefinition.isPacked,
+        );
+    final bool writesEnumFields =
+        hasUnboxedEnumFields ||
+        (directClassWriters &&
+            root.classes.any(
+              (Class classDefinition) =>
+                  !classDefinition.isCompact &&
+                  classDefinition.fields.any(
+                    (NamedType field) => field.type.isEnum,
+                  ),
+            ));
+    if (writesEnumFields) {
+      _writeUnboxedEnumSupport(indent, module, readers: hasUnboxedEnumFields);
+    }
+    if (directClassWriters) {
+      _writeDirectWriterSupport(root, indent, module, generatorOptions);
+    }
+    if (root.classes.any(
+      (Class classDefinition) => classDefinition.isCompact,
+    )) {
+      _writeCompactSupport(root, indent, module, generatorOptions);
+    }
+    if (root.classes.any((Class classDefinition) => classDefinition.isPacked)) {
+      _writePackedSupport(customTypes, indent, module);
+    }
+
     for (final customType in customTypes) {
       final String customTypeName = _getClassName(module, customType.name);
       final String snakeCustomTypeName = _snakeCaseFromCamelCase(
@@ -1099,7 +2048,36 @@ class GObjectSourceGenerator
           indent.writeln(
             'g_byte_array_append(buffer, &type, sizeof(uint8_t));',
           );
-          if (customType.type == CustomTypes.customClass) {
+          if (customType.type == CustomTypes.customClass &&
+              customType.associatedClass!.isCompact) {
+            indent.writeln(
+              '${codecMethodPrefix}_write_compact_$snakeCustomTypeName(buffer, value);',
+            );
+            indent.writeln('return TRUE;');
+          } else if (customType.type == CustomTypes.customClass &&
+              customType.associatedClass!.isPacked) {
+            indent.writeln('uint8_t kind = 0;');
+            indent.writeln(
+              'g_byte_array_append(buffer, &kind, sizeof(uint8_t));',
+            );
+            indent.writeln(
+              '${codecMethodPrefix}_write_packed_$snakeCustomTypeName(buffer, value);',
+            );
+            indent.writeln('return TRUE;');
+          } else if (customType.type == CustomTypes.customClass &&
+              (generatorOptions.directClassWriters ||
+                  _hasUnboxedEnumFields(
+                    generatorOptions,
+                    customType.associatedClass!,
+                  ))) {
+            _writeUnboxedClassWriter(
+              root,
+              indent,
+              module,
+              customType.associatedClass!,
+              generatorOptions,
+            );
+          } else if (customType.type == CustomTypes.customClass) {
             indent.writeln(
               'g_autoptr(FlValue) values = ${snakeCustomTypeName}_to_list(value);',
             );
@@ -1113,6 +2091,24 @@ class GObjectSourceGenerator
           }
         },
       );
+
+      if (customType.type == CustomTypes.customClass &&
+          customType.associatedClass!.isPacked) {
+        final String methodPrefix = _getMethodPrefix(module, customType.name);
+        indent.newln();
+        indent.format('''
+static gboolean ${codecMethodPrefix}_write_${snakeCustomTypeName}_list($_standardCodecName* codec, GByteArray* buffer, FlValue* value, GError** error) {
+\tuint8_t type = $customTypeId;
+\tg_byte_array_append(buffer, &type, sizeof(uint8_t));
+\tuint8_t kind = 1;
+\tg_byte_array_append(buffer, &kind, sizeof(uint8_t));
+\tsize_t length;
+\tconst ${customTypeName}Packed* records = ${methodPrefix}_packed_list_get_records(value, &length);
+\tfl_standard_message_codec_write_size(codec, buffer, length);
+\tg_byte_array_append(buffer, reinterpret_cast<const uint8_t*>(records), length * sizeof(${customTypeName}Packed));
+\treturn TRUE;
+}''');
+      }
     }
 
     indent.newln();
@@ -1142,13 +2138,15 @@ class GObjectSourceGenerator
                     final String snakeCustomTypeName = _snakeCaseFromCamelCase(
                       customTypeName,
                     );
-                    final String castMacro = _getClassCastMacro(
-                      module,
-                      customType.name,
-                    );
                     if (customType.type == CustomTypes.customClass) {
+                      final String object = _classFromFlValue(
+                        module,
+                        customType.name,
+                        'value',
+                        boxedDataClasses: generatorOptions.boxedDataClasses,
+                      );
                       indent.writeln(
-                        'return ${codecMethodPrefix}_write_$snakeCustomTypeName(codec, buffer, $castMacro(fl_value_get_custom_value_object(value)), error);',
+                        'return ${codecMethodPrefix}_write_$snakeCustomTypeName(codec, buffer, $object, error);',
                       );
                     } else if (customType.type == CustomTypes.customEnum) {
                       indent.writeln(
@@ -1156,6 +2154,16 @@ class GObjectSourceGenerator
                       );
                     }
                   });
+                  if (customType.associatedClass?.isPacked ?? false) {
+                    indent.writeln(
+                      'case ${_getMethodPrefix(module, customType.name)}_packed_list_type_id:',
+                    );
+                    indent.nest(1, () {
+                      indent.writeln(
+                        'return ${codecMethodPrefix}_write_${_snakeCaseFromCamelCase(_getClassName(module, customType.name))}_list(codec, buffer, value, error);',
+                      );
+                    });
+                  }
                 }
               },
             );
@@ -1180,7 +2188,39 @@ class GObjectSourceGenerator
         'static FlValue* ${codecMethodPrefix}_read_$snakeCustomTypeName($_standardCodecName* codec, GBytes* buffer, size_t* offset, GError** error) {',
         '}',
         () {
-          if (customType.type == CustomTypes.customClass) {
+          if (customType.type == CustomTypes.customClass &&
+              customType.associatedClass!.isCompact) {
+            indent.writeln(
+              'g_autoptr($customTypeName) value = ${codecMethodPrefix}_read_compact_$snakeCustomTypeName(buffer, offset, error);',
+            );
+            indent.writeScoped('if (value == nullptr) {', '}', () {
+              indent.writeln('return nullptr;');
+            });
+            indent.writeln(
+              'return ${_newClassFlValue(module, customType.name, customTypeId, 'value', boxedDataClasses: generatorOptions.boxedDataClasses)};',
+            );
+          } else if (customType.type == CustomTypes.customClass &&
+              customType.associatedClass!.isPacked) {
+            _writePackedClassReader(
+              indent,
+              module,
+              customType,
+              generatorOptions,
+            );
+          } else if (customType.type == CustomTypes.customClass &&
+              _hasUnboxedEnumFields(
+                generatorOptions,
+                customType.associatedClass!,
+              )) {
+            _writeUnboxedClassReader(
+              root,
+              indent,
+              module,
+              customType.associatedClass!,
+              customTypeId,
+              generatorOptions,
+            );
+          } else if (customType.type == CustomTypes.customClass) {
             indent.writeln(
               'g_autoptr(FlValue) values = fl_standard_message_codec_read_value(codec, buffer, offset, error);',
             );
@@ -1199,7 +2239,7 @@ class GObjectSourceGenerator
             });
             indent.newln();
             indent.writeln(
-              'return fl_value_new_custom_object($customTypeId, G_OBJECT(value));',
+              'return ${_newClassFlValue(module, customType.name, customTypeId, 'value', boxedDataClasses: generatorOptions.boxedDataClasses)};',
             );
           } else if (customType.type == CustomTypes.customEnum) {
             indent.writeln(
@@ -1243,32 +2283,2666 @@ class GObjectSourceGenerator
       },
     );
 
-    indent.newln();
-    _writeInit(indent, module, _codecBaseName, () {});
+    if (generatorOptions.encodedSizes) {
+      _writeEncodedSizeSupport(root, indent, module, generatorOptions);
+    }
 
-    indent.newln();
-    _writeClassInit(indent, module, _codecBaseName, () {
-      indent.writeln(
-        'FL_STANDARD_MESSAGE_CODEC_CLASS(klass)->write_value = ${codecMethodPrefix}_write_value;',
-      );
-      indent.writeln(
-        'FL_STANDARD_MESSAGE_CODEC_CLASS(klass)->read_value_of_type = ${codecMethodPrefix}_read_value_of_type;',
+    if (generatorOptions.includeInstrumentation) {
+      _writeCodecInstrumentation(
+        indent,
+        module,
+        encodedSizes: generatorOptions.encodedSizes,
       );
-    }, hasDispose: false);
+
+      indent.newln();
+      _writeDispose(indent, module, _codecBaseName, () {
+        _writeCastSelf(indent, module, _codecBaseName, 'object');
+        indent.writeln('g_clear_pointer(&self->channel_name, g_free);');
+      });
+    }
 
     indent.newln();
-    indent.writeScoped(
-      'static $codecClassName* ${codecMethodPrefix}_new() {',
-      '}',
-      () {
+    _writeInit(indent, module, _codecBaseName, () {});
+
+    indent.newln();
+    _writeClassInit(
+      indent,
+      module,
+      _codecBaseName,
+      () {
+        indent.writeln(
+          'FL_STANDARD_MESSAGE_CODEC_CLASS(klass)->write_value = ${codecMethodPrefix}_write_value;',
+        );
+        indent.writeln(
+          'FL_STANDARD_MESSAGE_CODEC_CLASS(klass)->read_value_of_type = ${codecMethodPrefix}_read_value_of_type;',
+        );
+        if (generatorOptions.includeInstrumentation) {
+          indent.writeln(
+            'FL_MESSAGE_CODEC_CLASS(klass)->encode_message = ${codecMethodPrefix}_encode_message;',
+          );
+          indent.writeln(
+            'FL_MESSAGE_CODEC_CLASS(klass)->decode_message = ${codecMethodPrefix}_decode_message;',
+          );
+        } else if (generatorOptions.encodedSizes) {
+          indent.writeln(
+            'FL_MESSAGE_CODEC_CLASS(klass)->encode_message = ${codecMethodPrefix}_encode_message_reserved;',
+          );
+        }
+      },
+      hasDispose: generatorOptions.includeInstrumentation,
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'static $codecClassName* ${codecMethodPrefix}_new() {',
+      '}',
+      () {
         _writeObjectNew(indent, module, _codecBaseName);
         indent.writeln('return self;');
       },
     );
+
+    // The codec is stateless, so a single instance is shared by every channel
+    // and is never freed. Callers borrow the reference rather than owning it.
+    if (_usesSharedCodec(generatorOptions, root)) {
+      indent.newln();
+      indent.writeScoped(
+        'static $codecClassName* ${codecMethodPrefix}_get_instance() {',
+        '}',
+        () {
+          indent.writeln('static gsize instance = 0;');
+          indent.writeScoped('if (g_once_init_enter(&instance)) {', '}', () {
+            indent.writeln(
+              'g_once_init_leave(&instance, GPOINTER_TO_SIZE(${codecMethodPrefix}_new()));',
+            );
+          });
+          indent.writeln(
+            'return ${_getClassCastMacro(module, _codecBaseName)}(GSIZE_TO_POINTER(instance));',
+          );
+        },
+      );
+    }
+
+    if (generatorOptions.encodedSizes) {
+      for (final EnumeratedType customType in customTypes.where(
+        (EnumeratedType customType) =>
+            customType.type == CustomTypes.customClass,
+      )) {
+        _writeClassEncodedSize(indent, module, customType, generatorOptions);
+      }
+    }
+
+    // Instrumented codecs report the channel they belong to, so there is one
+    // shared instance per channel name rather than one for the whole module.
+    if (generatorOptions.includeInstrumentation) {
+      indent.newln();
+      indent.writeScoped(
+        'static $codecClassName* ${codecMethodPrefix}_get_instance_for_channel(const gchar* channel_name, gboolean is_host_api) {',
+        '}',
+        () {
+          indent.writeln('static GMutex mutex;');
+          indent.writeln('static GHashTable* instances = nullptr;');
+          indent.writeln('g_mutex_lock(&mutex);');
+          indent.writeScoped('if (instances == nullptr) {', '}', () {
+            indent.writeln(
+              'instances = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, nullptr);',
+            );
+          });
+          indent.writeln(
+            '$codecClassName* instance = static_cast<$codecClassName*>(g_hash_table_lookup(instances, channel_name));',
+          );
+          indent.writeScoped('if (instance == nullptr) {', '}', () {
+            indent.writeln('instance = ${codecMethodPrefix}_new();');
+            indent.writeln('instance->channel_name = g_strdup(channel_name);');
+            indent.writeln('instance->is_host_api = is_host_api;');
+            indent.writeln(
+              'g_hash_table_insert(instances, g_strdup(channel_name), instance);',
+            );
+          });
+          indent.writeln('g_mutex_unlock(&mutex);');
+          indent.writeln('return instance;');
+        },
+      );
+    }
+  }
+
+  // Writes the functions that compute the encoded size of values, and the
+  // encode_message override that allocates messages at their exact size.
+  void _writeEncodedSizeSupport(
+    Root root,
+    Indent indent,
+    String module,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final Iterable<EnumeratedType> customTypes = getEnumeratedTypes(
+      root,
+      excludeSealedClasses: true,
+    );
+
+    indent.newln();
+    indent.format('''
+// Returns `end` plus the number of bytes the standard codec writes `size` as.
+static size_t ${codecMethodPrefix}_add_size_size(size_t end, size_t size) {
+\treturn end + (size < 254 ? 1 : size <= 0xffff ? 3 : 5);
+}
+
+// Returns `end` padded to a multiple of `alignment`.
+static size_t ${codecMethodPrefix}_align_end(size_t end, size_t alignment) {
+\treturn (end + alignment - 1) / alignment * alignment;
+}
+
+// Ints that fit are written as 32-bit integers.
+static size_t ${codecMethodPrefix}_int_encoded_size(int64_t value) {
+\treturn value >= G_MININT32 && value <= G_MAXINT32 ? 5 : 9;
+}
+
+static size_t ${codecMethodPrefix}_string_encoded_end(const gchar* value, size_t offset) {
+\tconst size_t length = strlen(value);
+\treturn ${codecMethodPrefix}_add_size_size(offset + 1, length) + length;
+}
+
+// Typed lists are padded to their element size, even when empty.
+static size_t ${codecMethodPrefix}_typed_list_encoded_end(size_t offset, size_t length, size_t element_size) {
+\treturn ${codecMethodPrefix}_align_end(${codecMethodPrefix}_add_size_size(offset + 1, length), element_size) + length * element_size;
+}''');
+    if (root.classes.any(
+      (Class classDefinition) => classDefinition.isCompact,
+    )) {
+      _writeCompactEncodedEnds(root, indent, module, generatorOptions);
+    }
+
+    indent.newln();
+    indent.writeScoped(
+      'static size_t ${codecMethodPrefix}_value_encoded_size(FlValue* value, size_t offset) {',
+      '}',
+      () {
+        indent.writeScoped('if (value == nullptr) {', '}', () {
+          indent.writeln('return 1;');
+        });
+        indent.writeScoped('switch (fl_value_get_type(value)) {', '}', () {
+          indent.format('''
+case FL_VALUE_TYPE_INT:
+\treturn ${codecMethodPrefix}_int_encoded_size(fl_value_get_int(value));
+case FL_VALUE_TYPE_FLOAT:
+\treturn ${codecMethodPrefix}_align_end(offset + 1, 8) + 8 - offset;
+case FL_VALUE_TYPE_STRING:
+\treturn ${codecMethodPrefix}_string_encoded_end(fl_value_get_string(value), offset) - offset;
+case FL_VALUE_TYPE_UINT8_LIST:
+\treturn ${codecMethodPrefix}_typed_list_encoded_end(offset, fl_value_get_length(value), sizeof(uint8_t)) - offset;
+case FL_VALUE_TYPE_INT32_LIST:
+\treturn ${codecMethodPrefix}_typed_list_encoded_end(offset, fl_value_get_length(value), sizeof(int32_t)) - offset;
+case FL_VALUE_TYPE_INT64_LIST:
+\treturn ${codecMethodPrefix}_typed_list_encoded_end(offset, fl_value_get_length(value), sizeof(int64_t)) - offset;
+case FL_VALUE_TYPE_FLOAT32_LIST:
+\treturn ${codecMethodPrefix}_typed_list_encoded_end(offset, fl_value_get_length(value), sizeof(float)) - offset;
+case FL_VALUE_TYPE_FLOAT_LIST:
+\treturn ${codecMethodPrefix}_typed_list_encoded_end(offset, fl_value_get_length(value), sizeof(double)) - offset;''');
+          indent.writeln('case FL_VALUE_TYPE_LIST: {');
+          indent.nest(1, () {
+            indent.format('''
+const size_t length = fl_value_get_length(value);
+size_t end = ${codecMethodPrefix}_add_size_size(offset + 1, length);
+for (size_t i = 0; i < length; i++) {
+\tend += ${codecMethodPrefix}_value_encoded_size(fl_value_get_list_value(value, i), end);
+}
+return end - offset;''');
+          });
+          indent.writeln('}');
+          indent.writeln('case FL_VALUE_TYPE_MAP: {');
+          indent.nest(1, () {
+            indent.format('''
+const size_t length = fl_value_get_length(value);
+size_t end = ${codecMethodPrefix}_add_size_size(offset + 1, length);
+for (size_t i = 0; i < length; i++) {
+\tend += ${codecMethodPrefix}_value_encoded_size(fl_value_get_map_key(value, i), end);
+\tend += ${codecMethodPrefix}_value_encoded_size(fl_value_get_map_value(value, i), end);
+}
+return end - offset;''');
+          });
+          indent.writeln('}');
+          indent.writeln('case FL_VALUE_TYPE_CUSTOM:');
+          indent.nest(1, () {
+            indent.writeScoped(
+              'switch (fl_value_get_custom_type(value)) {',
+              '}',
+              () {
+                for (final customType in customTypes) {
+                  indent.writeln(
+                    'case ${_getCustomTypeId(module, customType)}:',
+                  );
+                  indent.nest(1, () {
+                    if (customType.type == CustomTypes.customClass) {
+                      final String object = _classFromFlValue(
+                        module,
+                        customType.name,
+                        'value',
+                        boxedDataClasses: generatorOptions.boxedDataClasses,
+                      );
+                      indent.writeln(
+                        'return ${_getMethodPrefix(module, customType.name)}_encoded_size($object, offset);',
+                      );
+                    } else {
+                      indent.writeln(
+                        '// The type byte, then the index as an int32.',
+                      );
+                      indent.writeln('return 6;');
+                    }
+                  });
+                  if (customType.associatedClass?.isPacked ?? false) {
+                    final String methodPrefix = _getMethodPrefix(
+                      module,
+                      customType.name,
+                    );
+                    indent.writeln(
+                      'case ${methodPrefix}_packed_list_type_id: {',
+                    );
+                    indent.nest(1, () {
+                      indent.format('''
+size_t length;
+${methodPrefix}_packed_list_get_records(value, &length);
+// The type byte, the packed kind and the count, then the records.
+return ${codecMethodPrefix}_add_size_size(offset + 2, length) + length * ${getPackedLayout(customType.associatedClass!).size} - offset;''');
+                    });
+                    indent.writeln('}');
+                  }
+                }
+                indent.writeln('default:');
+                indent.nest(1, () {
+                  indent.writeln('return 1;');
+                });
+              },
+            );
+          });
+          indent.writeln('default:');
+          indent.nest(1, () {
+            indent.writeln('// Null and bools are only a type byte.');
+            indent.writeln('return 1;');
+          });
+        });
+      },
+    );
+
+    indent.newln();
+    indent.format('''
+static GBytes* ${codecMethodPrefix}_encode_message_reserved(FlMessageCodec* codec, FlValue* message, GError** error) {
+\tGByteArray* buffer = g_byte_array_sized_new(${codecMethodPrefix}_value_encoded_size(message, 0));
+\tif (!fl_standard_message_codec_write_value(FL_STANDARD_MESSAGE_CODEC(codec), buffer, message, error)) {
+\t\tg_byte_array_unref(buffer);
+\t\treturn nullptr;
+\t}
+\treturn g_byte_array_free_to_bytes(buffer);
+}''');
+  }
+
+  // Writes the `*_encoded_size` function of the class of [customType], which
+  // follows the field order of its list encoding, or of its own encoding for
+  // packed and compact classes.
+  void _writeClassEncodedSize(
+    Indent indent,
+    String module,
+    EnumeratedType customType,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final Class classDefinition = customType.associatedClass!;
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final String className = _getClassName(module, classDefinition.name);
+    final String methodPrefix = _getMethodPrefix(module, classDefinition.name);
+    final String testMacro =
+        '${_snakeCaseFromCamelCase(module)}_IS_${_snakeCaseFromCamelCase(classDefinition.name)}'
+            .toUpperCase();
+
+    indent.newln();
+    indent.writeScoped(
+      'size_t ${methodPrefix}_encoded_size($className* self, size_t offset) {',
+      '}',
+      () {
+        indent.writeln(
+          'g_return_val_if_fail(${generatorOptions.boxedDataClasses ? 'self != nullptr' : '$testMacro(self)'}, 0);',
+        );
+        if (classDefinition.isPacked) {
+          final int recordSize = getPackedLayout(classDefinition).size;
+          indent.writeln(
+            '// The type byte and the packed kind, then the record.',
+          );
+          indent.writeln('return ${2 + recordSize};');
+          return;
+        }
+        if (classDefinition.isCompact) {
+          final String snakeClassName = _snakeCaseFromCamelCase(className);
+          indent.writeln(
+            '// The type byte, then the fields in the compact format.',
+          );
+          indent.writeln(
+            'return ${codecMethodPrefix}_compact_encoded_end_$snakeClassName(self, offset + 1) - offset;',
+          );
+          return;
+        }
+        indent.writeln('// The type byte, then the fields as a list.');
+        indent.writeln(
+          'size_t end = ${codecMethodPrefix}_add_size_size(offset + 2, ${classDefinition.fields.length});',
+        );
+        for (final NamedType field in classDefinition.fields) {
+          final variableName = 'self->${_getFieldName(field.name)}';
+          final TypeDeclaration type = field.type;
+          final String? present;
+          final String statement;
+          if (_isInlineField(generatorOptions, field)) {
+            present = _inlineFieldPresent(
+              generatorOptions,
+              classDefinition,
+              field,
+              'self',
+            );
+            statement = _encodedSizeStatement(module, type, variableName);
+          } else if (_isRetainedListField(generatorOptions, field) ||
+              _isFlValueWrappedType(type)) {
+            present = null;
+            statement =
+                'end += ${codecMethodPrefix}_value_encoded_size($variableName, end);';
+          } else {
+            final bool isPointer =
+                type.isNullable &&
+                !type.isClass &&
+                type.baseName != 'String' &&
+                !_isNumericListType(type);
+            present = type.isNullable ? '$variableName != nullptr' : null;
+            statement = _encodedSizeStatement(
+              module,
+              type,
+              isPointer ? '*$variableName' : variableName,
+              lengthVariableName: '${variableName}_length',
+            );
+          }
+          if (present == null) {
+            indent.writeln(statement);
+          } else {
+            indent.writeScoped('if ($present) {', '} ', () {
+              indent.writeln(statement);
+            }, addTrailingNewline: false);
+            indent.addScoped('else {', '}', () {
+              indent.writeln('end += 1;');
+            });
+          }
+        }
+        indent.writeln('return end - offset;');
+      },
+    );
+  }
+
+  // Returns the statement that advances `end` past the encoding of [value].
+  String _encodedSizeStatement(
+    String module,
+    TypeDeclaration type,
+    String value, {
+    String? lengthVariableName,
+  }) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    if (type.isClass) {
+      return 'end += ${_getMethodPrefix(module, type.baseName)}_encoded_size($value, end);';
+    } else if (type.isEnum) {
+      return 'end += 6;';
+    }
+    return switch (type.baseName) {
+      'bool' => 'end += 1;',
+      'int' => 'end += ${codecMethodPrefix}_int_encoded_size($value);',
+      'double' => 'end = ${codecMethodPrefix}_align_end(end + 1, 8) + 8;',
+      'String' =>
+        'end = ${codecMethodPrefix}_string_encoded_end($value, end);',
+      'Uint8List' =>
+        'end = ${codecMethodPrefix}_typed_list_encoded_end(end, $lengthVariableName, sizeof(uint8_t));',
+      'Int32List' =>
+        'end = ${codecMethodPrefix}_typed_list_encoded_end(end, $lengthVariableName, sizeof(int32_t));',
+      'Int64List' =>
+        'end = ${codecMethodPrefix}_typed_list_encoded_end(end, $lengthVariableName, sizeof(int64_t));',
+      'Float32List' =>
+        'end = ${codecMethodPrefix}_typed_list_encoded_end(end, $lengthVariableName, sizeof(float));',
+      'Float64List' =>
+        'end = ${codecMethodPrefix}_typed_list_encoded_end(end, $lengthVariableName, sizeof(double));',
+      _ => throw Exception('Unknown type ${type.baseName}'),
+    };
+  }
+
+  // Writes the helpers that read and write enum values without boxing them
+  // in an FlValue. Values use the standard codec encoding: the enum type byte
+  // followed by the index as a 32-bit integer.
+  void _writeUnboxedEnumSupport(
+    Indent indent,
+    String module, {
+    required bool readers,
+  }) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+
+    indent.newln();
+    indent.writeScoped(
+      'static void ${codecMethodPrefix}_write_enum_value(GByteArray* buffer, uint8_t type, gboolean is_null, int64_t index) {',
+      '}',
+      () {
+        indent.writeScoped('if (is_null) {', '}', () {
+          indent.writeln('uint8_t null_type = 0;');
+          indent.writeln(
+            'g_byte_array_append(buffer, &null_type, sizeof(uint8_t));',
+          );
+          indent.writeln('return;');
+        });
+        indent.writeln('g_byte_array_append(buffer, &type, sizeof(uint8_t));');
+        indent.writeln('uint8_t index_type = 3;');
+        indent.writeln(
+          'g_byte_array_append(buffer, &index_type, sizeof(uint8_t));',
+        );
+        indent.writeln('int32_t value = index;');
+        indent.writeln(
+          'g_byte_array_append(buffer, reinterpret_cast<const uint8_t*>(&value), sizeof(int32_t));',
+        );
+      },
+    );
+
+    if (!readers) {
+      return;
+    }
+
+    indent.newln();
+    indent.writeScoped(
+      'static gboolean ${codecMethodPrefix}_read_enum_value(GBytes* buffer, size_t* offset, uint8_t type, gboolean* is_null, int64_t* index, GError** error) {',
+      '}',
+      () {
+        indent.writeln('size_t size;');
+        indent.writeln(
+          'const uint8_t* data = static_cast<const uint8_t*>(g_bytes_get_data(buffer, &size));',
+        );
+        indent.writeScoped('if (*offset >= size) {', '}', () {
+          indent.writeln(
+            'g_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_OUT_OF_DATA, "Unexpected end of data");',
+          );
+          indent.writeln('return FALSE;');
+        });
+        indent.writeln('uint8_t value_type = data[(*offset)++];');
+        indent.writeScoped(
+          'if (value_type == 0 && is_null != nullptr) {',
+          '}',
+          () {
+            indent.writeln('*is_null = TRUE;');
+            indent.writeln('return TRUE;');
+          },
+        );
+        indent.writeScoped(
+          'if (value_type == type && *offset < size) {',
+          '}',
+          () {
+            indent.writeln('uint8_t index_type = data[(*offset)++];');
+            indent.writeScoped(
+              'if (index_type == 3 && *offset + sizeof(int32_t) <= size) {',
+              '}',
+              () {
+                indent.writeln('int32_t value;');
+                indent.writeln(
+                  'memcpy(&value, data + *offset, sizeof(int32_t));',
+                );
+                indent.writeln('*offset += sizeof(int32_t);');
+                indent.writeln('*index = value;');
+                indent.writeScoped('if (is_null != nullptr) {', '}', () {
+                  indent.writeln('*is_null = FALSE;');
+                });
+                indent.writeln('return TRUE;');
+              },
+            );
+            indent.writeScoped(
+              'if (index_type == 4 && *offset + sizeof(int64_t) <= size) {',
+              '}',
+              () {
+                indent.writeln(
+                  'memcpy(index, data + *offset, sizeof(int64_t));',
+                );
+                indent.writeln('*offset += sizeof(int64_t);');
+                indent.writeScoped('if (is_null != nullptr) {', '}', () {
+                  indent.writeln('*is_null = FALSE;');
+                });
+                indent.writeln('return TRUE;');
+              },
+            );
+          },
+        );
+        indent.writeln(
+          'g_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_FAILED, "Invalid data received for enum");',
+        );
+        indent.writeln('return FALSE;');
+      },
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'static gboolean ${codecMethodPrefix}_read_list_header($_standardCodecName* codec, GBytes* buffer, size_t* offset, uint32_t length, GError** error) {',
+      '}',
+      () {
+        indent.writeln('size_t size;');
+        indent.writeln(
+          'const uint8_t* data = static_cast<const uint8_t*>(g_bytes_get_data(buffer, &size));',
+        );
+        indent.writeScoped(
+          'if (*offset >= size || data[*offset] != 12) {',
+          '}',
+          () {
+            indent.writeln(
+              'g_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_FAILED, "Expected a list");',
+            );
+            indent.writeln('return FALSE;');
+          },
+        );
+        indent.writeln('(*offset)++;');
+        indent.writeln('uint32_t actual_length;');
+        indent.writeScoped(
+          'if (!fl_standard_message_codec_read_size(codec, buffer, offset, &actual_length, error)) {',
+          '}',
+          () {
+            indent.writeln('return FALSE;');
+          },
+        );
+        indent.writeScoped('if (actual_length != length) {', '}', () {
+          indent.writeln(
+            'g_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_FAILED, "Unexpected list length %u", actual_length);',
+          );
+          indent.writeln('return FALSE;');
+        });
+        indent.writeln('return TRUE;');
+      },
+    );
+  }
+
+  // Writes the helpers used to write data class fields directly to the codec
+  // buffer. Only the helpers needed by the fields in [root] are written.
+  void _writeDirectWriterSupport(
+    Root root,
+    Indent indent,
+    String module,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final Iterable<NamedType> fields = root.classes
+        .where(
+          (Class classDefinition) =>
+              !classDefinition.isCompact && !classDefinition.isPacked,
+        )
+        .expand((Class classDefinition) => classDefinition.fields);
+    bool hasField(bool Function(TypeDeclaration type) test) => fields.any(
+      (NamedType field) => !field.type.isEnum && test(field.type),
+    );
+    final bool hasInt = hasField(
+      (TypeDeclaration type) => type.baseName == 'int',
+    );
+    final bool hasDouble = hasField(
+      (TypeDeclaration type) => type.baseName == 'double',
+    );
+    final bool hasString = hasField(
+      (TypeDeclaration type) => type.baseName == 'String',
+    );
+    final bool hasTypedList = fields.any(
+      (NamedType field) =>
+          _isNumericListType(field.type) &&
+          !_isRetainedListField(generatorOptions, field),
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'static void ${codecMethodPrefix}_write_type(GByteArray* buffer, uint8_t type) {',
+      '}',
+      () {
+        indent.writeln('g_byte_array_append(buffer, &type, sizeof(uint8_t));');
+      },
+    );
+
+    if (hasDouble || hasTypedList) {
+      indent.newln();
+      indent.writeScoped(
+        'static void ${codecMethodPrefix}_write_align(GByteArray* buffer, guint alignment) {',
+        '}',
+        () {
+          indent.writeScoped('while (buffer->len % alignment != 0) {', '}', () {
+            indent.writeln('${codecMethodPrefix}_write_type(buffer, 0);');
+          });
+        },
+      );
+    }
+
+    if (hasInt) {
+      indent.newln();
+      indent.writeScoped(
+        'static void ${codecMethodPrefix}_write_int(GByteArray* buffer, int64_t value) {',
+        '}',
+        () {
+          indent.writeScoped(
+            'if (value >= INT32_MIN && value <= INT32_MAX) {',
+            '}',
+            () {
+              indent.writeln('${codecMethodPrefix}_write_type(buffer, 3);');
+              indent.writeln('int32_t value32 = value;');
+              indent.writeln(
+                'g_byte_array_append(buffer, reinterpret_cast<const uint8_t*>(&value32), sizeof(int32_t));',
+              );
+            },
+          );
+          indent.writeScoped('else {', '}', () {
+            indent.writeln('${codecMethodPrefix}_write_type(buffer, 4);');
+            indent.writeln(
+              'g_byte_array_append(buffer, reinterpret_cast<const uint8_t*>(&value), sizeof(int64_t));',
+            );
+          });
+        },
+      );
+    }
+
+    if (hasDouble) {
+      indent.newln();
+      indent.writeScoped(
+        'static void ${codecMethodPrefix}_write_double(GByteArray* buffer, double value) {',
+        '}',
+        () {
+          indent.writeln('${codecMethodPrefix}_write_type(buffer, 6);');
+          indent.writeln('${codecMethodPrefix}_write_align(buffer, 8);');
+          indent.writeln(
+            'g_byte_array_append(buffer, reinterpret_cast<const uint8_t*>(&value), sizeof(double));',
+          );
+        },
+      );
+    }
+
+    if (hasString) {
+      indent.newln();
+      indent.writeScoped(
+        'static void ${codecMethodPrefix}_write_string($_standardCodecName* codec, GByteArray* buffer, const gchar* value) {',
+        '}',
+        () {
+          indent.writeln('${codecMethodPrefix}_write_type(buffer, 7);');
+          indent.writeln('size_t length = strlen(value);');
+          indent.writeln(
+            'fl_standard_message_codec_write_size(codec, buffer, length);',
+          );
+          indent.writeln(
+            'g_byte_array_append(buffer, reinterpret_cast<const uint8_t*>(value), length);',
+          );
+        },
+      );
+    }
+
+    if (hasTypedList) {
+      indent.newln();
+      indent.writeScoped(
+        'static void ${codecMethodPrefix}_write_typed_list($_standardCodecName* codec, GByteArray* buffer, uint8_t type, const void* data, size_t length, size_t element_size) {',
+        '}',
+        () {
+          indent.writeln('${codecMethodPrefix}_write_type(buffer, type);');
+          indent.writeln(
+            'fl_standard_message_codec_write_size(codec, buffer, length);',
+          );
+          indent.writeln(
+            '${codecMethodPrefix}_write_align(buffer, element_size);',
+          );
+          indent.writeln(
+            'g_byte_array_append(buffer, static_cast<const uint8_t*>(data), length * element_size);',
+          );
+        },
+      );
+    }
+
+    // Class fields are written by the codec function of their class, which
+    // may be defined after the class that contains them.
+    if (fields.any((NamedType field) => field.type.isClass)) {
+      indent.newln();
+      for (final Class classDefinition in root.classes) {
+        final String className = _getClassName(module, classDefinition.name);
+        final String snakeClassName = _snakeCaseFromCamelCase(className);
+        indent.writeln(
+          'static gboolean ${codecMethodPrefix}_write_$snakeClassName($_standardCodecName* codec, GByteArray* buffer, $className* value, GError** error);',
+        );
+      }
+    }
+  }
+
+  // Writes the helpers and the functions that write and read compact classes.
+  void _writeCompactSupport(
+    Root root,
+    Indent indent,
+    String module,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final List<Class> compactClasses = root.classes
+        .where((Class classDefinition) => classDefinition.isCompact)
+        .toList();
+    final Iterable<TypeDeclaration> types = compactClasses
+        .expand((Class classDefinition) => classDefinition.fields)
+        .map((NamedType field) => field.type);
+    final bool hasVarints = types.any(
+      (TypeDeclaration type) =>
+          !type.isClass && type.baseName != 'bool' && type.baseName != 'double',
+    );
+    final bool hasBytes = types.any(
+      (TypeDeclaration type) =>
+          type.isNullable ||
+          (!type.isClass && !type.isEnum && type.baseName != 'int'),
+    );
+
+    if (hasBytes) {
+      indent.newln();
+      indent.writeScoped(
+        'static void ${codecMethodPrefix}_write_compact_bytes(GByteArray* buffer, size_t element_size, const void* data, size_t count) {',
+        '}',
+        () {
+          indent.writeScoped(
+            'while (buffer->len % element_size != 0) {',
+            '}',
+            () {
+              indent.writeln('uint8_t zero = 0;');
+              indent.writeln(
+                'g_byte_array_append(buffer, &zero, sizeof(uint8_t));',
+              );
+            },
+          );
+          indent.writeln(
+            'g_byte_array_append(buffer, static_cast<const uint8_t*>(data), count * element_size);',
+          );
+        },
+      );
+
+      indent.newln();
+      indent.writeScoped(
+        'static gboolean ${codecMethodPrefix}_read_compact_bytes(GBytes* buffer, size_t* offset, size_t element_size, uint64_t count, const uint8_t** data, GError** error) {',
+        '}',
+        () {
+          indent.writeln('size_t size;');
+          indent.writeln(
+            'const uint8_t* bytes = static_cast<const uint8_t*>(g_bytes_get_data(buffer, &size));',
+          );
+          indent.writeln(
+            'size_t start = (*offset + element_size - 1) / element_size * element_size;',
+          );
+          indent.writeScoped(
+            'if (start > size || count > (size - start) / element_size) {',
+            '}',
+            () {
+              indent.writeln(
+                'g_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_OUT_OF_DATA, "Unexpected end of data");',
+              );
+              indent.writeln('return FALSE;');
+            },
+          );
+          indent.writeln('*data = bytes + start;');
+          indent.writeln('*offset = start + count * element_size;');
+          indent.writeln('return TRUE;');
+        },
+      );
+    }
+
+    if (hasVarints) {
+      indent.newln();
+      indent.writeScoped(
+        'static void ${codecMethodPrefix}_write_compact_varint(GByteArray* buffer, int64_t value) {',
+        '}',
+        () {
+          indent.writeln(
+            'uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);',
+          );
+          indent.writeScoped('while (zigzag >= 0x80) {', '}', () {
+            indent.writeln(
+              'uint8_t byte = static_cast<uint8_t>(zigzag | 0x80);',
+            );
+            indent.writeln(
+              'g_byte_array_append(buffer, &byte, sizeof(uint8_t));',
+            );
+            indent.writeln('zigzag >>= 7;');
+          });
+          indent.writeln('uint8_t byte = static_cast<uint8_t>(zigzag);');
+          indent.writeln(
+            'g_byte_array_append(buffer, &byte, sizeof(uint8_t));',
+          );
+        },
+      );
+
+      indent.newln();
+      indent.writeScoped(
+        'static gboolean ${codecMethodPrefix}_read_compact_varint(GBytes* buffer, size_t* offset, int64_t* value, GError** error) {',
+        '}',
+        () {
+          indent.writeln('size_t size;');
+          indent.writeln(
+            'const uint8_t* data = static_cast<const uint8_t*>(g_bytes_get_data(buffer, &size));',
+          );
+          indent.writeln('uint64_t zigzag = 0;');
+          indent.writeScoped(
+            'for (int shift = 0; shift < 64 && *offset < size; shift += 7) {',
+            '}',
+            () {
+              indent.writeln('uint8_t byte = data[(*offset)++];');
+              indent.writeln(
+                'zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;',
+              );
+              indent.writeScoped('if ((byte & 0x80) == 0) {', '}', () {
+                indent.writeln(
+                  '*value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);',
+                );
+                indent.writeln('return TRUE;');
+              });
+            },
+          );
+          indent.writeln(
+            'g_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_FAILED, "Invalid varint");',
+          );
+          indent.writeln('return FALSE;');
+        },
+      );
+    }
+
+    // Compact classes may contain each other in any order.
+    indent.newln();
+    for (final classDefinition in compactClasses) {
+      final String className = _getClassName(module, classDefinition.name);
+      final String snakeClassName = _snakeCaseFromCamelCase(className);
+      indent.writeln(
+        'static void ${codecMethodPrefix}_write_compact_$snakeClassName(GByteArray* buffer, $className* value);',
+      );
+      indent.writeln(
+        'static $className* ${codecMethodPrefix}_read_compact_$snakeClassName(GBytes* buffer, size_t* offset, GError** error);',
+      );
+    }
+
+    for (final classDefinition in compactClasses) {
+      _writeCompactClassWriter(
+        indent,
+        module,
+        classDefinition,
+        generatorOptions,
+      );
+      _writeCompactClassReader(
+        indent,
+        module,
+        classDefinition,
+        generatorOptions,
+      );
+    }
+  }
+
+  // Writes the checks that the records of the packed classes in
+  // [customTypes] match the Dart layout, and the functions that write, read
+  // and wrap them.
+  void _writePackedSupport(
+    Iterable<EnumeratedType> customTypes,
+    Indent indent,
+    String module,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    for (final EnumeratedType customType in customTypes.where(
+      (EnumeratedType customType) =>
+          customType.associatedClass?.isPacked ?? false,
+    )) {
+      final Class classDefinition = customType.associatedClass!;
+      final String className = _getClassName(module, classDefinition.name);
+      final String snakeClassName = _snakeCaseFromCamelCase(className);
+      final String methodPrefix = _getMethodPrefix(
+        module,
+        classDefinition.name,
+      );
+      final recordName = '${className}Packed';
+      final ({List<int> offsets, int size}) layout = getPackedLayout(
+        classDefinition,
+      );
+      final String offsetAsserts = classDefinition.fields.indexed
+          .map(
+            ((int, NamedType) field) =>
+                'static_assert(offsetof($recordName, ${_getFieldName(field.$2.name)}) == ${layout.offsets[field.$1]}, "$recordName must match the Dart layout");',
+          )
+          .join('\n');
+      final String recordAssignments = classDefinition.fields
+          .map((NamedType field) {
+            final String fieldName = _getFieldName(field.name);
+            return '\trecord.$fieldName = value->$fieldName;';
+          })
+          .join('\n');
+      final String constructorArguments = classDefinition.fields
+          .map((NamedType field) => 'record.${_getFieldName(field.name)}')
+          .join(', ');
+      indent.newln();
+      indent.format('''
+// Packed lists are not a wire type of their own, so their ids are kept clear
+// of the custom type ids.
+const int ${methodPrefix}_packed_list_type_id = ${maximumCodecFieldKey + 1 + customType.enumeration};
+
+$offsetAsserts
+static_assert(sizeof($recordName) == ${layout.size}, "$recordName must match the Dart layout");
+
+FlValue* ${methodPrefix}_packed_list_new(const $recordName* records, size_t length) {
+\treturn fl_value_new_custom(${methodPrefix}_packed_list_type_id, g_bytes_new(records, length * sizeof($recordName)), (GDestroyNotify)g_bytes_unref);
+}
+
+const $recordName* ${methodPrefix}_packed_list_get_records(FlValue* value, size_t* length) {
+\tif (fl_value_get_type(value) != FL_VALUE_TYPE_CUSTOM || fl_value_get_custom_type(value) != ${methodPrefix}_packed_list_type_id) {
+\t\t*length = 0;
+\t\treturn nullptr;
+\t}
+\tGBytes* records = reinterpret_cast<GBytes*>(const_cast<gpointer>(fl_value_get_custom_value(value)));
+\tsize_t size;
+\tconst $recordName* data = static_cast<const $recordName*>(g_bytes_get_data(records, &size));
+\t*length = size / sizeof($recordName);
+\treturn data;
+}
+
+static void ${codecMethodPrefix}_write_packed_$snakeClassName(GByteArray* buffer, $className* value) {
+\t$recordName record = {};
+$recordAssignments
+\tg_byte_array_append(buffer, reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+}
+
+static $className* ${codecMethodPrefix}_read_packed_$snakeClassName(GBytes* buffer, size_t* offset, GError** error) {
+\tsize_t size;
+\tconst uint8_t* data = static_cast<const uint8_t*>(g_bytes_get_data(buffer, &size));
+\t$recordName record;
+\tif (*offset > size || size - *offset < sizeof(record)) {
+\t\tg_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_OUT_OF_DATA, "Unexpected end of data");
+\t\treturn nullptr;
+\t}
+\tmemcpy(&record, data + *offset, sizeof(record));
+\t*offset += sizeof(record);
+\treturn ${methodPrefix}_new($constructorArguments);
+}''');
+    }
+  }
+
+  // Writes the body of the function that reads a packed record of the class
+  // of [customType], or a contiguous list of them when the byte after the
+  // type is 1.
+  void _writePackedClassReader(
+    Indent indent,
+    String module,
+    EnumeratedType customType,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final String className = _getClassName(module, customType.name);
+    final String snakeClassName = _snakeCaseFromCamelCase(className);
+    final String customTypeId = _getCustomTypeId(module, customType);
+    final String newValue = _newClassFlValue(
+      module,
+      customType.name,
+      customTypeId,
+      'value',
+      boxedDataClasses: generatorOptions.boxedDataClasses,
+    );
+    indent.format('''
+size_t size;
+const uint8_t* data = static_cast<const uint8_t*>(g_bytes_get_data(buffer, &size));
+if (*offset >= size) {
+\tg_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_OUT_OF_DATA, "Unexpected end of data");
+\treturn nullptr;
+}
+if (data[(*offset)++] == 0) {
+\tg_autoptr($className) value = ${codecMethodPrefix}_read_packed_$snakeClassName(buffer, offset, error);
+\tif (value == nullptr) {
+\t\treturn nullptr;
+\t}
+\treturn $newValue;
+}
+
+uint32_t length;
+if (!fl_standard_message_codec_read_size(codec, buffer, offset, &length, error)) {
+\treturn nullptr;
+}
+if (*offset > size || (size - *offset) / sizeof(${className}Packed) < length) {
+\tg_set_error(error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_OUT_OF_DATA, "Unexpected end of data");
+\treturn nullptr;
+}
+// Copied into a new allocation, so that the records are aligned.
+FlValue* list = fl_value_new_custom(${_getMethodPrefix(module, customType.name)}_packed_list_type_id, g_bytes_new(data + *offset, length * sizeof(${className}Packed)), (GDestroyNotify)g_bytes_unref);
+*offset += length * sizeof(${className}Packed);
+return list;''');
+  }
+
+  // Writes the function that writes the fields of [classDefinition] in the
+  // compact wire format.
+  void _writeCompactClassWriter(
+    Indent indent,
+    String module,
+    Class classDefinition,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final String className = _getClassName(module, classDefinition.name);
+    final String snakeClassName = _snakeCaseFromCamelCase(className);
+    final List<NamedType> fields = classDefinition.fields;
+    final List<NamedType> nullableFields = fields
+        .where((NamedType field) => field.type.isNullable)
+        .toList();
+
+    String present(NamedType field) {
+      return _isInlineField(generatorOptions, field)
+          ? _inlineFieldPresent(
+              generatorOptions,
+              classDefinition,
+              field,
+              'value',
+            )
+          : 'value->${_getFieldName(field.name)} != nullptr';
+    }
+
+    indent.newln();
+    indent.writeScoped(
+      'static void ${codecMethodPrefix}_write_compact_$snakeClassName(GByteArray* buffer, $className* value) {',
+      '}',
+      () {
+        final int presentLength = (nullableFields.length + 7) ~/ 8;
+        if (presentLength > 0) {
+          indent.writeln('uint8_t present[$presentLength];');
+          for (var i = 0; i < presentLength; i++) {
+            final String bits = nullableFields
+                .skip(i * 8)
+                .take(8)
+                .indexed
+                .map(
+                  ((int, NamedType) bit) =>
+                      '(${present(bit.$2)} ? ${1 << bit.$1} : 0)',
+                )
+                .join(' | ');
+            indent.writeln('present[$i] = static_cast<uint8_t>($bits);');
+          }
+          indent.writeln(
+            '${codecMethodPrefix}_write_compact_bytes(buffer, 1, present, $presentLength);',
+          );
+        }
+        for (var i = 0; i < fields.length; i++) {
+          final NamedType field = fields[i];
+          final TypeDeclaration type = field.type;
+          final variableName = 'value->${_getFieldName(field.name)}';
+          // Nullable primitives not stored inline are pointers.
+          final bool isPointer =
+              _isNullablePrimitiveType(type) &&
+              !_isInlineField(generatorOptions, field);
+          final value = isPointer ? '*$variableName' : variableName;
+          final address = isPointer ? variableName : '&$variableName';
+
+          void writeValue() {
+            if (type.isClass) {
+              final String fieldSnakeClassName = _snakeCaseFromCamelCase(
+                _getClassName(module, type.baseName),
+              );
+              indent.writeln(
+                '${codecMethodPrefix}_write_compact_$fieldSnakeClassName(buffer, $value);',
+              );
+            } else if (type.isEnum || type.baseName == 'int') {
+              indent.writeln(
+                '${codecMethodPrefix}_write_compact_varint(buffer, $value);',
+              );
+            } else if (type.baseName == 'bool') {
+              indent.writeln('uint8_t field${i}_byte = $value ? 1 : 0;');
+              indent.writeln(
+                '${codecMethodPrefix}_write_compact_bytes(buffer, 1, &field${i}_byte, 1);',
+              );
+            } else if (type.baseName == 'double') {
+              indent.writeln(
+                '${codecMethodPrefix}_write_compact_bytes(buffer, sizeof(double), $address, 1);',
+              );
+            } else if (type.baseName == 'String') {
+              indent.writeln('size_t field${i}_length = strlen($value);');
+              indent.writeln(
+                '${codecMethodPrefix}_write_compact_varint(buffer, field${i}_length);',
+              );
+              indent.writeln(
+                '${codecMethodPrefix}_write_compact_bytes(buffer, 1, $value, field${i}_length);',
+              );
+            } else {
+              final String elementType = _getType(
+                module,
+                type,
+                isOutput: true,
+              ).replaceAll('*', '');
+              final bool retained = _isRetainedListField(
+                generatorOptions,
+                field,
+              );
+              final String data = retained
+                  ? _fromFlValue(
+                      module,
+                      type,
+                      value,
+                      boxedDataClasses: generatorOptions.boxedDataClasses,
+                    )
+                  : value;
+              final length = retained
+                  ? 'fl_value_get_length($value)'
+                  : '${variableName}_length';
+              indent.writeln('size_t field${i}_length = $length;');
+              indent.writeln(
+                '${codecMethodPrefix}_write_compact_varint(buffer, field${i}_length);',
+              );
+              indent.writeln(
+                '${codecMethodPrefix}_write_compact_bytes(buffer, sizeof($elementType), $data, field${i}_length);',
+              );
+            }
+          }
+
+          if (type.isNullable) {
+            indent.writeScoped('if (${present(field)}) {', '}', writeValue);
+          } else {
+            writeValue();
+          }
+        }
+      },
+    );
+  }
+
+  // Writes the functions that return where the compact encoding of each
+  // compact class ends, mirroring the compact writers field by field.
+  void _writeCompactEncodedEnds(
+    Root root,
+    Indent indent,
+    String module,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final List<Class> compactClasses = root.classes
+        .where((Class classDefinition) => classDefinition.isCompact)
+        .toList();
+    final bool hasVarints = compactClasses
+        .expand((Class classDefinition) => classDefinition.fields)
+        .any(
+          (NamedType field) =>
+              !field.type.isClass &&
+              field.type.baseName != 'bool' &&
+              field.type.baseName != 'double',
+        );
+
+    if (hasVarints) {
+      indent.newln();
+      indent.format('''
+static size_t ${codecMethodPrefix}_compact_varint_size(int64_t value) {
+\tuint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+\tsize_t size = 1;
+\twhile (zigzag >= 0x80) {
+\t\tzigzag >>= 7;
+\t\tsize++;
+\t}
+\treturn size;
+}''');
+    }
+
+    // Compact classes may contain each other in any order.
+    indent.newln();
+    for (final classDefinition in compactClasses) {
+      final String className = _getClassName(module, classDefinition.name);
+      indent.writeln(
+        'static size_t ${codecMethodPrefix}_compact_encoded_end_${_snakeCaseFromCamelCase(className)}($className* value, size_t offset);',
+      );
+    }
+
+    for (final classDefinition in compactClasses) {
+      final String className = _getClassName(module, classDefinition.name);
+      final String snakeClassName = _snakeCaseFromCamelCase(className);
+      final List<NamedType> fields = classDefinition.fields;
+      final int presentLength =
+          (fields.where((NamedType field) => field.type.isNullable).length +
+              7) ~/
+          8;
+
+      indent.newln();
+      indent.writeScoped(
+        'static size_t ${codecMethodPrefix}_compact_encoded_end_$snakeClassName($className* value, size_t offset) {',
+        '}',
+        () {
+          if (presentLength > 0) {
+            indent.writeln('// The presence bits of the nullable fields.');
+            indent.writeln('size_t end = offset + $presentLength;');
+          } else {
+            indent.writeln('size_t end = offset;');
+          }
+          for (var i = 0; i < fields.length; i++) {
+            final NamedType field = fields[i];
+            final TypeDeclaration type = field.type;
+            final variableName = 'value->${_getFieldName(field.name)}';
+            final bool isPointer =
+                _isNullablePrimitiveType(type) &&
+                !_isInlineField(generatorOptions, field);
+            final value = isPointer ? '*$variableName' : variableName;
+
+            void writeEnd() {
+              if (type.isClass) {
+                final String fieldSnakeClassName = _snakeCaseFromCamelCase(
+                  _getClassName(module, type.baseName),
+                );
+                indent.writeln(
+                  'end = ${codecMethodPrefix}_compact_encoded_end_$fieldSnakeClassName($value, end);',
+                );
+              } else if (type.isEnum || type.baseName == 'int') {
+                indent.writeln(
+                  'end += ${codecMethodPrefix}_compact_varint_size($value);',
+                );
+              } else if (type.baseName == 'bool') {
+                indent.writeln('end += 1;');
+              } else if (type.baseName == 'double') {
+                indent.writeln(
+                  'end = ${codecMethodPrefix}_align_end(end, sizeof(double)) + sizeof(double);',
+                );
+              } else if (type.baseName == 'String') {
+                indent.writeln('size_t field${i}_length = strlen($value);');
+                indent.writeln(
+                  'end += ${codecMethodPrefix}_compact_varint_size(field${i}_length) + field${i}_length;',
+                );
+              } else {
+                final String elementType = _getType(
+                  module,
+                  type,
+                  isOutput: true,
+                ).replaceAll('*', '');
+                final length = _isRetainedListField(generatorOptions, field)
+                    ? 'fl_value_get_length($value)'
+                    : '${variableName}_length';
+                indent.writeln('size_t field${i}_length = $length;');
+                indent.writeln(
+                  'end = ${codecMethodPrefix}_align_end(end + ${codecMethodPrefix}_compact_varint_size(field${i}_length), sizeof($elementType)) + field${i}_length * sizeof($elementType);',
+                );
+              }
+            }
+
+            if (type.isNullable) {
+              final String present = _isInlineField(generatorOptions, field)
+                  ? _inlineFieldPresent(
+                      generatorOptions,
+                      classDefinition,
+                      field,
+                      'value',
+                    )
+                  : '$variableName != nullptr';
+              indent.writeScoped('if ($present) {', '}', writeEnd);
+            } else {
+              writeEnd();
+            }
+          }
+          indent.writeln('return end;');
+        },
+      );
+    }
+  }
+
+  // Writes the function that reads [classDefinition] from the compact wire
+  // format.
+  void _writeCompactClassReader(
+    Indent indent,
+    String module,
+    Class classDefinition,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final String className = _getClassName(module, classDefinition.name);
+    final String snakeClassName = _snakeCaseFromCamelCase(className);
+    final String methodPrefix = _getMethodPrefix(module, classDefinition.name);
+    final List<NamedType> fields = classDefinition.fields;
+    final List<NamedType> nullableFields = fields
+        .where((NamedType field) => field.type.isNullable)
+        .toList();
+
+    void writeReadFailure() {
+      indent.writeln('return nullptr;');
+    }
+
+    void readBytes(String size, String count, String data) {
+      indent.writeScoped(
+        'if (!${codecMethodPrefix}_read_compact_bytes(buffer, offset, $size, $count, &$data, error)) {',
+        '}',
+        writeReadFailure,
+      );
+    }
+
+    void readVarint(String value) {
+      indent.writeScoped(
+        'if (!${codecMethodPrefix}_read_compact_varint(buffer, offset, &$value, error)) {',
+        '}',
+        writeReadFailure,
+      );
+    }
+
+    indent.newln();
+    indent.writeScoped(
+      'static $className* ${codecMethodPrefix}_read_compact_$snakeClassName(GBytes* buffer, size_t* offset, GError** error) {',
+      '}',
+      () {
+        final int presentLength = (nullableFields.length + 7) ~/ 8;
+        if (presentLength > 0) {
+          indent.writeln('const uint8_t* present;');
+          readBytes('1', '$presentLength', 'present');
+        }
+        final args = <String>[];
+        for (var i = 0; i < fields.length; i++) {
+          final NamedType field = fields[i];
+          final TypeDeclaration type = field.type;
+          final name = 'field$i';
+          final bool isNullable = type.isNullable;
+
+          // Reads the value into the locals declared below, which hold the
+          // default value when the field is null.
+          void readValue() {
+            if (type.isClass) {
+              final String fieldSnakeClassName = _snakeCaseFromCamelCase(
+                _getClassName(module, type.baseName),
+              );
+              indent.writeln(
+                '$name = ${codecMethodPrefix}_read_compact_$fieldSnakeClassName(buffer, offset, error);',
+              );
+              indent.writeScoped(
+                'if ($name == nullptr) {',
+                '}',
+                writeReadFailure,
+              );
+            } else if (type.isEnum) {
+              final String enumName = _getClassName(module, type.baseName);
+              indent.writeln('int64_t ${name}_index;');
+              readVarint('${name}_index');
+              indent.writeln(
+                '${name}_value = static_cast<$enumName>(${name}_index);',
+              );
+            } else if (type.baseName == 'int') {
+              readVarint('${name}_value');
+            } else if (type.baseName == 'bool') {
+              indent.writeln('const uint8_t* ${name}_bytes;');
+              readBytes('1', '1', '${name}_bytes');
+              indent.writeln('${name}_value = *${name}_bytes != 0;');
+            } else if (type.baseName == 'double') {
+              indent.writeln('const uint8_t* ${name}_bytes;');
+              readBytes('sizeof(double)', '1', '${name}_bytes');
+              indent.writeln(
+                'memcpy(&${name}_value, ${name}_bytes, sizeof(double));',
+              );
+            } else if (type.baseName == 'String') {
+              indent.writeln('int64_t ${name}_length;');
+              readVarint('${name}_length');
+              indent.writeln('const uint8_t* ${name}_bytes;');
+              readBytes('1', '${name}_length', '${name}_bytes');
+              indent.writeln(
+                '$name = g_strndup(reinterpret_cast<const gchar*>(${name}_bytes), ${name}_length);',
+              );
+            } else {
+              final String elementType = _getType(
+                module,
+                type,
+                isOutput: true,
+              ).replaceAll('*', '');
+              indent.writeln('int64_t ${name}_count;');
+              readVarint('${name}_count');
+              indent.writeln('const uint8_t* ${name}_bytes;');
+              readBytes(
+                'sizeof($elementType)',
+                '${name}_count',
+                '${name}_bytes',
+              );
+              indent.writeln(
+                '$name = reinterpret_cast<const $elementType*>(${name}_bytes);',
+              );
+              indent.writeln('${name}_length = ${name}_count;');
+            }
+            if (isNullable && _isNullablePrimitiveType(type)) {
+              indent.writeln('$name = &${name}_value;');
+            }
+          }
+
+          if (type.isClass) {
+            final String fieldClassName = _getClassName(module, type.baseName);
+            indent.writeln('g_autoptr($fieldClassName) $name = nullptr;');
+            args.add(name);
+          } else if (type.baseName == 'String') {
+            indent.writeln('g_autofree gchar* $name = nullptr;');
+            args.add(name);
+          } else if (_isNumericListType(type)) {
+            final String elementType = _getType(module, type);
+            indent.writeln('$elementType $name = nullptr;');
+            indent.writeln('size_t ${name}_length = 0;');
+            args.add(name);
+            args.add('${name}_length');
+          } else {
+            final String valueType = _getType(module, type, primitive: true);
+            indent.writeln(
+              '$valueType ${name}_value = ${_getDefaultValue(module, type, primitive: true)};',
+            );
+            if (isNullable) {
+              indent.writeln('$valueType* $name = nullptr;');
+              args.add(name);
+            } else {
+              args.add('${name}_value');
+            }
+          }
+          if (isNullable) {
+            indent.writeScoped(
+              'if ((present[${nullableFields.indexOf(field) ~/ 8}] & ${1 << (nullableFields.indexOf(field) % 8)}) != 0) {',
+              '}',
+              readValue,
+            );
+          } else {
+            readValue();
+          }
+        }
+        indent.writeln('return ${methodPrefix}_new(${args.join(', ')});');
+      },
+    );
+  }
+
+  // Writes the shared state and push function of the ring buffer of
+  // [classDefinition], and the C functions the Dart reader calls.
+  void _writeRingBuffer(
+    Indent indent,
+    String module,
+    Class classDefinition, {
+    required String dartPackageName,
+  }) {
+    final String className = _getClassName(module, classDefinition.name);
+    final String methodPrefix = _getMethodPrefix(module, classDefinition.name);
+    final int capacity = classDefinition.ringBufferCapacity!;
+    final stateName = '${methodPrefix}_ring_state';
+    String symbol(String function) =>
+        makeRingBufferSymbolName(classDefinition, function, dartPackageName);
+    const export = 'extern "C" __attribute__((visibility("default")))';
+    final String recordFields = classDefinition.fields
+        .map((NamedType field) {
+          final String type = field.type.baseName == 'bool'
+              ? 'bool'
+              : _getType(module, field.type);
+          return '\t$type ${_getFieldName(field.name)};';
+        })
+        .join('\n');
+    final String recordAssignments = classDefinition.fields
+        .map((NamedType field) {
+          final String fieldName = _getFieldName(field.name);
+          return '\trecord->$fieldName = value->$fieldName;';
+        })
+        .join('\n');
+
+    indent.newln();
+    indent.format('''
+// The layout of a ${classDefinition.name} record in the ring, which the Dart
+// reader mirrors.
+typedef struct {
+$recordFields
+} ${className}RingRecord;
+
+// The positions count records since the start, and are kept on separate cache
+// lines so the producer and consumer don't contend.
+typedef struct {
+\talignas(64) guint64 head;
+\talignas(64) guint64 tail;
+\tgboolean consumer_idle;
+\tvoid (*wakeup)(void);
+\t${className}RingRecord records[$capacity];
+} ${className}RingState;
+
+static ${className}RingState $stateName;
+
+gboolean ${methodPrefix}_ring_buffer_push($className* value) {
+\t${className}RingState* ring = &$stateName;
+\tguint64 head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+\tif (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == $capacity) {
+\t\treturn FALSE;
+\t}
+\t${className}RingRecord* record = &ring->records[head & ${capacity - 1}];
+$recordAssignments
+\t// Publishing the record must not be reordered with checking whether the
+\t// consumer is idle, or a wakeup could be lost.
+\t__atomic_store_n(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+\tif (__atomic_load_n(&ring->consumer_idle, __ATOMIC_SEQ_CST) && __atomic_exchange_n(&ring->consumer_idle, FALSE, __ATOMIC_SEQ_CST)) {
+\t\tvoid (*wakeup)(void) = __atomic_load_n(&ring->wakeup, __ATOMIC_ACQUIRE);
+\t\tif (wakeup != nullptr) {
+\t\t\twakeup();
+\t\t}
+\t}
+\treturn TRUE;
+}
+
+$export void* ${symbol('records')}() {
+\treturn $stateName.records;
+}
+
+$export guint64 ${symbol('tail')}() {
+\treturn __atomic_load_n(&$stateName.tail, __ATOMIC_RELAXED);
+}
+
+$export guint64 ${symbol('acquire')}() {
+\t${className}RingState* ring = &$stateName;
+\tguint64 tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+\tguint64 head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+\tif (head == tail) {
+\t\t// Ask for a wakeup, then check for records pushed in the meantime.
+\t\t__atomic_store_n(&ring->consumer_idle, TRUE, __ATOMIC_SEQ_CST);
+\t\thead = __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST);
+\t\tif (head != tail) {
+\t\t\t__atomic_store_n(&ring->consumer_idle, FALSE, __ATOMIC_RELAXED);
+\t\t}
+\t}
+\treturn head;
+}
+
+$export void ${symbol('release')}(guint64 tail) {
+\t__atomic_store_n(&$stateName.tail, tail, __ATOMIC_RELEASE);
+}
+
+$export void ${symbol('set_wakeup')}(void (*wakeup)(void)) {
+\t__atomic_store_n(&$stateName.wakeup, wakeup, __ATOMIC_RELEASE);
+}
+''');
+  }
+
+  // Writes the function that sends the replies of `@Chunked()` methods in
+  // frames on a side channel, one frame per main loop iteration.
+  void _writeChunkedReplySupport(Indent indent, String module) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final String replyName = _getClassName(
+      module,
+      '${_codecBaseName}ChunkedReply',
+    );
+    indent.newln();
+    indent.format('''
+// A reply being sent in frames on a side channel.
+typedef struct {
+	FlBasicMessageChannel* channel;
+	FlBasicMessageChannelResponseHandle* response_handle;
+	FlBinaryMessenger* messenger;
+	gchar* chunk_channel_name;
+	GBytes* message;
+	size_t frame_size;
+	size_t offset;
+	uint32_t sequence;
+} $replyName;
+
+static void ${codecMethodPrefix}_chunked_reply_free(gpointer user_data) {
+	$replyName* reply = static_cast<$replyName*>(user_data);
+	g_object_unref(reply->channel);
+	g_object_unref(reply->response_handle);
+	g_object_unref(reply->messenger);
+	g_free(reply->chunk_channel_name);
+	g_bytes_unref(reply->message);
+	g_free(reply);
+}
+
+// Sends the next frame, starting with its little-endian 32-bit sequence
+// number, and replies with the number of frames after the last one.
+static gboolean ${codecMethodPrefix}_chunked_reply_send_frame(gpointer user_data) {
+	$replyName* reply = static_cast<$replyName*>(user_data);
+	size_t size = 0;
+	const uint8_t* data = static_cast<const uint8_t*>(g_bytes_get_data(reply->message, &size));
+	size_t length = MIN(reply->frame_size, size - reply->offset);
+	g_autoptr(GByteArray) frame = g_byte_array_sized_new(4 + length);
+	for (size_t i = 0; i < 4; i++) {
+		uint8_t byte = static_cast<uint8_t>(reply->sequence >> (8 * i));
+		g_byte_array_append(frame, &byte, 1);
+	}
+	g_byte_array_append(frame, data + reply->offset, length);
+	g_autoptr(GBytes) frame_bytes = g_byte_array_free_to_bytes(static_cast<GByteArray*>(g_steal_pointer(&frame)));
+	fl_binary_messenger_send_on_channel(reply->messenger, reply->chunk_channel_name, frame_bytes, nullptr, nullptr, nullptr);
+	reply->offset += length;
+	reply->sequence++;
+	if (reply->offset < size) {
+		return G_SOURCE_CONTINUE;
+	}
+	g_autoptr(FlValue) frame_count = fl_value_new_list();
+	fl_value_append_take(frame_count, fl_value_new_int(reply->sequence));
+	g_autoptr(GError) error = nullptr;
+	if (!fl_basic_message_channel_respond(reply->channel, reply->response_handle, frame_count, &error)) {
+		g_warning("Failed to send response after %s: %s", reply->chunk_channel_name, error->message);
+	}
+	return G_SOURCE_REMOVE;
+}
+
+// Sends the reply `value` in frames of at most `frame_size` encoded bytes on
+// `chunk_channel_name`. Frames are sent from the main loop at idle priority,
+// so other messages aren't held up behind them. Errors are sent as they are.
+static gboolean ${codecMethodPrefix}_respond_chunked(FlBasicMessageChannel* channel, FlBasicMessageChannelResponseHandle* response_handle, FlBinaryMessenger* messenger, const gchar* chunk_channel_name, FlValue* value, size_t frame_size, GError** error) {
+	if (fl_value_get_length(value) > 1) {
+		return fl_basic_message_channel_respond(channel, response_handle, value, error);
+	}
+	GBytes* message = fl_message_codec_encode_message(FL_MESSAGE_CODEC(${codecMethodPrefix}_get_instance()), value, error);
+	if (message == nullptr) {
+		return FALSE;
+	}
+	$replyName* reply = g_new0($replyName, 1);
+	reply->channel = FL_BASIC_MESSAGE_CHANNEL(g_object_ref(channel));
+	reply->response_handle = FL_BASIC_MESSAGE_CHANNEL_RESPONSE_HANDLE(g_object_ref(response_handle));
+	reply->messenger = FL_BINARY_MESSENGER(g_object_ref(messenger));
+	reply->chunk_channel_name = g_strdup(chunk_channel_name);
+	reply->message = message;
+	reply->frame_size = frame_size;
+	g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, ${codecMethodPrefix}_chunked_reply_send_frame, reply, ${codecMethodPrefix}_chunked_reply_free);
+	return TRUE;
+}
+''');
+  }
+
+  // Writes the C functions exported for the `@FfiSync()` methods of [api].
+  // They call the handlers set up without a suffix directly and keep the
+  // error of the last call for the functions that report it.
+  void _writeFfiSyncFunctions(
+    Indent indent,
+    String module,
+    Api api, {
+    required bool sharedResponses,
+    required String dartPackageName,
+  }) {
+    final String className = _getClassName(module, api.name);
+    final String methodPrefix = _getMethodPrefix(module, api.name);
+    final instanceName = '${methodPrefix}_ffi_instance';
+    final errorName = '${methodPrefix}_ffi_error';
+
+    indent.newln();
+    indent.writeln(
+      '// The API set up without a suffix, which the exported functions call.',
+    );
+    indent.writeln(
+      '// Only accessed under its mutex, and the exported functions hold a',
+    );
+    indent.writeln(
+      '// reference to it for the whole call, so that it is not finalized while',
+    );
+    indent.writeln('// they use it.');
+    indent.writeln('static $className* $instanceName = nullptr;');
+    indent.writeln('static GMutex ${instanceName}_mutex;');
+
+    indent.newln();
+    indent.writeScoped(
+      'static void ${instanceName}_set($className* api_data) {',
+      '}',
+      () {
+        indent.writeln('g_mutex_lock(&${instanceName}_mutex);');
+        indent.writeln(
+          '$className* old_instance = g_steal_pointer(&$instanceName);',
+        );
+        indent.writeln(
+          '$instanceName = api_data != nullptr ? ${_getClassCastMacro(module, api.name)}(g_object_ref(api_data)) : nullptr;',
+        );
+        indent.writeln('g_mutex_unlock(&${instanceName}_mutex);');
+        // Released outside the lock, in case finalizing it frees user data
+        // that calls back into an exported function.
+        indent.writeln('g_clear_object(&old_instance);');
+      },
+    );
+
+    indent.newln();
+    indent.writeScoped('static $className* ${instanceName}_get() {', '}', () {
+      indent.writeln('g_mutex_lock(&${instanceName}_mutex);');
+      indent.writeln(
+        '$className* api_data = $instanceName != nullptr ? ${_getClassCastMacro(module, api.name)}(g_object_ref($instanceName)) : nullptr;',
+      );
+      indent.writeln('g_mutex_unlock(&${instanceName}_mutex);');
+      indent.writeln('return api_data;');
+    });
+    indent.newln();
+    indent.writeln(
+      '// The error returned by the last exported call on this thread, as a list',
+    );
+    indent.writeln('// of its code, message and details.');
+    indent.writeln('static thread_local FlValue* $errorName = nullptr;');
+
+    indent.newln();
+    indent.writeScoped(
+      'static void ${errorName}_set(FlValue* error) {',
+      '}',
+      () {
+        indent.writeln('g_clear_pointer(&$errorName, fl_value_unref);');
+        indent.writeScoped('if (error != nullptr) {', '}', () {
+          indent.writeln('$errorName = fl_value_ref(error);');
+        });
+      },
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'static void ${errorName}_set_channel_error(const gchar* message) {',
+      '}',
+      () {
+        indent.writeln('g_autoptr(FlValue) error = fl_value_new_list();');
+        indent.writeln(
+          'fl_value_append_take(error, fl_value_new_string("channel-error"));',
+        );
+        indent.writeln(
+          'fl_value_append_take(error, fl_value_new_string(message));',
+        );
+        indent.writeln('fl_value_append_take(error, fl_value_new_null());');
+        indent.writeln('${errorName}_set(error);');
+      },
+    );
+
+    for (final Method method in api.methods.where(
+      (Method method) => method.isFfiSync,
+    )) {
+      final String methodName = _getMethodName(method.name);
+      final String responseClassName = _getClassName(
+        module,
+        _getHostApiResponseName(
+          api.name,
+          method.name,
+          sharedHostApiResponses: sharedResponses,
+        ),
+      );
+      final String returnType = switch (method.returnType.baseName) {
+        'bool' => 'bool',
+        'int' => 'int64_t',
+        'double' => 'double',
+        _ => 'void',
+      };
+      final String failureReturn = switch (method.returnType.baseName) {
+        'bool' => 'return false;',
+        'int' => 'return 0;',
+        'double' => 'return 0.0;',
+        _ => 'return;',
+      };
+      final String parameters = method.parameters
+          .map((Parameter param) {
+            final String type = param.type.baseName == 'bool'
+                ? 'bool'
+                : _getType(module, param.type);
+            return '$type ${_snakeCaseFromCamelCase(param.name)}';
+          })
+          .join(', ');
+      final vfuncArgs = <String>[
+        ...method.parameters.map(
+          (Parameter param) => _snakeCaseFromCamelCase(param.name),
+        ),
+        'api_data->user_data',
+      ];
+      final String channelName = api is AstHostApi && api.multiplexed
+          ? makeMultiplexedChannelName(api, dartPackageName)
+          : makeChannelName(api, method, dartPackageName);
+
+      indent.newln();
+      indent.writeScoped(
+        'extern "C" __attribute__((visibility("default"))) $returnType ${makeFfiSymbolName(api, method.name, dartPackageName)}($parameters) {',
+        '}',
+        () {
+          indent.writeln('${errorName}_set(nullptr);');
+          indent.writeln(
+            'g_autoptr($className) api_data = ${instanceName}_get();',
+          );
+          indent.writeScoped(
+            'if (api_data == nullptr || api_data->vtable == nullptr || api_data->vtable->$methodName == nullptr) {',
+            '}',
+            () {
+              indent.writeln(
+                '${errorName}_set_channel_error("Unable to establish connection on channel: \'$channelName\'.");',
+              );
+              indent.writeln(failureReturn);
+            },
+          );
+          indent.newln();
+          indent.writeln(
+            'g_autoptr($responseClassName) response = api_data->vtable->$methodName(${vfuncArgs.join(', ')});',
+          );
+          indent.writeScoped('if (response == nullptr) {', '}', () {
+            indent.writeln(
+              '${errorName}_set_channel_error("No response returned to ${api.name}.${method.name}");',
+            );
+            indent.writeln(failureReturn);
+          });
+          indent.writeScoped(
+            'if (fl_value_get_length(response->value) > 1) {',
+            '}',
+            () {
+              indent.writeln('${errorName}_set(response->value);');
+              indent.writeln(failureReturn);
+            },
+          );
+          if (!method.returnType.isVoid) {
+            final String value = _fromFlValue(
+              module,
+              method.returnType,
+              'fl_value_get_list_value(response->value, 0)',
+              boxedDataClasses: false,
+            );
+            indent.writeln('return $value;');
+          }
+        },
+      );
+    }
+
+    const errorFields = <String>['code', 'message'];
+    for (var i = 0; i < errorFields.length; i++) {
+      indent.newln();
+      indent.writeScoped(
+        'extern "C" __attribute__((visibility("default"))) const char* ${makeFfiSymbolName(api, 'ffi_error_${errorFields[i]}', dartPackageName)}() {',
+        '}',
+        () {
+          indent.writeln(
+            'return $errorName != nullptr ? fl_value_get_string(fl_value_get_list_value($errorName, $i)) : nullptr;',
+          );
+        },
+      );
+    }
+  }
+
+  // Writes the body of the codec function that writes [classDefinition] as a
+  // list of its fields. Enum fields are written directly, as are all other
+  // fields when direct class writers are enabled.
+  void _writeUnboxedClassWriter(
+    Root root,
+    Indent indent,
+    String module,
+    Class classDefinition,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final List<NamedType> fields = classDefinition.fields;
+
+    if (generatorOptions.directClassWriters) {
+      indent.writeln('${codecMethodPrefix}_write_type(buffer, 12);');
+    } else {
+      indent.writeln('uint8_t list_type = 12;');
+      indent.writeln(
+        'g_byte_array_append(buffer, &list_type, sizeof(uint8_t));',
+      );
+    }
+    indent.writeln(
+      'fl_standard_message_codec_write_size(codec, buffer, ${fields.length});',
+    );
+    for (var i = 0; i < fields.length; i++) {
+      final NamedType field = fields[i];
+      final String fieldName = _getFieldName(field.name);
+      if (field.type.isEnum) {
+        final String enumTypeId = _getCustomTypeIdFromDeclaration(
+          root,
+          field.type,
+          module,
+        );
+        if (_isInlineField(generatorOptions, field)) {
+          final String present = _inlineFieldPresent(
+            generatorOptions,
+            classDefinition,
+            field,
+            'value',
+          );
+          indent.writeln(
+            '${codecMethodPrefix}_write_enum_value(buffer, $enumTypeId, !($present), value->$fieldName);',
+          );
+        } else {
+          indent.writeln(
+            field.type.isNullable
+                ? '${codecMethodPrefix}_write_enum_value(buffer, $enumTypeId, value->$fieldName == nullptr, value->$fieldName != nullptr ? *value->$fieldName : 0);'
+                : '${codecMethodPrefix}_write_enum_value(buffer, $enumTypeId, FALSE, value->$fieldName);',
+          );
+        }
+      } else if (generatorOptions.directClassWriters) {
+        _writeDirectFieldValue(
+          root,
+          indent,
+          module,
+          classDefinition,
+          field,
+          generatorOptions,
+        );
+      } else {
+        indent.writeln(
+          'g_autoptr(FlValue) value$i = ${_fieldFlValue(root, module, classDefinition, field, 'value', generatorOptions)};',
+        );
+        indent.writeScoped(
+          'if (!fl_standard_message_codec_write_value(codec, buffer, value$i, error)) {',
+          '}',
+          () {
+            indent.writeln('return FALSE;');
+          },
+        );
+      }
+    }
+    indent.writeln('return TRUE;');
+  }
+
+  // Writes the body of the codec function that reads [classDefinition] from a
+  // list of its fields, with enum fields read directly.
+  void _writeUnboxedClassReader(
+    Root root,
+    Indent indent,
+    String module,
+    Class classDefinition,
+    String customTypeId,
+    InternalGObjectOptions generatorOptions,
+  ) {
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final String className = _getClassName(module, classDefinition.name);
+    final String methodPrefix = _getMethodPrefix(
+      module,
+      classDefinition.name,
+    );
+    final List<NamedType> fields = classDefinition.fields;
+
+    indent.writeScoped(
+      'if (!${codecMethodPrefix}_read_list_header(codec, buffer, offset, ${fields.length}, error)) {',
+      '}',
+      () {
+        indent.writeln('return nullptr;');
+      },
+    );
+    final args = <String>[];
+    for (var i = 0; i < fields.length; i++) {
+      final NamedType field = fields[i];
+      if (field.type.isEnum) {
+        final String enumTypeId = _getCustomTypeIdFromDeclaration(
+          root,
+          field.type,
+          module,
+        );
+        final String enumName = _getClassName(module, field.type.baseName);
+        if (field.type.isNullable) {
+          indent.writeln('gboolean value${i}_is_null = FALSE;');
+        }
+        indent.writeln('int64_t value$i = 0;');
+        final isNull = field.type.isNullable ? '&value${i}_is_null' : 'nullptr';
+        indent.writeScoped(
+          'if (!${codecMethodPrefix}_read_enum_value(buffer, offset, $enumTypeId, $isNull, &value$i, error)) {',
+          '}',
+          () {
+            indent.writeln('return nullptr;');
+          },
+        );
+        if (field.type.isNullable) {
+          indent.writeln('$enumName* field$i = nullptr;');
+          indent.writeln('$enumName field${i}_value;');
+          indent.writeScoped('if (!value${i}_is_null) {', '}', () {
+            indent.writeln(
+              'field${i}_value = static_cast<$enumName>(value$i);',
+            );
+            indent.writeln('field$i = &field${i}_value;');
+          });
+        } else {
+          indent.writeln(
+            '$enumName field$i = static_cast<$enumName>(value$i);',
+          );
+        }
+        args.add('field$i');
+      } else {
+        indent.writeln(
+          'g_autoptr(FlValue) value$i = fl_standard_message_codec_read_value(codec, buffer, offset, error);',
+        );
+        indent.writeScoped('if (value$i == nullptr) {', '}', () {
+          indent.writeln('return nullptr;');
+        });
+        _writeFieldFromFlValue(
+          indent,
+          module,
+          field,
+          'value$i',
+          args,
+          localName: 'field$i',
+          boxedDataClasses: generatorOptions.boxedDataClasses,
+          zeroCopyTypedLists: generatorOptions.zeroCopyTypedLists,
+        );
+      }
+    }
+    final String constructor =
+        _hasRetainedListFields(generatorOptions, classDefinition)
+        ? '${methodPrefix}_new_with_values'
+        : '${methodPrefix}_new';
+    indent.newln();
+    indent.writeln(
+      'g_autoptr($className) value = $constructor(${args.join(', ')});',
+    );
+    indent.writeln(
+      'return ${_newClassFlValue(module, classDefinition.name, customTypeId, 'value', boxedDataClasses: generatorOptions.boxedDataClasses)};',
+    );
+  }
+
+  // Writes the instrumentation state and the codec overrides that report
+  // messages to it. Requests are reported as they are decoded, host API
+  // replies as they are encoded and Flutter API replies as they are decoded.
+  void _writeCodecInstrumentation(
+    Indent indent,
+    String module, {
+    required bool encodedSizes,
+  }) {
+    final String codecClassName = _getClassName(module, _codecBaseName);
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    final String instrumentationName = _getClassName(
+      module,
+      _instrumentationBaseName,
+    );
+    final String modulePrefix = _snakeCaseFromCamelCase(module);
+
+    indent.newln();
+    indent.writeln(
+      'static const $instrumentationName* ${modulePrefix}_instrumentation = nullptr;',
+    );
+    indent.writeln(
+      'static gpointer ${modulePrefix}_instrumentation_user_data = nullptr;',
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'void ${modulePrefix}_set_instrumentation(const $instrumentationName* instrumentation, gpointer user_data) {',
+      '}',
+      () {
+        indent.writeln('${modulePrefix}_instrumentation = instrumentation;');
+        indent.writeln(
+          '${modulePrefix}_instrumentation_user_data = user_data;',
+        );
+      },
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'static void ${codecMethodPrefix}_notify_error($codecClassName* self, FlValue* reply) {',
+      '}',
+      () {
+        indent.writeScoped(
+          'if (${modulePrefix}_instrumentation->error == nullptr || reply == nullptr || fl_value_get_type(reply) != FL_VALUE_TYPE_LIST || fl_value_get_length(reply) <= 1) {',
+          '}',
+          () {
+            indent.writeln('return;');
+          },
+        );
+        indent.writeln('FlValue* code = fl_value_get_list_value(reply, 0);');
+        indent.writeln(
+          'FlValue* message = fl_value_get_list_value(reply, 1);',
+        );
+        indent.writeln(
+          '${modulePrefix}_instrumentation->error(self->channel_name, fl_value_get_type(code) == FL_VALUE_TYPE_STRING ? fl_value_get_string(code) : "", fl_value_get_type(message) == FL_VALUE_TYPE_STRING ? fl_value_get_string(message) : "", ${modulePrefix}_instrumentation_user_data);',
+        );
+      },
+    );
+
+    _writeTraceSupport(indent, module);
+
+    indent.newln();
+    indent.writeScoped(
+      'static GBytes* ${codecMethodPrefix}_encode_message(FlMessageCodec* codec, FlValue* message, GError** error) {',
+      '}',
+      () {
+        _writeCastSelf(indent, module, _codecBaseName, 'codec');
+        indent.writeln(
+          'const gint64 encode_start = ${modulePrefix}_trace_now();',
+        );
+        indent.writeScoped(
+          'if (self->is_host_api && self->handler_start != 0) {',
+          '}',
+          () {
+            indent.writeln(
+              '${modulePrefix}_trace_span("handler", self->channel_name, self->handler_start);',
+            );
+            indent.writeln('self->handler_start = 0;');
+          },
+        );
+        indent.writeln(
+          'const $instrumentationName* instrumentation = self->is_host_api ? ${modulePrefix}_instrumentation : nullptr;',
+        );
+        indent.writeScoped('if (instrumentation != nullptr) {', '}', () {
+          indent.writeln('${codecMethodPrefix}_notify_error(self, message);');
+        });
+        indent.writeln(
+          encodedSizes
+              ? 'GBytes* result = ${codecMethodPrefix}_encode_message_reserved(codec, message, error);'
+              : 'GBytes* result = FL_MESSAGE_CODEC_CLASS(${codecMethodPrefix}_parent_class)->encode_message(codec, message, error);',
+        );
+        indent.writeScoped(
+          'if (self->channel_name == nullptr || result == nullptr) {',
+          '}',
+          () {
+            indent.writeln('return result;');
+          },
+        );
+        indent.writeln(
+          '${modulePrefix}_trace_span("encode", self->channel_name, encode_start);',
+        );
+        indent.writeScoped(
+          'if (instrumentation != nullptr && instrumentation->reply != nullptr) {',
+          '}',
+          () {
+            indent.writeln(
+              'instrumentation->reply(self->channel_name, g_bytes_get_size(result), ${modulePrefix}_instrumentation_user_data);',
+            );
+          },
+        );
+        indent.writeScoped('if (self->is_host_api) {', '}', () {
+          indent.writeln(
+            '${modulePrefix}_trace_reply_start(self->channel_name);',
+          );
+        });
+        indent.writeln('return result;');
+      },
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'static FlValue* ${codecMethodPrefix}_decode_message(FlMessageCodec* codec, GBytes* message, GError** error) {',
+      '}',
+      () {
+        _writeCastSelf(indent, module, _codecBaseName, 'codec');
+        indent.writeln(
+          'const gint64 decode_start = ${modulePrefix}_trace_now();',
+        );
+        indent.writeln(
+          'const $instrumentationName* instrumentation = self->channel_name != nullptr ? ${modulePrefix}_instrumentation : nullptr;',
+        );
+        indent.writeScoped(
+          'if (instrumentation != nullptr && instrumentation->decode_start != nullptr) {',
+          '}',
+          () {
+            indent.writeln(
+              'instrumentation->decode_start(self->channel_name, g_bytes_get_size(message), ${modulePrefix}_instrumentation_user_data);',
+            );
+          },
+        );
+        indent.writeln(
+          'FlValue* result = FL_MESSAGE_CODEC_CLASS(${codecMethodPrefix}_parent_class)->decode_message(codec, message, error);',
+        );
+        indent.writeScoped(
+          'if (self->channel_name == nullptr || result == nullptr) {',
+          '}',
+          () {
+            indent.writeln('return result;');
+          },
+        );
+        indent.writeln(
+          '${modulePrefix}_trace_span("decode", self->channel_name, decode_start);',
+        );
+        indent.writeScoped('if (self->is_host_api) {', '}', () {
+          indent.writeln(
+            'self->handler_start = ${modulePrefix}_trace_now();',
+          );
+        });
+        indent.writeScoped('if (instrumentation == nullptr) {', '}', () {
+          indent.writeln('return result;');
+        });
+        indent.writeScoped(
+          'if (instrumentation->handler_start != nullptr) {',
+          '}',
+          () {
+            indent.writeln(
+              'instrumentation->handler_start(self->channel_name, ${modulePrefix}_instrumentation_user_data);',
+            );
+          },
+        );
+        indent.writeScoped('if (!self->is_host_api) {', '}', () {
+          indent.writeln('${codecMethodPrefix}_notify_error(self, result);');
+        });
+        indent.writeln('return result;');
+      },
+    );
+  }
+
+  // Writes the trace event recording used by the codec. Without
+  // GOLUBETS_ENABLE_TRACE the functions compile to no-ops.
+  void _writeTraceSupport(Indent indent, String module) {
+    final String modulePrefix = _snakeCaseFromCamelCase(module);
+    final traceEventName = '${module}TraceEvent';
+    final traceBufferName = '${module}TraceBuffer';
+    final traceBufferSize = '${modulePrefix.toUpperCase()}_TRACE_BUFFER_SIZE';
+
+    indent.newln();
+    indent.format('''
+#ifdef GOLUBETS_ENABLE_TRACE
+// A completed span of a call on a channel. The fields are accessed with
+// atomic builtins so that the trace can be dumped while a thread overwrites
+// them.
+typedef struct {
+  // Twice the index of the span in its buffer, plus one while the span is
+  // written and plus two once it is complete.
+  guint64 sequence;
+  const gchar* name;
+  gchar channel_name[128];
+  gint64 start_us;
+  gint64 duration_us;
+} $traceEventName;
+
+// Number of most recent spans kept for each thread.
+#define $traceBufferSize 4096
+
+// Ring buffer of the spans recorded by one thread. Only the owning thread
+// writes to it, and it never waits for readers: each slot is published
+// through its sequence as in a seqlock, so the dump skips slots it read while
+// they were written.
+typedef struct {
+  guint thread_index;
+  guint64 count;
+  $traceEventName events[$traceBufferSize];
+} $traceBufferName;
+
+G_LOCK_DEFINE_STATIC(${modulePrefix}_trace_buffers);
+static GPtrArray* ${modulePrefix}_trace_buffers = nullptr;
+
+// Channel and start of the reply being sent on this thread.
+static thread_local const gchar* ${modulePrefix}_trace_reply_channel = nullptr;
+static thread_local gint64 ${modulePrefix}_trace_reply_start_us = 0;
+
+static gint64 ${modulePrefix}_trace_now() {
+  return g_get_monotonic_time();
+}
+
+static $traceBufferName* ${modulePrefix}_trace_buffer() {
+  static thread_local $traceBufferName* buffer = nullptr;
+  if (buffer == nullptr) {
+    buffer = g_new0($traceBufferName, 1);
+    G_LOCK(${modulePrefix}_trace_buffers);
+    if (${modulePrefix}_trace_buffers == nullptr) {
+      ${modulePrefix}_trace_buffers = g_ptr_array_new();
+    }
+    buffer->thread_index = ${modulePrefix}_trace_buffers->len;
+    g_ptr_array_add(${modulePrefix}_trace_buffers, buffer);
+    G_UNLOCK(${modulePrefix}_trace_buffers);
+  }
+  return buffer;
+}
+
+// Records the span [name] of a call on [channel_name] from [start_us] until now.
+static void ${modulePrefix}_trace_span(const gchar* name, const gchar* channel_name, gint64 start_us) {
+  const gint64 now = g_get_monotonic_time();
+  $traceBufferName* buffer = ${modulePrefix}_trace_buffer();
+  const guint64 index = __atomic_load_n(&buffer->count, __ATOMIC_RELAXED);
+  $traceEventName* event = &buffer->events[index % $traceBufferSize];
+  __atomic_store_n(&event->sequence, 2 * index + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(&event->name, name, __ATOMIC_RELAXED);
+  gsize length = 0;
+  for (; length + 1 < sizeof(event->channel_name) && channel_name[length] != '\\0'; length++) {
+    __atomic_store_n(&event->channel_name[length], channel_name[length], __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&event->channel_name[length], '\\0', __ATOMIC_RELAXED);
+  __atomic_store_n(&event->start_us, start_us, __ATOMIC_RELAXED);
+  __atomic_store_n(&event->duration_us, now - start_us, __ATOMIC_RELAXED);
+  __atomic_store_n(&event->sequence, 2 * index + 2, __ATOMIC_RELEASE);
+  __atomic_store_n(&buffer->count, index + 1, __ATOMIC_RELEASE);
+}
+
+static void ${modulePrefix}_trace_reply_start(const gchar* channel_name) {
+  ${modulePrefix}_trace_reply_channel = channel_name;
+  ${modulePrefix}_trace_reply_start_us = g_get_monotonic_time();
+}
+
+// Records the time taken to send the reply encoded last on this thread.
+static void ${modulePrefix}_trace_reply_sent() {
+  if (${modulePrefix}_trace_reply_channel != nullptr) {
+    ${modulePrefix}_trace_span("reply", ${modulePrefix}_trace_reply_channel, ${modulePrefix}_trace_reply_start_us);
+    ${modulePrefix}_trace_reply_channel = nullptr;
+  }
+}
+
+gboolean ${modulePrefix}_dump_trace(const gchar* path, GError** error) {
+  g_autoptr(GString) json = g_string_new("{\\"traceEvents\\":[");
+  gboolean first = TRUE;
+  G_LOCK(${modulePrefix}_trace_buffers);
+  for (guint i = 0; ${modulePrefix}_trace_buffers != nullptr && i < ${modulePrefix}_trace_buffers->len; i++) {
+    $traceBufferName* buffer = static_cast<$traceBufferName*>(g_ptr_array_index(${modulePrefix}_trace_buffers, i));
+    const guint64 count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+    const guint64 begin = count > $traceBufferSize ? count - $traceBufferSize : 0;
+    for (guint64 j = begin; j != count; j++) {
+      $traceEventName* event = &buffer->events[j % $traceBufferSize];
+      // Skips the slot if its thread is writing it or has reused it for a
+      // later span, either before or while it is copied.
+      const guint64 sequence = __atomic_load_n(&event->sequence, __ATOMIC_ACQUIRE);
+      if (sequence != 2 * j + 2) {
+        continue;
+      }
+      const gchar* name = __atomic_load_n(&event->name, __ATOMIC_RELAXED);
+      gchar channel_name[sizeof(event->channel_name)] = {};
+      for (gsize k = 0; k + 1 < sizeof(channel_name); k++) {
+        channel_name[k] = __atomic_load_n(&event->channel_name[k], __ATOMIC_RELAXED);
+        if (channel_name[k] == '\\0') {
+          break;
+        }
+      }
+      const gint64 start_us = __atomic_load_n(&event->start_us, __ATOMIC_RELAXED);
+      const gint64 duration_us = __atomic_load_n(&event->duration_us, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&event->sequence, __ATOMIC_RELAXED) != sequence) {
+        continue;
+      }
+      g_string_append_printf(json, "%s{\\"name\\":\\"%s\\",\\"cat\\":\\"golubets\\",\\"ph\\":\\"X\\",\\"ts\\":%" G_GINT64_FORMAT ",\\"dur\\":%" G_GINT64_FORMAT ",\\"pid\\":0,\\"tid\\":%u,\\"args\\":{\\"channel\\":\\"%s\\"}}", first ? "" : ",", name, start_us, duration_us, buffer->thread_index, channel_name);
+      first = FALSE;
+    }
+  }
+  G_UNLOCK(${modulePrefix}_trace_buffers);
+  g_string_append(json, "]}");
+  return g_file_set_contents(path, json->str, json->len, error);
+}
+#else
+static gint64 ${modulePrefix}_trace_now() {
+  return 0;
+}
+
+static void ${modulePrefix}_trace_span(const gchar* name, const gchar* channel_name, gint64 start_us) {}
+
+static void ${modulePrefix}_trace_reply_start(const gchar* channel_name) {}
+
+static void ${modulePrefix}_trace_reply_sent() {}
+#endif  // GOLUBETS_ENABLE_TRACE''');
+  }
+
+  @override
+  void writeFlutterApi(
+    InternalGObjectOptions generatorOptions,
+    Root root,
+    Indent indent,
+    Api api, {
+    required String dartPackageName,
+  }) {
+    final String module = _getModule(generatorOptions, dartPackageName);
+    final String className = _getClassName(module, api.name);
+    final String methodPrefix = _getMethodPrefix(module, api.name);
+    final String codecClassName = _getClassName(module, _codecBaseName);
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+
+    indent.newln();
+    _writeObjectStruct(indent, module, api.name, () {
+      indent.writeln('FlBinaryMessenger* messenger;');
+      indent.writeln('gchar *suffix;');
+      for (final Method method in api.methods) {
+        indent.writeln(
+          'FlBasicMessageChannel* ${_getMethodName(method.name)}_channel;',
+        );
+      }
+    });
+
+    indent.newln();
+    _writeDefineType(indent, module, api.name);
+
+    indent.newln();
+    _writeDispose(indent, module, api.name, () {
+      _writeCastSelf(indent, module, api.name, 'object');
+      indent.writeln('g_clear_object(&self->messenger);');
+      indent.writeln('g_clear_pointer(&self->suffix, g_free);');
+      for (final Method method in api.methods) {
+        indent.writeln(
+          'g_clear_object(&self->${_getMethodName(method.name)}_channel);',
+        );
+      }
+    });
+
+    indent.newln();
+    _writeInit(indent, module, api.name, () {});
+
+    indent.newln();
+    _writeClassInit(indent, module, api.name, () {});
+
+    indent.newln();
+    indent.writeScoped(
+      '$className* ${methodPrefix}_new(FlBinaryMessenger* messenger, const gchar* suffix) {',
+      '}',
+      () {
+        _writeObjectNew(indent, module, api.name);
+        indent.writeln(
+          'self->messenger = FL_BINARY_MESSENGER(g_object_ref(messenger));',
+        );
+        indent.writeln(
+          'self->suffix = suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");',
+        );
+        indent.writeln('return self;');
+      },
+    );
+
+    for (final Method method in api.methods) {
+      final String methodName = _getMethodName(method.name);
+      final String responseName = _getResponseName(api.name, method.name);
+      final String responseClassName = _getClassName(module, responseName);
+      final String responseMethodPrefix = _getMethodPrefix(
+        module,
+        responseName,
+      );
+      final String testResponseMacro =
+          '${_snakeCaseFromCamelCase(module)}_IS_${_snakeCaseFromCamelCase(responseName)}'
+              .toUpperCase();
+
+      indent.newln();
+      _writeObjectStruct(indent, module, responseName, () {
+        indent.writeln('FlValue* error;');
+        if (!method.returnType.isVoid) {
+          indent.writeln('FlValue* return_value;');
+          if (_isNullablePrimitiveType(method.returnType)) {
+            final String primitiveType = _getType(
+              module,
+              method.returnType,
+              primitive: true,
+            );
+            indent.writeln('$primitiveType return_value_;');
+          }
+        }
+      });
+
+      indent.newln();
+      _writeDefineType(indent, module, responseName);
+
+      indent.newln();
+      _writeDispose(indent, module, responseName, () {
+        _writeCastSelf(indent, module, responseName, 'object');
+        indent.writeln('g_clear_pointer(&self->error, fl_value_unref);');
+        if (!method.returnType.isVoid) {
+          indent.writeln(
+            'g_clear_pointer(&self->return_value, fl_value_unref);',
+          );
+        }
+      });
+
+      indent.newln();
+      _writeInit(indent, module, responseName, () {});
+
+      indent.newln();
+      _writeClassInit(indent, module, responseName, () {});
+
+      indent.newln();
+      indent.writeScoped(
+        'static $responseClassName* ${responseMethodPrefix}_new(FlValue* response) {',
+        '}',
+        () {
+          _writeObjectNew(indent, module, responseName);
+          indent.writeScoped(
+            'if (fl_value_get_length(response) > 1) {',
+            '}',
+            () {
+              indent.writeln('self->error = fl_value_ref(response);');
+            },
+          );
+          if (!method.returnType.isVoid) {
+            indent.writeScoped('else {', '}', () {
+              indent.writeln(
+                'FlValue* value = fl_value_get_list_value(response, 0);',
+              );
+              indent.writeln('self->return_value = fl_value_ref(value);');
+            });
+          }
+          indent.writeln('return self;');
+        },
+      );
+
+      indent.newln();
+      indent.writeScoped(
+        'gboolean ${responseMethodPrefix}_is_error($responseClassName* self) {',
+        '}',
+        () {
+          indent.writeln(
+            'g_return_val_if_fail($testResponseMacro(self), FALSE);',
+          );
+          indent.writeln('return self->error != nullptr;');
+        },
+      );
+
+      indent.newln();
+      indent.writeScoped(
+        'const gchar* ${responseMethodPrefix}_get_error_code($responseClassName* self) {',
+        '}',
+        () {
+          indent.writeln(
+            'g_return_val_if_fail($testResponseMacro(self), nullptr);',
+          );
+          indent.writeln('g_assert(${responseMethodPrefix}_is_error(self));');
+          indent.writeln(
+            'return fl_value_get_string(fl_value_get_list_value(self->error, 0));',
+          );
+        },
+      );
+
+      indent.newln();
+      indent.writeScoped(
+        'const gchar* ${responseMethodPrefix}_get_error_message($responseClassName* self) {',
+        '}',
+        () {
+          indent.writeln(
+            'g_return_val_if_fail($testResponseMacro(self), nullptr);',
+          );
+          indent.writeln('g_assert(${responseMethodPrefix}_is_error(self));');
+          indent.writeln(
+            'return fl_value_get_string(fl_value_get_list_value(self->error, 1));',
+          );
+        },
+      );
+
+      indent.newln();
+      indent.writeScoped(
+        'FlValue* ${responseMethodPrefix}_get_error_details($responseClassName* self) {',
+        '}',
+        () {
+          indent.writeln(
+            'g_return_val_if_fail($testResponseMacro(self), nullptr);',
+          );
+          indent.writeln('g_assert(${responseMethodPrefix}_is_error(self));');
+          indent.writeln('return fl_value_get_list_value(self->error, 2);');
+        },
+      );
+
+      if (!method.returnType.isVoid) {
+        final String primitiveType = _getType(
+          module,
+          method.returnType,
+          primitive: true,
+        );
+
+        indent.newln();
+        final returnType = _isNullablePrimitiveType(method.returnType)
+            ? '$primitiveType*'
+            : primitiveType;
+        indent.writeScoped(
+          '$returnType ${responseMethodPrefix}_get_return_value($responseClassName* self${_isNumericListType(method.returnType) ? ', size_t* return_value_length' : ''}) {',
+          '}',
+          () {
+            indent.writeln(
+              'g_return_val_if_fail($testResponseMacro(self), ${_getDefaultValue(module, method.returnType)});',
+            );
+            indent.writeln(
+              'g_assert(!${responseMethodPrefix}_is_error(self));',
+            );
+            if (method.returnType.isNullable) {
+              indent.writeScoped(
+                'if (fl_value_get_type(self->return_value) == FL_VALUE_TYPE_NULL) {',
+                '}',
+                () {
+                  indent.writeln('return nullptr;');
+                },
+              );
+            }
+            if (_isNumericListType(method.returnType)) {
+              indent.writeScoped(
+                'if (return_value_length != nullptr) {',
+                '}',
+                () {
+                  indent.writeln(
+                    '*return_value_length = fl_value_get_length(self->return_value);',
+                  );
+                },
+              );
+            }
+            if (_isNullablePrimitiveType(method.returnType)) {
+              indent.writeln(
+                'self->return_value_ = ${_fromFlValue(module, method.returnType, 'self->return_value', boxedDataClasses: generatorOptions.boxedDataClasses)};',
+              );
+              indent.writeln('return &self->return_value_;');
+            } else {
+              indent.writeln(
+                'return ${_fromFlValue(module, method.returnType, 'self->return_value', boxedDataClasses: generatorOptions.boxedDataClasses)};',
+              );
+            }
+          },
+        );
+      }
+
+      indent.newln();
+      indent.writeScoped(
+        'static void ${methodPrefix}_${methodName}_cb(GObject* object, GAsyncResult* result, gpointer user_data) {',
+        '}',
+        () {
+          indent.writeln('GTask* task = G_TASK(user_data);');
+          indent.writeln(
+            'g_task_return_pointer(task, result, g_object_unref);',
+          );
+        },
+      );
+
+      final asyncArgs = <String>['$className* self'];
+      for (final Parameter param in method.parameters) {
+        final String name = _snakeCaseFromCamelCase(param.name);
+        asyncArgs.add('${_getType(module, param.type)} $name');
+        if (_isNumericListType(param.type)) {
+          asyncArgs.add('size_t ${name}_length');
+        }
+      }
+      asyncArgs.addAll(<String>[
+        'GCancellable* cancellable',
+        'GAsyncReadyCallback callback',
+        'gpointer user_data',
+      ]);
+      indent.newln();
+      indent.writeScoped(
+        "void ${methodPrefix}_$methodName(${asyncArgs.join(', ')}) {",
+        '}',
+        () {
+          indent.writeln('g_autoptr(FlValue) args = fl_value_new_list();');
+          for (final Parameter param in method.parameters) {
+            final String name = _snakeCaseFromCamelCase(param.name);
+            final String value = _makeFlValue(
+              root,
+              module,
+              param.type,
+              name,
+              lengthVariableName: '${name}_length',
+              boxedDataClasses: generatorOptions.boxedDataClasses,
+            );
+            indent.writeln('fl_value_append_take(args, $value);');
+          }
+          final String channelName = makeChannelName(
+            api,
+            method,
+            dartPackageName,
+          );
+          final channel = 'self->${methodName}_channel';
+          indent.writeScoped('if ($channel == nullptr) {', '}', () {
+            indent.writeln(
+              'g_autofree gchar* channel_name = g_strdup_printf("$channelName%s", self->suffix);',
+            );
+            indent.writeln(
+              generatorOptions.includeInstrumentation
+                  ? '$codecClassName* codec = ${codecMethodPrefix}_get_instance_for_channel(channel_name, FALSE);'
+                  : '$codecClassName* codec = ${codecMethodPrefix}_get_instance();',
+            );
+            indent.writeln(
+              '$channel = fl_basic_message_channel_new(self->messenger, channel_name, FL_MESSAGE_CODEC(codec));',
+            );
+          });
+          indent.writeln(
+            'GTask* task = g_task_new(self, cancellable, callback, user_data);',
+          );
+          indent.writeln(
+            'fl_basic_message_channel_send($channel, args, cancellable, ${methodPrefix}_${methodName}_cb, task);',
+          );
+        },
+      );
+
+      final finishArgs = <String>[
+        '$className* self',
+        'GAsyncResult* result',
+        'GError** error',
+      ];
+      indent.newln();
+      indent.writeScoped(
+        "$responseClassName* ${methodPrefix}_${methodName}_finish(${finishArgs.join(', ')}) {",
+        '}',
+        () {
+          indent.writeln('g_autoptr(GTask) task = G_TASK(result);');
+          indent.writeln(
+            'GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));',
+          );
+          indent.writeln(
+            'g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(self->${methodName}_channel, r, error);',
+          );
+          indent.writeScoped('if (response == nullptr) { ', '}', () {
+            indent.writeln('return nullptr;');
+          });
+          indent.writeln('return ${responseMethodPrefix}_new(response);');
+        },
+      );
+    }
   }
 
   @override
-  void writeFlutterApi(
+  void writeHostApi(
     InternalGObjectOptions generatorOptions,
     Root root,
     Indent indent,
@@ -1277,14 +4951,207 @@ class GObjectSourceGenerator
   }) {
     final String module = _getModule(generatorOptions, dartPackageName);
     final String className = _getClassName(module, api.name);
+
     final String methodPrefix = _getMethodPrefix(module, api.name);
+    final String vtableName = _getVTableName(module, api.name);
+
     final String codecClassName = _getClassName(module, _codecBaseName);
     final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
 
+    final bool sharedResponses = generatorOptions.sharedHostApiResponses;
+    if (sharedResponses && _isFirstHostApi(root, api)) {
+      _writeSharedHostApiResponse(indent, module);
+    }
+
+    final bool chunked = api.methods.any(isChunkedMethod);
+    if (chunked && identical(_firstChunkedHostApi(root), api)) {
+      _writeChunkedReplySupport(indent, module);
+    }
+
+    final bool hasAsyncMethod = api.methods.any(
+      (Method method) => method.isAsynchronous,
+    );
+    if (hasAsyncMethod) {
+      indent.newln();
+      _writeObjectStruct(indent, module, '${api.name}ResponseHandle', () {
+        indent.writeln('FlBasicMessageChannel* channel;');
+        indent.writeln('FlBasicMessageChannelResponseHandle* response_handle;');
+        if (chunked) {
+          indent.writeln('FlBinaryMessenger* messenger;');
+          indent.writeln('gchar* chunk_channel_name;');
+        }
+      });
+
+      indent.newln();
+      _writeDefineType(indent, module, '${api.name}ResponseHandle');
+
+      indent.newln();
+      _writeDispose(indent, module, '${api.name}ResponseHandle', () {
+        _writeCastSelf(indent, module, '${api.name}ResponseHandle', 'object');
+        indent.writeln('g_clear_object(&self->channel);');
+        indent.writeln('g_clear_object(&self->response_handle);');
+        if (chunked) {
+          indent.writeln('g_clear_pointer(&self->chunk_channel_name, g_free);');
+        }
+      });
+
+      indent.newln();
+      _writeInit(indent, module, '${api.name}ResponseHandle', () {});
+
+      indent.newln();
+      _writeClassInit(indent, module, '${api.name}ResponseHandle', () {});
+
+      indent.newln();
+      indent.writeScoped(
+        'static ${className}ResponseHandle* ${methodPrefix}_response_handle_new(FlBasicMessageChannel* channel, FlBasicMessageChannelResponseHandle* response_handle) {',
+        '}',
+        () {
+          _writeObjectNew(indent, module, '${api.name}ResponseHandle');
+          indent.writeln(
+            'self->channel = FL_BASIC_MESSAGE_CHANNEL(g_object_ref(channel));',
+          );
+          indent.writeln(
+            'self->response_handle = FL_BASIC_MESSAGE_CHANNEL_RESPONSE_HANDLE(g_object_ref(response_handle));',
+          );
+          indent.writeln('return self;');
+        },
+      );
+    }
+
+    for (final Method method in api.methods) {
+      final String responseName = _getResponseName(api.name, method.name);
+      final String responseClassName = _getClassName(
+        module,
+        _getHostApiResponseName(
+          api.name,
+          method.name,
+          sharedHostApiResponses: sharedResponses,
+        ),
+      );
+      final String responseMethodPrefix = _getMethodPrefix(
+        module,
+        responseName,
+      );
+
+      if (!sharedResponses) {
+        if (method.isAsynchronous) {
+          indent.newln();
+          _writeDeclareFinalType(indent, module, responseName);
+        }
+
+        indent.newln();
+        _writeObjectStruct(indent, module, responseName, () {
+          indent.writeln('FlValue* value;');
+        });
+
+        indent.newln();
+        _writeDefineType(indent, module, responseName);
+
+        indent.newln();
+        _writeDispose(indent, module, responseName, () {
+          _writeCastSelf(indent, module, responseName, 'object');
+          indent.writeln('g_clear_pointer(&self->value, fl_value_unref);');
+        });
+
+        indent.newln();
+        _writeInit(indent, module, responseName, () {});
+
+        indent.newln();
+        _writeClassInit(indent, module, responseName, () {});
+      }
+
+      void writeResponseNew() {
+        if (sharedResponses) {
+          indent.writeln(
+            '$responseClassName* self = g_atomic_rc_box_new0($responseClassName);',
+          );
+        } else {
+          _writeObjectNew(indent, module, responseName);
+        }
+      }
+
+      final String returnType = _getType(module, method.returnType);
+      indent.newln();
+      final constructorArgs = <String>[
+        if (returnType != 'void') '$returnType return_value',
+        if (_isNumericListType(method.returnType)) 'size_t return_value_length',
+      ];
+      indent.writeScoped(
+        "${method.isAsynchronous ? 'static ' : ''}$responseClassName* ${responseMethodPrefix}_new(${constructorArgs.join(', ')}) {",
+        '}',
+        () {
+          writeResponseNew();
+          indent.writeln('self->value = fl_value_new_list();');
+          final String value = _makeFlValue(
+            root,
+            module,
+            method.returnType,
+            'return_value',
+            lengthVariableName: 'return_value_length',
+            boxedDataClasses: generatorOptions.boxedDataClasses,
+          );
+          final int? largeBlobThreshold = method.largeBlobThreshold;
+          if (largeBlobThreshold != null) {
+            final String codecMethodPrefix = _getMethodPrefix(
+              module,
+              _codecBaseName,
+            );
+            final nonNull = method.returnType.isNullable
+                ? 'return_value != nullptr && '
+                : '';
+            indent.writeScoped(
+              'if (${nonNull}return_value_length >= $largeBlobThreshold) {',
+              '}',
+              () {
+                indent.writeln(
+                  'fl_value_append_take(self->value, ${codecMethodPrefix}_large_blob_new(return_value, return_value_length));',
+                );
+              },
+              addTrailingNewline: false,
+            );
+            indent.addScoped(' else {', '}', () {
+              indent.writeln('fl_value_append_take(self->value, $value);');
+            });
+          } else {
+            indent.writeln('fl_value_append_take(self->value, $value);');
+          }
+          indent.writeln('return self;');
+        },
+      );
+
+      indent.newln();
+      indent.writeScoped(
+        '${method.isAsynchronous ? 'static ' : ''}$responseClassName* ${responseMethodPrefix}_new_error(const gchar* code, const gchar* message, FlValue* details) {',
+        '}',
+        () {
+          writeResponseNew();
+          indent.writeln('self->value = fl_value_new_list();');
+          indent.writeln(
+            'fl_value_append_take(self->value, fl_value_new_string(code));',
+          );
+          indent.writeln(
+            'fl_value_append_take(self->value, fl_value_new_string(message != nullptr ? message : ""));',
+          );
+          indent.writeln(
+            'fl_value_append_take(self->value, details != nullptr ? fl_value_ref(details) : fl_value_new_null());',
+          );
+          indent.writeln('return self;');
+        },
+      );
+    }
+
     indent.newln();
     _writeObjectStruct(indent, module, api.name, () {
-      indent.writeln('FlBinaryMessenger* messenger;');
-      indent.writeln('gchar *suffix;');
+      indent.writeln('const ${className}VTable* vtable;');
+      indent.writeln('gpointer user_data;');
+      indent.writeln('GDestroyNotify user_data_free_func;');
+      if (chunked) {
+        indent.writeln(
+          '// The messenger owns the method handlers that keep this alive.',
+        );
+        indent.writeln('FlBinaryMessenger* messenger;');
+        indent.writeln('gchar* dot_suffix;');
+      }
     });
 
     indent.newln();
@@ -1293,8 +5160,13 @@ class GObjectSourceGenerator
     indent.newln();
     _writeDispose(indent, module, api.name, () {
       _writeCastSelf(indent, module, api.name, 'object');
-      indent.writeln('g_clear_object(&self->messenger);');
-      indent.writeln('g_clear_pointer(&self->suffix, g_free);');
+      indent.writeScoped('if (self->user_data != nullptr) {', '}', () {
+        indent.writeln('self->user_data_free_func(self->user_data);');
+      });
+      indent.writeln('self->user_data = nullptr;');
+      if (chunked) {
+        indent.writeln('g_clear_pointer(&self->dot_suffix, g_free);');
+      }
     });
 
     indent.newln();
@@ -1305,572 +5177,1111 @@ class GObjectSourceGenerator
 
     indent.newln();
     indent.writeScoped(
-      '$className* ${methodPrefix}_new(FlBinaryMessenger* messenger, const gchar* suffix) {',
+      'static $className* ${methodPrefix}_new(const $vtableName* vtable, gpointer user_data, GDestroyNotify user_data_free_func) {',
       '}',
       () {
         _writeObjectNew(indent, module, api.name);
-        indent.writeln(
-          'self->messenger = FL_BINARY_MESSENGER(g_object_ref(messenger));',
-        );
-        indent.writeln(
-          'self->suffix = suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");',
-        );
+        indent.writeln('self->vtable = vtable;');
+        indent.writeln('self->user_data = user_data;');
+        indent.writeln('self->user_data_free_func = user_data_free_func;');
         indent.writeln('return self;');
       },
     );
 
+    final bool ffiSync = hasFfiSyncMethods(api);
+    if (ffiSync) {
+      _writeFfiSyncFunctions(
+        indent,
+        module,
+        api,
+        sharedResponses: sharedResponses,
+        dartPackageName: dartPackageName,
+      );
+    }
+
+    final bool multiplexed = api.multiplexed && api.methods.isNotEmpty;
+    final argumentOffset = multiplexed ? 1 : 0;
     for (final Method method in api.methods) {
       final String methodName = _getMethodName(method.name);
-      final String responseName = _getResponseName(api.name, method.name);
-      final String responseClassName = _getClassName(module, responseName);
-      final String responseMethodPrefix = _getMethodPrefix(
+      final String responseClassName = _getClassName(
         module,
-        responseName,
+        _getHostApiResponseName(
+          api.name,
+          method.name,
+          sharedHostApiResponses: sharedResponses,
+        ),
       );
-      final String testResponseMacro =
-          '${_snakeCaseFromCamelCase(module)}_IS_${_snakeCaseFromCamelCase(responseName)}'
-              .toUpperCase();
 
       indent.newln();
-      _writeObjectStruct(indent, module, responseName, () {
-        indent.writeln('FlValue* error;');
-        if (!method.returnType.isVoid) {
-          indent.writeln('FlValue* return_value;');
-          if (_isNullablePrimitiveType(method.returnType)) {
-            final String primitiveType = _getType(
-              module,
-              method.returnType,
-              primitive: true,
+      indent.writeScoped(
+        'static void ${methodPrefix}_${methodName}_cb(FlBasicMessageChannel* channel, FlValue* message_, FlBasicMessageChannelResponseHandle* response_handle, gpointer user_data) {',
+        '}',
+        () {
+          _writeCastSelf(indent, module, api.name, 'user_data');
+
+          indent.newln();
+          indent.writeScoped(
+            'if (self->vtable == nullptr || self->vtable->$methodName == nullptr) {',
+            '}',
+            () {
+              indent.writeln('return;');
+            },
+          );
+
+          indent.newln();
+          final methodArgs = <String>[];
+          for (var i = 0; i < method.parameters.length; i++) {
+            final Parameter param = method.parameters[i];
+            final String paramName = _snakeCaseFromCamelCase(param.name);
+            final String paramType = _getType(module, param.type);
+            indent.writeln(
+              'FlValue* value$i = fl_value_get_list_value(message_, ${i + argumentOffset});',
             );
-            indent.writeln('$primitiveType return_value_;');
+            if (_isNullablePrimitiveType(param.type)) {
+              final String primitiveType = _getType(
+                module,
+                param.type,
+                primitive: true,
+              );
+              indent.writeln('$paramType $paramName = nullptr;');
+              indent.writeln('$primitiveType ${paramName}_value;');
+              indent.writeScoped(
+                'if (fl_value_get_type(value$i) != FL_VALUE_TYPE_NULL) {',
+                '}',
+                () {
+                  final String paramValue = _fromFlValue(
+                    module,
+                    method.parameters[i].type,
+                    'value$i',
+                    boxedDataClasses: generatorOptions.boxedDataClasses,
+                  );
+                  indent.writeln('${paramName}_value = $paramValue;');
+                  indent.writeln('$paramName = &${paramName}_value;');
+                },
+              );
+            } else {
+              final String paramValue = _fromFlValue(
+                module,
+                method.parameters[i].type,
+                'value$i',
+                boxedDataClasses: generatorOptions.boxedDataClasses,
+              );
+              indent.writeln('$paramType $paramName = $paramValue;');
+            }
+            methodArgs.add(paramName);
+            if (_isNumericListType(method.parameters[i].type)) {
+              indent.writeln(
+                'size_t ${paramName}_length = fl_value_get_length(value$i);',
+              );
+              methodArgs.add('${paramName}_length');
+            }
           }
-        }
-      });
+          final String chunkChannelName =
+              'g_strdup_printf("${makeChannelName(api, method, dartPackageName)}%s.chunks", self->dot_suffix)';
+          if (method.isAsynchronous) {
+            final vfuncArgs = <String>[];
+            vfuncArgs.addAll(methodArgs);
+            vfuncArgs.addAll(<String>['handle', 'self->user_data']);
+            indent.writeln(
+              'g_autoptr(${className}ResponseHandle) handle = ${methodPrefix}_response_handle_new(channel, response_handle);',
+            );
+            if (isChunkedMethod(method)) {
+              indent.writeln('handle->messenger = self->messenger;');
+              indent.writeln('handle->chunk_channel_name = $chunkChannelName;');
+            }
+            indent.writeln(
+              "self->vtable->$methodName(${vfuncArgs.join(', ')});",
+            );
+          } else {
+            final vfuncArgs = <String>[];
+            vfuncArgs.addAll(methodArgs);
+            vfuncArgs.add('self->user_data');
+            indent.writeln(
+              "g_autoptr($responseClassName) response = self->vtable->$methodName(${vfuncArgs.join(', ')});",
+            );
+            indent.writeScoped('if (response == nullptr) {', '}', () {
+              indent.writeln(
+                'g_warning("No response returned to %s.%s", "${api.name}", "${method.name}");',
+              );
+              indent.writeln('return;');
+            });
 
-      indent.newln();
-      _writeDefineType(indent, module, responseName);
+            indent.newln();
+            indent.writeln('g_autoptr(GError) error = NULL;');
+            final int? chunkFrameSize = method.chunkFrameSize;
+            if (chunkFrameSize != null) {
+              indent.writeln(
+                'g_autofree gchar* chunk_channel_name = $chunkChannelName;',
+              );
+            }
+            indent.writeScoped(
+              chunkFrameSize != null
+                  ? 'if (!${codecMethodPrefix}_respond_chunked(channel, response_handle, self->messenger, chunk_channel_name, response->value, $chunkFrameSize, &error)) {'
+                  : 'if (!fl_basic_message_channel_respond(channel, response_handle, response->value, &error)) {',
+              '}',
+              () {
+                indent.writeln(
+                  'g_warning("Failed to send response to %s.%s: %s", "${api.name}", "${method.name}", error->message);',
+                );
+              },
+            );
+            if (generatorOptions.includeInstrumentation) {
+              indent.writeln(
+                '${_snakeCaseFromCamelCase(module)}_trace_reply_sent();',
+              );
+            }
+          }
+        },
+      );
+    }
 
+    if (multiplexed) {
       indent.newln();
-      _writeDispose(indent, module, responseName, () {
-        _writeCastSelf(indent, module, responseName, 'object');
-        indent.writeln('g_clear_pointer(&self->error, fl_value_unref);');
-        if (!method.returnType.isVoid) {
+      _writeMultiplexedHostApiCallback(indent, module, api);
+    }
+
+    indent.newln();
+    indent.writeScoped(
+      'void ${methodPrefix}_set_method_handlers(FlBinaryMessenger* messenger, const gchar* suffix, const $vtableName* vtable, gpointer user_data, GDestroyNotify user_data_free_func) {',
+      '}',
+      () {
+        indent.writeln(
+          'g_autofree gchar* dot_suffix = suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");',
+        );
+        indent.writeln(
+          'g_autoptr($className) api_data = ${methodPrefix}_new(vtable, user_data, user_data_free_func);',
+        );
+        if (chunked) {
+          indent.writeln('api_data->messenger = messenger;');
+          indent.writeln('api_data->dot_suffix = g_strdup(dot_suffix);');
+        }
+        if (ffiSync) {
+          indent.writeScoped('if (suffix == nullptr) {', '}', () {
+            indent.writeln('${methodPrefix}_ffi_instance_set(api_data);');
+          });
+        }
+
+        indent.newln();
+        final bool instrumented = generatorOptions.includeInstrumentation;
+        if (multiplexed) {
+          final String channelName = makeMultiplexedChannelName(
+            api,
+            dartPackageName,
+          );
           indent.writeln(
-            'g_clear_pointer(&self->return_value, fl_value_unref);',
+            'g_autofree gchar* channel_name = g_strdup_printf("$channelName%s", dot_suffix);',
+          );
+          indent.writeln(
+            instrumented
+                ? '$codecClassName* codec = ${codecMethodPrefix}_get_instance_for_channel(channel_name, TRUE);'
+                : '$codecClassName* codec = ${codecMethodPrefix}_get_instance();',
+          );
+          indent.writeln(
+            'g_autoptr(FlBasicMessageChannel) channel = fl_basic_message_channel_new(messenger, channel_name, FL_MESSAGE_CODEC(codec));',
+          );
+          indent.writeln(
+            'fl_basic_message_channel_set_message_handler(channel, ${methodPrefix}_cb, g_object_ref(api_data), g_object_unref);',
+          );
+          return;
+        }
+        if (!instrumented) {
+          indent.writeln(
+            '$codecClassName* codec = ${codecMethodPrefix}_get_instance();',
+          );
+        }
+        for (final Method method in api.methods) {
+          final String methodName = _getMethodName(method.name);
+          final String channelName = makeChannelName(
+            api,
+            method,
+            dartPackageName,
+          );
+          final codecName = instrumented ? '${methodName}_codec' : 'codec';
+          indent.writeln(
+            'g_autofree gchar* ${methodName}_channel_name = g_strdup_printf("$channelName%s", dot_suffix);',
+          );
+          if (instrumented) {
+            indent.writeln(
+              '$codecClassName* $codecName = ${codecMethodPrefix}_get_instance_for_channel(${methodName}_channel_name, TRUE);',
+            );
+          }
+          indent.writeln(
+            'g_autoptr(FlBasicMessageChannel) ${methodName}_channel = fl_basic_message_channel_new(messenger, ${methodName}_channel_name, FL_MESSAGE_CODEC($codecName));',
+          );
+          indent.writeln(
+            'fl_basic_message_channel_set_message_handler(${methodName}_channel, ${methodPrefix}_${methodName}_cb, g_object_ref(api_data), g_object_unref);',
+          );
+        }
+      },
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'void ${methodPrefix}_clear_method_handlers(FlBinaryMessenger* messenger, const gchar* suffix) {',
+      '}',
+      () {
+        indent.writeln(
+          'g_autofree gchar* dot_suffix = suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");',
+        );
+        if (ffiSync) {
+          indent.writeScoped('if (suffix == nullptr) {', '}', () {
+            indent.writeln('${methodPrefix}_ffi_instance_set(nullptr);');
+          });
+        }
+
+        indent.newln();
+        indent.writeln(
+          '$codecClassName* codec = ${codecMethodPrefix}_get_instance();',
+        );
+        if (multiplexed) {
+          final String channelName = makeMultiplexedChannelName(
+            api,
+            dartPackageName,
+          );
+          indent.writeln(
+            'g_autofree gchar* channel_name = g_strdup_printf("$channelName%s", dot_suffix);',
+          );
+          indent.writeln(
+            'g_autoptr(FlBasicMessageChannel) channel = fl_basic_message_channel_new(messenger, channel_name, FL_MESSAGE_CODEC(codec));',
+          );
+          indent.writeln(
+            'fl_basic_message_channel_set_message_handler(channel, nullptr, nullptr, nullptr);',
           );
+          return;
         }
-      });
-
-      indent.newln();
-      _writeInit(indent, module, responseName, () {});
-
-      indent.newln();
-      _writeClassInit(indent, module, responseName, () {});
-
-      indent.newln();
-      indent.writeScoped(
-        'static $responseClassName* ${responseMethodPrefix}_new(FlValue* response) {',
-        '}',
-        () {
-          _writeObjectNew(indent, module, responseName);
-          indent.writeScoped(
-            'if (fl_value_get_length(response) > 1) {',
-            '}',
-            () {
-              indent.writeln('self->error = fl_value_ref(response);');
-            },
+        for (final Method method in api.methods) {
+          final String methodName = _getMethodName(method.name);
+          final String channelName = makeChannelName(
+            api,
+            method,
+            dartPackageName,
           );
-          if (!method.returnType.isVoid) {
-            indent.writeScoped('else {', '}', () {
-              indent.writeln(
-                'FlValue* value = fl_value_get_list_value(response, 0);',
-              );
-              indent.writeln('self->return_value = fl_value_ref(value);');
-            });
-          }
-          indent.writeln('return self;');
-        },
-      );
-
-      indent.newln();
-      indent.writeScoped(
-        'gboolean ${responseMethodPrefix}_is_error($responseClassName* self) {',
-        '}',
-        () {
           indent.writeln(
-            'g_return_val_if_fail($testResponseMacro(self), FALSE);',
+            'g_autofree gchar* ${methodName}_channel_name = g_strdup_printf("$channelName%s", dot_suffix);',
           );
-          indent.writeln('return self->error != nullptr;');
-        },
-      );
-
-      indent.newln();
-      indent.writeScoped(
-        'const gchar* ${responseMethodPrefix}_get_error_code($responseClassName* self) {',
-        '}',
-        () {
           indent.writeln(
-            'g_return_val_if_fail($testResponseMacro(self), nullptr);',
+            'g_autoptr(FlBasicMessageChannel) ${methodName}_channel = fl_basic_message_channel_new(messenger, ${methodName}_channel_name, FL_MESSAGE_CODEC(codec));',
           );
-          indent.writeln('g_assert(${responseMethodPrefix}_is_error(self));');
           indent.writeln(
-            'return fl_value_get_string(fl_value_get_list_value(self->error, 0));',
+            'fl_basic_message_channel_set_message_handler(${methodName}_channel, nullptr, nullptr, nullptr);',
           );
-        },
+        }
+      },
+    );
+
+    for (final Method method in api.methods.where(
+      (Method method) => method.isAsynchronous,
+    )) {
+      final String returnType = _getType(module, method.returnType);
+      final String methodName = _getMethodName(method.name);
+      final String responseName = _getResponseName(api.name, method.name);
+      final String responseClassName = _getClassName(
+        module,
+        _getHostApiResponseName(
+          api.name,
+          method.name,
+          sharedHostApiResponses: sharedResponses,
+        ),
+      );
+      final String responseMethodPrefix = _getMethodPrefix(
+        module,
+        responseName,
       );
 
       indent.newln();
+      final respondArgs = <String>[
+        '${className}ResponseHandle* response_handle',
+        if (returnType != 'void') '$returnType return_value',
+        if (_isNumericListType(method.returnType)) 'size_t return_value_length',
+      ];
       indent.writeScoped(
-        'const gchar* ${responseMethodPrefix}_get_error_message($responseClassName* self) {',
+        "void ${methodPrefix}_respond_$methodName(${respondArgs.join(', ')}) {",
         '}',
         () {
+          final returnArgs = <String>[
+            if (returnType != 'void') 'return_value',
+            if (_isNumericListType(method.returnType)) 'return_value_length',
+          ];
           indent.writeln(
-            'g_return_val_if_fail($testResponseMacro(self), nullptr);',
+            'g_autoptr($responseClassName) response = ${responseMethodPrefix}_new(${returnArgs.join(', ')});',
           );
-          indent.writeln('g_assert(${responseMethodPrefix}_is_error(self));');
-          indent.writeln(
-            'return fl_value_get_string(fl_value_get_list_value(self->error, 1));',
+          indent.writeln('g_autoptr(GError) error = nullptr;');
+          final int? chunkFrameSize = method.chunkFrameSize;
+          indent.writeScoped(
+            chunkFrameSize != null
+                ? 'if (!${codecMethodPrefix}_respond_chunked(response_handle->channel, response_handle->response_handle, response_handle->messenger, response_handle->chunk_channel_name, response->value, $chunkFrameSize, &error)) {'
+                : 'if (!fl_basic_message_channel_respond(response_handle->channel, response_handle->response_handle, response->value, &error)) {',
+            '}',
+            () {
+              indent.writeln(
+                'g_warning("Failed to send response to %s.%s: %s", "${api.name}", "${method.name}", error->message);',
+              );
+            },
           );
+          if (generatorOptions.includeInstrumentation) {
+            indent.writeln(
+              '${_snakeCaseFromCamelCase(module)}_trace_reply_sent();',
+            );
+          }
         },
       );
 
       indent.newln();
+      final respondErrorArgs = <String>[
+        '${className}ResponseHandle* response_handle',
+        'const gchar* code',
+        'const gchar* message',
+        'FlValue* details',
+      ];
       indent.writeScoped(
-        'FlValue* ${responseMethodPrefix}_get_error_details($responseClassName* self) {',
+        "void ${methodPrefix}_respond_error_$methodName(${respondErrorArgs.join(', ')}) {",
         '}',
         () {
           indent.writeln(
-            'g_return_val_if_fail($testResponseMacro(self), nullptr);',
+            'g_autoptr($responseClassName) response = ${responseMethodPrefix}_new_error(code, message, details);',
           );
-          indent.writeln('g_assert(${responseMethodPrefix}_is_error(self));');
-          indent.writeln('return fl_value_get_list_value(self->error, 2);');
+          indent.writeln('g_autoptr(GError) error = nullptr;');
+          indent.writeScoped(
+            'if (!fl_basic_message_channel_respond(response_handle->channel, response_handle->response_handle, response->value, &error)) {',
+            '}',
+            () {
+              indent.writeln(
+                'g_warning("Failed to send response to %s.%s: %s", "${api.name}", "${method.name}", error->message);',
+              );
+            },
+          );
+          if (generatorOptions.includeInstrumentation) {
+            indent.writeln(
+              '${_snakeCaseFromCamelCase(module)}_trace_reply_sent();',
+            );
+          }
         },
       );
+    }
+  }
 
-      if (!method.returnType.isVoid) {
-        final String primitiveType = _getType(
-          module,
-          method.returnType,
-          primitive: true,
+  // Writes the reference counted response type shared by all host API
+  // methods.
+  void _writeSharedHostApiResponse(Indent indent, String module) {
+    final String className = _getClassName(module, _sharedHostApiResponseName);
+    final String methodPrefix = _getMethodPrefix(
+      module,
+      _sharedHostApiResponseName,
+    );
+
+    indent.newln();
+    indent.writeScoped('struct _$className {', '};', () {
+      indent.writeln('FlValue* value;');
+    });
+
+    indent.newln();
+    indent.writeScoped(
+      'static void ${methodPrefix}_clear($className* self) {',
+      '}',
+      () {
+        indent.writeln('g_clear_pointer(&self->value, fl_value_unref);');
+      },
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      '$className* ${methodPrefix}_ref($className* self) {',
+      '}',
+      () {
+        indent.writeln(
+          'return static_cast<$className*>(g_atomic_rc_box_acquire(self));',
+        );
+      },
+    );
+
+    indent.newln();
+    indent.writeScoped(
+      'void ${methodPrefix}_unref($className* self) {',
+      '}',
+      () {
+        indent.writeln(
+          'g_atomic_rc_box_release_full(self, (GDestroyNotify)${methodPrefix}_clear);',
+        );
+      },
+    );
+
+    indent.newln();
+    indent.writeln(
+      'G_DEFINE_BOXED_TYPE($className, $methodPrefix, ${methodPrefix}_ref, ${methodPrefix}_unref)',
+    );
+  }
+
+  // Writes the message handler shared by all methods of a multiplexed [api],
+  // which dispatches on the method index at the start of the message.
+  void _writeMultiplexedHostApiCallback(
+    Indent indent,
+    String module,
+    AstHostApi api,
+  ) {
+    final String methodPrefix = _getMethodPrefix(module, api.name);
+    indent.writeScoped(
+      'static void ${methodPrefix}_cb(FlBasicMessageChannel* channel, FlValue* message_, FlBasicMessageChannelResponseHandle* response_handle, gpointer user_data) {',
+      '}',
+      () {
+        indent.writeln(
+          'int64_t method_index = fl_value_get_int(fl_value_get_list_value(message_, 0));',
         );
+        indent.writeScoped('switch (method_index) {', '}', () {
+          for (var i = 0; i < api.methods.length; i++) {
+            final String methodName = _getMethodName(api.methods[i].name);
+            indent.writeln('case $i:');
+            indent.nest(1, () {
+              indent.writeln(
+                '${methodPrefix}_${methodName}_cb(channel, message_, response_handle, user_data);',
+              );
+              indent.writeln('return;');
+            });
+          }
+        });
 
         indent.newln();
-        final returnType = _isNullablePrimitiveType(method.returnType)
-            ? '$primitiveType*'
-            : primitiveType;
+        indent.writeln(
+          'g_autofree gchar* code = g_strdup_printf("Unknown method index %" G_GINT64_FORMAT " for ${api.name}.", method_index);',
+        );
+        indent.writeln('g_autoptr(FlValue) response = fl_value_new_list();');
+        indent.writeln(
+          'fl_value_append_take(response, fl_value_new_string(code));',
+        );
+        indent.writeln(
+          'fl_value_append_take(response, fl_value_new_string("Error"));',
+        );
+        indent.writeln('fl_value_append_take(response, fl_value_new_null());');
+        indent.writeln('g_autoptr(GError) error = nullptr;');
         indent.writeScoped(
-          '$returnType ${responseMethodPrefix}_get_return_value($responseClassName* self${_isNumericListType(method.returnType) ? ', size_t* return_value_length' : ''}) {',
+          'if (!fl_basic_message_channel_respond(channel, response_handle, response, &error)) {',
           '}',
           () {
             indent.writeln(
-              'g_return_val_if_fail($testResponseMacro(self), ${_getDefaultValue(module, method.returnType)});',
-            );
-            indent.writeln(
-              'g_assert(!${responseMethodPrefix}_is_error(self));',
+              'g_warning("Failed to send response to %s: %s", "${api.name}", error->message);',
             );
-            if (method.returnType.isNullable) {
-              indent.writeScoped(
-                'if (fl_value_get_type(self->return_value) == FL_VALUE_TYPE_NULL) {',
-                '}',
-                () {
-                  indent.writeln('return nullptr;');
-                },
-              );
-            }
-            if (_isNumericListType(method.returnType)) {
-              indent.writeScoped(
-                'if (return_value_length != nullptr) {',
-                '}',
-                () {
-                  indent.writeln(
-                    '*return_value_length = fl_value_get_length(self->return_value);',
-                  );
-                },
-              );
-            }
-            if (_isNullablePrimitiveType(method.returnType)) {
-              indent.writeln(
-                'self->return_value_ = ${_fromFlValue(module, method.returnType, 'self->return_value')};',
-              );
-              indent.writeln('return &self->return_value_;');
-            } else {
-              indent.writeln(
-                'return ${_fromFlValue(module, method.returnType, 'self->return_value')};',
-              );
-            }
           },
         );
-      }
+      },
+    );
+  }
+}
+
+/// Writes a standalone GObject benchmark (.cc) for the generated code to sink.
+///
+/// The benchmark builds randomized instances of every data class and
+/// round-trips them through the generated codec, then dispatches every host
+/// API method through an in-process fake `FlBinaryMessenger`, so that message
+/// cost can be measured for a real schema.
+class GObjectBenchmarkGenerator extends Generator<InternalGObjectOptions> {
+  /// Constructor.
+  const GObjectBenchmarkGenerator();
+
+  @override
+  void generate(
+    InternalGObjectOptions generatorOptions,
+    Root root,
+    StringSink sink, {
+    required String dartPackageName,
+  }) {
+    final String module = _getModule(generatorOptions, dartPackageName);
+    final indent = Indent();
+    if (generatorOptions.copyrightHeader != null) {
+      addLines(indent, generatorOptions.copyrightHeader!, linePrefix: '// ');
+    }
+    indent.writeln('// ${getGeneratedCodeWarning()}');
+    indent.writeln('// $seeAlsoWarning');
+    indent.newln();
+    indent.writeln('#include "${generatorOptions.headerIncludePath}"');
+    indent.newln();
+    indent.writeln('#include <stdio.h>');
+    indent.writeln('#include <stdlib.h>');
+    indent.newln();
+    _writeBenchmarkUtilities(indent);
 
+    for (final Enum anEnum in root.enums) {
+      final String customTypeId = _getCustomTypeIdFromDeclaration(
+        root,
+        TypeDeclaration(
+          baseName: anEnum.name,
+          isNullable: false,
+          associatedEnum: anEnum,
+        ),
+        module,
+      );
       indent.newln();
       indent.writeScoped(
-        'static void ${methodPrefix}_${methodName}_cb(GObject* object, GAsyncResult* result, gpointer user_data) {',
+        'static FlValue* ${_randomValueFunctionName(anEnum.name)}(GRand* rng) {',
         '}',
         () {
-          indent.writeln('GTask* task = G_TASK(user_data);');
           indent.writeln(
-            'g_task_return_pointer(task, result, g_object_unref);',
+            'return fl_value_new_custom($customTypeId, fl_value_new_int(g_rand_int_range(rng, 0, ${anEnum.members.length})), (GDestroyNotify)fl_value_unref);',
           );
         },
       );
+    }
 
-      final asyncArgs = <String>['$className* self'];
-      for (final Parameter param in method.parameters) {
-        final String name = _snakeCaseFromCamelCase(param.name);
-        asyncArgs.add('${_getType(module, param.type)} $name');
-        if (_isNumericListType(param.type)) {
-          asyncArgs.add('size_t ${name}_length');
-        }
+    if (root.classes.isNotEmpty) {
+      indent.newln();
+      for (final Class classDefinition in root.classes) {
+        indent.writeln(
+          'static FlValue* ${_randomValueFunctionName(classDefinition.name)}(GRand* rng, int depth);',
+        );
       }
-      asyncArgs.addAll(<String>[
-        'GCancellable* cancellable',
-        'GAsyncReadyCallback callback',
-        'gpointer user_data',
-      ]);
+    }
+    for (final Class classDefinition in root.classes) {
       indent.newln();
-      indent.writeScoped(
-        "void ${methodPrefix}_$methodName(${asyncArgs.join(', ')}) {",
-        '}',
-        () {
-          indent.writeln('g_autoptr(FlValue) args = fl_value_new_list();');
-          for (final Parameter param in method.parameters) {
-            final String name = _snakeCaseFromCamelCase(param.name);
-            final String value = _makeFlValue(
-              root,
-              module,
-              param.type,
-              name,
-              lengthVariableName: '${name}_length',
-            );
-            indent.writeln('fl_value_append_take(args, $value);');
-          }
-          final String channelName = makeChannelName(
-            api,
-            method,
-            dartPackageName,
-          );
-          indent.writeln(
-            'g_autofree gchar* channel_name = g_strdup_printf("$channelName%s", self->suffix);',
-          );
-          indent.writeln(
-            'g_autoptr($codecClassName) codec = ${codecMethodPrefix}_new();',
-          );
-          indent.writeln(
-            'FlBasicMessageChannel* channel = fl_basic_message_channel_new(self->messenger, channel_name, FL_MESSAGE_CODEC(codec));',
-          );
-          indent.writeln(
-            'GTask* task = g_task_new(self, cancellable, callback, user_data);',
-          );
-          indent.writeln(
-            'g_task_set_task_data(task, channel, g_object_unref);',
-          );
-          indent.writeln(
-            'fl_basic_message_channel_send(channel, args, cancellable, ${methodPrefix}_${methodName}_cb, task);',
-          );
-        },
+      _writeRandomClassFunction(
+        root,
+        module,
+        indent,
+        classDefinition,
+        boxedDataClasses: generatorOptions.boxedDataClasses,
       );
+    }
+
+    final Iterable<AstHostApi> hostApis = root.apis.whereType<AstHostApi>();
+    for (final api in hostApis) {
+      _writeBenchmarkHostApi(
+        root,
+        module,
+        indent,
+        api,
+        boxedDataClasses: generatorOptions.boxedDataClasses,
+        sharedHostApiResponses: generatorOptions.sharedHostApiResponses,
+      );
+    }
+
+    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+    indent.newln();
+    indent.writeScoped('int main(int argc, char** argv) {', '}', () {
+      indent.writeln(
+        'const int iterations = argc > 1 ? MAX(atoi(argv[1]), 1) : 10000;',
+      );
+      indent.writeln('g_autoptr(GRand) rng = g_rand_new_with_seed(kSeed);');
+      indent.writeln(
+        'g_autoptr(FlMessageCodec) codec = FL_MESSAGE_CODEC(g_object_new(${codecMethodPrefix}_get_type(), nullptr));',
+      );
+      for (final Class classDefinition in root.classes) {
+        indent.writeln(
+          'run_round_trip_benchmark("${classDefinition.name}", iterations, codec, rng, ${_randomValueFunctionName(classDefinition.name)});',
+        );
+      }
+      if (hostApis.isEmpty) {
+        indent.writeln('return 0;');
+        return;
+      }
 
-      final finishArgs = <String>[
-        '$className* self',
-        'GAsyncResult* result',
-        'GError** error',
-      ];
       indent.newln();
-      indent.writeScoped(
-        "$responseClassName* ${methodPrefix}_${methodName}_finish(${finishArgs.join(', ')}) {",
-        '}',
-        () {
-          indent.writeln('g_autoptr(GTask) task = G_TASK(result);');
-          indent.writeln(
-            'GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));',
-          );
+      indent.writeln(
+        'g_autoptr(BenchMessenger) messenger = BENCH_MESSENGER(g_object_new(bench_messenger_get_type(), nullptr));',
+      );
+      String returnValue(Method method) => method.returnType.isVoid
+          ? 'fl_value_new_null()'
+          : _benchValueExpression(root, module, method.returnType);
+      // Only classes and collections take the nesting depth.
+      if (hostApis.any(
+        (AstHostApi api) => api.methods.any(
+          (Method method) => returnValue(method).contains('depth'),
+        ),
+      )) {
+        indent.writeln('const int depth = 0;');
+      }
+      for (final api in hostApis) {
+        final String methodPrefix = _getMethodPrefix(module, api.name);
+        final returnsName = '${_snakeCaseFromCamelCase(api.name)}_returns';
+        indent.writeln(
+          'GPtrArray* $returnsName = g_ptr_array_new_with_free_func((GDestroyNotify)fl_value_unref);',
+        );
+        for (final Method method in api.methods) {
           indent.writeln(
-            'FlBasicMessageChannel* channel = FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));',
+            'g_ptr_array_add($returnsName, ${returnValue(method)});',
           );
+        }
+        indent.writeln(
+          '${methodPrefix}_set_method_handlers(FL_BINARY_MESSENGER(messenger), nullptr, &${_benchFunctionPrefix(api.name)}_vtable, $returnsName, (GDestroyNotify)g_ptr_array_unref);',
+        );
+        for (final Method method in api.methods) {
+          final String channelName = api.multiplexed
+              ? makeMultiplexedChannelName(api, dartPackageName)
+              : makeChannelName(api, method, dartPackageName);
           indent.writeln(
-            'g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(channel, r, error);',
+            'run_host_call_benchmark("${api.name}.${method.name}", iterations, messenger, codec, "$channelName", rng, ${_benchFunctionPrefix(api.name)}_${_getMethodName(method.name)}_arguments);',
           );
-          indent.writeScoped('if (response == nullptr) { ', '}', () {
-            indent.writeln('return nullptr;');
-          });
-          indent.writeln('return ${responseMethodPrefix}_new(response);');
-        },
-      );
-    }
+        }
+      }
+      indent.newln();
+      indent.writeln('return 0;');
+    });
+    sink.write(indent.toString());
   }
 
-  @override
-  void writeHostApi(
-    InternalGObjectOptions generatorOptions,
-    Root root,
-    Indent indent,
-    Api api, {
-    required String dartPackageName,
-  }) {
-    final String module = _getModule(generatorOptions, dartPackageName);
-    final String className = _getClassName(module, api.name);
+  void _writeBenchmarkUtilities(Indent indent) {
+    indent.format('''
+// Fixed seed so that runs are comparable with each other.
+static const guint32 kSeed = 0x676f6c75;
+// Number of randomized messages generated for each benchmark.
+static const int kSampleCount = 64;
+// Maximum nesting depth of randomized nullable fields and collections.
+static const int kMaxDepth = 3;
+// Maximum length of randomized strings, typed data and collections.
+static const int kMaxLength = 32;
+
+typedef FlValue* (*BenchRandomValueFunc)(GRand* rng, int depth);
+
+// Returns whether a nullable value at [depth] should be populated.
+static gboolean random_present(GRand* rng, int depth) {
+  return depth < kMaxDepth && g_rand_boolean(rng);
+}
 
-    final String methodPrefix = _getMethodPrefix(module, api.name);
-    final String vtableName = _getVTableName(module, api.name);
+static size_t random_length(GRand* rng) {
+  return g_rand_int_range(rng, 0, kMaxLength + 1);
+}
 
-    final String codecClassName = _getClassName(module, _codecBaseName);
-    final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+static int64_t random_int(GRand* rng) {
+  return static_cast<int64_t>(static_cast<uint64_t>(g_rand_int(rng)) << 32 |
+                              g_rand_int(rng));
+}
 
-    final bool hasAsyncMethod = api.methods.any(
-      (Method method) => method.isAsynchronous,
-    );
-    if (hasAsyncMethod) {
-      indent.newln();
-      _writeObjectStruct(indent, module, '${api.name}ResponseHandle', () {
-        indent.writeln('FlBasicMessageChannel* channel;');
-        indent.writeln('FlBasicMessageChannelResponseHandle* response_handle;');
-      });
+template <typename T>
+static T* random_array(GRand* rng, size_t length) {
+  T* value = g_new(T, length);
+  for (size_t i = 0; i < length; i++) {
+    value[i] = static_cast<T>(random_int(rng));
+  }
+  return value;
+}
 
-      indent.newln();
-      _writeDefineType(indent, module, '${api.name}ResponseHandle');
+static FlValue* random_bool_value(GRand* rng) {
+  return fl_value_new_bool(g_rand_boolean(rng));
+}
 
-      indent.newln();
-      _writeDispose(indent, module, '${api.name}ResponseHandle', () {
-        _writeCastSelf(indent, module, '${api.name}ResponseHandle', 'object');
-        indent.writeln('g_clear_object(&self->channel);');
-        indent.writeln('g_clear_object(&self->response_handle);');
-      });
+static FlValue* random_int_value(GRand* rng) {
+  return fl_value_new_int(random_int(rng));
+}
 
-      indent.newln();
-      _writeInit(indent, module, '${api.name}ResponseHandle', () {});
+static FlValue* random_double_value(GRand* rng) {
+  return fl_value_new_float(g_rand_double_range(rng, -1e6, 1e6));
+}
 
-      indent.newln();
-      _writeClassInit(indent, module, '${api.name}ResponseHandle', () {});
+static FlValue* random_string_value(GRand* rng) {
+  size_t length = random_length(rng);
+  g_autofree gchar* value = g_new(gchar, length + 1);
+  for (size_t i = 0; i < length; i++) {
+    value[i] = 'a' + g_rand_int_range(rng, 0, 26);
+  }
+  value[length] = '\\0';
+  return fl_value_new_string(value);
+}
 
-      indent.newln();
-      indent.writeScoped(
-        'static ${className}ResponseHandle* ${methodPrefix}_response_handle_new(FlBasicMessageChannel* channel, FlBasicMessageChannelResponseHandle* response_handle) {',
-        '}',
-        () {
-          _writeObjectNew(indent, module, '${api.name}ResponseHandle');
-          indent.writeln(
-            'self->channel = FL_BASIC_MESSAGE_CHANNEL(g_object_ref(channel));',
-          );
-          indent.writeln(
-            'self->response_handle = FL_BASIC_MESSAGE_CHANNEL_RESPONSE_HANDLE(g_object_ref(response_handle));',
-          );
-          indent.writeln('return self;');
-        },
-      );
+static FlValue* random_uint8_list_value(GRand* rng) {
+  size_t length = random_length(rng);
+  g_autofree uint8_t* value = random_array<uint8_t>(rng, length);
+  return fl_value_new_uint8_list(value, length);
+}
+
+static FlValue* random_int32_list_value(GRand* rng) {
+  size_t length = random_length(rng);
+  g_autofree int32_t* value = random_array<int32_t>(rng, length);
+  return fl_value_new_int32_list(value, length);
+}
+
+static FlValue* random_int64_list_value(GRand* rng) {
+  size_t length = random_length(rng);
+  g_autofree int64_t* value = random_array<int64_t>(rng, length);
+  return fl_value_new_int64_list(value, length);
+}
+
+static FlValue* random_float32_list_value(GRand* rng) {
+  size_t length = random_length(rng);
+  g_autofree float* value = random_array<float>(rng, length);
+  return fl_value_new_float32_list(value, length);
+}
+
+static FlValue* random_float_list_value(GRand* rng) {
+  size_t length = random_length(rng);
+  g_autofree double* value = random_array<double>(rng, length);
+  return fl_value_new_float_list(value, length);
+}
+
+static FlValue* random_fl_value(GRand* rng, int depth) {
+  switch (g_rand_int_range(rng, 0, 4)) {
+    case 0:
+      return random_bool_value(rng);
+    case 1:
+      return random_int_value(rng);
+    case 2:
+      return random_double_value(rng);
+    default:
+      return random_string_value(rng);
+  }
+}
+
+static FlValue* random_list_value(GRand* rng, int depth,
+                                  BenchRandomValueFunc element) {
+  FlValue* value = fl_value_new_list();
+  if (depth < kMaxDepth) {
+    size_t length = random_length(rng);
+    for (size_t i = 0; i < length; i++) {
+      fl_value_append_take(value, element(rng, depth + 1));
     }
+  }
+  return value;
+}
 
-    for (final Method method in api.methods) {
-      final String responseName = _getResponseName(api.name, method.name);
-      final String responseClassName = _getClassName(module, responseName);
-      final String responseMethodPrefix = _getMethodPrefix(
-        module,
-        responseName,
-      );
+static FlValue* random_map_value(GRand* rng, int depth, BenchRandomValueFunc key,
+                                 BenchRandomValueFunc value) {
+  FlValue* map = fl_value_new_map();
+  if (depth < kMaxDepth) {
+    size_t length = random_length(rng);
+    for (size_t i = 0; i < length; i++) {
+      fl_value_set_take(map, key(rng, depth + 1), value(rng, depth + 1));
+    }
+  }
+  return map;
+}
 
-      if (method.isAsynchronous) {
-        indent.newln();
-        _writeDeclareFinalType(indent, module, responseName);
-      }
+// A FlBinaryMessenger that dispatches messages to registered handlers
+// in-process, standing in for the engine.
+G_DECLARE_FINAL_TYPE(BenchMessenger, bench_messenger, BENCH, MESSENGER, GObject)
 
-      indent.newln();
-      _writeObjectStruct(indent, module, responseName, () {
-        indent.writeln('FlValue* value;');
-      });
+struct _BenchMessenger {
+  GObject parent_instance;
 
-      indent.newln();
-      _writeDefineType(indent, module, responseName);
+  GHashTable* message_handlers;
+  size_t response_size;
+};
 
-      indent.newln();
-      _writeDispose(indent, module, responseName, () {
-        _writeCastSelf(indent, module, responseName, 'object');
-        indent.writeln('g_clear_pointer(&self->value, fl_value_unref);');
-      });
+G_DECLARE_FINAL_TYPE(BenchMessengerResponseHandle,
+                     bench_messenger_response_handle, BENCH,
+                     MESSENGER_RESPONSE_HANDLE, FlBinaryMessengerResponseHandle)
 
-      indent.newln();
-      _writeInit(indent, module, responseName, () {});
+struct _BenchMessengerResponseHandle {
+  FlBinaryMessengerResponseHandle parent_instance;
+};
 
-      indent.newln();
-      _writeClassInit(indent, module, responseName, () {});
+G_DEFINE_TYPE(BenchMessengerResponseHandle, bench_messenger_response_handle,
+              fl_binary_messenger_response_handle_get_type())
 
-      final String returnType = _getType(module, method.returnType);
-      indent.newln();
-      final constructorArgs = <String>[
-        if (returnType != 'void') '$returnType return_value',
-        if (_isNumericListType(method.returnType)) 'size_t return_value_length',
-      ];
-      indent.writeScoped(
-        "${method.isAsynchronous ? 'static ' : ''}$responseClassName* ${responseMethodPrefix}_new(${constructorArgs.join(', ')}) {",
-        '}',
-        () {
-          _writeObjectNew(indent, module, responseName);
-          indent.writeln('self->value = fl_value_new_list();');
-          indent.writeln(
-            "fl_value_append_take(self->value, ${_makeFlValue(root, module, method.returnType, 'return_value', lengthVariableName: 'return_value_length')});",
-          );
-          indent.writeln('return self;');
-        },
-      );
+static void bench_messenger_response_handle_class_init(
+    BenchMessengerResponseHandleClass* klass) {}
 
-      indent.newln();
-      indent.writeScoped(
-        '${method.isAsynchronous ? 'static ' : ''}$responseClassName* ${responseMethodPrefix}_new_error(const gchar* code, const gchar* message, FlValue* details) {',
-        '}',
-        () {
-          _writeObjectNew(indent, module, responseName);
-          indent.writeln('self->value = fl_value_new_list();');
-          indent.writeln(
-            'fl_value_append_take(self->value, fl_value_new_string(code));',
-          );
-          indent.writeln(
-            'fl_value_append_take(self->value, fl_value_new_string(message != nullptr ? message : ""));',
-          );
-          indent.writeln(
-            'fl_value_append_take(self->value, details != nullptr ? fl_value_ref(details) : fl_value_new_null());',
-          );
-          indent.writeln('return self;');
-        },
-      );
-    }
+static void bench_messenger_response_handle_init(
+    BenchMessengerResponseHandle* self) {}
+
+typedef struct {
+  FlBinaryMessengerMessageHandler handler;
+  gpointer user_data;
+  GDestroyNotify destroy_notify;
+} BenchMessageHandler;
+
+static void bench_message_handler_free(gpointer data) {
+  BenchMessageHandler* self = static_cast<BenchMessageHandler*>(data);
+  if (self->destroy_notify != nullptr) {
+    self->destroy_notify(self->user_data);
+  }
+  g_free(self);
+}
+
+static void bench_messenger_binary_messenger_iface_init(
+    FlBinaryMessengerInterface* iface);
+
+G_DEFINE_TYPE_WITH_CODE(
+    BenchMessenger, bench_messenger, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE(fl_binary_messenger_get_type(),
+                          bench_messenger_binary_messenger_iface_init))
+
+static void bench_messenger_set_message_handler_on_channel(
+    FlBinaryMessenger* messenger, const gchar* channel,
+    FlBinaryMessengerMessageHandler handler, gpointer user_data,
+    GDestroyNotify destroy_notify) {
+  BenchMessenger* self = BENCH_MESSENGER(messenger);
+  if (handler == nullptr) {
+    g_hash_table_remove(self->message_handlers, channel);
+    return;
+  }
+  BenchMessageHandler* message_handler = g_new0(BenchMessageHandler, 1);
+  message_handler->handler = handler;
+  message_handler->user_data = user_data;
+  message_handler->destroy_notify = destroy_notify;
+  g_hash_table_replace(self->message_handlers, g_strdup(channel),
+                       message_handler);
+}
+
+static gboolean bench_messenger_send_response(
+    FlBinaryMessenger* messenger,
+    FlBinaryMessengerResponseHandle* response_handle, GBytes* response,
+    GError** error) {
+  BenchMessenger* self = BENCH_MESSENGER(messenger);
+  self->response_size = response != nullptr ? g_bytes_get_size(response) : 0;
+  return TRUE;
+}
+
+static void bench_messenger_send_on_channel(FlBinaryMessenger* messenger,
+                                            const gchar* channel,
+                                            GBytes* message,
+                                            GCancellable* cancellable,
+                                            GAsyncReadyCallback callback,
+                                            gpointer user_data) {}
 
-    indent.newln();
-    _writeObjectStruct(indent, module, api.name, () {
-      indent.writeln('const ${className}VTable* vtable;');
-      indent.writeln('gpointer user_data;');
-      indent.writeln('GDestroyNotify user_data_free_func;');
-    });
+static GBytes* bench_messenger_send_on_channel_finish(
+    FlBinaryMessenger* messenger, GAsyncResult* result, GError** error) {
+  return g_bytes_new(nullptr, 0);
+}
 
-    indent.newln();
-    _writeDefineType(indent, module, api.name);
+static void bench_messenger_resize_channel(FlBinaryMessenger* messenger,
+                                           const gchar* channel,
+                                           int64_t new_size) {}
 
-    indent.newln();
-    _writeDispose(indent, module, api.name, () {
-      _writeCastSelf(indent, module, api.name, 'object');
-      indent.writeScoped('if (self->user_data != nullptr) {', '}', () {
-        indent.writeln('self->user_data_free_func(self->user_data);');
-      });
-      indent.writeln('self->user_data = nullptr;');
-    });
+static void bench_messenger_set_warns_on_channel_overflow(
+    FlBinaryMessenger* messenger, const gchar* channel, bool warns) {}
 
-    indent.newln();
-    _writeInit(indent, module, api.name, () {});
+static void bench_messenger_dispose(GObject* object) {
+  BenchMessenger* self = BENCH_MESSENGER(object);
+  g_clear_pointer(&self->message_handlers, g_hash_table_unref);
+  G_OBJECT_CLASS(bench_messenger_parent_class)->dispose(object);
+}
 
-    indent.newln();
-    _writeClassInit(indent, module, api.name, () {});
+static void bench_messenger_class_init(BenchMessengerClass* klass) {
+  G_OBJECT_CLASS(klass)->dispose = bench_messenger_dispose;
+}
 
-    indent.newln();
+static void bench_messenger_binary_messenger_iface_init(
+    FlBinaryMessengerInterface* iface) {
+  iface->set_message_handler_on_channel =
+      bench_messenger_set_message_handler_on_channel;
+  iface->send_response = bench_messenger_send_response;
+  iface->send_on_channel = bench_messenger_send_on_channel;
+  iface->send_on_channel_finish = bench_messenger_send_on_channel_finish;
+  iface->resize_channel = bench_messenger_resize_channel;
+  iface->set_warns_on_channel_overflow =
+      bench_messenger_set_warns_on_channel_overflow;
+}
+
+static void bench_messenger_init(BenchMessenger* self) {
+  self->message_handlers = g_hash_table_new_full(
+      g_str_hash, g_str_equal, g_free, bench_message_handler_free);
+}
+
+// Synchronously calls the handler registered for [channel] with [message], and
+// returns the size of the response.
+static size_t bench_messenger_dispatch(BenchMessenger* self,
+                                       const gchar* channel, GBytes* message) {
+  BenchMessageHandler* message_handler = static_cast<BenchMessageHandler*>(
+      g_hash_table_lookup(self->message_handlers, channel));
+  if (message_handler == nullptr) {
+    return 0;
+  }
+  self->response_size = 0;
+  g_autoptr(BenchMessengerResponseHandle) response_handle =
+      BENCH_MESSENGER_RESPONSE_HANDLE(
+          g_object_new(bench_messenger_response_handle_get_type(), nullptr));
+  message_handler->handler(FL_BINARY_MESSENGER(self), channel, message,
+                           FL_BINARY_MESSENGER_RESPONSE_HANDLE(response_handle),
+                           message_handler->user_data);
+  return self->response_size;
+}
+
+typedef struct {
+  FlMessageCodec* codec;
+  BenchMessenger* messenger;
+  const gchar* channel;
+  // FlValue* samples for round trips, GBytes* messages for host calls.
+  GPtrArray* samples;
+} BenchContext;
+
+typedef size_t (*BenchFunc)(BenchContext* context, guint sample);
+
+// Calls [func] [iterations] times and prints the mean time and bytes per call.
+static void run_benchmark(const gchar* name, int iterations, BenchFunc func,
+                          BenchContext* context) {
+  size_t bytes = 0;
+  gint64 start = g_get_monotonic_time();
+  for (int i = 0; i < iterations; i++) {
+    bytes += func(context, i % kSampleCount);
+  }
+  gint64 elapsed = g_get_monotonic_time() - start;
+  printf("%-64s %10d iterations %12.1f ns/op %10.1f bytes/op\\n", name,
+         iterations, elapsed * 1000.0 / iterations,
+         static_cast<double>(bytes) / iterations);
+}
+
+static size_t bench_round_trip(BenchContext* context, guint sample) {
+  FlValue* value =
+      static_cast<FlValue*>(g_ptr_array_index(context->samples, sample));
+  g_autoptr(GBytes) message =
+      fl_message_codec_encode_message(context->codec, value, nullptr);
+  if (message == nullptr) {
+    return 0;
+  }
+  g_autoptr(FlValue) decoded =
+      fl_message_codec_decode_message(context->codec, message, nullptr);
+  return decoded != nullptr ? g_bytes_get_size(message) : 0;
+}
+
+static size_t bench_host_call(BenchContext* context, guint sample) {
+  GBytes* message =
+      static_cast<GBytes*>(g_ptr_array_index(context->samples, sample));
+  return g_bytes_get_size(message) +
+         bench_messenger_dispatch(context->messenger, context->channel,
+                                  message);
+}
+
+// Benchmarks encoding and decoding values created by [make_sample].
+static void run_round_trip_benchmark(const gchar* name, int iterations,
+                                     FlMessageCodec* codec, GRand* rng,
+                                     BenchRandomValueFunc make_sample) {
+  g_autoptr(GPtrArray) samples =
+      g_ptr_array_new_with_free_func((GDestroyNotify)fl_value_unref);
+  for (int i = 0; i < kSampleCount; i++) {
+    g_ptr_array_add(samples, make_sample(rng, 0));
+  }
+  BenchContext context = {codec, nullptr, nullptr, samples};
+  g_autofree gchar* label = g_strdup_printf("%s round trip", name);
+  run_benchmark(label, iterations, bench_round_trip, &context);
+}
+
+// Benchmarks dispatching messages created by [make_arguments] to the host API
+// handler registered for [channel].
+static void run_host_call_benchmark(const gchar* name, int iterations,
+                                    BenchMessenger* messenger,
+                                    FlMessageCodec* codec, const gchar* channel,
+                                    GRand* rng,
+                                    BenchRandomValueFunc make_arguments) {
+  g_autoptr(GPtrArray) messages =
+      g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+  for (int i = 0; i < kSampleCount; i++) {
+    g_autoptr(FlValue) arguments = make_arguments(rng, 0);
+    g_ptr_array_add(messages,
+                    fl_message_codec_encode_message(codec, arguments, nullptr));
+  }
+  BenchContext context = {codec, messenger, channel, messages};
+  g_autofree gchar* label = g_strdup_printf("%s host call", name);
+  run_benchmark(label, iterations, bench_host_call, &context);
+}''');
+  }
+
+  void _writeRandomClassFunction(
+    Root root,
+    String module,
+    Indent indent,
+    Class classDefinition, {
+    required bool boxedDataClasses,
+  }) {
+    final String methodPrefix = _getMethodPrefix(module, classDefinition.name);
+    final String className = _getClassName(module, classDefinition.name);
+    final String customTypeId = _getCustomTypeIdFromDeclaration(
+      root,
+      TypeDeclaration(
+        baseName: classDefinition.name,
+        isNullable: false,
+        associatedClass: classDefinition,
+      ),
+      module,
+    );
     indent.writeScoped(
-      'static $className* ${methodPrefix}_new(const $vtableName* vtable, gpointer user_data, GDestroyNotify user_data_free_func) {',
+      'static FlValue* ${_randomValueFunctionName(classDefinition.name)}(GRand* rng, int depth) {',
       '}',
       () {
-        _writeObjectNew(indent, module, api.name);
-        indent.writeln('self->vtable = vtable;');
-        indent.writeln('self->user_data = user_data;');
-        indent.writeln('self->user_data_free_func = user_data_free_func;');
-        indent.writeln('return self;');
+        final args = <String>[];
+        for (final NamedType field in classDefinition.fields) {
+          final String fieldName = _getFieldName(field.name);
+          indent.writeln(
+            'g_autoptr(FlValue) ${fieldName}_fl_value = ${_benchFlValueExpression(root, module, field.type)};',
+          );
+          args.addAll(
+            _writeNativeValue(
+              module,
+              indent,
+              field.type,
+              fieldName,
+              '${fieldName}_fl_value',
+              boxedDataClasses: boxedDataClasses,
+            ),
+          );
+        }
+        indent.writeln(
+          'g_autoptr($className) value = ${methodPrefix}_new(${args.join(', ')});',
+        );
+        indent.writeln(
+          'return ${_newClassFlValue(module, classDefinition.name, customTypeId, 'value', boxedDataClasses: boxedDataClasses)};',
+        );
       },
     );
+  }
 
-    for (final Method method in api.methods) {
+  void _writeBenchmarkHostApi(
+    Root root,
+    String module,
+    Indent indent,
+    AstHostApi api, {
+    required bool boxedDataClasses,
+    required bool sharedHostApiResponses,
+  }) {
+    final String className = _getClassName(module, api.name);
+    final String methodPrefix = _getMethodPrefix(module, api.name);
+    final String benchPrefix = _benchFunctionPrefix(api.name);
+
+    for (var i = 0; i < api.methods.length; i++) {
+      final Method method = api.methods[i];
       final String methodName = _getMethodName(method.name);
       final String responseName = _getResponseName(api.name, method.name);
-      final String responseClassName = _getClassName(module, responseName);
+      final String responseClassName = _getClassName(
+        module,
+        _getHostApiResponseName(
+          api.name,
+          method.name,
+          sharedHostApiResponses: sharedHostApiResponses,
+        ),
+      );
+      final String responseMethodPrefix = _getMethodPrefix(
+        module,
+        responseName,
+      );
 
+      final methodArgs = <String>[];
+      for (final Parameter param in method.parameters) {
+        final String name = _snakeCaseFromCamelCase(param.name);
+        methodArgs.add('${_getType(module, param.type)} $name');
+        if (_isNumericListType(param.type)) {
+          methodArgs.add('size_t ${name}_length');
+        }
+      }
+      methodArgs.addAll(<String>[
+        if (method.isAsynchronous)
+          '${className}ResponseHandle* response_handle',
+        'gpointer user_data',
+      ]);
+      final returnType = method.isAsynchronous
+          ? 'void'
+          : '$responseClassName*';
       indent.newln();
       indent.writeScoped(
-        'static void ${methodPrefix}_${methodName}_cb(FlBasicMessageChannel* channel, FlValue* message_, FlBasicMessageChannelResponseHandle* response_handle, gpointer user_data) {',
+        'static $returnType ${benchPrefix}_$methodName(${methodArgs.join(', ')}) {',
         '}',
         () {
-          _writeCastSelf(indent, module, api.name, 'user_data');
-
-          indent.newln();
-          indent.writeScoped(
-            'if (self->vtable == nullptr || self->vtable->$methodName == nullptr) {',
-            '}',
-            () {
-              indent.writeln('return;');
-            },
-          );
-
-          indent.newln();
-          final methodArgs = <String>[];
-          for (var i = 0; i < method.parameters.length; i++) {
-            final Parameter param = method.parameters[i];
-            final String paramName = _snakeCaseFromCamelCase(param.name);
-            final String paramType = _getType(module, param.type);
+          final returnArgs = <String>[];
+          if (!method.returnType.isVoid) {
             indent.writeln(
-              'FlValue* value$i = fl_value_get_list_value(message_, $i);',
+              'FlValue* return_fl_value = static_cast<FlValue*>(g_ptr_array_index(static_cast<GPtrArray*>(user_data), $i));',
             );
-            if (_isNullablePrimitiveType(param.type)) {
-              final String primitiveType = _getType(
-                module,
-                param.type,
-                primitive: true,
-              );
-              indent.writeln('$paramType $paramName = nullptr;');
-              indent.writeln('$primitiveType ${paramName}_value;');
-              indent.writeScoped(
-                'if (fl_value_get_type(value$i) != FL_VALUE_TYPE_NULL) {',
-                '}',
-                () {
-                  final String paramValue = _fromFlValue(
-                    module,
-                    method.parameters[i].type,
-                    'value$i',
-                  );
-                  indent.writeln('${paramName}_value = $paramValue;');
-                  indent.writeln('$paramName = &${paramName}_value;');
-                },
-              );
-            } else {
-              final String paramValue = _fromFlValue(
+            returnArgs.addAll(
+              _writeNativeValue(
                 module,
-                method.parameters[i].type,
-                'value$i',
-              );
-              indent.writeln('$paramType $paramName = $paramValue;');
-            }
-            methodArgs.add(paramName);
-            if (_isNumericListType(method.parameters[i].type)) {
-              indent.writeln(
-                'size_t ${paramName}_length = fl_value_get_length(value$i);',
-              );
-              methodArgs.add('${paramName}_length');
-            }
+                indent,
+                method.returnType,
+                'return_value',
+                'return_fl_value',
+                boxedDataClasses: boxedDataClasses,
+              ),
+            );
           }
           if (method.isAsynchronous) {
-            final vfuncArgs = <String>[];
-            vfuncArgs.addAll(methodArgs);
-            vfuncArgs.addAll(<String>['handle', 'self->user_data']);
             indent.writeln(
-              'g_autoptr(${className}ResponseHandle) handle = ${methodPrefix}_response_handle_new(channel, response_handle);',
-            );
-            indent.writeln(
-              "self->vtable->$methodName(${vfuncArgs.join(', ')});",
+              '${methodPrefix}_respond_$methodName(${<String>['response_handle', ...returnArgs].join(', ')});',
             );
           } else {
-            final vfuncArgs = <String>[];
-            vfuncArgs.addAll(methodArgs);
-            vfuncArgs.add('self->user_data');
             indent.writeln(
-              "g_autoptr($responseClassName) response = self->vtable->$methodName(${vfuncArgs.join(', ')});",
-            );
-            indent.writeScoped('if (response == nullptr) {', '}', () {
-              indent.writeln(
-                'g_warning("No response returned to %s.%s", "${api.name}", "${method.name}");',
-              );
-              indent.writeln('return;');
-            });
-
-            indent.newln();
-            indent.writeln('g_autoptr(GError) error = NULL;');
-            indent.writeScoped(
-              'if (!fl_basic_message_channel_respond(channel, response_handle, response->value, &error)) {',
-              '}',
-              () {
-                indent.writeln(
-                  'g_warning("Failed to send response to %s.%s: %s", "${api.name}", "${method.name}", error->message);',
-                );
-              },
+              'return ${responseMethodPrefix}_new(${returnArgs.join(', ')});',
             );
           }
         },
@@ -1879,143 +6290,169 @@ class GObjectSourceGenerator
 
     indent.newln();
     indent.writeScoped(
-      'void ${methodPrefix}_set_method_handlers(FlBinaryMessenger* messenger, const gchar* suffix, const $vtableName* vtable, gpointer user_data, GDestroyNotify user_data_free_func) {',
-      '}',
-      () {
-        indent.writeln(
-          'g_autofree gchar* dot_suffix = suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");',
-        );
-        indent.writeln(
-          'g_autoptr($className) api_data = ${methodPrefix}_new(vtable, user_data, user_data_free_func);',
-        );
-
-        indent.newln();
-        indent.writeln(
-          'g_autoptr($codecClassName) codec = ${codecMethodPrefix}_new();',
-        );
-        for (final Method method in api.methods) {
-          final String methodName = _getMethodName(method.name);
-          final String channelName = makeChannelName(
-            api,
-            method,
-            dartPackageName,
-          );
-          indent.writeln(
-            'g_autofree gchar* ${methodName}_channel_name = g_strdup_printf("$channelName%s", dot_suffix);',
-          );
-          indent.writeln(
-            'g_autoptr(FlBasicMessageChannel) ${methodName}_channel = fl_basic_message_channel_new(messenger, ${methodName}_channel_name, FL_MESSAGE_CODEC(codec));',
-          );
-          indent.writeln(
-            'fl_basic_message_channel_set_message_handler(${methodName}_channel, ${methodPrefix}_${methodName}_cb, g_object_ref(api_data), g_object_unref);',
-          );
-        }
-      },
-    );
-
-    indent.newln();
-    indent.writeScoped(
-      'void ${methodPrefix}_clear_method_handlers(FlBinaryMessenger* messenger, const gchar* suffix) {',
-      '}',
+      'static const ${_getVTableName(module, api.name)} ${benchPrefix}_vtable = {',
+      '};',
       () {
-        indent.writeln(
-          'g_autofree gchar* dot_suffix = suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");',
-        );
-
-        indent.newln();
-        indent.writeln(
-          'g_autoptr($codecClassName) codec = ${codecMethodPrefix}_new();',
-        );
-        for (final Method method in api.methods) {
-          final String methodName = _getMethodName(method.name);
-          final String channelName = makeChannelName(
-            api,
-            method,
-            dartPackageName,
-          );
-          indent.writeln(
-            'g_autofree gchar* ${methodName}_channel_name = g_strdup_printf("$channelName%s", dot_suffix);',
-          );
-          indent.writeln(
-            'g_autoptr(FlBasicMessageChannel) ${methodName}_channel = fl_basic_message_channel_new(messenger, ${methodName}_channel_name, FL_MESSAGE_CODEC(codec));',
-          );
-          indent.writeln(
-            'fl_basic_message_channel_set_message_handler(${methodName}_channel, nullptr, nullptr, nullptr);',
-          );
-        }
-      },
-    );
-
-    for (final Method method in api.methods.where(
-      (Method method) => method.isAsynchronous,
-    )) {
-      final String returnType = _getType(module, method.returnType);
-      final String methodName = _getMethodName(method.name);
-      final String responseName = _getResponseName(api.name, method.name);
-      final String responseClassName = _getClassName(module, responseName);
-      final String responseMethodPrefix = _getMethodPrefix(
-        module,
-        responseName,
-      );
+        for (final Method method in api.methods) {
+          final String methodName = _getMethodName(method.name);
+          indent.writeln('.$methodName = ${benchPrefix}_$methodName,');
+        }
+      },
+    );
 
+    for (var i = 0; i < api.methods.length; i++) {
+      final Method method = api.methods[i];
       indent.newln();
-      final respondArgs = <String>[
-        '${className}ResponseHandle* response_handle',
-        if (returnType != 'void') '$returnType return_value',
-        if (_isNumericListType(method.returnType)) 'size_t return_value_length',
-      ];
       indent.writeScoped(
-        "void ${methodPrefix}_respond_$methodName(${respondArgs.join(', ')}) {",
+        'static FlValue* ${benchPrefix}_${_getMethodName(method.name)}_arguments(GRand* rng, int depth) {',
         '}',
         () {
-          final returnArgs = <String>[
-            if (returnType != 'void') 'return_value',
-            if (_isNumericListType(method.returnType)) 'return_value_length',
-          ];
-          indent.writeln(
-            'g_autoptr($responseClassName) response = ${responseMethodPrefix}_new(${returnArgs.join(', ')});',
-          );
-          indent.writeln('g_autoptr(GError) error = nullptr;');
-          indent.writeScoped(
-            'if (!fl_basic_message_channel_respond(response_handle->channel, response_handle->response_handle, response->value, &error)) {',
-            '}',
-            () {
-              indent.writeln(
-                'g_warning("Failed to send response to %s.%s: %s", "${api.name}", "${method.name}", error->message);',
-              );
-            },
-          );
+          if (method.parameters.isEmpty && !api.multiplexed) {
+            indent.writeln('return fl_value_new_null();');
+            return;
+          }
+          indent.writeln('FlValue* arguments = fl_value_new_list();');
+          if (api.multiplexed) {
+            indent.writeln(
+              'fl_value_append_take(arguments, fl_value_new_int($i));',
+            );
+          }
+          for (final Parameter param in method.parameters) {
+            indent.writeln(
+              'fl_value_append_take(arguments, ${_benchFlValueExpression(root, module, param.type)});',
+            );
+          }
+          indent.writeln('return arguments;');
         },
       );
+    }
+  }
 
-      indent.newln();
-      final respondErrorArgs = <String>[
-        '${className}ResponseHandle* response_handle',
-        'const gchar* code',
-        'const gchar* message',
-        'FlValue* details',
-      ];
+  /// Writes the declarations converting the FlValue in [valueName] to the
+  /// native arguments for [type], and returns the argument names.
+  List<String> _writeNativeValue(
+    String module,
+    Indent indent,
+    TypeDeclaration type,
+    String name,
+    String valueName, {
+    required bool boxedDataClasses,
+  }) {
+    final String nativeType = _getType(module, type);
+    final String value = _fromFlValue(
+      module,
+      type,
+      valueName,
+      boxedDataClasses: boxedDataClasses,
+    );
+    final bool hasLength = _isNumericListType(type);
+    if (_isNullablePrimitiveType(type)) {
+      indent.writeln('$nativeType $name = nullptr;');
+      indent.writeln(
+        '${_getType(module, type, isOutput: true, primitive: true)} ${name}_value;',
+      );
       indent.writeScoped(
-        "void ${methodPrefix}_respond_error_$methodName(${respondErrorArgs.join(', ')}) {",
+        'if (fl_value_get_type($valueName) != FL_VALUE_TYPE_NULL) {',
         '}',
         () {
-          indent.writeln(
-            'g_autoptr($responseClassName) response = ${responseMethodPrefix}_new_error(code, message, details);',
-          );
-          indent.writeln('g_autoptr(GError) error = nullptr;');
-          indent.writeScoped(
-            'if (!fl_basic_message_channel_respond(response_handle->channel, response_handle->response_handle, response->value, &error)) {',
-            '}',
-            () {
-              indent.writeln(
-                'g_warning("Failed to send response to %s.%s: %s", "${api.name}", "${method.name}", error->message);',
-              );
-            },
-          );
+          indent.writeln('${name}_value = $value;');
+          indent.writeln('$name = &${name}_value;');
+        },
+      );
+    } else if (type.isNullable) {
+      indent.writeln('$nativeType $name = nullptr;');
+      if (hasLength) {
+        indent.writeln('size_t ${name}_length = 0;');
+      }
+      indent.writeScoped(
+        'if (fl_value_get_type($valueName) != FL_VALUE_TYPE_NULL) {',
+        '}',
+        () {
+          indent.writeln('$name = $value;');
+          if (hasLength) {
+            indent.writeln('${name}_length = fl_value_get_length($valueName);');
+          }
         },
       );
+    } else {
+      indent.writeln('$nativeType $name = $value;');
+      if (hasLength) {
+        indent.writeln(
+          'size_t ${name}_length = fl_value_get_length($valueName);',
+        );
+      }
+    }
+    return <String>[name, if (hasLength) '${name}_length'];
+  }
+
+  /// Returns an expression that creates a random FlValue holding a value of
+  /// [type], or null if [type] is nullable.
+  String _benchFlValueExpression(
+    Root root,
+    String module,
+    TypeDeclaration type,
+  ) {
+    final String value = _benchValueExpression(root, module, type);
+    return type.isNullable
+        ? 'random_present(rng, depth) ? $value : fl_value_new_null()'
+        : value;
+  }
+
+  /// Returns an expression that creates a random non-null FlValue holding a
+  /// value of [type].
+  String _benchValueExpression(Root root, String module, TypeDeclaration type) {
+    if (type.isClass) {
+      return '${_randomValueFunctionName(type.baseName)}(rng, depth + 1)';
+    } else if (type.isEnum) {
+      return '${_randomValueFunctionName(type.baseName)}(rng)';
+    }
+    switch (type.baseName) {
+      case 'bool':
+        return 'random_bool_value(rng)';
+      case 'int':
+        return 'random_int_value(rng)';
+      case 'double':
+        return 'random_double_value(rng)';
+      case 'String':
+        return 'random_string_value(rng)';
+      case 'Uint8List':
+        return 'random_uint8_list_value(rng)';
+      case 'Int32List':
+        return 'random_int32_list_value(rng)';
+      case 'Int64List':
+        return 'random_int64_list_value(rng)';
+      case 'Float32List':
+        return 'random_float32_list_value(rng)';
+      case 'Float64List':
+        return 'random_float_list_value(rng)';
+      case 'List':
+        final String element = type.typeArguments.isEmpty
+            ? 'random_fl_value'
+            : _benchElementFunction(root, module, type.typeArguments[0]);
+        return 'random_list_value(rng, depth, $element)';
+      case 'Map':
+        final String key = type.typeArguments.isEmpty
+            ? 'random_fl_value'
+            : _benchElementFunction(root, module, type.typeArguments[0]);
+        final String value = type.typeArguments.length < 2
+            ? 'random_fl_value'
+            : _benchElementFunction(root, module, type.typeArguments[1]);
+        return 'random_map_value(rng, depth, $key, $value)';
+      default:
+        return 'random_fl_value(rng, depth)';
     }
   }
+
+  /// Returns a function that creates random collection elements of [type].
+  String _benchElementFunction(Root root, String module, TypeDeclaration type) {
+    return '[](GRand* rng, int depth) { return ${_benchFlValueExpression(root, module, type)}; }';
+  }
+
+  String _randomValueFunctionName(String name) =>
+      'random_${_snakeCaseFromCamelCase(name)}_value';
+
+  String _benchFunctionPrefix(String apiName) =>
+      'bench_${_snakeCaseFromCamelCase(apiName)}';
 }
 
 // Returns the module name to use.
@@ -2248,6 +6685,11 @@ String _getEnumValue(String module, String enumName, String memberName) {
   return '${module}_${snakeEnumName}_$snakeMemberName'.toUpperCase();
 }
 
+// Returns the type [field] of a packed class has in its record.
+String _getPackedFieldType(String module, NamedType field) {
+  return field.type.baseName == 'bool' ? 'bool' : _getType(module, field.type);
+}
+
 // Returns code for storing a value of [type].
 String _getType(
   String module,
@@ -2317,12 +6759,19 @@ bool _isFlValueWrappedType(TypeDeclaration type) {
 }
 
 // Returns code to clear a value stored in [variableName], or null if no function required.
-String? _getClearFunction(TypeDeclaration type, String variableName) {
+String? _getClearFunction(
+  String module,
+  TypeDeclaration type,
+  String variableName, {
+  required bool boxedDataClasses,
+}) {
   if (type.isClass) {
-    return 'g_clear_object(&$variableName)';
+    return boxedDataClasses
+        ? 'g_clear_pointer(&$variableName, ${_getMethodPrefix(module, type.baseName)}_unref)'
+        : 'g_clear_object(&$variableName)';
   } else if (_isFlValueWrappedType(type)) {
     return 'g_clear_pointer(&$variableName, fl_value_unref)';
-  } else if (type.baseName == 'String') {
+  } else if (type.baseName == 'String' || _isNumericListType(type)) {
     return 'g_clear_pointer(&$variableName, g_free)';
   } else if (_isNullablePrimitiveType(type)) {
     return 'g_clear_pointer(&$variableName, g_free)';
@@ -2363,14 +6812,18 @@ String _getDefaultValue(
 
 // Returns code to copy the native data type stored in [variableName].
 //
-// [lengthVariableName] must be provided for the typed numeric *List types.
+// [lengthVariableName] must be provided for the typed numeric *List types,
+// which are copied with g_memdup2() so that they are released with g_free().
 String _referenceValue(
   String module,
   TypeDeclaration type,
   String variableName, {
   String? lengthVariableName,
+  required bool boxedDataClasses,
 }) {
-  if (type.isClass) {
+  if (type.isClass && boxedDataClasses) {
+    return '${_getMethodPrefix(module, type.baseName)}_ref($variableName)';
+  } else if (type.isClass) {
     final String castMacro = _getClassCastMacro(module, type.baseName);
     return '$castMacro(g_object_ref($variableName))';
   } else if (_isFlValueWrappedType(type)) {
@@ -2378,15 +6831,15 @@ String _referenceValue(
   } else if (type.baseName == 'String') {
     return 'g_strdup($variableName)';
   } else if (type.baseName == 'Uint8List') {
-    return 'static_cast<uint8_t*>(memcpy(malloc($lengthVariableName), $variableName, $lengthVariableName))';
+    return 'static_cast<uint8_t*>(g_memdup2($variableName, $lengthVariableName))';
   } else if (type.baseName == 'Int32List') {
-    return 'static_cast<int32_t*>(memcpy(malloc(sizeof(int32_t) * $lengthVariableName), $variableName, sizeof(int32_t) * $lengthVariableName))';
+    return 'static_cast<int32_t*>(g_memdup2($variableName, sizeof(int32_t) * $lengthVariableName))';
   } else if (type.baseName == 'Int64List') {
-    return 'static_cast<int64_t*>(memcpy(malloc(sizeof(int64_t) * $lengthVariableName), $variableName, sizeof(int64_t) * $lengthVariableName))';
+    return 'static_cast<int64_t*>(g_memdup2($variableName, sizeof(int64_t) * $lengthVariableName))';
   } else if (type.baseName == 'Float32List') {
-    return 'static_cast<float*>(memcpy(malloc(sizeof(float) * $lengthVariableName), $variableName, sizeof(float) * $lengthVariableName))';
+    return 'static_cast<float*>(g_memdup2($variableName, sizeof(float) * $lengthVariableName))';
   } else if (type.baseName == 'Float64List') {
-    return 'static_cast<double*>(memcpy(malloc(sizeof(double) * $lengthVariableName), $variableName, sizeof(double) * $lengthVariableName))';
+    return 'static_cast<double*>(g_memdup2($variableName, sizeof(double) * $lengthVariableName))';
   } else {
     return variableName;
   }
@@ -2416,6 +6869,7 @@ String _makeFlValue(
   TypeDeclaration type,
   String variableName, {
   String? lengthVariableName,
+  required bool boxedDataClasses,
 }) {
   final String value;
   if (type.isClass) {
@@ -2424,8 +6878,13 @@ String _makeFlValue(
       type,
       module,
     );
-    value =
-        'fl_value_new_custom_object($customTypeId, G_OBJECT($variableName))';
+    value = _newClassFlValue(
+      module,
+      type.baseName,
+      customTypeId,
+      variableName,
+      boxedDataClasses: boxedDataClasses,
+    );
   } else if (type.isEnum) {
     final String customTypeId = _getCustomTypeIdFromDeclaration(
       root,
@@ -2473,11 +6932,384 @@ String _makeFlValue(
   }
 }
 
+// Writes code that converts the FlValue stored in [valueName] into a local
+// variable for [field], and adds the matching constructor arguments to [args].
+//
+// The local is named after the field unless [localName] is given.
+void _writeFieldFromFlValue(
+  Indent indent,
+  String module,
+  NamedType field,
+  String valueName,
+  List<String> args, {
+  String? localName,
+  required bool boxedDataClasses,
+  required bool zeroCopyTypedLists,
+}) {
+  final String fieldName = localName ?? _getFieldName(field.name);
+  if (zeroCopyTypedLists && _isNumericListType(field.type)) {
+    args.add(fieldName);
+    if (field.type.isNullable) {
+      indent.writeln('FlValue* $fieldName = nullptr;');
+      indent.writeScoped(
+        'if (fl_value_get_type($valueName) != FL_VALUE_TYPE_NULL) {',
+        '}',
+        () {
+          indent.writeln('$fieldName = $valueName;');
+        },
+      );
+    } else {
+      indent.writeln('FlValue* $fieldName = $valueName;');
+    }
+    return;
+  }
+  final String fieldType = _getType(module, field.type);
+  final String fieldValue = _fromFlValue(
+    module,
+    field.type,
+    valueName,
+    boxedDataClasses: boxedDataClasses,
+  );
+  args.add(fieldName);
+  if (_isNullablePrimitiveType(field.type)) {
+    indent.writeln('$fieldType $fieldName = nullptr;');
+    indent.writeln(
+      '${_getType(module, field.type, isOutput: true, primitive: true)} ${fieldName}_value;',
+    );
+    indent.writeScoped(
+      'if (fl_value_get_type($valueName) != FL_VALUE_TYPE_NULL) {',
+      '}',
+      () {
+        indent.writeln('${fieldName}_value = $fieldValue;');
+        indent.writeln('$fieldName = &${fieldName}_value;');
+      },
+    );
+  } else if (field.type.isNullable) {
+    indent.writeln('$fieldType $fieldName = nullptr;');
+    if (_isNumericListType(field.type)) {
+      indent.writeln('size_t ${fieldName}_length = 0;');
+      args.add('${fieldName}_length');
+    }
+    indent.writeScoped(
+      'if (fl_value_get_type($valueName) != FL_VALUE_TYPE_NULL) {',
+      '}',
+      () {
+        indent.writeln('$fieldName = $fieldValue;');
+        if (_isNumericListType(field.type)) {
+          indent.writeln(
+            '${fieldName}_length = fl_value_get_length($valueName);',
+          );
+        }
+      },
+    );
+  } else {
+    indent.writeln('$fieldType $fieldName = $fieldValue;');
+    if (_isNumericListType(field.type)) {
+      indent.writeln(
+        'size_t ${fieldName}_length = fl_value_get_length($valueName);',
+      );
+      args.add('${fieldName}_length');
+    }
+  }
+}
+
+// Returns true if the generated source uses the shared codec instance. Host
+// APIs always do, while instrumented Flutter APIs use the per-channel
+// instances.
+bool _usesSharedCodec(InternalGObjectOptions generatorOptions, Root root) {
+  return root.apis.any((Api api) => api is AstHostApi) ||
+      (!generatorOptions.includeInstrumentation &&
+          root.apis.any((Api api) => api is AstFlutterApi));
+}
+
+// Returns true if [field] is a typed numeric list that is stored as the
+// FlValue holding its elements.
+bool _isRetainedListField(
+  InternalGObjectOptions generatorOptions,
+  NamedType field,
+) {
+  return generatorOptions.zeroCopyTypedLists && _isNumericListType(field.type);
+}
+
+// Returns true if [classDefinition] has any retained typed list fields.
+bool _hasRetainedListFields(
+  InternalGObjectOptions generatorOptions,
+  Class classDefinition,
+) {
+  return classDefinition.fields.any(
+    (NamedType field) => _isRetainedListField(generatorOptions, field),
+  );
+}
+
+// Returns code that creates a new FlValue for [field] of the data class
+// instance in [objectName].
+String _fieldFlValue(
+  Root root,
+  String module,
+  Class classDefinition,
+  NamedType field,
+  String objectName,
+  InternalGObjectOptions generatorOptions,
+) {
+  final String fieldName = _getFieldName(field.name);
+  final variableName = '$objectName->$fieldName';
+  if (_isInlineField(generatorOptions, field)) {
+    final String present = _inlineFieldPresent(
+      generatorOptions,
+      classDefinition,
+      field,
+      objectName,
+    );
+    final String value = _makeFlValue(
+      root,
+      module,
+      TypeDeclaration(
+        baseName: field.type.baseName,
+        isNullable: false,
+        associatedEnum: field.type.associatedEnum,
+      ),
+      variableName,
+      boxedDataClasses: generatorOptions.boxedDataClasses,
+    );
+    return '$present ? $value : fl_value_new_null()';
+  }
+  if (_isRetainedListField(generatorOptions, field)) {
+    return field.type.isNullable
+        ? '$variableName != nullptr ? fl_value_ref($variableName) : fl_value_new_null()'
+        : 'fl_value_ref($variableName)';
+  }
+  return _makeFlValue(
+    root,
+    module,
+    field.type,
+    variableName,
+    lengthVariableName: '${variableName}_length',
+    boxedDataClasses: generatorOptions.boxedDataClasses,
+  );
+}
+
+// Writes code that writes [field] of the data class instance in `value`
+// directly to the codec buffer.
+void _writeDirectFieldValue(
+  Root root,
+  Indent indent,
+  String module,
+  Class classDefinition,
+  NamedType field,
+  InternalGObjectOptions generatorOptions,
+) {
+  final String codecMethodPrefix = _getMethodPrefix(module, _codecBaseName);
+  final TypeDeclaration type = field.type;
+  final variableName = 'value->${_getFieldName(field.name)}';
+
+  String? present;
+  var valueName = variableName;
+  if (_isInlineField(generatorOptions, field)) {
+    present = _inlineFieldPresent(
+      generatorOptions,
+      classDefinition,
+      field,
+      'value',
+    );
+  } else if (type.isNullable) {
+    present = '$variableName != nullptr';
+    if (_isNullablePrimitiveType(type)) {
+      valueName = '*$variableName';
+    }
+  }
+
+  void writeValue() {
+    if (_isFlValueWrappedType(type) ||
+        _isRetainedListField(generatorOptions, field)) {
+      indent.writeScoped(
+        'if (!fl_standard_message_codec_write_value(codec, buffer, $valueName, error)) {',
+        '}',
+        () {
+          indent.writeln('return FALSE;');
+        },
+      );
+    } else if (type.isClass) {
+      final String snakeClassName = _snakeCaseFromCamelCase(
+        _getClassName(module, type.baseName),
+      );
+      indent.writeScoped(
+        'if (!${codecMethodPrefix}_write_$snakeClassName(codec, buffer, $valueName, error)) {',
+        '}',
+        () {
+          indent.writeln('return FALSE;');
+        },
+      );
+    } else if (type.baseName == 'bool') {
+      indent.writeln(
+        '${codecMethodPrefix}_write_type(buffer, $valueName ? 1 : 2);',
+      );
+    } else if (type.baseName == 'int') {
+      indent.writeln('${codecMethodPrefix}_write_int(buffer, $valueName);');
+    } else if (type.baseName == 'double') {
+      indent.writeln('${codecMethodPrefix}_write_double(buffer, $valueName);');
+    } else if (type.baseName == 'String') {
+      indent.writeln(
+        '${codecMethodPrefix}_write_string(codec, buffer, $valueName);',
+      );
+    } else if (_isNumericListType(type)) {
+      final (int listType, String elementType) = switch (type.baseName) {
+        'Uint8List' => (8, 'uint8_t'),
+        'Int32List' => (9, 'int32_t'),
+        'Int64List' => (10, 'int64_t'),
+        'Float32List' => (14, 'float'),
+        _ => (11, 'double'),
+      };
+      indent.writeln(
+        '${codecMethodPrefix}_write_typed_list(codec, buffer, $listType, $valueName, ${variableName}_length, sizeof($elementType));',
+      );
+    } else {
+      throw Exception('Unknown type ${type.baseName}');
+    }
+  }
+
+  if (present == null) {
+    writeValue();
+  } else {
+    indent.writeScoped('if ($present) {', '}', writeValue);
+    indent.writeScoped('else {', '}', () {
+      indent.writeln('${codecMethodPrefix}_write_type(buffer, 0);');
+    });
+  }
+}
+
+// Returns true if [field] is a nullable primitive stored inside the data class
+// instance.
+bool _isInlineField(InternalGObjectOptions generatorOptions, NamedType field) {
+  return generatorOptions.inlineNullablePrimitives &&
+      _isNullablePrimitiveType(field.type);
+}
+
+// Returns the bit in the present_ mask of [classDefinition] that records
+// whether the inline [field] is set.
+int _getInlineFieldIndex(
+  InternalGObjectOptions generatorOptions,
+  Class classDefinition,
+  NamedType field,
+) {
+  return classDefinition.fields
+      .where((NamedType other) => _isInlineField(generatorOptions, other))
+      .toList()
+      .indexOf(field);
+}
+
+// Returns code that checks if the inline [field] of the data class instance
+// in [objectName] is set.
+String _inlineFieldPresent(
+  InternalGObjectOptions generatorOptions,
+  Class classDefinition,
+  NamedType field,
+  String objectName,
+) {
+  final int index = _getInlineFieldIndex(
+    generatorOptions,
+    classDefinition,
+    field,
+  );
+  return '($objectName->present_[${index ~/ 32}] & (1u << ${index % 32})) != 0';
+}
+
+// Returns true if [field] is adopted rather than copied by the _new_take
+// constructor.
+bool _isTakenField(InternalGObjectOptions generatorOptions, NamedType field) {
+  final TypeDeclaration type = field.type;
+  return (type.isClass ||
+          _isFlValueWrappedType(type) ||
+          type.baseName == 'String' ||
+          _isNumericListType(type)) &&
+      !_isRetainedListField(generatorOptions, field);
+}
+
+// Returns true if [classDefinition] has any fields adopted by the _new_take
+// constructor.
+bool _hasTakeableFields(
+  InternalGObjectOptions generatorOptions,
+  Class classDefinition,
+) {
+  return classDefinition.fields.any(
+    (NamedType field) => _isTakenField(generatorOptions, field),
+  );
+}
+
+// Returns the arguments of the _new_take constructor of [classDefinition].
+List<String> _getTakeConstructorArgs(
+  String module,
+  InternalGObjectOptions generatorOptions,
+  Class classDefinition,
+) {
+  final args = <String>[];
+  for (final NamedType field in classDefinition.fields) {
+    final String fieldName = _getFieldName(field.name);
+    final bool taken = _isTakenField(generatorOptions, field);
+    args.add('${_getType(module, field.type, isOutput: taken)} $fieldName');
+    if (_isNumericListType(field.type)) {
+      args.add('size_t ${fieldName}_length');
+    }
+  }
+  return args;
+}
+
+// Returns true if the codec serializes [classDefinition] itself so that its
+// enum fields are written without boxing.
+bool _hasUnboxedEnumFields(
+  InternalGObjectOptions generatorOptions,
+  Class classDefinition,
+) {
+  return generatorOptions.unboxedEnums &&
+      !classDefinition.isCompact &&
+      classDefinition.fields.any((NamedType field) => field.type.isEnum);
+}
+
+// Returns code that wraps the data class instance [variableName] of class
+// [name] in a custom FlValue with [customTypeId].
+String _newClassFlValue(
+  String module,
+  String name,
+  String customTypeId,
+  String variableName, {
+  required bool boxedDataClasses,
+}) {
+  if (boxedDataClasses) {
+    final String methodPrefix = _getMethodPrefix(module, name);
+    return 'fl_value_new_custom($customTypeId, ${methodPrefix}_ref($variableName), (GDestroyNotify)${methodPrefix}_unref)';
+  }
+  return 'fl_value_new_custom_object($customTypeId, G_OBJECT($variableName))';
+}
+
+// Returns code that gets the instance of data class [name] held by the custom
+// FlValue in [variableName].
+String _classFromFlValue(
+  String module,
+  String name,
+  String variableName, {
+  required bool boxedDataClasses,
+}) {
+  if (boxedDataClasses) {
+    final String className = _getClassName(module, name);
+    return 'static_cast<$className*>(const_cast<gpointer>(fl_value_get_custom_value($variableName)))';
+  }
+  final String castMacro = _getClassCastMacro(module, name);
+  return '$castMacro(fl_value_get_custom_value_object($variableName))';
+}
+
 // Returns code to convert the FlValue stored in [variableName] to a native data type.
-String _fromFlValue(String module, TypeDeclaration type, String variableName) {
+String _fromFlValue(
+  String module,
+  TypeDeclaration type,
+  String variableName, {
+  required bool boxedDataClasses,
+}) {
   if (type.isClass) {
-    final String castMacro = _getClassCastMacro(module, type.baseName);
-    return '$castMacro(fl_value_get_custom_value_object($variableName))';
+    return _classFromFlValue(
+      module,
+      type.baseName,
+      variableName,
+      boxedDataClasses: boxedDataClasses,
+    );
   } else if (type.isEnum) {
     final String enumName = _getClassName(module, type.baseName);
     return 'static_cast<$enumName>(fl_value_get_int(reinterpret_cast<FlValue*>(const_cast<gpointer>(fl_value_get_custom_value($variableName)))))';
@@ -2512,3 +7344,35 @@ String _getResponseName(String name, String methodName) {
       methodName[0].toUpperCase() + methodName.substring(1);
   return '$name${upperMethodName}Response';
 }
+
+// Returns the name of the type returned by the host API method [methodName],
+// which is shared by all methods if [sharedHostApiResponses] is set.
+String _getHostApiResponseName(
+  String name,
+  String methodName, {
+  required bool sharedHostApiResponses,
+}) {
+  return sharedHostApiResponses
+      ? _sharedHostApiResponseName
+      : _getResponseName(name, methodName);
+}
+
+// Whether any host method may reply with a large blob in a memfd.
+bool _usesLargeBlobs(Root root) => root.apis.any(
+  (Api api) => api is AstHostApi && api.methods.any(isLargeBlobMethod),
+);
+
+// Returns the first host API in [root] with `@Chunked()` methods, which
+// declares the function that sends their replies.
+Api? _firstChunkedHostApi(Root root) => root.apis
+    .where((Api api) => api is AstHostApi && api.methods.any(isChunkedMethod))
+    .firstOrNull;
+
+// Returns true if [api] is the first host API in [root], which declares the
+// types shared by all host APIs.
+bool _isFirstHostApi(Root root, Api api) {
+  return identical(
+    root.apis.firstWhere((Api other) => other is AstHostApi),
+    api,
+  );
+}
@@ -177,6 +177,7 @@ class HostApi {
   const HostApi({
     @Deprecated('Mock/fake the generated Dart API instead.')
     this.dartHostTestHandler,
+    this.multiplexed = false,
   });
 
   /// The name of an interface generated for tests. Implement this
@@ -194,6 +195,16 @@ class HostApi {
   /// Defaults to `null` in which case no handler will be generated.
   @Deprecated('Mock/fake the generated Dart API instead.')
   final String? dartHostTestHandler;
+
+  /// Whether all methods of the API share a single message channel.
+  ///
+  /// Each message carries the index of the method being called, and the host
+  /// dispatches it through a generated table, so registering the API costs one
+  /// channel however many methods it has. Only supported by the Dart, C++ and
+  /// GObject generators.
+  ///
+  /// Defaults to `false`, in which case each method has its own channel.
+  final bool multiplexed;
 }
 
 /// Metadata to annotate a Golubets API implemented by Flutter.
@@ -302,6 +313,148 @@ class SwiftClass {
   const SwiftClass();
 }
 
+/// Metadata to annotate data classes to be encoded with the compact wire
+/// format.
+///
+/// Both sides know the layout of the class, so its fields are written in
+/// order without the type byte and size prefix the standard codec adds to
+/// each one:
+/// * a presence bitmap with one bit per nullable field, after which null
+///   fields are omitted,
+/// * `bool` as one byte,
+/// * `int` and enum indexes as zigzag varints,
+/// * `double` as 8 bytes aligned to 8,
+/// * `String` as a varint length followed by its UTF-8 bytes,
+/// * typed lists as a varint length followed by their aligned elements,
+/// * compact class fields inline, without a type byte.
+///
+/// Fields must be of one of these types. Channels of methods that use compact
+/// classes are named with a hash of their layouts, so code generated from
+/// different schemas fails to connect rather than misreading messages.
+///
+/// Only supported by the Dart, C++ and GObject generators.
+class Compact {
+  /// Constructor.
+  const Compact();
+}
+
+/// Metadata to annotate data classes that are encoded as a single fixed-layout
+/// record.
+///
+/// The fields are laid out like a C struct, in declaration order at their
+/// natural alignment, with `bool` as one byte and `int` and `double` as eight.
+/// The C++ and GObject generators copy the record to and from a struct whose
+/// layout is checked with `static_assert`, and lists whose elements are all
+/// of the class are written as one contiguous array of records.
+///
+/// Fields must be non-nullable `bool`, `int` or `double`, and the records are
+/// little-endian. Channels of methods that use packed classes are named with
+/// a hash of their layouts, like those of [Compact] classes.
+///
+/// Only supported by the Dart, C++ and GObject generators.
+class Packed {
+  /// Constructor.
+  const Packed();
+}
+
+/// Metadata to annotate data classes whose lists are sent as columns.
+///
+/// A `<Class>Columns` class is generated with a typed list per field of the
+/// class, `Float64List` for `double`, `Int64List` for `int` and `Uint8List`
+/// for `bool`, and non-nullable lists of the class in fields, parameters and
+/// return values are replaced with it. A list of rows is then sent as one
+/// typed list per field instead of one encoded object per row, and the hosts
+/// read the columns in place. The generated class has functions to convert
+/// from and to rows.
+///
+/// Fields must be non-nullable `bool`, `int` or `double`.
+class Columnar {
+  /// Constructor.
+  const Columnar();
+}
+
+/// Metadata to annotate data classes that the host streams to Dart through a
+/// ring buffer in shared memory instead of a message channel.
+///
+/// The C++ and GObject generators write a single-producer, single-consumer
+/// ring of [capacity] records with a `Push` function, and the Dart generator
+/// writes a `<Class>RingBuffer` that reads the records from the same memory
+/// through `dart:ffi`. Dart is only woken up when it has drained the ring, so
+/// a busy stream costs no messages at all.
+///
+/// Fields must be non-nullable `bool`, `int` or `double`. The Dart reader
+/// requires `NativeCallable.listener`, and can't be compiled for the web.
+class RingBuffer {
+  /// Constructor.
+  const RingBuffer({required this.capacity});
+
+  /// The number of records the ring holds, which must be a power of two.
+  final int capacity;
+}
+
+/// Metadata to annotate synchronous HostApi methods to be called through
+/// `dart:ffi` instead of a message channel.
+///
+/// The C++ and GObject generators export a C function for the method that
+/// calls the handler registered without a message channel suffix, and the
+/// Dart method calls it synchronously without encoding the arguments or the
+/// result. The handler therefore runs on the thread of the calling isolate
+/// rather than the platform thread, and bypasses instrumentation. The Dart
+/// method falls back to the message channel when the function is not
+/// exported, such as on other platforms, or when the API is created with a
+/// binary messenger or message channel suffix.
+///
+/// Arguments and return values must be non-nullable `bool`, `int` or
+/// `double`, and errors only carry their code and message. Generated Dart
+/// code that uses this annotation imports `dart:ffi`, so it can't be compiled
+/// for the web.
+class FfiSync {
+  /// Constructor.
+  const FfiSync();
+}
+
+/// Metadata to annotate host methods that return large `Uint8List` values.
+///
+/// When the value is at least [threshold] bytes, the GObject generator copies
+/// it into a sealed `memfd` and replies with its file descriptor instead of
+/// the bytes, and the Dart method maps the file read-only through `dart:ffi`.
+/// This skips the copies into the encoded message and through the engine, so
+/// a reply of hundreds of megabytes no longer needs several times its size in
+/// memory. The mapping is released when the `Uint8List` is garbage collected.
+///
+/// Other generators always reply with the bytes. Generated Dart code that
+/// uses this annotation imports `dart:ffi`, so it can't be compiled for the
+/// web. [threshold] must be an integer literal.
+class LargeBlob {
+  /// Constructor.
+  const LargeBlob({this.threshold = defaultLargeBlobThreshold});
+
+  /// The size in bytes from which the value is sent in a `memfd`.
+  final int threshold;
+}
+
+/// Metadata to annotate host methods with large replies, which the host sends
+/// in frames of at most [frameSize] encoded bytes.
+///
+/// The C++ and GObject generators send the encoded reply in numbered frames
+/// on a side channel named after the method channel with a `.chunks` suffix,
+/// followed by a reply holding the number of frames, and the Dart method
+/// reassembles them before decoding. The C++ host encodes straight into the
+/// frames, so the encoded reply never exists in one piece, while the GObject
+/// host sends one frame per main loop iteration so other messages aren't held
+/// up behind a large reply. Calls to the method from Dart wait for the reply
+/// to the previous call, since frames don't identify their call.
+///
+/// Other generators reply in one message, which the Dart method also accepts.
+/// Not supported on multiplexed APIs. [frameSize] must be an integer literal.
+class Chunked {
+  /// Constructor.
+  const Chunked({this.frameSize = defaultChunkFrameSize});
+
+  /// The largest number of encoded bytes in a frame.
+  final int frameSize;
+}
+
 /// Metadata annotation to control how handlers are dispatched for HostApi's.
 /// Note that the TaskQueue API might not be available on the target version of
 /// Flutter, see also:
@@ -333,9 +486,11 @@ class GolubetsOptions {
     this.cppHeaderOut,
     this.cppSourceOut,
     this.cppOptions,
+    this.cppBenchOut,
     this.gobjectHeaderOut,
     this.gobjectSourceOut,
     this.gobjectOptions,
+    this.gobjectBenchOut,
     this.dartOptions,
     this.copyrightHeader,
     this.astOut,
@@ -343,6 +498,7 @@ class GolubetsOptions {
     this.basePath,
     String? dartPackageName,
     this.ignoreLints = true,
+    this.typedNumericLists,
   }) : _dartPackageName = dartPackageName;
 
   /// Path to the file which will be processed.
@@ -391,6 +547,12 @@ class GolubetsOptions {
   /// Options that control how C++ will be generated.
   final CppOptions? cppOptions;
 
+  /// Path to the standalone C++ benchmark source (".cpp") that will be
+  /// generated.
+  ///
+  /// Requires [cppHeaderOut] and [cppSourceOut].
+  final String? cppBenchOut;
+
   /// Path to the ".h" GObject file that will be generated.
   final String? gobjectHeaderOut;
 
@@ -400,6 +562,12 @@ class GolubetsOptions {
   /// Options that control how GObject source will be generated.
   final GObjectOptions? gobjectOptions;
 
+  /// Path to the standalone GObject benchmark source (".cc") that will be
+  /// generated.
+  ///
+  /// Requires [gobjectHeaderOut] and [gobjectSourceOut].
+  final String? gobjectBenchOut;
+
   /// Options that control how Dart will be generated.
   final DartOptions? dartOptions;
 
@@ -421,6 +589,20 @@ class GolubetsOptions {
   /// Whether to ignore lint violations in generated Dart code.
   final bool ignoreLints;
 
+  /// Whether data class fields declared as `List<double>`, `List<int>` or
+  /// `List<bool>` are sent as a `Float64List`, `Int64List` or `Uint8List`
+  /// (one byte per bool).
+  ///
+  /// Dart keeps the declared `List` types, while the host languages use the
+  /// typed list types, so the lists are copied in one block on each side
+  /// instead of one value at a time. Fields with default values are not
+  /// changed.
+  ///
+  /// Only the Dart, C++ and GObject generators support this option. Bools
+  /// are not bit-packed, so that hosts can index them directly, as with the
+  /// bool columns of `@Columnar()` classes.
+  final bool? typedNumericLists;
+
   /// Creates a [GolubetsOptions] from a Map representation where:
   /// `x = GolubetsOptions.fromMap(x.toMap())`.
   static GolubetsOptions fromMap(Map<String, Object> map) {
@@ -450,6 +632,7 @@ class GolubetsOptions {
       cppOptions: map.containsKey('cppOptions')
           ? CppOptions.fromMap(map['cppOptions']! as Map<String, Object>)
           : null,
+      cppBenchOut: map['cppBenchOut'] as String?,
       gobjectHeaderOut: map['gobjectHeaderOut'] as String?,
       gobjectSourceOut: map['gobjectSourceOut'] as String?,
       gobjectOptions: map.containsKey('gobjectOptions')
@@ -457,6 +640,7 @@ class GolubetsOptions {
               map['gobjectOptions']! as Map<String, Object>,
             )
           : null,
+      gobjectBenchOut: map['gobjectBenchOut'] as String?,
       dartOptions: map.containsKey('dartOptions')
           ? DartOptions.fromMap(map['dartOptions']! as Map<String, Object>)
           : null,
@@ -465,6 +649,7 @@ class GolubetsOptions {
       debugGenerators: map['debugGenerators'] as bool?,
       basePath: map['basePath'] as String?,
       dartPackageName: map['dartPackageName'] as String?,
+      typedNumericLists: map['typedNumericLists'] as bool?,
     );
   }
 
@@ -487,15 +672,18 @@ class GolubetsOptions {
       if (cppHeaderOut != null) 'cppHeaderOut': cppHeaderOut!,
       if (cppSourceOut != null) 'cppSourceOut': cppSourceOut!,
       if (cppOptions != null) 'cppOptions': cppOptions!.toMap(),
+      if (cppBenchOut != null) 'cppBenchOut': cppBenchOut!,
       if (gobjectHeaderOut != null) 'gobjectHeaderOut': gobjectHeaderOut!,
       if (gobjectSourceOut != null) 'gobjectSourceOut': gobjectSourceOut!,
       if (gobjectOptions != null) 'gobjectOptions': gobjectOptions!.toMap(),
+      if (gobjectBenchOut != null) 'gobjectBenchOut': gobjectBenchOut!,
       if (dartOptions != null) 'dartOptions': dartOptions!.toMap(),
       if (copyrightHeader != null) 'copyrightHeader': copyrightHeader!,
       if (astOut != null) 'astOut': astOut!,
       if (debugGenerators != null) 'debugGenerators': debugGenerators!,
       if (basePath != null) 'basePath': basePath!,
       if (_dartPackageName != null) 'dartPackageName': _dartPackageName,
+      if (typedNumericLists != null) 'typedNumericLists': typedNumericLists!,
     };
     return result;
   }
@@ -647,6 +835,12 @@ ${_argParser.usage}''';
       'cpp_namespace',
       help: 'The namespace that generated C++ code will be in.',
     )
+    ..addOption(
+      'cpp_bench_out',
+      help:
+          'Path to a generated standalone C++ benchmark (.cpp) that measures '
+          'codec round trips and host API dispatch for the input schema.',
+    )
     ..addOption(
       'gobject_header_out',
       help: 'Path to generated GObject header file (.h).',
@@ -661,6 +855,13 @@ ${_argParser.usage}''';
       'gobject_module',
       help: 'The module that generated GObject code will be in.',
     )
+    ..addOption(
+      'gobject_bench_out',
+      help:
+          'Path to a generated standalone GObject benchmark (.cc) that '
+          'measures codec round trips and host API dispatch for the input '
+          'schema.',
+    )
     ..addOption(
       'objc_header_out',
       help: 'Path to generated Objective-C header file (.h).',
@@ -702,6 +903,11 @@ ${_argParser.usage}''';
       'ignore_lints',
       help: 'Ignore all lint violations in generated Dart code.',
       hide: true,
+    )
+    ..addFlag(
+      'typed_numeric_lists',
+      help:
+          'Send List<double>, List<int> and List<bool> data class fields as typed lists.',
     );
 
   /// Convert command-line arguments to [GolubetsOptions].
@@ -735,17 +941,20 @@ ${_argParser.usage}''';
       cppHeaderOut: results['cpp_header_out'] as String?,
       cppSourceOut: results['cpp_source_out'] as String?,
       cppOptions: CppOptions(namespace: results['cpp_namespace'] as String?),
+      cppBenchOut: results['cpp_bench_out'] as String?,
       gobjectHeaderOut: results['gobject_header_out'] as String?,
       gobjectSourceOut: results['gobject_source_out'] as String?,
       gobjectOptions: GObjectOptions(
         module: results['gobject_module'] as String?,
       ),
+      gobjectBenchOut: results['gobject_bench_out'] as String?,
       copyrightHeader: results['copyright_header'] as String?,
       astOut: results['ast_out'] as String?,
       debugGenerators: results['debug_generators'] as bool?,
       basePath: results['base_path'] as String?,
       dartPackageName: results['package_name'] as String?,
       ignoreLints: results.flag('ignore_lints'),
+      typedNumericLists: results['typed_numeric_lists'] as bool?,
     );
     return opts;
   }
@@ -806,7 +1015,9 @@ ${_argParser.usage}''';
           const SwiftGeneratorAdapter(),
           const KotlinGeneratorAdapter(),
           const CppGeneratorAdapter(),
+          const CppBenchmarkGeneratorAdapter(),
           const GObjectGeneratorAdapter(),
+          const GObjectBenchmarkGeneratorAdapter(),
           const DartTestGeneratorAdapter(),
           const ObjcGeneratorAdapter(),
           const AstGeneratorAdapter(),
@@ -840,6 +1051,10 @@ ${_argParser.usage}''';
     final InternalGolubetsOptions internalOptions =
         InternalGolubetsOptions.fromGolubetsOptions(options);
 
+    if (options.typedNumericLists ?? false) {
+      sendNumericListsAsTypedLists(parseResults.root);
+    }
+
     for (final adapter in safeGeneratorAdapters) {
       final IOSink? sink = adapter.shouldGenerate(
         internalOptions,
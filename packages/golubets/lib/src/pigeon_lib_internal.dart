@@ -42,6 +42,8 @@ class InternalGolubetsOptions {
     required this.dartOptions,
     this.copyrightHeader,
     this.astOut,
+    this.cppBenchOut,
+    this.gobjectBenchOut,
     this.debugGenerators,
     this.basePath,
     required this.dartPackageName,
@@ -95,6 +97,7 @@ class InternalGolubetsOptions {
               options.cppOptions ?? const CppOptions(),
               cppHeaderOut: options.cppHeaderOut!,
               cppSourceOut: options.cppSourceOut!,
+              cppBenchOut: options.cppBenchOut,
               copyrightHeader: copyrightHeader,
             ),
       gobjectOptions =
@@ -104,6 +107,7 @@ class InternalGolubetsOptions {
               options.gobjectOptions ?? const GObjectOptions(),
               gobjectHeaderOut: options.gobjectHeaderOut!,
               gobjectSourceOut: options.gobjectSourceOut!,
+              gobjectBenchOut: options.gobjectBenchOut,
               copyrightHeader: copyrightHeader,
             ),
       dartOptions =
@@ -123,6 +127,8 @@ class InternalGolubetsOptions {
             )
           : null,
       astOut = options.astOut,
+      cppBenchOut = options.cppBenchOut,
+      gobjectBenchOut = options.gobjectBenchOut,
       debugGenerators = options.debugGenerators,
       basePath = options.basePath,
       dartPackageName = options.getPackageName();
@@ -171,6 +177,15 @@ class InternalGolubetsOptions {
   /// Path to AST debugging output.
   final String? astOut;
 
+  /// Path to the C++ benchmark output, which is set even when [cppOptions] is
+  /// not so that a missing header or source output can be reported.
+  final String? cppBenchOut;
+
+  /// Path to the GObject benchmark output, which is set even when
+  /// [gobjectOptions] is not so that a missing header or source output can be
+  /// reported.
+  final String? gobjectBenchOut;
+
   /// True means print out line number of generators in comments at newlines.
   final bool? debugGenerators;
 
@@ -240,6 +255,66 @@ void _errorOnSealedClass(List<Error> errors, String generator, Root root) {
   }
 }
 
+void _errorOnMultiplexedHostApi(
+  List<Error> errors,
+  String generator,
+  Root root,
+) {
+  for (final Api api in root.apis.where(isMultiplexedApi)) {
+    errors.add(
+      Error(
+        message:
+            '$generator does not support multiplexed host APIs: ${api.name}',
+      ),
+    );
+  }
+}
+
+void _errorOnCompactClass(List<Error> errors, String generator, Root root) {
+  for (final Class classDefinition in root.classes.where(
+    (Class classDefinition) => classDefinition.isCompact,
+  )) {
+    errors.add(
+      Error(
+        message:
+            '$generator does not support compact classes: ${classDefinition.name}',
+      ),
+    );
+  }
+}
+
+void _errorOnPackedClass(List<Error> errors, String generator, Root root) {
+  for (final Class classDefinition in root.classes.where(
+    (Class classDefinition) => classDefinition.isPacked,
+  )) {
+    errors.add(
+      Error(
+        message:
+            '$generator does not support packed classes: ${classDefinition.name}',
+      ),
+    );
+  }
+}
+
+void _errorOnTypedNumericLists(
+  List<Error> errors,
+  String generator,
+  Root root,
+) {
+  for (final Class classDefinition in root.classes) {
+    for (final NamedType field in classDefinition.fields.where(
+      (NamedType field) => field.type.typedListOf != null,
+    )) {
+      errors.add(
+        Error(
+          message:
+              '$generator does not support typedNumericLists: ${classDefinition.name}.${field.name}',
+        ),
+      );
+    }
+  }
+}
+
 void _errorOnInheritedClass(List<Error> errors, String generator, Root root) {
   if (root.classes.any((Class element) => element.superClass != null)) {
     errors.add(
@@ -358,7 +433,16 @@ class DartTestGeneratorAdapter implements GeneratorAdapter {
   }
 
   @override
-  List<Error> validate(InternalGolubetsOptions options, Root root) => <Error>[];
+  List<Error> validate(InternalGolubetsOptions options, Root root) {
+    return <Error>[
+      for (final Api api in root.apis.where(isMultiplexedApi))
+        if ((api as AstHostApi).dartHostTestHandler != null)
+          Error(
+            message:
+                'dartHostTestHandler is not supported by multiplexed host APIs: ${api.name}',
+          ),
+    ];
+  }
 }
 
 /// A [GeneratorAdapter] that generates Objective-C code.
@@ -419,6 +503,10 @@ class ObjcGeneratorAdapter implements GeneratorAdapter {
     _errorOnEventChannelApi(errors, languageString, root);
     _errorOnSealedClass(errors, languageString, root);
     _errorOnInheritedClass(errors, languageString, root);
+    _errorOnMultiplexedHostApi(errors, languageString, root);
+    _errorOnCompactClass(errors, languageString, root);
+    _errorOnPackedClass(errors, languageString, root);
+    _errorOnTypedNumericLists(errors, languageString, root);
     return errors;
   }
 }
@@ -463,6 +551,10 @@ class JavaGeneratorAdapter implements GeneratorAdapter {
     _errorOnEventChannelApi(errors, languageString, root);
     _errorOnSealedClass(errors, languageString, root);
     _errorOnInheritedClass(errors, languageString, root);
+    _errorOnMultiplexedHostApi(errors, languageString, root);
+    _errorOnCompactClass(errors, languageString, root);
+    _errorOnPackedClass(errors, languageString, root);
+    _errorOnTypedNumericLists(errors, languageString, root);
     return errors;
   }
 }
@@ -566,6 +658,10 @@ class SwiftGeneratorAdapter implements GeneratorAdapter {
         }
       }
     }
+    _errorOnMultiplexedHostApi(result, languageString, root);
+    _errorOnCompactClass(result, languageString, root);
+    _errorOnPackedClass(result, languageString, root);
+    _errorOnTypedNumericLists(result, languageString, root);
 
     return result;
   }
@@ -629,6 +725,59 @@ class CppGeneratorAdapter implements GeneratorAdapter {
     _errorOnEventChannelApi(errors, languageString, root);
     _errorOnSealedClass(errors, languageString, root);
     _errorOnInheritedClass(errors, languageString, root);
+    final int? threshold = options.cppOptions?.parallelEncodeThreshold;
+    if (threshold != null && threshold < 1) {
+      errors.add(
+        Error(message: 'parallelEncodeThreshold must be at least 1.'),
+      );
+    }
+    return errors;
+  }
+}
+
+/// A [GeneratorAdapter] that generates a standalone C++ benchmark for the
+/// generated C++ codec and host APIs.
+class CppBenchmarkGeneratorAdapter implements GeneratorAdapter {
+  /// Constructor for [CppBenchmarkGeneratorAdapter].
+  const CppBenchmarkGeneratorAdapter();
+
+  @override
+  List<FileType> get fileTypeList => const <FileType>[FileType.na];
+
+  @override
+  void generate(
+    StringSink sink,
+    InternalGolubetsOptions options,
+    Root root,
+    FileType fileType,
+  ) {
+    if (options.cppOptions == null) {
+      return;
+    }
+    const generator = CppBenchmarkGenerator();
+    generator.generate(
+      options.cppOptions!,
+      root,
+      sink,
+      dartPackageName: options.dartPackageName,
+    );
+  }
+
+  @override
+  IOSink? shouldGenerate(InternalGolubetsOptions options, FileType _) =>
+      _openSink(options.cppBenchOut, basePath: options.basePath ?? '');
+
+  @override
+  List<Error> validate(InternalGolubetsOptions options, Root root) {
+    final errors = <Error>[];
+    if (options.cppBenchOut != null && options.cppOptions == null) {
+      errors.add(
+        Error(
+          message:
+              'cpp_bench_out requires both cpp_header_out and cpp_source_out.',
+        ),
+      );
+    }
     return errors;
   }
 }
@@ -706,6 +855,53 @@ class GObjectGeneratorAdapter implements GeneratorAdapter {
   }
 }
 
+/// A [GeneratorAdapter] that generates a standalone GObject benchmark for the
+/// generated GObject codec and host APIs.
+class GObjectBenchmarkGeneratorAdapter implements GeneratorAdapter {
+  /// Constructor for [GObjectBenchmarkGeneratorAdapter].
+  const GObjectBenchmarkGeneratorAdapter();
+
+  @override
+  List<FileType> get fileTypeList => const <FileType>[FileType.na];
+
+  @override
+  void generate(
+    StringSink sink,
+    InternalGolubetsOptions options,
+    Root root,
+    FileType fileType,
+  ) {
+    if (options.gobjectOptions == null) {
+      return;
+    }
+    const generator = GObjectBenchmarkGenerator();
+    generator.generate(
+      options.gobjectOptions!,
+      root,
+      sink,
+      dartPackageName: options.dartPackageName,
+    );
+  }
+
+  @override
+  IOSink? shouldGenerate(InternalGolubetsOptions options, FileType _) =>
+      _openSink(options.gobjectBenchOut, basePath: options.basePath ?? '');
+
+  @override
+  List<Error> validate(InternalGolubetsOptions options, Root root) {
+    final errors = <Error>[];
+    if (options.gobjectBenchOut != null && options.gobjectOptions == null) {
+      errors.add(
+        Error(
+          message:
+              'gobject_bench_out requires both gobject_header_out and gobject_source_out.',
+        ),
+      );
+    }
+    return errors;
+  }
+}
+
 /// A [GeneratorAdapter] that generates Kotlin source code.
 class KotlinGeneratorAdapter implements GeneratorAdapter {
   /// Constructor for [KotlinGeneratorAdapter].
@@ -741,7 +937,48 @@ class KotlinGeneratorAdapter implements GeneratorAdapter {
       );
 
   @override
-  List<Error> validate(InternalGolubetsOptions options, Root root) => <Error>[];
+  List<Error> validate(InternalGolubetsOptions options, Root root) {
+    final errors = <Error>[];
+    _errorOnMultiplexedHostApi(errors, 'Kotlin', root);
+    _errorOnCompactClass(errors, 'Kotlin', root);
+    _errorOnPackedClass(errors, 'Kotlin', root);
+    _errorOnTypedNumericLists(errors, 'Kotlin', root);
+    return errors;
+  }
+}
+
+/// Replaces the `List<double>`, `List<int>` and `List<bool>` fields of the
+/// data classes in [root] with the typed lists they are sent as, recording the
+/// declared element type in [TypeDeclaration.typedListOf].
+void sendNumericListsAsTypedLists(Root root) {
+  for (final Class classDefinition in root.classes) {
+    classDefinition.fields = classDefinition.fields.map((NamedType field) {
+      final TypeDeclaration type = field.type;
+      if (type.baseName != 'List' ||
+          type.typeArguments.length != 1 ||
+          type.typeArguments.first.isNullable ||
+          field.defaultValue != null) {
+        return field;
+      }
+      final String element = type.typeArguments.first.baseName;
+      final String? typedList = switch (element) {
+        'double' => 'Float64List',
+        'int' => 'Int64List',
+        'bool' => 'Uint8List',
+        _ => null,
+      };
+      if (typedList == null) {
+        return field;
+      }
+      return field.copyWithType(
+        TypeDeclaration(
+          baseName: typedList,
+          isNullable: type.isNullable,
+          typedListOf: element,
+        ),
+      );
+    }).toList();
+  }
 }
 
 dart_ast.Annotation? _findMetadata(
@@ -814,6 +1051,34 @@ List<Error> _validateAst(Root root, String source) {
         ),
       );
     }
+    final int? ringBufferCapacity = classDefinition.ringBufferCapacity;
+    if (ringBufferCapacity != null &&
+        (ringBufferCapacity <= 0 ||
+            (ringBufferCapacity & (ringBufferCapacity - 1)) != 0)) {
+      result.add(
+        Error(
+          message:
+              'Ring buffer capacity of class "${classDefinition.name}" must be a power of two.',
+        ),
+      );
+    }
+    if (classDefinition.isColumnar && classDefinition.fields.isEmpty) {
+      result.add(
+        Error(
+          message:
+              'Columnar class "${classDefinition.name}" must have fields.',
+        ),
+      );
+    }
+    if (classDefinition.isPacked &&
+        (classDefinition.isCompact || classDefinition.fields.isEmpty)) {
+      result.add(
+        Error(
+          message:
+              'Packed class "${classDefinition.name}" must have fields and must not be compact.',
+        ),
+      );
+    }
     for (final NamedType field in getFieldsInSerializationOrder(
       classDefinition,
     )) {
@@ -853,6 +1118,43 @@ List<Error> _validateAst(Root root, String source) {
           );
         }
       }
+      if (classDefinition.ringBufferCapacity != null &&
+          !isFfiSyncType(field.type)) {
+        result.add(
+          Error(
+            message:
+                'Ring buffer class "${classDefinition.name}" field "${field.name}" must be a non-nullable bool, int or double.',
+            lineNumber: _calculateLineNumberNullable(source, field.offset),
+          ),
+        );
+      }
+      if (classDefinition.isColumnar && !isFfiSyncType(field.type)) {
+        result.add(
+          Error(
+            message:
+                'Columnar class "${classDefinition.name}" field "${field.name}" must be a non-nullable bool, int or double.',
+            lineNumber: _calculateLineNumberNullable(source, field.offset),
+          ),
+        );
+      }
+      if (classDefinition.isPacked && !isFfiSyncType(field.type)) {
+        result.add(
+          Error(
+            message:
+                'Packed class "${classDefinition.name}" field "${field.name}" must be a non-nullable bool, int or double.',
+            lineNumber: _calculateLineNumberNullable(source, field.offset),
+          ),
+        );
+      }
+      if (classDefinition.isCompact && !isCompactFieldType(field.type)) {
+        result.add(
+          Error(
+            message:
+                'Compact class "${classDefinition.name}" field "${field.name}" must be a bool, int, double, String, enum, Uint8List, Int32List, Int64List, Float64List or compact class.',
+            lineNumber: _calculateLineNumberNullable(source, field.offset),
+          ),
+        );
+      }
       if (classDefinition.superClass != null) {
         if (!classDefinition.superClass!.isSealed) {
           result.add(
@@ -1005,6 +1307,56 @@ List<Error> _validateAst(Root root, String source) {
           ),
         );
       }
+      if (method.isFfiSync) {
+        if (api is! AstHostApi || method.isAsynchronous) {
+          result.add(
+            Error(
+              message:
+                  'FfiSync is only supported on synchronous HostApi methods, in method "${method.name}" in API: "${api.name}"',
+              lineNumber: _calculateLineNumberNullable(source, method.offset),
+            ),
+          );
+        }
+        if ((!method.returnType.isVoid &&
+                !isFfiSyncType(method.returnType)) ||
+            !method.parameters.every(
+              (Parameter param) => isFfiSyncType(param.type),
+            )) {
+          result.add(
+            Error(
+              message:
+                  'FfiSync method "${method.name}" in API: "${api.name}" must only take and return non-nullable bool, int or double.',
+              lineNumber: _calculateLineNumberNullable(source, method.offset),
+            ),
+          );
+        }
+      }
+      final int? largeBlobThreshold = method.largeBlobThreshold;
+      if (largeBlobThreshold != null) {
+        if (api is! AstHostApi ||
+            method.returnType.baseName != 'Uint8List' ||
+            largeBlobThreshold <= 0) {
+          result.add(
+            Error(
+              message:
+                  'LargeBlob is only supported on HostApi methods returning Uint8List with a positive threshold, in method "${method.name}" in API: "${api.name}"',
+              lineNumber: _calculateLineNumberNullable(source, method.offset),
+            ),
+          );
+        }
+      }
+      final int? chunkFrameSize = method.chunkFrameSize;
+      if (chunkFrameSize != null) {
+        if (api is! AstHostApi || api.multiplexed || chunkFrameSize <= 0) {
+          result.add(
+            Error(
+              message:
+                  'Chunked is only supported on HostApi methods of APIs that aren\'t multiplexed, with a positive frame size, in method "${method.name}" in API: "${api.name}"',
+              lineNumber: _calculateLineNumberNullable(source, method.offset),
+            ),
+          );
+        }
+      }
     }
   }
 
@@ -1361,6 +1713,7 @@ class RootBuilder extends dart_ast_visitor.RecursiveAstVisitor<Object?> {
   ParseResults results() {
     _storeCurrentApi();
     _storeCurrentClass();
+    _addColumnarClasses();
 
     final Map<TypeDeclaration, List<int>> referencedTypes = getReferencedTypes(
       _apis,
@@ -1492,6 +1845,96 @@ class RootBuilder extends dart_ast_visitor.RecursiveAstVisitor<Object?> {
     );
   }
 
+  /// Adds the `<Class>Columns` class of each `@Columnar()` class, and replaces
+  /// the non-nullable lists of those classes with it.
+  void _addColumnarClasses() {
+    final columnsNames = <String, String>{};
+    for (final Class row in _classes.toList()) {
+      if (!row.isColumnar) {
+        continue;
+      }
+      final columnsName = '${row.name}Columns';
+      if (_classes.any(
+        (Class classDefinition) => classDefinition.name == columnsName,
+      )) {
+        _errors.add(
+          Error(
+            message:
+                'Columnar class "${row.name}" conflicts with class "$columnsName".',
+          ),
+        );
+        continue;
+      }
+      columnsNames[row.name] = columnsName;
+      _classes.add(
+        Class(
+          name: columnsName,
+          columnsOf: row,
+          fields: row.fields
+              .where((NamedType field) => isFfiSyncType(field.type))
+              .map(
+                (NamedType field) => NamedType(
+                  name: field.name,
+                  type: TypeDeclaration(
+                    baseName: switch (field.type.baseName) {
+                      'bool' => 'Uint8List',
+                      'int' => 'Int64List',
+                      _ => 'Float64List',
+                    },
+                    isNullable: false,
+                  ),
+                  documentationComments: field.documentationComments,
+                ),
+              )
+              .toList(),
+          documentationComments: <String>[
+            ' The columns of a list of [${row.name}], with a typed list per field.',
+          ],
+        ),
+      );
+    }
+    if (columnsNames.isEmpty) {
+      return;
+    }
+
+    TypeDeclaration replace(TypeDeclaration type) {
+      if (type.baseName == 'List' &&
+          type.typeArguments.length == 1 &&
+          !type.typeArguments.first.isNullable) {
+        final String? columnsName =
+            columnsNames[type.typeArguments.first.baseName];
+        if (columnsName != null) {
+          return TypeDeclaration(
+            baseName: columnsName,
+            isNullable: type.isNullable,
+          );
+        }
+      }
+      return type.typeArguments.isEmpty
+          ? type
+          : type.copyWithTypeArguments(
+              type.typeArguments.map(replace).toList(),
+            );
+    }
+
+    for (final Class classDefinition in _classes) {
+      classDefinition.fields = classDefinition.fields
+          .map((NamedType field) => field.copyWithType(replace(field.type)))
+          .toList();
+    }
+    for (final Api api in _apis) {
+      for (final Method method in api.methods) {
+        method.parameters = method.parameters
+            .map(
+              (Parameter parameter) =>
+                  parameter.copyWithType(replace(parameter.type)),
+            )
+            .toList();
+        method.returnType = replace(method.returnType);
+      }
+    }
+  }
+
   TypeDeclaration _attachAssociatedDefinition(TypeDeclaration type) {
     final Enum? assocEnum = _enums.firstWhereOrNull(
       (Enum enumDefinition) => enumDefinition.name == type.baseName,
@@ -1671,6 +2114,7 @@ class RootBuilder extends dart_ast_visitor.RecursiveAstVisitor<Object?> {
           (dart_ast.Annotation element) => element.name.name == 'HostApi',
         );
         String? dartHostTestHandler;
+        var multiplexed = false;
         if (hostApi.arguments != null) {
           for (final dart_ast.Expression expression
               in hostApi.arguments!.arguments) {
@@ -1682,6 +2126,12 @@ class RootBuilder extends dart_ast_visitor.RecursiveAstVisitor<Object?> {
                     is dart_ast.SimpleStringLiteral) {
                   dartHostTestHandler = dartHostTestHandlerExpression.value;
                 }
+              } else if (expression.name.label.name == 'multiplexed') {
+                final dart_ast.Expression multiplexedExpression =
+                    expression.expression;
+                if (multiplexedExpression is dart_ast.BooleanLiteral) {
+                  multiplexed = multiplexedExpression.value;
+                }
               }
             }
           }
@@ -1691,6 +2141,7 @@ class RootBuilder extends dart_ast_visitor.RecursiveAstVisitor<Object?> {
           name: node.name.lexeme,
           methods: <Method>[],
           dartHostTestHandler: dartHostTestHandler,
+          multiplexed: multiplexed,
           documentationComments: _documentationCommentsParser(
             node.documentationComment?.tokens,
           ),
@@ -1875,6 +2326,13 @@ class RootBuilder extends dart_ast_visitor.RecursiveAstVisitor<Object?> {
             node.extendsClause?.superclass.name.toString(),
         isSealed: node.sealedKeyword != null,
         isSwiftClass: _hasMetadata(node.metadata, 'SwiftClass'),
+        isCompact: _hasMetadata(node.metadata, 'Compact'),
+        isPacked: _hasMetadata(node.metadata, 'Packed'),
+        isColumnar: _hasMetadata(node.metadata, 'Columnar'),
+        ringBufferCapacity: _parseIntegerAnnotation(
+          node.metadata,
+          'RingBuffer',
+        ),
         documentationComments: _documentationCommentsParser(
           node.documentationComment?.tokens,
         ),
@@ -2080,6 +2538,17 @@ class RootBuilder extends dart_ast_visitor.RecursiveAstVisitor<Object?> {
             swiftFunction: swiftFunction,
             offset: node.offset,
             taskQueueType: taskQueueType,
+            isFfiSync: _hasMetadata(node.metadata, 'FfiSync'),
+            largeBlobThreshold: _parseIntegerAnnotation(
+              node.metadata,
+              'LargeBlob',
+              defaultValue: defaultLargeBlobThreshold,
+            ),
+            chunkFrameSize: _parseIntegerAnnotation(
+              node.metadata,
+              'Chunked',
+              defaultValue: defaultChunkFrameSize,
+            ),
             documentationComments: _documentationCommentsParser(
               node.documentationComment?.tokens,
             ),
@@ -2407,6 +2876,30 @@ class RootBuilder extends dart_ast_visitor.RecursiveAstVisitor<Object?> {
     }
   }
 
+  // Returns the integer argument of the [annotation] in [metadata], or null
+  // if there is no such annotation. Returns [defaultValue] if the annotation
+  // has no arguments, or 0 if the argument isn't an integer literal.
+  int? _parseIntegerAnnotation(
+    dart_ast.NodeList<dart_ast.Annotation> metadata,
+    String annotation, {
+    int defaultValue = 0,
+  }) {
+    final dart_ast.ArgumentList? arguments = _findMetadata(
+      metadata,
+      annotation,
+    )?.arguments;
+    if (arguments == null) {
+      return null;
+    }
+    if (arguments.arguments.isEmpty) {
+      return defaultValue;
+    }
+    final dart_ast.Expression? value = _getFirstChildOfType<
+      dart_ast.NamedExpression
+    >(arguments)?.expression;
+    return value is dart_ast.IntegerLiteral ? value.value ?? 0 : 0;
+  }
+
   AsynchronousType _parseAsynchronousType(
     dart_ast.NodeList<dart_ast.Annotation> metadata,
   ) {
@@ -114,6 +114,10 @@ G_DEFINE_TYPE(CoreTestsGolubetsTestAllTypes, core_tests_golubets_test_all_types,
 static void core_tests_golubets_test_all_types_dispose(GObject* object) {
   CoreTestsGolubetsTestAllTypes* self =
       CORE_TESTS_GOLUBETS_TEST_ALL_TYPES(object);
+  g_clear_pointer(&self->a_byte_array, g_free);
+  g_clear_pointer(&self->a4_byte_array, g_free);
+  g_clear_pointer(&self->a8_byte_array, g_free);
+  g_clear_pointer(&self->a_float_array, g_free);
   g_clear_pointer(&self->a_string, g_free);
   g_clear_pointer(&self->an_object, fl_value_unref);
   g_clear_pointer(&self->list, fl_value_unref);
@@ -164,19 +168,16 @@ CoreTestsGolubetsTestAllTypes* core_tests_golubets_test_all_types_new(
   self->an_int64 = an_int64;
   self->a_double = a_double;
   self->a_byte_array = static_cast<uint8_t*>(
-      memcpy(malloc(a_byte_array_length), a_byte_array, a_byte_array_length));
+      g_memdup2(a_byte_array, a_byte_array_length));
   self->a_byte_array_length = a_byte_array_length;
   self->a4_byte_array = static_cast<int32_t*>(
-      memcpy(malloc(sizeof(int32_t) * a4_byte_array_length), a4_byte_array,
-             sizeof(int32_t) * a4_byte_array_length));
+      g_memdup2(a4_byte_array, sizeof(int32_t) * a4_byte_array_length));
   self->a4_byte_array_length = a4_byte_array_length;
   self->a8_byte_array = static_cast<int64_t*>(
-      memcpy(malloc(sizeof(int64_t) * a8_byte_array_length), a8_byte_array,
-             sizeof(int64_t) * a8_byte_array_length));
+      g_memdup2(a8_byte_array, sizeof(int64_t) * a8_byte_array_length));
   self->a8_byte_array_length = a8_byte_array_length;
   self->a_float_array = static_cast<double*>(
-      memcpy(malloc(sizeof(double) * a_float_array_length), a_float_array,
-             sizeof(double) * a_float_array_length));
+      g_memdup2(a_float_array, sizeof(double) * a_float_array_length));
   self->a_float_array_length = a_float_array_length;
   self->an_enum = an_enum;
   self->another_enum = another_enum;
@@ -552,6 +553,10 @@ static void core_tests_golubets_test_all_nullable_types_dispose(
   g_clear_pointer(&self->a_nullable_int, g_free);
   g_clear_pointer(&self->a_nullable_int64, g_free);
   g_clear_pointer(&self->a_nullable_double, g_free);
+  g_clear_pointer(&self->a_nullable_byte_array, g_free);
+  g_clear_pointer(&self->a_nullable4_byte_array, g_free);
+  g_clear_pointer(&self->a_nullable8_byte_array, g_free);
+  g_clear_pointer(&self->a_nullable_float_array, g_free);
   g_clear_pointer(&self->a_nullable_enum, g_free);
   g_clear_pointer(&self->another_nullable_enum, g_free);
   g_clear_pointer(&self->a_nullable_string, g_free);
@@ -635,8 +640,7 @@ core_tests_golubets_test_all_nullable_types_new(
   }
   if (a_nullable_byte_array != nullptr) {
     self->a_nullable_byte_array = static_cast<uint8_t*>(
-        memcpy(malloc(a_nullable_byte_array_length), a_nullable_byte_array,
-               a_nullable_byte_array_length));
+        g_memdup2(a_nullable_byte_array, a_nullable_byte_array_length));
     self->a_nullable_byte_array_length = a_nullable_byte_array_length;
   } else {
     self->a_nullable_byte_array = nullptr;
@@ -644,9 +648,8 @@ core_tests_golubets_test_all_nullable_types_new(
   }
   if (a_nullable4_byte_array != nullptr) {
     self->a_nullable4_byte_array = static_cast<int32_t*>(
-        memcpy(malloc(sizeof(int32_t) * a_nullable4_byte_array_length),
-               a_nullable4_byte_array,
-               sizeof(int32_t) * a_nullable4_byte_array_length));
+        g_memdup2(a_nullable4_byte_array,
+                  sizeof(int32_t) * a_nullable4_byte_array_length));
     self->a_nullable4_byte_array_length = a_nullable4_byte_array_length;
   } else {
     self->a_nullable4_byte_array = nullptr;
@@ -654,9 +657,8 @@ core_tests_golubets_test_all_nullable_types_new(
   }
   if (a_nullable8_byte_array != nullptr) {
     self->a_nullable8_byte_array = static_cast<int64_t*>(
-        memcpy(malloc(sizeof(int64_t) * a_nullable8_byte_array_length),
-               a_nullable8_byte_array,
-               sizeof(int64_t) * a_nullable8_byte_array_length));
+        g_memdup2(a_nullable8_byte_array,
+                  sizeof(int64_t) * a_nullable8_byte_array_length));
     self->a_nullable8_byte_array_length = a_nullable8_byte_array_length;
   } else {
     self->a_nullable8_byte_array = nullptr;
@@ -664,9 +666,8 @@ core_tests_golubets_test_all_nullable_types_new(
   }
   if (a_nullable_float_array != nullptr) {
     self->a_nullable_float_array = static_cast<double*>(
-        memcpy(malloc(sizeof(double) * a_nullable_float_array_length),
-               a_nullable_float_array,
-               sizeof(double) * a_nullable_float_array_length));
+        g_memdup2(a_nullable_float_array,
+                  sizeof(double) * a_nullable_float_array_length));
     self->a_nullable_float_array_length = a_nullable_float_array_length;
   } else {
     self->a_nullable_float_array = nullptr;
@@ -1387,6 +1388,10 @@ core_tests_golubets_test_all_nullable_types_without_recursion_dispose(
   g_clear_pointer(&self->a_nullable_int, g_free);
   g_clear_pointer(&self->a_nullable_int64, g_free);
   g_clear_pointer(&self->a_nullable_double, g_free);
+  g_clear_pointer(&self->a_nullable_byte_array, g_free);
+  g_clear_pointer(&self->a_nullable4_byte_array, g_free);
+  g_clear_pointer(&self->a_nullable8_byte_array, g_free);
+  g_clear_pointer(&self->a_nullable_float_array, g_free);
   g_clear_pointer(&self->a_nullable_enum, g_free);
   g_clear_pointer(&self->another_nullable_enum, g_free);
   g_clear_pointer(&self->a_nullable_string, g_free);
@@ -1468,8 +1473,7 @@ core_tests_golubets_test_all_nullable_types_without_recursion_new(
   }
   if (a_nullable_byte_array != nullptr) {
     self->a_nullable_byte_array = static_cast<uint8_t*>(
-        memcpy(malloc(a_nullable_byte_array_length), a_nullable_byte_array,
-               a_nullable_byte_array_length));
+        g_memdup2(a_nullable_byte_array, a_nullable_byte_array_length));
     self->a_nullable_byte_array_length = a_nullable_byte_array_length;
   } else {
     self->a_nullable_byte_array = nullptr;
@@ -1477,9 +1481,8 @@ core_tests_golubets_test_all_nullable_types_without_recursion_new(
   }
   if (a_nullable4_byte_array != nullptr) {
     self->a_nullable4_byte_array = static_cast<int32_t*>(
-        memcpy(malloc(sizeof(int32_t) * a_nullable4_byte_array_length),
-               a_nullable4_byte_array,
-               sizeof(int32_t) * a_nullable4_byte_array_length));
+        g_memdup2(a_nullable4_byte_array,
+                  sizeof(int32_t) * a_nullable4_byte_array_length));
     self->a_nullable4_byte_array_length = a_nullable4_byte_array_length;
   } else {
     self->a_nullable4_byte_array = nullptr;
@@ -1487,9 +1490,8 @@ core_tests_golubets_test_all_nullable_types_without_recursion_new(
   }
   if (a_nullable8_byte_array != nullptr) {
     self->a_nullable8_byte_array = static_cast<int64_t*>(
-        memcpy(malloc(sizeof(int64_t) * a_nullable8_byte_array_length),
-               a_nullable8_byte_array,
-               sizeof(int64_t) * a_nullable8_byte_array_length));
+        g_memdup2(a_nullable8_byte_array,
+                  sizeof(int64_t) * a_nullable8_byte_array_length));
     self->a_nullable8_byte_array_length = a_nullable8_byte_array_length;
   } else {
     self->a_nullable8_byte_array = nullptr;
@@ -1497,9 +1499,8 @@ core_tests_golubets_test_all_nullable_types_without_recursion_new(
   }
   if (a_nullable_float_array != nullptr) {
     self->a_nullable_float_array = static_cast<double*>(
-        memcpy(malloc(sizeof(double) * a_nullable_float_array_length),
-               a_nullable_float_array,
-               sizeof(double) * a_nullable_float_array_length));
+        g_memdup2(a_nullable_float_array,
+                  sizeof(double) * a_nullable_float_array_length));
     self->a_nullable_float_array_length = a_nullable_float_array_length;
   } else {
     self->a_nullable_float_array = nullptr;
@@ -3661,6 +3662,18 @@ core_tests_golubets_test_golub_message_codec_new() {
   return self;
 }
 
+static CoreTestsGolubetsTestGolubMessageCodec*
+core_tests_golubets_test_golub_message_codec_get_instance() {
+  static gsize instance = 0;
+  if (g_once_init_enter(&instance)) {
+    g_once_init_leave(
+        &instance,
+        GPOINTER_TO_SIZE(core_tests_golubets_test_golub_message_codec_new()));
+  }
+  return CORE_TESTS_GOLUBETS_TEST_GOLUB_MESSAGE_CODEC(
+      GSIZE_TO_POINTER(instance));
+}
+
 struct _CoreTestsGolubetsTestHostIntegrationCoreApiResponseHandle {
   GObject parent_instance;
 
@@ -19308,8 +19321,8 @@ void core_tests_golubets_test_host_integration_core_api_set_method_handlers(
       core_tests_golubets_test_host_integration_core_api_new(
           vtable, user_data, user_data_free_func);
 
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
+  CoreTestsGolubetsTestGolubMessageCodec* codec =
+      core_tests_golubets_test_golub_message_codec_get_instance();
   g_autofree gchar* noop_channel_name = g_strdup_printf(
       "dev.bayori.golubets.golubets_integration_tests.HostIntegrationCoreApi."
       "noop%s",
@@ -21284,8 +21297,8 @@ void core_tests_golubets_test_host_integration_core_api_clear_method_handlers(
   g_autofree gchar* dot_suffix =
       suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");
 
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
+  CoreTestsGolubetsTestGolubMessageCodec* codec =
+      core_tests_golubets_test_golub_message_codec_get_instance();
   g_autofree gchar* noop_channel_name = g_strdup_printf(
       "dev.bayori.golubets.golubets_integration_tests.HostIntegrationCoreApi."
       "noop%s",
@@ -26131,6 +26144,58 @@ struct _CoreTestsGolubetsTestFlutterIntegrationCoreApi {
 
   FlBinaryMessenger* messenger;
   gchar* suffix;
+  FlBasicMessageChannel* noop_channel;
+  FlBasicMessageChannel* throw_error_channel;
+  FlBasicMessageChannel* throw_error_from_void_channel;
+  FlBasicMessageChannel* echo_all_types_channel;
+  FlBasicMessageChannel* echo_all_nullable_types_channel;
+  FlBasicMessageChannel* send_multiple_nullable_types_channel;
+  FlBasicMessageChannel* echo_all_nullable_types_without_recursion_channel;
+  FlBasicMessageChannel* send_multiple_nullable_types_without_recursion_channel;
+  FlBasicMessageChannel* echo_bool_channel;
+  FlBasicMessageChannel* echo_int_channel;
+  FlBasicMessageChannel* echo_double_channel;
+  FlBasicMessageChannel* echo_string_channel;
+  FlBasicMessageChannel* echo_uint8_list_channel;
+  FlBasicMessageChannel* echo_list_channel;
+  FlBasicMessageChannel* echo_enum_list_channel;
+  FlBasicMessageChannel* echo_class_list_channel;
+  FlBasicMessageChannel* echo_non_null_enum_list_channel;
+  FlBasicMessageChannel* echo_non_null_class_list_channel;
+  FlBasicMessageChannel* echo_map_channel;
+  FlBasicMessageChannel* echo_string_map_channel;
+  FlBasicMessageChannel* echo_int_map_channel;
+  FlBasicMessageChannel* echo_enum_map_channel;
+  FlBasicMessageChannel* echo_class_map_channel;
+  FlBasicMessageChannel* echo_non_null_string_map_channel;
+  FlBasicMessageChannel* echo_non_null_int_map_channel;
+  FlBasicMessageChannel* echo_non_null_enum_map_channel;
+  FlBasicMessageChannel* echo_non_null_class_map_channel;
+  FlBasicMessageChannel* echo_enum_channel;
+  FlBasicMessageChannel* echo_another_enum_channel;
+  FlBasicMessageChannel* echo_nullable_bool_channel;
+  FlBasicMessageChannel* echo_nullable_int_channel;
+  FlBasicMessageChannel* echo_nullable_double_channel;
+  FlBasicMessageChannel* echo_nullable_string_channel;
+  FlBasicMessageChannel* echo_nullable_uint8_list_channel;
+  FlBasicMessageChannel* echo_nullable_list_channel;
+  FlBasicMessageChannel* echo_nullable_enum_list_channel;
+  FlBasicMessageChannel* echo_nullable_class_list_channel;
+  FlBasicMessageChannel* echo_nullable_non_null_enum_list_channel;
+  FlBasicMessageChannel* echo_nullable_non_null_class_list_channel;
+  FlBasicMessageChannel* echo_nullable_map_channel;
+  FlBasicMessageChannel* echo_nullable_string_map_channel;
+  FlBasicMessageChannel* echo_nullable_int_map_channel;
+  FlBasicMessageChannel* echo_nullable_enum_map_channel;
+  FlBasicMessageChannel* echo_nullable_class_map_channel;
+  FlBasicMessageChannel* echo_nullable_non_null_string_map_channel;
+  FlBasicMessageChannel* echo_nullable_non_null_int_map_channel;
+  FlBasicMessageChannel* echo_nullable_non_null_enum_map_channel;
+  FlBasicMessageChannel* echo_nullable_non_null_class_map_channel;
+  FlBasicMessageChannel* echo_nullable_enum_channel;
+  FlBasicMessageChannel* echo_another_nullable_enum_channel;
+  FlBasicMessageChannel* noop_async_channel;
+  FlBasicMessageChannel* echo_async_string_channel;
 };
 
 G_DEFINE_TYPE(CoreTestsGolubetsTestFlutterIntegrationCoreApi,
@@ -26143,6 +26208,58 @@ static void core_tests_golubets_test_flutter_integration_core_api_dispose(
       CORE_TESTS_GOLUBETS_TEST_FLUTTER_INTEGRATION_CORE_API(object);
   g_clear_object(&self->messenger);
   g_clear_pointer(&self->suffix, g_free);
+  g_clear_object(&self->noop_channel);
+  g_clear_object(&self->throw_error_channel);
+  g_clear_object(&self->throw_error_from_void_channel);
+  g_clear_object(&self->echo_all_types_channel);
+  g_clear_object(&self->echo_all_nullable_types_channel);
+  g_clear_object(&self->send_multiple_nullable_types_channel);
+  g_clear_object(&self->echo_all_nullable_types_without_recursion_channel);
+  g_clear_object(&self->send_multiple_nullable_types_without_recursion_channel);
+  g_clear_object(&self->echo_bool_channel);
+  g_clear_object(&self->echo_int_channel);
+  g_clear_object(&self->echo_double_channel);
+  g_clear_object(&self->echo_string_channel);
+  g_clear_object(&self->echo_uint8_list_channel);
+  g_clear_object(&self->echo_list_channel);
+  g_clear_object(&self->echo_enum_list_channel);
+  g_clear_object(&self->echo_class_list_channel);
+  g_clear_object(&self->echo_non_null_enum_list_channel);
+  g_clear_object(&self->echo_non_null_class_list_channel);
+  g_clear_object(&self->echo_map_channel);
+  g_clear_object(&self->echo_string_map_channel);
+  g_clear_object(&self->echo_int_map_channel);
+  g_clear_object(&self->echo_enum_map_channel);
+  g_clear_object(&self->echo_class_map_channel);
+  g_clear_object(&self->echo_non_null_string_map_channel);
+  g_clear_object(&self->echo_non_null_int_map_channel);
+  g_clear_object(&self->echo_non_null_enum_map_channel);
+  g_clear_object(&self->echo_non_null_class_map_channel);
+  g_clear_object(&self->echo_enum_channel);
+  g_clear_object(&self->echo_another_enum_channel);
+  g_clear_object(&self->echo_nullable_bool_channel);
+  g_clear_object(&self->echo_nullable_int_channel);
+  g_clear_object(&self->echo_nullable_double_channel);
+  g_clear_object(&self->echo_nullable_string_channel);
+  g_clear_object(&self->echo_nullable_uint8_list_channel);
+  g_clear_object(&self->echo_nullable_list_channel);
+  g_clear_object(&self->echo_nullable_enum_list_channel);
+  g_clear_object(&self->echo_nullable_class_list_channel);
+  g_clear_object(&self->echo_nullable_non_null_enum_list_channel);
+  g_clear_object(&self->echo_nullable_non_null_class_list_channel);
+  g_clear_object(&self->echo_nullable_map_channel);
+  g_clear_object(&self->echo_nullable_string_map_channel);
+  g_clear_object(&self->echo_nullable_int_map_channel);
+  g_clear_object(&self->echo_nullable_enum_map_channel);
+  g_clear_object(&self->echo_nullable_class_map_channel);
+  g_clear_object(&self->echo_nullable_non_null_string_map_channel);
+  g_clear_object(&self->echo_nullable_non_null_int_map_channel);
+  g_clear_object(&self->echo_nullable_non_null_enum_map_channel);
+  g_clear_object(&self->echo_nullable_non_null_class_map_channel);
+  g_clear_object(&self->echo_nullable_enum_channel);
+  g_clear_object(&self->echo_another_nullable_enum_channel);
+  g_clear_object(&self->noop_async_channel);
+  g_clear_object(&self->echo_async_string_channel);
   G_OBJECT_CLASS(
       core_tests_golubets_test_flutter_integration_core_api_parent_class)
       ->dispose(object);
@@ -26277,18 +26394,19 @@ void core_tests_golubets_test_flutter_integration_core_api_noop(
     GCancellable* cancellable, GAsyncReadyCallback callback,
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.noop%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->noop_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.noop%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->noop_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->noop_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_noop_cb, task);
 }
 
@@ -26298,10 +26416,8 @@ core_tests_golubets_test_flutter_integration_core_api_noop_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->noop_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -26440,18 +26556,19 @@ void core_tests_golubets_test_flutter_integration_core_api_throw_error(
     GCancellable* cancellable, GAsyncReadyCallback callback,
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.throwError%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->throw_error_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.throwError%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->throw_error_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->throw_error_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_throw_error_cb,
       task);
 }
@@ -26462,10 +26579,8 @@ core_tests_golubets_test_flutter_integration_core_api_throw_error_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->throw_error_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -26589,18 +26704,19 @@ void core_tests_golubets_test_flutter_integration_core_api_throw_error_from_void
     GCancellable* cancellable, GAsyncReadyCallback callback,
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.throwErrorFromVoid%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->throw_error_from_void_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.throwErrorFromVoid%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->throw_error_from_void_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->throw_error_from_void_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_throw_error_from_void_cb,
       task);
 }
@@ -26611,10 +26727,8 @@ core_tests_golubets_test_flutter_integration_core_api_throw_error_from_void_fini
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->throw_error_from_void_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -26754,18 +26868,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_all_types(
   fl_value_append_take(args, fl_value_new_custom_object(
                                  core_tests_golubets_test_all_types_type_id,
                                  G_OBJECT(everything)));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoAllTypes%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_all_types_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoAllTypes%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_all_types_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_all_types_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_all_types_cb,
       task);
 }
@@ -26776,10 +26891,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_all_types_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_all_types_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -26933,18 +27046,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_all_nullable_typ
                       core_tests_golubets_test_all_nullable_types_type_id,
                       G_OBJECT(everything))
                 : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoAllNullableTypes%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_all_nullable_types_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoAllNullableTypes%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_all_nullable_types_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_all_nullable_types_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_all_nullable_types_cb,
       task);
 }
@@ -26955,10 +27069,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_all_nullable_types_fi
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_all_nullable_types_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -27113,18 +27225,19 @@ void core_tests_golubets_test_flutter_integration_core_api_send_multiple_nullabl
   fl_value_append_take(args, a_nullable_string != nullptr
                                  ? fl_value_new_string(a_nullable_string)
                                  : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.sendMultipleNullableTypes%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->send_multiple_nullable_types_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.sendMultipleNullableTypes%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->send_multiple_nullable_types_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->send_multiple_nullable_types_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_send_multiple_nullable_types_cb,
       task);
 }
@@ -27135,10 +27248,8 @@ core_tests_golubets_test_flutter_integration_core_api_send_multiple_nullable_typ
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->send_multiple_nullable_types_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -27294,18 +27405,21 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_all_nullable_typ
                 core_tests_golubets_test_all_nullable_types_without_recursion_type_id,
                 G_OBJECT(everything))
           : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoAllNullableTypesWithoutRecursion%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_all_nullable_types_without_recursion_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoAllNullableTypesWithoutRecursion%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_all_nullable_types_without_recursion_channel =
+        fl_basic_message_channel_new(self->messenger, channel_name,
+                                     FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_all_nullable_types_without_recursion_channel, args,
+      cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_all_nullable_types_without_recursion_cb,
       task);
 }
@@ -27316,10 +27430,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_all_nullable_types_wi
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_all_nullable_types_without_recursion_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -27474,18 +27586,21 @@ void core_tests_golubets_test_flutter_integration_core_api_send_multiple_nullabl
   fl_value_append_take(args, a_nullable_string != nullptr
                                  ? fl_value_new_string(a_nullable_string)
                                  : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.sendMultipleNullableTypesWithoutRecursion%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->send_multiple_nullable_types_without_recursion_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.sendMultipleNullableTypesWithoutRecursion%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->send_multiple_nullable_types_without_recursion_channel =
+        fl_basic_message_channel_new(self->messenger, channel_name,
+                                     FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->send_multiple_nullable_types_without_recursion_channel, args,
+      cancellable,
       core_tests_golubets_test_flutter_integration_core_api_send_multiple_nullable_types_without_recursion_cb,
       task);
 }
@@ -27496,10 +27611,8 @@ core_tests_golubets_test_flutter_integration_core_api_send_multiple_nullable_typ
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->send_multiple_nullable_types_without_recursion_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -27635,18 +27748,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_bool(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_new_bool(a_bool));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoBool%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_bool_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoBool%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_bool_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_bool_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_bool_cb, task);
 }
 
@@ -27656,10 +27770,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_bool_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->echo_bool_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -27794,18 +27906,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_int(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_new_int(an_int));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoInt%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_int_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoInt%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_int_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_int_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_int_cb, task);
 }
 
@@ -27815,10 +27928,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_int_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->echo_int_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -27955,18 +28066,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_double(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_new_float(a_double));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoDouble%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_double_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoDouble%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_double_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_double_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_double_cb,
       task);
 }
@@ -27977,10 +28089,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_double_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->echo_double_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -28117,18 +28227,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_string(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_new_string(a_string));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoString%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_string_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoString%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_string_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_string_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_string_cb,
       task);
 }
@@ -28139,10 +28250,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_string_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->echo_string_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -28284,18 +28393,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_uint8_list(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_new_uint8_list(list, list_length));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoUint8List%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_uint8_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoUint8List%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_uint8_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_uint8_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_uint8_list_cb,
       task);
 }
@@ -28306,10 +28416,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_uint8_list_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_uint8_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -28445,18 +28553,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_list(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(list));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_list_cb, task);
 }
 
@@ -28466,10 +28575,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_list_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->echo_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -28606,18 +28713,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_enum_list(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(enum_list));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoEnumList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_enum_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoEnumList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_enum_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_enum_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_enum_list_cb,
       task);
 }
@@ -28628,10 +28736,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_enum_list_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_enum_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -28769,18 +28875,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_class_list(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(class_list));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoClassList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_class_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoClassList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_class_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_class_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_class_list_cb,
       task);
 }
@@ -28791,10 +28898,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_class_list_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_class_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -28938,18 +29043,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_non_null_enum_li
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(enum_list));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNonNullEnumList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_non_null_enum_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNonNullEnumList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_non_null_enum_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_non_null_enum_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_non_null_enum_list_cb,
       task);
 }
@@ -28960,10 +29066,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_non_null_enum_list_fi
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_non_null_enum_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -29107,18 +29211,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_non_null_class_l
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(class_list));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNonNullClassList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_non_null_class_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNonNullClassList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_non_null_class_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_non_null_class_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_non_null_class_list_cb,
       task);
 }
@@ -29129,10 +29234,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_non_null_class_list_f
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_non_null_class_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -29267,18 +29370,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_map(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_map_cb, task);
 }
 
@@ -29288,10 +29392,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_map_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->echo_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -29429,18 +29531,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_string_map(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(string_map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoStringMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_string_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoStringMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_string_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_string_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_string_map_cb,
       task);
 }
@@ -29451,10 +29554,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_string_map_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_string_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -29591,18 +29692,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_int_map(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(int_map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoIntMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_int_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoIntMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_int_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_int_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_int_map_cb,
       task);
 }
@@ -29613,10 +29715,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_int_map_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_int_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -29753,18 +29853,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_enum_map(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(enum_map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoEnumMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_enum_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoEnumMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_enum_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_enum_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_enum_map_cb,
       task);
 }
@@ -29775,10 +29876,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_enum_map_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_enum_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -29915,18 +30014,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_class_map(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(class_map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoClassMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_class_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoClassMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_class_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_class_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_class_map_cb,
       task);
 }
@@ -29937,10 +30037,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_class_map_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_class_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -30084,18 +30182,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_non_null_string_
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(string_map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNonNullStringMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_non_null_string_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNonNullStringMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_non_null_string_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_non_null_string_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_non_null_string_map_cb,
       task);
 }
@@ -30106,10 +30205,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_non_null_string_map_f
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_non_null_string_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -30253,18 +30350,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_non_null_int_map
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(int_map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNonNullIntMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_non_null_int_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNonNullIntMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_non_null_int_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_non_null_int_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_non_null_int_map_cb,
       task);
 }
@@ -30275,10 +30373,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_non_null_int_map_fini
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_non_null_int_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -30422,18 +30518,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_non_null_enum_ma
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(enum_map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNonNullEnumMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_non_null_enum_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNonNullEnumMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_non_null_enum_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_non_null_enum_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_non_null_enum_map_cb,
       task);
 }
@@ -30444,10 +30541,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_non_null_enum_map_fin
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_non_null_enum_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -30591,18 +30686,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_non_null_class_m
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_ref(class_map));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNonNullClassMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_non_null_class_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNonNullClassMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_non_null_class_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_non_null_class_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_non_null_class_map_cb,
       task);
 }
@@ -30613,10 +30709,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_non_null_class_map_fi
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_non_null_class_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -30757,18 +30851,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_enum(
       args, fl_value_new_custom(core_tests_golubets_test_an_enum_type_id,
                                 fl_value_new_int(an_enum),
                                 (GDestroyNotify)fl_value_unref));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoEnum%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_enum_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoEnum%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_enum_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_enum_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_enum_cb, task);
 }
 
@@ -30778,10 +30873,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_enum_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->echo_enum_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -30929,18 +31022,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_another_enum(
       args, fl_value_new_custom(core_tests_golubets_test_another_enum_type_id,
                                 fl_value_new_int(another_enum),
                                 (GDestroyNotify)fl_value_unref));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoAnotherEnum%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_another_enum_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoAnotherEnum%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_another_enum_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_another_enum_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_another_enum_cb,
       task);
 }
@@ -30951,10 +31045,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_another_enum_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_another_enum_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -31103,18 +31195,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_bool(
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, a_bool != nullptr ? fl_value_new_bool(*a_bool)
                                                : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableBool%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_bool_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableBool%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_bool_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_bool_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_bool_cb,
       task);
 }
@@ -31125,10 +31218,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_bool_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_bool_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -31277,18 +31368,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_int(
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, an_int != nullptr ? fl_value_new_int(*an_int)
                                                : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableInt%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_int_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableInt%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_int_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_int_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_int_cb,
       task);
 }
@@ -31299,10 +31391,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_int_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_int_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -31452,18 +31542,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_double(
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, a_double != nullptr ? fl_value_new_float(*a_double)
                                                  : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableDouble%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_double_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableDouble%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_double_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_double_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_double_cb,
       task);
 }
@@ -31474,10 +31565,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_double_finis
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_double_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -31625,18 +31714,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_string(
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, a_string != nullptr ? fl_value_new_string(a_string)
                                                  : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableString%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_string_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableString%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_string_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_string_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_string_cb,
       task);
 }
@@ -31647,10 +31737,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_string_finis
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_string_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -31803,18 +31891,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_uint8_l
   fl_value_append_take(args, list != nullptr
                                  ? fl_value_new_uint8_list(list, list_length)
                                  : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableUint8List%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_uint8_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableUint8List%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_uint8_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_uint8_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_uint8_list_cb,
       task);
 }
@@ -31825,10 +31914,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_uint8_list_f
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_uint8_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -31975,18 +32062,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_list(
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(
       args, list != nullptr ? fl_value_ref(list) : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_list_cb,
       task);
 }
@@ -31997,10 +32085,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_list_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -32148,18 +32234,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum_li
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, enum_list != nullptr ? fl_value_ref(enum_list)
                                                   : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableEnumList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_enum_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableEnumList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_enum_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_enum_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum_list_cb,
       task);
 }
@@ -32170,10 +32257,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum_list_fi
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_enum_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -32321,18 +32406,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_class_l
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, class_list != nullptr ? fl_value_ref(class_list)
                                                    : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableClassList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_class_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableClassList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_class_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_class_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_class_list_cb,
       task);
 }
@@ -32343,10 +32429,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_class_list_f
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_class_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -32495,18 +32579,20 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_nul
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, enum_list != nullptr ? fl_value_ref(enum_list)
                                                   : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableNonNullEnumList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_non_null_enum_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableNonNullEnumList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_non_null_enum_list_channel =
+        fl_basic_message_channel_new(self->messenger, channel_name,
+                                     FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_non_null_enum_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_enum_list_cb,
       task);
 }
@@ -32517,10 +32603,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_enu
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_non_null_enum_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -32669,18 +32753,20 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_nul
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, class_list != nullptr ? fl_value_ref(class_list)
                                                    : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableNonNullClassList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_non_null_class_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableNonNullClassList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_non_null_class_list_channel =
+        fl_basic_message_channel_new(self->messenger, channel_name,
+                                     FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_non_null_class_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_class_list_cb,
       task);
 }
@@ -32691,10 +32777,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_cla
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_non_null_class_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -32841,18 +32925,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_map(
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(
       args, map != nullptr ? fl_value_ref(map) : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_map_cb,
       task);
 }
@@ -32863,10 +32948,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_map_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -33014,18 +33097,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_string_
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, string_map != nullptr ? fl_value_ref(string_map)
                                                    : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableStringMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_string_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableStringMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_string_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_string_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_string_map_cb,
       task);
 }
@@ -33036,10 +33120,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_string_map_f
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_string_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -33187,18 +33269,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_int_map
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(
       args, int_map != nullptr ? fl_value_ref(int_map) : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableIntMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_int_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableIntMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_int_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_int_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_int_map_cb,
       task);
 }
@@ -33209,10 +33292,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_int_map_fini
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_int_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -33360,18 +33441,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum_ma
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(
       args, enum_map != nullptr ? fl_value_ref(enum_map) : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableEnumMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_enum_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableEnumMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_enum_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_enum_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum_map_cb,
       task);
 }
@@ -33382,10 +33464,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum_map_fin
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_enum_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -33533,18 +33613,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_class_m
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, class_map != nullptr ? fl_value_ref(class_map)
                                                   : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableClassMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_class_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableClassMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_class_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_class_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_class_map_cb,
       task);
 }
@@ -33555,10 +33636,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_class_map_fi
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_class_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -33707,18 +33786,20 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_nul
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, string_map != nullptr ? fl_value_ref(string_map)
                                                    : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableNonNullStringMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_non_null_string_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableNonNullStringMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_non_null_string_map_channel =
+        fl_basic_message_channel_new(self->messenger, channel_name,
+                                     FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_non_null_string_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_string_map_cb,
       task);
 }
@@ -33729,10 +33810,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_str
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_non_null_string_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -33881,18 +33960,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_nul
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(
       args, int_map != nullptr ? fl_value_ref(int_map) : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableNonNullIntMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_non_null_int_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableNonNullIntMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_non_null_int_map_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_non_null_int_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_int_map_cb,
       task);
 }
@@ -33903,10 +33983,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_int
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_non_null_int_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -34055,18 +34133,20 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_nul
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(
       args, enum_map != nullptr ? fl_value_ref(enum_map) : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableNonNullEnumMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_non_null_enum_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableNonNullEnumMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_non_null_enum_map_channel =
+        fl_basic_message_channel_new(self->messenger, channel_name,
+                                     FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_non_null_enum_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_enum_map_cb,
       task);
 }
@@ -34077,10 +34157,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_enu
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_non_null_enum_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -34229,18 +34307,20 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_nul
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, class_map != nullptr ? fl_value_ref(class_map)
                                                   : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableNonNullClassMap%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_non_null_class_map_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableNonNullClassMap%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_non_null_class_map_channel =
+        fl_basic_message_channel_new(self->messenger, channel_name,
+                                     FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_non_null_class_map_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_class_map_cb,
       task);
 }
@@ -34251,10 +34331,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_non_null_cla
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_non_null_class_map_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -34409,18 +34487,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum(
                                       fl_value_new_int(*an_enum),
                                       (GDestroyNotify)fl_value_unref)
                 : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoNullableEnum%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_nullable_enum_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoNullableEnum%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_nullable_enum_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_nullable_enum_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum_cb,
       task);
 }
@@ -34431,10 +34510,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_nullable_enum_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_nullable_enum_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -34592,18 +34669,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_another_nullable
                                 fl_value_new_int(*another_enum),
                                 (GDestroyNotify)fl_value_unref)
           : fl_value_new_null());
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoAnotherNullableEnum%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_another_nullable_enum_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoAnotherNullableEnum%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_another_nullable_enum_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_another_nullable_enum_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_another_nullable_enum_cb,
       task);
 }
@@ -34614,10 +34692,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_another_nullable_enum
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_another_nullable_enum_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -34734,18 +34810,19 @@ void core_tests_golubets_test_flutter_integration_core_api_noop_async(
     GCancellable* cancellable, GAsyncReadyCallback callback,
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.noopAsync%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->noop_async_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.noopAsync%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->noop_async_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->noop_async_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_noop_async_cb,
       task);
 }
@@ -34756,10 +34833,8 @@ core_tests_golubets_test_flutter_integration_core_api_noop_async_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->noop_async_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -34902,18 +34977,19 @@ void core_tests_golubets_test_flutter_integration_core_api_echo_async_string(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_new_string(a_string));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests."
-      "FlutterIntegrationCoreApi.echoAsyncString%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_async_string_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests."
+        "FlutterIntegrationCoreApi.echoAsyncString%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_async_string_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_async_string_channel, args, cancellable,
       core_tests_golubets_test_flutter_integration_core_api_echo_async_string_cb,
       task);
 }
@@ -34924,10 +35000,8 @@ core_tests_golubets_test_flutter_integration_core_api_echo_async_string_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_async_string_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -35070,8 +35144,8 @@ void core_tests_golubets_test_host_trivial_api_set_method_handlers(
       core_tests_golubets_test_host_trivial_api_new(vtable, user_data,
                                                     user_data_free_func);
 
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
+  CoreTestsGolubetsTestGolubMessageCodec* codec =
+      core_tests_golubets_test_golub_message_codec_get_instance();
   g_autofree gchar* noop_channel_name = g_strdup_printf(
       "dev.bayori.golubets.golubets_integration_tests.HostTrivialApi.noop%s",
       dot_suffix);
@@ -35087,8 +35161,8 @@ void core_tests_golubets_test_host_trivial_api_clear_method_handlers(
   g_autofree gchar* dot_suffix =
       suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");
 
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
+  CoreTestsGolubetsTestGolubMessageCodec* codec =
+      core_tests_golubets_test_golub_message_codec_get_instance();
   g_autofree gchar* noop_channel_name = g_strdup_printf(
       "dev.bayori.golubets.golubets_integration_tests.HostTrivialApi.noop%s",
       dot_suffix);
@@ -35355,8 +35429,8 @@ void core_tests_golubets_test_host_small_api_set_method_handlers(
       core_tests_golubets_test_host_small_api_new(vtable, user_data,
                                                   user_data_free_func);
 
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
+  CoreTestsGolubetsTestGolubMessageCodec* codec =
+      core_tests_golubets_test_golub_message_codec_get_instance();
   g_autofree gchar* echo_channel_name = g_strdup_printf(
       "dev.bayori.golubets.golubets_integration_tests.HostSmallApi.echo%s",
       dot_suffix);
@@ -35381,8 +35455,8 @@ void core_tests_golubets_test_host_small_api_clear_method_handlers(
   g_autofree gchar* dot_suffix =
       suffix != nullptr ? g_strdup_printf(".%s", suffix) : g_strdup("");
 
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
+  CoreTestsGolubetsTestGolubMessageCodec* codec =
+      core_tests_golubets_test_golub_message_codec_get_instance();
   g_autofree gchar* echo_channel_name = g_strdup_printf(
       "dev.bayori.golubets.golubets_integration_tests.HostSmallApi.echo%s",
       dot_suffix);
@@ -35462,6 +35536,8 @@ struct _CoreTestsGolubetsTestFlutterSmallApi {
 
   FlBinaryMessenger* messenger;
   gchar* suffix;
+  FlBasicMessageChannel* echo_wrapped_list_channel;
+  FlBasicMessageChannel* echo_string_channel;
 };
 
 G_DEFINE_TYPE(CoreTestsGolubetsTestFlutterSmallApi,
@@ -35473,6 +35549,8 @@ static void core_tests_golubets_test_flutter_small_api_dispose(
       CORE_TESTS_GOLUBETS_TEST_FLUTTER_SMALL_API(object);
   g_clear_object(&self->messenger);
   g_clear_pointer(&self->suffix, g_free);
+  g_clear_object(&self->echo_wrapped_list_channel);
+  g_clear_object(&self->echo_string_channel);
   G_OBJECT_CLASS(core_tests_golubets_test_flutter_small_api_parent_class)
       ->dispose(object);
 }
@@ -35628,18 +35706,19 @@ void core_tests_golubets_test_flutter_small_api_echo_wrapped_list(
   fl_value_append_take(
       args, fl_value_new_custom_object(
                 core_tests_golubets_test_test_message_type_id, G_OBJECT(msg)));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests.FlutterSmallApi."
-      "echoWrappedList%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_wrapped_list_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests.FlutterSmallApi."
+        "echoWrappedList%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_wrapped_list_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_wrapped_list_channel, args, cancellable,
       core_tests_golubets_test_flutter_small_api_echo_wrapped_list_cb, task);
 }
 
@@ -35649,10 +35728,8 @@ core_tests_golubets_test_flutter_small_api_echo_wrapped_list_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
-  g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+  g_autoptr(FlValue) response = fl_basic_message_channel_send_finish(
+      self->echo_wrapped_list_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -35779,18 +35856,19 @@ void core_tests_golubets_test_flutter_small_api_echo_string(
     gpointer user_data) {
   g_autoptr(FlValue) args = fl_value_new_list();
   fl_value_append_take(args, fl_value_new_string(a_string));
-  g_autofree gchar* channel_name = g_strdup_printf(
-      "dev.bayori.golubets.golubets_integration_tests.FlutterSmallApi."
-      "echoString%s",
-      self->suffix);
-  g_autoptr(CoreTestsGolubetsTestGolubMessageCodec) codec =
-      core_tests_golubets_test_golub_message_codec_new();
-  FlBasicMessageChannel* channel = fl_basic_message_channel_new(
-      self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  if (self->echo_string_channel == nullptr) {
+    g_autofree gchar* channel_name = g_strdup_printf(
+        "dev.bayori.golubets.golubets_integration_tests.FlutterSmallApi."
+        "echoString%s",
+        self->suffix);
+    CoreTestsGolubetsTestGolubMessageCodec* codec =
+        core_tests_golubets_test_golub_message_codec_get_instance();
+    self->echo_string_channel = fl_basic_message_channel_new(
+        self->messenger, channel_name, FL_MESSAGE_CODEC(codec));
+  }
   GTask* task = g_task_new(self, cancellable, callback, user_data);
-  g_task_set_task_data(task, channel, g_object_unref);
   fl_basic_message_channel_send(
-      channel, args, cancellable,
+      self->echo_string_channel, args, cancellable,
       core_tests_golubets_test_flutter_small_api_echo_string_cb, task);
 }
 
@@ -35800,10 +35878,8 @@ core_tests_golubets_test_flutter_small_api_echo_string_finish(
     GError** error) {
   g_autoptr(GTask) task = G_TASK(result);
   GAsyncResult* r = G_ASYNC_RESULT(g_task_propagate_pointer(task, nullptr));
-  FlBasicMessageChannel* channel =
-      FL_BASIC_MESSAGE_CHANNEL(g_task_get_task_data(task));
   g_autoptr(FlValue) response =
-      fl_basic_message_channel_send_finish(channel, r, error);
+      fl_basic_message_channel_send_finish(self->echo_string_channel, r, error);
   if (response == nullptr) {
     return nullptr;
   }
@@ -2614,4 +2614,1426 @@ void main() {
     );
     expect(code, contains('channel.Send'));
   });
+  test('benchmark exercises classes and host methods', () {
+    final dataClass = Class(
+      name: 'Data',
+      fields: <NamedType>[
+        NamedType(
+          name: 'count',
+          type: const TypeDeclaration(baseName: 'int', isNullable: false),
+        ),
+        NamedType(
+          name: 'label',
+          type: const TypeDeclaration(baseName: 'String', isNullable: true),
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'echo',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(
+                  name: 'data',
+                  type: TypeDeclaration(
+                    baseName: 'Data',
+                    isNullable: false,
+                    associatedClass: dataClass,
+                  ),
+                ),
+              ],
+              returnType: TypeDeclaration(
+                baseName: 'Data',
+                isNullable: true,
+                associatedClass: dataClass,
+              ),
+            ),
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              asynchronousType: AsynchronousType.callback,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[dataClass],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const CppBenchmarkGenerator().generate(
+      const InternalCppOptions(
+        cppHeaderOut: '',
+        cppSourceOut: '',
+        headerIncludePath: 'messages.g.h',
+        namespace: 'foo',
+      ),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('#include "messages.g.h"'));
+    expect(code, contains('Data RandomData(BenchRandom& rng, int depth) {'));
+    expect(code, contains('return Data(count, label ? &*label : nullptr);'));
+    expect(code, contains('class BenchApi : public Api {'));
+    expect(
+      code,
+      contains(
+        'ErrorOr<std::optional<Data>> Echo(const Data& data) override {',
+      ),
+    );
+    expect(code, contains('result(std::nullopt);'));
+    expect(
+      code,
+      contains('"dev.bayori.golubets.$DEFAULT_PACKAGE_NAME.Api.echo"'),
+    );
+    expect(code, contains('RunRoundTripBenchmark("Data"'));
+    expect(code, contains('foo::RunAllBenchmarks('));
+    expect(code, contains('#include <cstdint>'));
+    expect(
+      code,
+      contains('EncodableValue RandomEncodableValue(BenchRandom& rng) {'),
+    );
+    expect(
+      code,
+      contains(
+        '[&reply_size](const uint8_t*, size_t size) { reply_size = size; });',
+      ),
+    );
+    expect(
+      code,
+      contains('rng, [](BenchRandom&, int) { return EncodableValue(); });'),
+    );
+  });
+
+  test('instrumentation hooks are opt-in', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'HostApi',
+          methods: <Method>[
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+        AstFlutterApi(
+          name: 'FlutterApi',
+          methods: <Method>[
+            Method(
+              name: 'pong',
+              location: ApiLocation.flutter,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType, {required bool includeInstrumentation}) {
+      final sink = StringBuffer();
+      const generator = CppGenerator();
+      final generatorOptions = OutputFileOptions<InternalCppOptions>(
+        fileType: fileType,
+        languageOptions: InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+          includeInstrumentation: includeInstrumentation,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(
+      FileType.header,
+      includeInstrumentation: true,
+    );
+    expect(header, contains('class GolubetsInstrumentation {'));
+    expect(
+      header,
+      contains(
+        'void SetGolubetsInstrumentation(GolubetsInstrumentation* instrumentation);',
+      ),
+    );
+    expect(header, contains('bool DumpTrace(const std::string& path);'));
+
+    final String source = generate(
+      FileType.source,
+      includeInstrumentation: true,
+    );
+    expect(
+      source,
+      contains(
+        'class InstrumentedBinaryMessenger : public flutter::BinaryMessenger {',
+      ),
+    );
+    expect(
+      source,
+      contains(
+        'InstrumentedBinaryMessenger instrumented_messenger(binary_messenger);',
+      ),
+    );
+    expect(source, contains('NotifyHandlerStart(channel_name);'));
+    expect(source, contains('NotifyDecodeStart(channel_name, reply_size);'));
+    expect(source, contains('#ifdef GOLUBETS_ENABLE_TRACE'));
+    expect(
+      source,
+      contains(
+        'const int64_t handler_start = NotifyHandlerStart(channel_name);',
+      ),
+    );
+    expect(source, contains('NotifyHandlerEnd(channel_name, handler_start);'));
+    expect(source, contains('bool DumpTrace(const std::string& path) {'));
+    expect(
+      source,
+      contains(
+        'event.sequence.store(2 * index + 2, std::memory_order_release);',
+      ),
+    );
+    expect(
+      source,
+      contains(
+        'if (event.sequence.load(std::memory_order_relaxed) != sequence) {',
+      ),
+    );
+    expect(source, isNot(contains('buffer.mutex')));
+
+    expect(
+      generate(FileType.header, includeInstrumentation: false),
+      isNot(contains('Instrumentation')),
+    );
+    expect(
+      generate(FileType.source, includeInstrumentation: false),
+      isNot(contains('Instrument')),
+    );
+  });
+
+  test('multiplexed host api registers a single channel', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          multiplexed: true,
+          methods: <Method>[
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+            Method(
+              name: 'echo',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(
+                  type: const TypeDeclaration(
+                    baseName: 'int',
+                    isNullable: false,
+                  ),
+                  name: 'value',
+                ),
+              ],
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = CppGenerator();
+    final generatorOptions = OutputFileOptions<InternalCppOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalCppOptions(
+        cppHeaderOut: '',
+        cppSourceOut: '',
+        headerIncludePath: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains(
+        '"dev.bayori.golubets.$DEFAULT_PACKAGE_NAME.Api" + prepended_suffix',
+      ),
+    );
+    expect(code, isNot(contains('.Api.ping')));
+    expect(code, contains('static const MethodHandler method_handlers[] = {'));
+    expect(
+      code,
+      contains('const int64_t method_index = args->at(0).LongValue();'),
+    );
+    expect(code, contains('const auto& encodable_value_arg = args.at(1);'));
+    expect(
+      code,
+      contains('method_handlers[method_index](api, *args, reply);'),
+    );
+  });
+
+  test('multiplexed host api rejects malformed method indices', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          multiplexed: true,
+          methods: <Method>[
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+            Method(
+              name: 'pong',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = CppGenerator();
+    final generatorOptions = OutputFileOptions<InternalCppOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalCppOptions(
+        cppHeaderOut: '',
+        cppSourceOut: '',
+        headerIncludePath: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, isNot(contains('std::get<EncodableList>(message)')));
+    final int tryIndex = code.indexOf(
+      'try {\n'
+      '          const auto* args = std::get_if<EncodableList>(&message);',
+    );
+    expect(tryIndex, greaterThanOrEqualTo(0));
+    final int emptyCheck = code.indexOf(
+      'if (args == nullptr || args->empty()) {',
+    );
+    final int rangeCheck = code.indexOf(
+      'if (method_index < 0 || method_index >= 2) {\n'
+      '            reply(WrapError("Unknown method index " + '
+      'std::to_string(method_index) + " for Api."));\n'
+      '            return;',
+    );
+    final int dispatch = code.indexOf(
+      'method_handlers[method_index](api, *args, reply);',
+    );
+    expect(emptyCheck, greaterThan(tryIndex));
+    expect(rangeCheck, greaterThan(emptyCheck));
+    expect(dispatch, greaterThan(rangeCheck));
+    expect(
+      code.indexOf('catch (const std::exception& exception)', dispatch),
+      greaterThan(dispatch),
+    );
+  });
+
+  test('unboxed enums are written directly by the serializer', () {
+    final anEnum = Enum(
+      name: 'AnEnum',
+      members: <EnumMember>[
+        EnumMember(name: 'one'),
+        EnumMember(name: 'two'),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Input',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'String', isNullable: false),
+              name: 'name',
+            ),
+            NamedType(
+              type: TypeDeclaration(
+                baseName: anEnum.name,
+                isNullable: false,
+                associatedEnum: anEnum,
+              ),
+              name: 'code',
+            ),
+            NamedType(
+              type: TypeDeclaration(
+                baseName: anEnum.name,
+                isNullable: true,
+                associatedEnum: anEnum,
+              ),
+              name: 'optionalCode',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[anEnum],
+    );
+    String generate({required bool unboxedEnums}) {
+      final sink = StringBuffer();
+      const generator = CppGenerator();
+      final generatorOptions = OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.source,
+        languageOptions: InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+          unboxedEnums: unboxedEnums,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String code = generate(unboxedEnums: true);
+    expect(
+      code,
+      contains(
+        'const auto& object = std::any_cast<const Input&>(*custom_value);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'WriteValue(EncodableValue(static_cast<int>(object.code_)), stream);',
+      ),
+    );
+    expect(code, contains('if (object.optional_code_) {'));
+    expect(
+      code,
+      contains(
+        'const auto decoded_code = static_cast<AnEnum>(ReadValue(stream).LongValue());',
+      ),
+    );
+    expect(code, contains('std::optional<AnEnum> decoded_optional_code;'));
+    expect(code, contains('decoded.optional_code_ = decoded_optional_code;'));
+    expect(code, contains('return CustomEncodableValue(decoded);'));
+
+    final String boxedCode = generate(unboxedEnums: false);
+    expect(boxedCode, isNot(contains('decoded_code')));
+    expect(
+      boxedCode,
+      contains(
+        'WriteValue(EncodableValue(std::any_cast<Input>(*custom_value).ToEncodableList()), stream);',
+      ),
+    );
+  });
+
+  test('unboxed enums are sent as indexes by host methods', () {
+    final anEnum = Enum(
+      name: 'AnEnum',
+      members: <EnumMember>[
+        EnumMember(name: 'one'),
+        EnumMember(name: 'two'),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'echo',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(
+                  type: TypeDeclaration(
+                    baseName: anEnum.name,
+                    isNullable: false,
+                    associatedEnum: anEnum,
+                  ),
+                  name: 'value',
+                ),
+                Parameter(
+                  type: TypeDeclaration(
+                    baseName: anEnum.name,
+                    isNullable: true,
+                    associatedEnum: anEnum,
+                  ),
+                  name: 'other',
+                ),
+              ],
+              returnType: TypeDeclaration(
+                baseName: anEnum.name,
+                isNullable: false,
+                associatedEnum: anEnum,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[anEnum],
+    );
+    String generate(FileType fileType, {required bool unboxedEnums}) {
+      final sink = StringBuffer();
+      const generator = CppGenerator();
+      final generatorOptions = OutputFileOptions<InternalCppOptions>(
+        fileType: fileType,
+        languageOptions: InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+          unboxedEnums: unboxedEnums,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(FileType.header, unboxedEnums: true);
+    expect(header, contains('flutter::EncodableValue ReadArguments('));
+    expect(header, contains('void WriteResult('));
+
+    final String code = generate(FileType.source, unboxedEnums: true);
+    expect(code, contains('class UnboxedEnumCodec'));
+    expect(code, contains('class BufferStreamReader'));
+    expect(
+      code,
+      contains(
+        'static const UnboxedEnumCodec unboxed_enum_codec({129, 129}, 129);',
+      ),
+    );
+    expect(code, contains('prepended_suffix, &unboxed_enum_codec);'));
+    expect(
+      code,
+      contains(
+        'const AnEnum value_arg = static_cast<AnEnum>(encodable_value_arg.LongValue());',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'other_arg_value = static_cast<AnEnum>(encodable_other_arg.LongValue());',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'wrapped.push_back(EncodableValue(static_cast<int>(std::move(output).TakeValue())));',
+      ),
+    );
+
+    final String boxedCode = generate(FileType.source, unboxedEnums: false);
+    expect(boxedCode, isNot(contains('UnboxedEnumCodec')));
+    expect(boxedCode, isNot(contains('ReadArguments')));
+    expect(
+      boxedCode,
+      contains(
+        'wrapped.push_back(CustomEncodableValue(std::move(output).TakeValue()));',
+      ),
+    );
+  });
+
+  test('compact classes are serialized without lists', () {
+    final point = Class(
+      name: 'Point',
+      isCompact: true,
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'int', isNullable: false),
+          name: 'x',
+        ),
+        NamedType(
+          type: const TypeDeclaration(baseName: 'double', isNullable: true),
+          name: 'y',
+        ),
+        NamedType(
+          type: const TypeDeclaration(
+            baseName: 'Int32List',
+            isNullable: false,
+          ),
+          name: 'samples',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[point],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType, {bool encodedSizes = false}) {
+      final sink = StringBuffer();
+      const generator = CppGenerator();
+      final generatorOptions = OutputFileOptions<InternalCppOptions>(
+        fileType: fileType,
+        languageOptions: InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+          encodedSizes: encodedSizes,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(FileType.header);
+    expect(
+      header,
+      contains('static Point ReadCompact(flutter::ByteStreamReader* stream);'),
+    );
+    expect(
+      header,
+      contains('void WriteCompact(flutter::ByteStreamWriter* stream) const;'),
+    );
+    final String code = generate(FileType.source);
+    expect(code, contains('stream->WriteByte((y_ ? 1 : 0));'));
+    expect(code, contains('WriteCompactVarint(x_, stream);'));
+    expect(code, contains('WriteCompactList(samples_, stream);'));
+    expect(code, contains('stream->ReadAlignment(8);'));
+    expect(
+      code,
+      contains('return CustomEncodableValue(Point::ReadCompact(stream));'),
+    );
+    expect(
+      code,
+      contains(
+        'std::any_cast<const Point&>(*custom_value).WriteCompact(stream);',
+      ),
+    );
+    expect(code, isNot(contains('CompactVarintSize')));
+
+    final String sizedHeader = generate(FileType.header, encodedSizes: true);
+    expect(
+      sizedHeader,
+      contains('size_t CompactEncodedEnd(size_t offset) const;'),
+    );
+    final String sizedCode = generate(FileType.source, encodedSizes: true);
+    expect(
+      sizedCode,
+      contains('return CompactEncodedEnd(offset + 1) - offset;'),
+    );
+    expect(sizedCode, contains('size_t end = offset + 1;'));
+    expect(sizedCode, contains('end += CompactVarintSize(x_);'));
+    expect(sizedCode, contains('end = AlignEncodedEnd(end, 8) + 8;'));
+    expect(
+      sizedCode,
+      contains(
+        'end = AlignEncodedEnd(end + CompactVarintSize(static_cast<int64_t>(samples_.size())), sizeof(int32_t)) + samples_.size() * sizeof(int32_t);',
+      ),
+    );
+    expect(sizedCode, isNot(contains('CustomEncodableValue(*this)')));
+  });
+
+  test('FfiSync host methods export C functions', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'add',
+              location: ApiLocation.host,
+              isFfiSync: true,
+              parameters: <Parameter>[
+                Parameter(
+                  type: const TypeDeclaration(
+                    baseName: 'int',
+                    isNullable: false,
+                  ),
+                  name: 'x',
+                ),
+              ],
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = CppGenerator();
+    final generatorOptions = OutputFileOptions<InternalCppOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalCppOptions(
+        cppHeaderOut: '',
+        cppSourceOut: '',
+        headerIncludePath: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('#define GOLUBETS_FFI_EXPORT'));
+    expect(code, contains('std::shared_ptr<Api> api_ffi_instance;'));
+    expect(code, contains('std::future<void> api_ffi_instance_released;'));
+    expect(
+      code,
+      contains(
+        'instance = std::shared_ptr<Api>(api, [promise](Api*) { promise->set_value(); });',
+      ),
+    );
+    expect(code, contains('api_ffi_instance.swap(instance);'));
+    expect(code, contains('released.wait();'));
+    expect(code, contains('std::shared_mutex api_ffi_instance_mutex;'));
+    expect(
+      code,
+      contains(
+        'std::unique_lock<std::shared_mutex> lock(api_ffi_instance_mutex);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        '  {\n'
+        '    std::shared_lock<std::shared_mutex> lock(api_ffi_instance_mutex);\n'
+        '    instance = api_ffi_instance;\n'
+        '  }\n'
+        '  if (instance == nullptr) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'extern "C" GOLUBETS_FFI_EXPORT int64_t golubets_${DEFAULT_PACKAGE_NAME}_Api_add(int64_t x) {',
+      ),
+    );
+    expect(
+      code,
+      contains('ErrorOr<int64_t> output = instance->Add(x);'),
+    );
+    expect(
+      code,
+      contains(
+        'extern "C" GOLUBETS_FFI_EXPORT const char* golubets_${DEFAULT_PACKAGE_NAME}_Api_ffi_error_code() {',
+      ),
+    );
+  });
+
+  test('RingBuffer classes push records into shared memory', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Point',
+          ringBufferCapacity: 1024,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: false),
+              name: 'x',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'double',
+                isNullable: false,
+              ),
+              name: 'y',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    const generator = CppGenerator();
+    final headerSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.header,
+        languageOptions: const InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+        ),
+      ),
+      root,
+      headerSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final header = headerSink.toString();
+    expect(header, contains('class PointRingBuffer {'));
+    expect(header, contains('static constexpr uint64_t kCapacity = 1024;'));
+    expect(header, contains('static bool Push(const Point& value);'));
+
+    final sourceSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+        ),
+      ),
+      root,
+      sourceSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sourceSink.toString();
+    expect(code, contains('#include <atomic>'));
+    expect(code, contains('#define GOLUBETS_FFI_EXPORT'));
+    expect(code, contains('bool PointRingBuffer::Push(const Point& value) {'));
+    expect(
+      code,
+      contains('ring.head.store(head + 1, std::memory_order_seq_cst);'),
+    );
+    for (final function in <String>[
+      'records',
+      'tail',
+      'acquire',
+      'release',
+      'set_wakeup',
+    ]) {
+      expect(
+        code,
+        contains('golubets_${DEFAULT_PACKAGE_NAME}_Point_ring_$function('),
+      );
+    }
+  });
+
+  test('Chunked host methods send replies in frames', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'document',
+              location: ApiLocation.host,
+              chunkFrameSize: 65536,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = CppGenerator();
+    final generatorOptions = OutputFileOptions<InternalCppOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalCppOptions(
+        cppHeaderOut: '',
+        cppSourceOut: '',
+        headerIncludePath: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('#include <algorithm>'));
+    expect(
+      code,
+      contains('class ChunkedReplyWriter : public flutter::ByteStreamWriter {'),
+    );
+    expect(
+      code,
+      contains(
+        'const std::string chunk_channel_name = "dev.bayori.golubets.$DEFAULT_PACKAGE_NAME.Api.document" + prepended_suffix + ".chunks";',
+      ),
+    );
+    expect(code, contains('[api, binary_messenger, chunk_channel_name]'));
+    expect(
+      code,
+      contains(
+        'void SendNextFrame(std::shared_ptr<PendingChunkedReply> pending) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'SendChunkedReply(binary_messenger, chunk_channel_name, 65536, GolubetsCodecSerializer::GetInstance(), EncodableValue(std::move(wrapped)), reply);',
+      ),
+    );
+  });
+
+  test('Packed classes are copied to and from a struct', () {
+    final sample = Class(
+      name: 'Sample',
+      isPacked: true,
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'int', isNullable: false),
+          name: 'x',
+        ),
+        NamedType(
+          type: const TypeDeclaration(baseName: 'bool', isNullable: false),
+          name: 'valid',
+        ),
+        NamedType(
+          type: const TypeDeclaration(baseName: 'double', isNullable: false),
+          name: 'y',
+        ),
+      ],
+    );
+    final samples = TypeDeclaration(
+      baseName: 'List',
+      isNullable: false,
+      typeArguments: <TypeDeclaration>[
+        TypeDeclaration(
+          baseName: 'Sample',
+          isNullable: false,
+          associatedClass: sample,
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'smooth',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(type: samples, name: 'samples'),
+              ],
+              returnType: samples,
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[
+        sample,
+        Class(
+          name: 'Trace',
+          fields: <NamedType>[NamedType(type: samples, name: 'samples')],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    const generator = CppGenerator();
+    final headerSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.header,
+        languageOptions: const InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+        ),
+      ),
+      root,
+      headerSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final header = headerSink.toString();
+    expect(
+      header,
+      contains('static Sample ReadPacked(flutter::ByteStreamReader* stream);'),
+    );
+    expect(
+      header,
+      contains('void WritePacked(flutter::ByteStreamWriter* stream) const;'),
+    );
+    expect(header, contains('const std::vector<Sample>& samples() const;'));
+    expect(header, contains('std::unique_ptr<std::vector<Sample>> samples_;'));
+    expect(
+      header,
+      contains(
+        'virtual ErrorOr<std::vector<Sample>> Smooth(const std::vector<Sample>& samples) = 0;',
+      ),
+    );
+
+    final sourceSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+        ),
+      ),
+      root,
+      sourceSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sourceSink.toString();
+    expect(code, contains('#include <type_traits>'));
+    expect(code, contains('struct SamplePacked {'));
+    expect(code, contains('static_assert(offsetof(SamplePacked, valid) == 8'));
+    expect(code, contains('static_assert(offsetof(SamplePacked, y) == 16'));
+    expect(code, contains('static_assert(sizeof(SamplePacked) == 24'));
+    expect(code, contains('return Sample(record.x, record.valid, record.y);'));
+    expect(code, isNot(contains('IsPackedList')));
+    expect(
+      code,
+      contains('if (custom_value->type() == typeid(std::vector<Sample>)) {'),
+    );
+    expect(code, contains('WriteSize(list.size(), stream);'));
+    expect(code, contains('std::vector<Sample> list;'));
+    expect(code, contains('list.push_back(Sample::ReadPacked(stream));'));
+    expect(code, contains('return CustomEncodableValue(std::move(list));'));
+    expect(
+      code,
+      contains(
+        'std::any_cast<const std::vector<Sample>&>(std::get<CustomEncodableValue>(list[0]))',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'const auto& samples_arg = std::any_cast<const std::vector<Sample>&>(std::get<CustomEncodableValue>(encodable_samples_arg));',
+      ),
+    );
+  });
+
+  test('Columns classes convert to and from rows', () {
+    final sample = Class(
+      name: 'Sample',
+      isColumnar: true,
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'double', isNullable: false),
+          name: 'time',
+        ),
+        NamedType(
+          type: const TypeDeclaration(baseName: 'bool', isNullable: false),
+          name: 'valid',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        sample,
+        Class(
+          name: 'SampleColumns',
+          columnsOf: sample,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+              ),
+              name: 'time',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+              name: 'valid',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    const generator = CppGenerator();
+    final headerSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.header,
+        languageOptions: const InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+        ),
+      ),
+      root,
+      headerSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final header = headerSink.toString();
+    expect(header, contains('const std::vector<double>& time() const;'));
+    expect(header, contains('size_t RowCount() const;'));
+    expect(header, contains('Sample Row(size_t index) const;'));
+    expect(header, contains('void AddRow(const Sample& row);'));
+
+    final sourceSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+        ),
+      ),
+      root,
+      sourceSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sourceSink.toString();
+    expect(code, contains('#include <algorithm>'));
+    expect(code, contains('return std::min({time_.size(), valid_.size()});'));
+    expect(code, contains('return Sample(time_[index], valid_[index] != 0);'));
+    expect(code, contains('valid_.push_back(row.valid() ? 1 : 0);'));
+  });
+
+  test('Long lists are encoded and decoded on worker threads', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Sample',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: false),
+              name: 'x',
+            ),
+          ],
+        ),
+        Class(
+          name: 'Reading',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'double',
+                isNullable: false,
+              ),
+              name: 'value',
+            ),
+          ],
+        ),
+        Class(
+          name: 'Point',
+          isCompact: true,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: false),
+              name: 'x',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType, {int? parallelEncodeThreshold}) {
+      final sink = StringBuffer();
+      const generator = CppGenerator();
+      generator.generate(
+        OutputFileOptions<InternalCppOptions>(
+          fileType: fileType,
+          languageOptions: InternalCppOptions(
+            cppHeaderOut: '',
+            cppSourceOut: '',
+            headerIncludePath: '',
+            parallelEncodeThreshold: parallelEncodeThreshold,
+          ),
+        ),
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(
+      FileType.header,
+      parallelEncodeThreshold: 4096,
+    );
+    expect(header, contains('bool WriteListInParallel('));
+    expect(header, contains('flutter::ByteStreamWriter* stream) const;'));
+    expect(header, contains('bool ReadListInParallel('));
+    expect(header, contains('flutter::EncodableList* list) const;'));
+
+    final String code = generate(
+      FileType.source,
+      parallelEncodeThreshold: 4096,
+    );
+    expect(code, contains('#include <future>'));
+    expect(code, contains('#include <thread>'));
+    expect(
+      code,
+      contains('constexpr size_t kParallelEncodeThreshold = 4096;'),
+    );
+    expect(
+      code,
+      contains(
+        'if (list->size() >= kParallelEncodeThreshold && !in_parallel_worker && WriteListInParallel(*list, stream)) {',
+      ),
+    );
+    expect(code, contains('stream->WriteByte(12);'));
+    expect(
+      code,
+      contains('if (std::any_of(list.begin(), list.end(), MayAlign)) {'),
+    );
+    expect(
+      code,
+      contains(
+        'return !(custom_value->type() == typeid(Sample) || custom_value->type() == typeid(Point));',
+      ),
+    );
+    expect(code, contains('ParallelWorkerScope scope;'));
+
+    expect(code, contains('if (type == 12 && !in_parallel_worker) {'));
+    expect(code, contains('if (ReadListInParallel(stream, &list)) {'));
+    expect(code, contains('bool SkipValue(BufferStreamReader* reader) {'));
+    // Sample and Reading are skipped as one standard value, and the compact
+    // Point has to be decoded in place.
+    expect(
+      code,
+      contains('    case 129:\n    case 130:\n      if (!SkipValue(reader)) {'),
+    );
+    expect(code, isNot(contains('case 131:\n      if (!SkipValue(reader))')));
+    expect(
+      code,
+      contains(
+        'BufferStreamReader chunk_reader(reader->bytes(), reader->size(), position);',
+      ),
+    );
+    expect(code, contains('reader->Seek(scanner.position());'));
+    expect(code, contains('class ParallelMessageCodec'));
+
+    final String serialCode = generate(FileType.source);
+    expect(serialCode, isNot(contains('WriteListInParallel')));
+    expect(serialCode, isNot(contains('ReadListInParallel')));
+    expect(serialCode, isNot(contains('#include <thread>')));
+  });
+
+  test('Encoded sizes are computed per field', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'doSomething',
+              parameters: <Parameter>[],
+              location: ApiLocation.host,
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[
+        Class(
+          name: 'Sample',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'double', isNullable: true),
+              name: 'value',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'String',
+                isNullable: false,
+              ),
+              name: 'name',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Int32List',
+                isNullable: false,
+              ),
+              name: 'counts',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType, {bool encodedSizes = true}) {
+      final sink = StringBuffer();
+      const generator = CppGenerator();
+      generator.generate(
+        OutputFileOptions<InternalCppOptions>(
+          fileType: fileType,
+          languageOptions: InternalCppOptions(
+            cppHeaderOut: '',
+            cppSourceOut: '',
+            headerIncludePath: '',
+            encodedSizes: encodedSizes,
+          ),
+        ),
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(FileType.header);
+    expect(header, contains('size_t EncodedSize(size_t offset = 0) const;'));
+    expect(header, contains('static size_t EncodedSize('));
+
+    final String code = generate(FileType.source);
+    expect(code, contains('size_t Sample::EncodedSize(size_t offset) const {'));
+    expect(code, contains('size_t end = AddEncodedSizeSize(offset + 2, 3);'));
+    expect(code, contains('if (value_) {'));
+    expect(code, contains('end = AlignEncodedEnd(end + 1, 8) + 8;'));
+    expect(
+      code,
+      contains(
+        'end = AddEncodedSizeSize(end + 1, name_.size()) + name_.size();',
+      ),
+    );
+    expect(code, contains('end = TypedListEncodedEnd(counts_, end);'));
+    expect(
+      code,
+      contains(
+        'return std::any_cast<const Sample&>(*custom_value).EncodedSize(offset);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'encoded->reserve(GolubetsCodecSerializer::EncodedSize(message));',
+      ),
+    );
+    expect(code, contains('&ReservingMessageCodec::GetInstance());'));
+    expect(code, isNot(contains('&GetCodec());')));
+
+    final String defaultCode = generate(FileType.source, encodedSizes: false);
+    expect(defaultCode, isNot(contains('EncodedSize')));
+    expect(defaultCode, contains('&GetCodec());'));
+  });
+
+  test('instrumented Flutter APIs alone omit the handler end hook', () {
+    final root = Root(
+      apis: <Api>[
+        AstFlutterApi(
+          name: 'FlutterApi',
+          methods: <Method>[
+            Method(
+              name: 'pong',
+              location: ApiLocation.flutter,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = CppGenerator();
+    generator.generate(
+      OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+          includeInstrumentation: true,
+        ),
+      ),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('int64_t NotifyHandlerStart('));
+    expect(code, isNot(contains('NotifyHandlerEnd')));
+  });
+
+  test('Typed numeric list fields are stored as typed vectors', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Sample',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+                typedListOf: 'double',
+              ),
+              name: 'times',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+                typedListOf: 'bool',
+              ),
+              name: 'flags',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = CppGenerator();
+    generator.generate(
+      OutputFileOptions<InternalCppOptions>(
+        fileType: FileType.header,
+        languageOptions: const InternalCppOptions(
+          cppHeaderOut: '',
+          cppSourceOut: '',
+          headerIncludePath: '',
+        ),
+      ),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('const std::vector<double>& times() const;'));
+    expect(
+      code,
+      contains(
+        '// Holds one byte, 0 or 1, per element of the declared List<bool>.',
+      ),
+    );
+    expect(code, contains('const std::vector<uint8_t>& flags() const;'));
+  });
 }
@@ -3219,4 +3219,640 @@ name: foobar
     expect(code, isNot(contains('Future<int> getNumber(int number);')));
     expect(code, isNot(contains('class SomeApi implements ISomeApi {')));
   });
+
+  test('multiplexed host api sends the method index', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          multiplexed: true,
+          methods: <Method>[
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+            Method(
+              name: 'echo',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(
+                  type: const TypeDeclaration(
+                    baseName: 'int',
+                    isNullable: false,
+                  ),
+                  name: 'value',
+                ),
+              ],
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(ignoreLints: false),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains(
+        "'dev.bayori.golubets.$DEFAULT_PACKAGE_NAME.Api\$golubetsVar_messageChannelSuffix'",
+      ),
+    );
+    expect(code, isNot(contains('.Api.ping')));
+    expect(code, contains('golubetsVar_channel.send(<Object?>[0])'));
+    expect(code, contains('golubetsVar_channel.send(<Object?>[1, value])'));
+  });
+
+  test('compact classes encode without lists', () {
+    final point = Class(
+      name: 'Point',
+      isCompact: true,
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'int', isNullable: false),
+          name: 'x',
+        ),
+        NamedType(
+          type: const TypeDeclaration(baseName: 'double', isNullable: true),
+          name: 'y',
+        ),
+        NamedType(
+          type: const TypeDeclaration(baseName: 'String', isNullable: false),
+          name: 'label',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'draw',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(
+                  type: TypeDeclaration(
+                    baseName: 'Point',
+                    isNullable: false,
+                    associatedClass: point,
+                  ),
+                  name: 'point',
+                ),
+              ],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[point],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains("import 'dart:convert' show utf8;"));
+    expect(code, contains('void encodeCompact(WriteBuffer buffer) {'));
+    expect(code, contains('buffer.putUint8((y != null ? 1 : 0));'));
+    expect(code, contains('_writeCompactVarint(buffer, x);'));
+    expect(code, contains('buffer.putFloat64(y!);'));
+    expect(code, contains('_writeCompactString(buffer, label);'));
+    expect(code, contains('static Point decodeCompact(ReadBuffer buffer) {'));
+    expect(
+      code,
+      contains('y: (present0 & 1) != 0 ? buffer.getFloat64() : null,'),
+    );
+    expect(code, contains('value.encodeCompact(buffer);'));
+    expect(code, contains('return Point.decodeCompact(buffer);'));
+    expect(code, isNot(contains('Point.decode(')));
+    expect(
+      code,
+      matches(RegExp(r'\.Api\.draw\.compact_[0-9a-f]{8}\$golubetsVar')),
+    );
+  });
+
+  test('FfiSync host methods call the exported function', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'add',
+              location: ApiLocation.host,
+              isFfiSync: true,
+              parameters: <Parameter>[
+                Parameter(
+                  type: const TypeDeclaration(
+                    baseName: 'int',
+                    isNullable: false,
+                  ),
+                  name: 'x',
+                ),
+              ],
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains("import 'dart:ffi' as ffi;"));
+    expect(code, contains('? _ApiFfi.add'));
+    expect(
+      code,
+      contains(
+        'final int golubetsVar_result = golubetsVar_ffiFunction(x);',
+      ),
+    );
+    expect(code, contains('_ApiFfi.throwIfError();'));
+    expect(
+      code,
+      contains(
+        "golubetsVar_library.providesSymbol('golubets_${DEFAULT_PACKAGE_NAME}_Api_add')",
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'lookupFunction<ffi.Int64 Function(ffi.Int64), int Function(int)>',
+      ),
+    );
+    expect(code, contains('String _ffiString(ffi.Pointer<ffi.Uint8> pointer)'));
+    expect(code, contains('golubetsVar_channel.send(<Object?>[x])'));
+  });
+
+  test('RingBuffer classes read records from shared memory', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Point',
+          ringBufferCapacity: 1024,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: false),
+              name: 'x',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'double',
+                isNullable: false,
+              ),
+              name: 'y',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains("import 'dart:ffi' as ffi;"));
+    expect(code, contains('final class _PointRingRecord extends ffi.Struct {'));
+    expect(code, contains('@ffi.Int64()'));
+    expect(code, contains('external double y;'));
+    expect(code, contains('class PointRingBuffer {'));
+    expect(code, contains('static const int capacity = 1024;'));
+    expect(
+      code,
+      contains(
+        "('golubets_${DEFAULT_PACKAGE_NAME}_Point_ring_acquire')",
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'final _PointRingRecord record = golubetsVar_records[position & (capacity - 1)];',
+      ),
+    );
+    expect(code, contains('onRecord(Point(x: record.x, y: record.y));'));
+    expect(code, contains('golubetsVar_release(head);'));
+    expect(code, contains('static Stream<List<Point>> batches() {'));
+  });
+
+  test('LargeBlob host methods map memfd replies', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'document',
+              location: ApiLocation.host,
+              largeBlobThreshold: 4096,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains("import 'dart:ffi' as ffi;"));
+    expect(
+      code,
+      contains('return _mapLargeBlob(golubetsVar_replyValue)! as Uint8List;'),
+    );
+    expect(code, contains('Object? _mapLargeBlob(Object? value) {'));
+    expect(code, contains('if (value is! Int64List) {'));
+    expect(
+      code,
+      contains("('golubets_${DEFAULT_PACKAGE_NAME}_large_blob_map')"),
+    );
+    expect(
+      code,
+      contains("('golubets_${DEFAULT_PACKAGE_NAME}_large_blob_unmap')"),
+    );
+    expect(code, contains('finalizer: _LargeBlobFfi.unmap,'));
+  });
+
+  test('Chunked host methods reassemble framed replies', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'document',
+              location: ApiLocation.host,
+              chunkFrameSize: 65536,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('BytesBuilder'));
+    expect(
+      code,
+      contains(
+        'final _ChunkedReply golubetsVar_chunks = await _ChunkedReply.listen(',
+      ),
+    );
+    expect(code, contains(r"'${golubetsVar_channelName}.chunks',"));
+    expect(
+      code,
+      contains(
+        'final List<Object?>? golubetsVar_replyList = await golubetsVar_chunks.reassemble(golubetsVar_sendFuture);',
+      ),
+    );
+    expect(code, contains('class _ChunkedReply {'));
+    expect(code, contains('frame!.getUint32(0, Endian.little)'));
+  });
+
+  test('Packed classes are encoded as records', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Sample',
+          isPacked: true,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: false),
+              name: 'x',
+            ),
+            NamedType(
+              type: const TypeDeclaration(baseName: 'bool', isNullable: false),
+              name: 'valid',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'double',
+                isNullable: false,
+              ),
+              name: 'y',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains(
+        "import 'dart:typed_data' show ByteData, Endian, Float64List, Int32List, Int64List, Uint8List;",
+      ),
+    );
+    expect(code, contains('abstract final class _SamplePacked {'));
+    expect(code, contains('static const int size = 24;'));
+    expect(code, contains('data.setUint8(offset + 8, value.valid ? 1 : 0);'));
+    expect(
+      code,
+      contains('y: data.getFloat64(offset + 16, Endian.little),'),
+    );
+    expect(code, contains('else if (value is _PackedList<Sample>) {'));
+    expect(code, isNot(contains('value is List<Sample>')));
+    expect(
+      code,
+      contains(
+        'final List<Sample> values = _SamplePacked.decode(buffer.getUint8List(count * _SamplePacked.size));',
+      ),
+    );
+  });
+
+  test('Only lists declared as packed lists are sent as records', () {
+    final sample = Class(
+      name: 'Sample',
+      isPacked: true,
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'int', isNullable: false),
+          name: 'x',
+        ),
+      ],
+    );
+    final samples = TypeDeclaration(
+      baseName: 'List',
+      isNullable: false,
+      typeArguments: <TypeDeclaration>[
+        TypeDeclaration(
+          baseName: 'Sample',
+          isNullable: false,
+          associatedClass: sample,
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'send',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(name: 'samples', type: samples),
+                Parameter(
+                  name: 'anything',
+                  type: const TypeDeclaration(
+                    baseName: 'Object',
+                    isNullable: true,
+                  ),
+                ),
+              ],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+        AstFlutterApi(
+          name: 'Callbacks',
+          methods: <Method>[
+            Method(
+              name: 'receive',
+              location: ApiLocation.flutter,
+              parameters: <Parameter>[],
+              returnType: TypeDeclaration(
+                baseName: 'List',
+                isNullable: true,
+                typeArguments: samples.typeArguments,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[
+        sample,
+        Class(
+          name: 'Batch',
+          fields: <NamedType>[
+            NamedType(type: samples, name: 'samples'),
+            NamedType(
+              type: const TypeDeclaration(baseName: 'Object', isNullable: true),
+              name: 'extra',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('final class _PackedList<T> {'));
+    expect(
+      code,
+      contains(
+        'channel.send(<Object?>[_PackedList<Sample>(samples), anything]);',
+      ),
+    );
+    expect(code, contains('_PackedList<Sample>(samples),'));
+    expect(code, contains('      extra,'));
+    expect(
+      code,
+      contains(
+        'return wrapResponse(result: output == null ? null : _PackedList<Sample>(output));',
+      ),
+    );
+    expect(code, isNot(contains('value is List<Sample>')));
+  });
+
+  test('Columns classes convert to and from rows', () {
+    final sample = Class(
+      name: 'Sample',
+      isColumnar: true,
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'double', isNullable: false),
+          name: 'time',
+        ),
+        NamedType(
+          type: const TypeDeclaration(baseName: 'bool', isNullable: false),
+          name: 'valid',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        sample,
+        Class(
+          name: 'SampleColumns',
+          columnsOf: sample,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+              ),
+              name: 'time',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+              name: 'valid',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('final Float64List time;'));
+    expect(
+      code,
+      contains('factory SampleColumns.fromRows(List<Sample> rows) {'),
+    );
+    expect(code, contains('columns.valid[index] = row.valid ? 1 : 0;'));
+    expect(code, contains('List<Sample> toRows() {'));
+    expect(
+      code,
+      contains(
+        '(int index) => Sample(time: time[index], valid: valid[index] != 0),',
+      ),
+    );
+  });
+
+  test('Typed numeric list fields keep their declared types', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Sample',
+          isCompact: true,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+                typedListOf: 'double',
+              ),
+              name: 'times',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: true,
+                typedListOf: 'bool',
+              ),
+              name: 'flags',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = DartGenerator();
+    generator.generate(
+      const InternalDartOptions(),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('List<double> times;'));
+    expect(code, contains('List<bool>? flags;'));
+    expect(code, contains('Float64List.fromList(times),'));
+    expect(
+      code,
+      contains(
+        'flags == null ? null : Uint8List.fromList(flags!.map((bool bit) => bit ? 1 : 0).toList()),',
+      ),
+    );
+    expect(code, contains('times: result[0]! as Float64List,'));
+    expect(
+      code,
+      contains(
+        'flags: (result[1] as Uint8List?)?.map((int bit) => bit != 0).toList(),',
+      ),
+    );
+    expect(
+      code,
+      contains('buffer.putFloat64List(Float64List.fromList(times));'),
+    );
+  });
 }
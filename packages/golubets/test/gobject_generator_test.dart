@@ -1035,4 +1035,1932 @@ void main() {
       expect(code, contains('const int test_package_object_type_id = 131;'));
     }
   });
+  test('benchmark exercises classes and host methods', () {
+    final dataClass = Class(
+      name: 'Data',
+      fields: <NamedType>[
+        NamedType(
+          name: 'count',
+          type: const TypeDeclaration(baseName: 'int', isNullable: true),
+        ),
+        NamedType(
+          name: 'bytes',
+          type: const TypeDeclaration(
+            baseName: 'Uint8List',
+            isNullable: false,
+          ),
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'echo',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(
+                  name: 'data',
+                  type: TypeDeclaration(
+                    baseName: 'Data',
+                    isNullable: false,
+                    associatedClass: dataClass,
+                  ),
+                ),
+              ],
+              returnType: TypeDeclaration(
+                baseName: 'Data',
+                isNullable: false,
+                associatedClass: dataClass,
+              ),
+            ),
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              asynchronousType: AsynchronousType.callback,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[dataClass],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const GObjectBenchmarkGenerator().generate(
+      const InternalGObjectOptions(
+        headerIncludePath: 'messages.g.h',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('#include "messages.g.h"'));
+    expect(
+      code,
+      contains('static FlValue* random_data_value(GRand* rng, int depth) {'),
+    );
+    expect(
+      code,
+      contains(
+        'g_autoptr(TestPackageData) value = test_package_data_new(count, bytes, bytes_length);',
+      ),
+    );
+    expect(
+      code,
+      contains('return test_package_api_echo_response_new(return_value);'),
+    );
+    expect(code, contains('test_package_api_respond_ping(response_handle);'));
+    expect(code, contains('.ping = bench_api_ping,'));
+    expect(
+      code,
+      contains(
+        'test_package_api_set_method_handlers(FL_BINARY_MESSENGER(messenger), nullptr, &bench_api_vtable',
+      ),
+    );
+    expect(
+      code,
+      contains('"dev.bayori.golubets.$DEFAULT_PACKAGE_NAME.Api.echo"'),
+    );
+    expect(code, contains('const int depth = 0;'));
+  });
+
+  test('benchmark declares depth only when a return value uses it', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'count',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const GObjectBenchmarkGenerator().generate(
+      const InternalGObjectOptions(
+        headerIncludePath: 'messages.g.h',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains('g_ptr_array_add(api_returns, random_int_value(rng));'),
+    );
+    expect(code, isNot(contains('const int depth')));
+  });
+
+  test('instrumentation hooks are opt-in', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'HostApi',
+          methods: <Method>[
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+        AstFlutterApi(
+          name: 'FlutterApi',
+          methods: <Method>[
+            Method(
+              name: 'pong',
+              location: ApiLocation.flutter,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType, {required bool includeInstrumentation}) {
+      final sink = StringBuffer();
+      const generator = GObjectGenerator();
+      final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+        fileType: fileType,
+        languageOptions: InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+          includeInstrumentation: includeInstrumentation,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(
+      FileType.header,
+      includeInstrumentation: true,
+    );
+    expect(header, contains('} TestPackageInstrumentation;'));
+    expect(
+      header,
+      contains(
+        'void test_package_set_instrumentation(const TestPackageInstrumentation* instrumentation, gpointer user_data);',
+      ),
+    );
+    expect(
+      header,
+      contains(
+        'gboolean test_package_dump_trace(const gchar* path, GError** error);',
+      ),
+    );
+
+    final String source = generate(
+      FileType.source,
+      includeInstrumentation: true,
+    );
+    expect(
+      source,
+      contains(
+        'FL_MESSAGE_CODEC_CLASS(klass)->decode_message = test_package_golub_message_codec_decode_message;',
+      ),
+    );
+    expect(
+      source,
+      contains(
+        'TestPackageGolubMessageCodec* ping_codec = test_package_golub_message_codec_get_instance_for_channel(ping_channel_name, TRUE);',
+      ),
+    );
+    expect(
+      source,
+      contains(
+        'TestPackageGolubMessageCodec* codec = test_package_golub_message_codec_get_instance_for_channel(channel_name, FALSE);',
+      ),
+    );
+    expect(
+      source,
+      contains(
+        'TestPackageGolubMessageCodec* instance = static_cast<TestPackageGolubMessageCodec*>(g_hash_table_lookup(instances, channel_name));',
+      ),
+    );
+    expect(source, isNot(contains('_new_for_channel(')));
+    expect(source, contains('#ifdef GOLUBETS_ENABLE_TRACE'));
+    expect(source, contains('test_package_trace_reply_sent();'));
+    expect(
+      source,
+      contains(
+        'gboolean test_package_dump_trace(const gchar* path, GError** error) {',
+      ),
+    );
+    expect(
+      source,
+      contains(
+        '__atomic_store_n(&event->sequence, 2 * index + 2, __ATOMIC_RELEASE);',
+      ),
+    );
+    expect(
+      source,
+      contains(
+        'if (__atomic_load_n(&event->sequence, __ATOMIC_RELAXED) != sequence) {',
+      ),
+    );
+    expect(source, isNot(contains('g_mutex_lock(&buffer->mutex);')));
+
+    expect(
+      generate(FileType.header, includeInstrumentation: false),
+      isNot(contains('Instrumentation')),
+    );
+    expect(
+      generate(FileType.source, includeInstrumentation: false),
+      isNot(contains('instrumentation')),
+    );
+  });
+
+  test('multiplexed host api registers a single channel', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          multiplexed: true,
+          methods: <Method>[
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+            Method(
+              name: 'echo',
+              location: ApiLocation.host,
+              parameters: <Parameter>[
+                Parameter(
+                  type: const TypeDeclaration(
+                    baseName: 'int',
+                    isNullable: false,
+                  ),
+                  name: 'value',
+                ),
+              ],
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains(
+        'g_autofree gchar* channel_name = g_strdup_printf("dev.bayori.golubets.$DEFAULT_PACKAGE_NAME.Api%s", dot_suffix);',
+      ),
+    );
+    expect(code, isNot(contains('ping_channel_name')));
+    expect(
+      code,
+      contains(
+        'fl_basic_message_channel_set_message_handler(channel, test_package_api_cb, g_object_ref(api_data), g_object_unref);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'test_package_api_echo_cb(channel, message_, response_handle, user_data);',
+      ),
+    );
+    expect(
+      code,
+      contains('FlValue* value0 = fl_value_get_list_value(message_, 1);'),
+    );
+  });
+
+  test('channels share a single codec instance', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'HostApi',
+          methods: <Method>[
+            Method(
+              name: 'ping',
+              location: ApiLocation.host,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+        AstFlutterApi(
+          name: 'FlutterApi',
+          methods: <Method>[
+            Method(
+              name: 'pong',
+              location: ApiLocation.flutter,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains(
+        'static TestPackageGolubMessageCodec* test_package_golub_message_codec_get_instance() {',
+      ),
+    );
+    expect(code, contains('if (g_once_init_enter(&instance)) {'));
+    expect(
+      code,
+      contains(
+        'TestPackageGolubMessageCodec* codec = test_package_golub_message_codec_get_instance();',
+      ),
+    );
+    expect(code, isNot(contains('g_autoptr(TestPackageGolubMessageCodec)')));
+  });
+
+  test('flutter api reuses one channel per method', () {
+    final root = Root(
+      apis: <Api>[
+        AstFlutterApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'doSomething',
+              location: ApiLocation.flutter,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('FlBasicMessageChannel* do_something_channel;'));
+    expect(code, contains('g_clear_object(&self->do_something_channel);'));
+    expect(code, contains('if (self->do_something_channel == nullptr) {'));
+    expect(
+      code,
+      contains(
+        'fl_basic_message_channel_send(self->do_something_channel, args, cancellable, test_package_api_do_something_cb, task);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'fl_basic_message_channel_send_finish(self->do_something_channel, r, error);',
+      ),
+    );
+    expect(code, isNot(contains('g_task_set_task_data')));
+  });
+
+  test('unboxed enums are written directly by the codec', () {
+    final anEnum = Enum(
+      name: 'AnEnum',
+      members: <EnumMember>[
+        EnumMember(name: 'one'),
+        EnumMember(name: 'two'),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Input',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'String', isNullable: false),
+              name: 'name',
+            ),
+            NamedType(
+              type: TypeDeclaration(
+                baseName: anEnum.name,
+                isNullable: false,
+                associatedEnum: anEnum,
+              ),
+              name: 'code',
+            ),
+            NamedType(
+              type: TypeDeclaration(
+                baseName: anEnum.name,
+                isNullable: true,
+                associatedEnum: anEnum,
+              ),
+              name: 'optionalCode',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[anEnum],
+    );
+    String generate({required bool unboxedEnums}) {
+      final sink = StringBuffer();
+      const generator = GObjectGenerator();
+      final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.source,
+        languageOptions: InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+          unboxedEnums: unboxedEnums,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String code = generate(unboxedEnums: true);
+    expect(code, isNot(contains('test_package_input_to_list')));
+    expect(code, isNot(contains('test_package_input_new_from_list')));
+    expect(
+      code,
+      contains(
+        'test_package_golub_message_codec_write_enum_value(buffer, test_package_an_enum_type_id, FALSE, value->code);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'test_package_golub_message_codec_write_enum_value(buffer, test_package_an_enum_type_id, value->optional_code == nullptr, value->optional_code != nullptr ? *value->optional_code : 0);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'if (!test_package_golub_message_codec_read_enum_value(buffer, offset, test_package_an_enum_type_id, nullptr, &value1, error)) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'TestPackageAnEnum field1 = static_cast<TestPackageAnEnum>(value1);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'g_autoptr(TestPackageInput) value = test_package_input_new(field0, field1, field2);',
+      ),
+    );
+
+    final String boxedCode = generate(unboxedEnums: false);
+    expect(boxedCode, contains('test_package_input_to_list'));
+    expect(boxedCode, isNot(contains('_write_enum_value')));
+  });
+
+  test('boxed data classes are plain reference-counted structs', () {
+    final inner = Class(
+      name: 'Inner',
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'String', isNullable: false),
+          name: 'name',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        inner,
+        Class(
+          name: 'Outer',
+          fields: <NamedType>[
+            NamedType(
+              type: TypeDeclaration(
+                baseName: 'Inner',
+                isNullable: false,
+                associatedClass: inner,
+              ),
+              name: 'inner',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType) {
+      final sink = StringBuffer();
+      const generator = GObjectGenerator();
+      final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+        fileType: fileType,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+          boxedDataClasses: true,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(FileType.header);
+    expect(header, isNot(contains('G_DECLARE_FINAL_TYPE(TestPackageInner')));
+    expect(
+      header,
+      contains('typedef struct _TestPackageInner TestPackageInner;'),
+    );
+    expect(
+      header,
+      contains(
+        'TestPackageInner* test_package_inner_ref(TestPackageInner* object);',
+      ),
+    );
+    expect(
+      header,
+      contains(
+        'G_DEFINE_AUTOPTR_CLEANUP_FUNC(TestPackageInner, test_package_inner_unref)',
+      ),
+    );
+
+    final String code = generate(FileType.source);
+    expect(code, isNot(contains('G_DEFINE_TYPE(TestPackageInner')));
+    expect(code, isNot(contains('fl_value_new_custom_object')));
+    expect(
+      code,
+      contains(
+        'G_DEFINE_BOXED_TYPE(TestPackageInner, test_package_inner, test_package_inner_ref, test_package_inner_unref)',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'TestPackageInner* self = g_atomic_rc_box_new0(TestPackageInner);',
+      ),
+    );
+    expect(code, contains('self->inner = test_package_inner_ref(inner);'));
+    expect(
+      code,
+      contains('g_clear_pointer(&self->inner, test_package_inner_unref);'),
+    );
+    expect(
+      code,
+      contains(
+        'fl_value_new_custom(test_package_inner_type_id, test_package_inner_ref(value), (GDestroyNotify)test_package_inner_unref)',
+      ),
+    );
+  });
+
+  test('host api methods share one response type', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'doSync',
+              parameters: <Parameter>[],
+              location: ApiLocation.host,
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+            Method(
+              name: 'doAsync',
+              parameters: <Parameter>[],
+              location: ApiLocation.host,
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+              asynchronousType: AsynchronousType.callback,
+            ),
+          ],
+        ),
+        AstHostApi(name: 'OtherApi', methods: <Method>[]),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType) {
+      final sink = StringBuffer();
+      const generator = GObjectGenerator();
+      final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+        fileType: fileType,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+          sharedHostApiResponses: true,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(FileType.header);
+    expect(header, isNot(contains('TestPackageApiDoSyncResponse')));
+    expect(
+      'typedef struct _TestPackageHostApiResponse'.allMatches(header),
+      hasLength(1),
+    );
+    expect(
+      header,
+      contains(
+        'TestPackageHostApiResponse* test_package_api_do_sync_response_new(int64_t return_value);',
+      ),
+    );
+    expect(
+      header,
+      contains('TestPackageHostApiResponse* (*do_sync)(gpointer user_data);'),
+    );
+
+    final String code = generate(FileType.source);
+    expect(code, isNot(contains('TestPackageApiDoSyncResponse')));
+    expect(code, isNot(contains('TestPackageApiDoAsyncResponse')));
+    expect(
+      'struct _TestPackageHostApiResponse {'.allMatches(code),
+      hasLength(1),
+    );
+    expect(
+      code,
+      contains(
+        'G_DEFINE_BOXED_TYPE(TestPackageHostApiResponse, test_package_host_api_response, test_package_host_api_response_ref, test_package_host_api_response_unref)',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'TestPackageHostApiResponse* self = g_atomic_rc_box_new0(TestPackageHostApiResponse);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'g_autoptr(TestPackageHostApiResponse) response = test_package_api_do_async_response_new(return_value);',
+      ),
+    );
+  });
+
+  test('zero copy typed lists retain the decoded value', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Frame',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+              name: 'data',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: true,
+              ),
+              name: 'samples',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+        zeroCopyTypedLists: true,
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('FlValue* data;'));
+    expect(code, isNot(contains('data_length;')));
+    expect(
+      code,
+      contains(
+        'static TestPackageFrame* test_package_frame_new_with_values(FlValue* data, FlValue* samples) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'g_autoptr(FlValue) data_value = fl_value_new_uint8_list(data, data_length);',
+      ),
+    );
+    expect(code, contains('return fl_value_get_uint8_list(self->data);'));
+    expect(
+      code,
+      contains('fl_value_append_take(values, fl_value_ref(self->data));'),
+    );
+    expect(
+      code,
+      contains('return test_package_frame_new_with_values(data, samples);'),
+    );
+    expect(code, isNot(contains('memcpy')));
+  });
+
+  test('take constructors adopt their arguments', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Result',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'String', isNullable: false),
+              name: 'name',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+              name: 'data',
+            ),
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: true),
+              name: 'count',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType) {
+      final sink = StringBuffer();
+      const generator = GObjectGenerator();
+      final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+        fileType: fileType,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+          includeTakeConstructors: true,
+        ),
+      );
+      generator.generate(
+        generatorOptions,
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    const declaration =
+        'TestPackageResult* test_package_result_new_take(gchar* name, uint8_t* data, size_t data_length, int64_t* count)';
+    expect(generate(FileType.header), contains('$declaration;'));
+
+    final String code = generate(FileType.source);
+    expect(code, contains('$declaration {'));
+    expect(code, contains('self->name = name;'));
+    expect(code, contains('self->data = data;'));
+    expect(code, contains('self->name = g_strdup(name);'));
+    expect(
+      code,
+      contains(
+        'self->data = static_cast<uint8_t*>(g_memdup2(data, data_length));',
+      ),
+    );
+    expect(code, isNot(contains('malloc(data_length)')));
+    expect(code, contains('g_clear_pointer(&self->data, g_free);'));
+  });
+
+  test('nullable primitives can be stored inline', () {
+    final anEnum = Enum(
+      name: 'AnEnum',
+      members: <EnumMember>[EnumMember(name: 'one')],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Options',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'bool', isNullable: true),
+              name: 'enabled',
+            ),
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: true),
+              name: 'count',
+            ),
+            NamedType(
+              type: TypeDeclaration(
+                baseName: anEnum.name,
+                isNullable: true,
+                associatedEnum: anEnum,
+              ),
+              name: 'mode',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[anEnum],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+        inlineNullablePrimitives: true,
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('int64_t count;'));
+    expect(code, contains('uint32_t present_[1];'));
+    expect(code, isNot(contains('malloc(sizeof(')));
+    expect(code, isNot(contains('g_clear_pointer(&self->count, g_free);')));
+    expect(code, contains('self->present_[0] |= 1u << 1;'));
+    expect(
+      code,
+      contains(
+        'return (self->present_[0] & (1u << 1)) != 0 ? &self->count : nullptr;',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'fl_value_append_take(values, (self->present_[0] & (1u << 1)) != 0 ? fl_value_new_int(self->count) : fl_value_new_null());',
+      ),
+    );
+  });
+
+  test('direct class writers encode fields without FlValues', () {
+    final child = Class(
+      name: 'Child',
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'String', isNullable: false),
+          name: 'name',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Parent',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'double', isNullable: true),
+              name: 'value',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+              ),
+              name: 'samples',
+            ),
+            NamedType(
+              type: TypeDeclaration(
+                baseName: 'Child',
+                isNullable: false,
+                associatedClass: child,
+              ),
+              name: 'child',
+            ),
+          ],
+        ),
+        child,
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+        directClassWriters: true,
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, isNot(contains('_to_list(')));
+    expect(code, isNot(contains('_write_int(')));
+    expect(
+      code,
+      contains('test_package_golub_message_codec_write_type(buffer, 12);'),
+    );
+    expect(
+      code,
+      contains(
+        'test_package_golub_message_codec_write_double(buffer, *value->value);',
+      ),
+    );
+    expect(
+      code,
+      contains('test_package_golub_message_codec_write_type(buffer, 0);'),
+    );
+    expect(
+      code,
+      contains(
+        'test_package_golub_message_codec_write_typed_list(codec, buffer, 11, value->samples, value->samples_length, sizeof(double));',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'if (!test_package_golub_message_codec_write_test_package_child(codec, buffer, value->child, error)) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'test_package_golub_message_codec_write_string(codec, buffer, value->name);',
+      ),
+    );
+  });
+
+  test('compact classes are written without FlValues', () {
+    final child = Class(
+      name: 'Child',
+      isCompact: true,
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'String', isNullable: false),
+          name: 'name',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Parent',
+          isCompact: true,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: true),
+              name: 'count',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+              ),
+              name: 'samples',
+            ),
+            NamedType(
+              type: TypeDeclaration(
+                baseName: 'Child',
+                isNullable: false,
+                associatedClass: child,
+              ),
+              name: 'child',
+            ),
+          ],
+        ),
+        child,
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, isNot(contains('_to_list(')));
+    expect(code, isNot(contains('_new_from_list(')));
+    expect(
+      code,
+      contains(
+        'present[0] = static_cast<uint8_t>((value->count != nullptr ? 1 : 0));',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'test_package_golub_message_codec_write_compact_varint(buffer, *value->count);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'test_package_golub_message_codec_write_compact_bytes(buffer, sizeof(double), value->samples, field1_length);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'test_package_golub_message_codec_write_compact_test_package_child(buffer, value->child);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'g_autoptr(TestPackageParent) value = test_package_golub_message_codec_read_compact_test_package_parent(buffer, offset, error);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'return test_package_parent_new(field0, field1, field1_length, field2);',
+      ),
+    );
+
+    final sizedSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+          encodedSizes: true,
+        ),
+      ),
+      root,
+      sizedSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final sizedCode = sizedSink.toString();
+    expect(
+      sizedCode,
+      contains(
+        'return test_package_golub_message_codec_compact_encoded_end_test_package_parent(self, offset + 1) - offset;',
+      ),
+    );
+    expect(
+      sizedCode,
+      contains(
+        'end += test_package_golub_message_codec_compact_varint_size(*value->count);',
+      ),
+    );
+    expect(
+      sizedCode,
+      contains(
+        'end = test_package_golub_message_codec_align_end(end + test_package_golub_message_codec_compact_varint_size(field1_length), sizeof(double)) + field1_length * sizeof(double);',
+      ),
+    );
+    expect(
+      sizedCode,
+      contains(
+        'end = test_package_golub_message_codec_compact_encoded_end_test_package_child(value->child, end);',
+      ),
+    );
+    expect(sizedCode, isNot(contains('g_byte_array_new()')));
+    expect(sizedCode, isNot(contains('_get_instance(')));
+  });
+
+  test('FfiSync host methods export C functions', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'add',
+              location: ApiLocation.host,
+              isFfiSync: true,
+              parameters: <Parameter>[
+                Parameter(
+                  type: const TypeDeclaration(
+                    baseName: 'int',
+                    isNullable: false,
+                  ),
+                  name: 'x',
+                ),
+              ],
+              returnType: const TypeDeclaration(
+                baseName: 'int',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains(
+        'static TestPackageApi* test_package_api_ffi_instance = nullptr;',
+      ),
+    );
+    expect(
+      code,
+      contains('static GMutex test_package_api_ffi_instance_mutex;'),
+    );
+    expect(code, contains('test_package_api_ffi_instance_set(api_data);'));
+    expect(code, contains('test_package_api_ffi_instance_set(nullptr);'));
+    expect(
+      code,
+      contains(
+        'TestPackageApi* old_instance = g_steal_pointer(&test_package_api_ffi_instance);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'g_autoptr(TestPackageApi) api_data = test_package_api_ffi_instance_get();',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'extern "C" __attribute__((visibility("default"))) int64_t golubets_${DEFAULT_PACKAGE_NAME}_Api_add(int64_t x) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'g_autoptr(TestPackageApiAddResponse) response = api_data->vtable->add(x, api_data->user_data);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'return fl_value_get_int(fl_value_get_list_value(response->value, 0));',
+      ),
+    );
+  });
+
+  test('RingBuffer classes push records into shared memory', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Point',
+          ringBufferCapacity: 1024,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: false),
+              name: 'x',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'double',
+                isNullable: false,
+              ),
+              name: 'y',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    const generator = GObjectGenerator();
+    final headerSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.header,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+        ),
+      ),
+      root,
+      headerSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    expect(
+      headerSink.toString(),
+      contains(
+        'gboolean test_package_point_ring_buffer_push(TestPackagePoint* value);',
+      ),
+    );
+
+    final sourceSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+        ),
+      ),
+      root,
+      sourceSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sourceSink.toString();
+    expect(code, contains('TestPackagePointRingRecord records[1024];'));
+    expect(code, contains('record->x = value->x;'));
+    expect(
+      code,
+      contains(
+        'extern "C" __attribute__((visibility("default"))) guint64 golubets_${DEFAULT_PACKAGE_NAME}_Point_ring_acquire() {',
+      ),
+    );
+  });
+
+  test('LargeBlob host methods reply with a sealed memfd', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'document',
+              location: ApiLocation.host,
+              largeBlobThreshold: 4096,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(code, contains('#include <sys/mman.h>'));
+    expect(
+      code,
+      contains(
+        'static FlValue* test_package_golub_message_codec_large_blob_new(const uint8_t* data, size_t length) {',
+      ),
+    );
+    expect(code, contains('MFD_CLOEXEC | MFD_ALLOW_SEALING'));
+    expect(code, contains('if (return_value_length >= 4096) {'));
+    expect(
+      code,
+      contains(
+        'fl_value_append_take(self->value, test_package_golub_message_codec_large_blob_new(return_value, return_value_length));',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'extern "C" __attribute__((visibility("default"))) void golubets_${DEFAULT_PACKAGE_NAME}_large_blob_unmap(void* token) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);',
+      ),
+    );
+    expect(code, isNot(contains('PROT_READ | PROT_WRITE, MAP_SHARED')));
+    expect(
+      code,
+      contains('mmap(nullptr, length, PROT_WRITE, MAP_SHARED, fd, 0);'),
+    );
+    expect(code, contains('memcpy(mapped, data, length);'));
+    expect(code, isNot(contains('write(fd,')));
+    expect(code, contains('#include <sys/stat.h>'));
+    expect(
+      code,
+      contains(
+        'if (fstat(fd, &status) != 0 || length <= 0 || status.st_size != length) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'if (!test_package_golub_message_codec_large_blob_claim(fd)) {',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'guint source_id = g_timeout_add_seconds(60, test_package_golub_message_codec_large_blob_expire, GINT_TO_POINTER(fd));',
+      ),
+    );
+  });
+
+  test('Chunked host methods send replies in frames', () {
+    final root = Root(
+      apis: <Api>[
+        AstHostApi(
+          name: 'Api',
+          methods: <Method>[
+            Method(
+              name: 'document',
+              location: ApiLocation.host,
+              chunkFrameSize: 65536,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    final generatorOptions = OutputFileOptions<InternalGObjectOptions>(
+      fileType: FileType.source,
+      languageOptions: const InternalGObjectOptions(
+        headerIncludePath: '',
+        gobjectHeaderOut: '',
+        gobjectSourceOut: '',
+      ),
+    );
+    generator.generate(
+      generatorOptions,
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains(
+        'static gboolean test_package_golub_message_codec_respond_chunked(',
+      ),
+    );
+    expect(code, contains('g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,'));
+    expect(code, contains('api_data->dot_suffix = g_strdup(dot_suffix);'));
+    expect(
+      code,
+      contains(
+        'g_autofree gchar* chunk_channel_name = g_strdup_printf("dev.bayori.golubets.$DEFAULT_PACKAGE_NAME.Api.document%s.chunks", self->dot_suffix);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'if (!test_package_golub_message_codec_respond_chunked(channel, response_handle, self->messenger, chunk_channel_name, response->value, 65536, &error)) {',
+      ),
+    );
+  });
+
+  test('Packed classes are copied to and from a struct', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Sample',
+          isPacked: true,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'int', isNullable: false),
+              name: 'x',
+            ),
+            NamedType(
+              type: const TypeDeclaration(baseName: 'bool', isNullable: false),
+              name: 'valid',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'double',
+                isNullable: false,
+              ),
+              name: 'y',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    const generator = GObjectGenerator();
+    final headerSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.header,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+        ),
+      ),
+      root,
+      headerSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final header = headerSink.toString();
+    expect(header, contains('} TestPackageSamplePacked;'));
+    expect(header, contains('  bool valid;'));
+    expect(
+      header,
+      contains(
+        'FlValue* test_package_sample_packed_list_new(const TestPackageSamplePacked* records, size_t length);',
+      ),
+    );
+    expect(
+      header,
+      contains(
+        'const TestPackageSamplePacked* test_package_sample_packed_list_get_records(FlValue* value, size_t* length);',
+      ),
+    );
+
+    final sink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+        ),
+      ),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains('const int test_package_sample_packed_list_type_id = 385;'),
+    );
+    expect(
+      code,
+      contains('static_assert(offsetof(TestPackageSamplePacked, y) == 16'),
+    );
+    expect(
+      code,
+      contains('static_assert(sizeof(TestPackageSamplePacked) == 24'),
+    );
+    expect(
+      code,
+      contains(
+        'return test_package_sample_new(record.x, record.valid, record.y);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'g_byte_array_append(buffer, reinterpret_cast<const uint8_t*>(records), length * sizeof(TestPackageSamplePacked));',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'FlValue* list = fl_value_new_custom(test_package_sample_packed_list_type_id, g_bytes_new(data + *offset, length * sizeof(TestPackageSamplePacked)), (GDestroyNotify)g_bytes_unref);',
+      ),
+    );
+    expect(code, isNot(contains('is_packed_list')));
+    expect(code, isNot(contains('test_package_sample_to_list')));
+  });
+
+  test('Columns classes return their rows', () {
+    final sample = Class(
+      name: 'Sample',
+      isColumnar: true,
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'double', isNullable: false),
+          name: 'time',
+        ),
+        NamedType(
+          type: const TypeDeclaration(baseName: 'bool', isNullable: false),
+          name: 'valid',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        sample,
+        Class(
+          name: 'SampleColumns',
+          columnsOf: sample,
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+              ),
+              name: 'time',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+              ),
+              name: 'valid',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    const generator = GObjectGenerator();
+    final headerSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.header,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+        ),
+      ),
+      root,
+      headerSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final header = headerSink.toString();
+    expect(
+      header,
+      contains(
+        'size_t test_package_sample_columns_get_row_count(TestPackageSampleColumns* object);',
+      ),
+    );
+    expect(
+      header,
+      contains(
+        'TestPackageSample* test_package_sample_columns_get_row(TestPackageSampleColumns* object, size_t index);',
+      ),
+    );
+
+    final sourceSink = StringBuffer();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+        ),
+      ),
+      root,
+      sourceSink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sourceSink.toString();
+    expect(code, contains('count = MIN(count, length);'));
+    expect(
+      code,
+      contains(
+        'return test_package_sample_new(test_package_sample_columns_get_time(self, &length)[index], test_package_sample_columns_get_valid(self, &length)[index] != 0);',
+      ),
+    );
+  });
+
+  test('Encoded sizes are computed per field', () {
+    final child = Class(
+      name: 'Child',
+      fields: <NamedType>[
+        NamedType(
+          type: const TypeDeclaration(baseName: 'int', isNullable: false),
+          name: 'count',
+        ),
+      ],
+    );
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Parent',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(baseName: 'double', isNullable: true),
+              name: 'value',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+              ),
+              name: 'samples',
+            ),
+            NamedType(
+              type: TypeDeclaration(
+                baseName: 'Child',
+                isNullable: false,
+                associatedClass: child,
+              ),
+              name: 'child',
+            ),
+          ],
+        ),
+        child,
+      ],
+      enums: <Enum>[],
+    );
+    String generate(FileType fileType) {
+      final sink = StringBuffer();
+      const generator = GObjectGenerator();
+      generator.generate(
+        OutputFileOptions<InternalGObjectOptions>(
+          fileType: fileType,
+          languageOptions: const InternalGObjectOptions(
+            headerIncludePath: '',
+            gobjectHeaderOut: '',
+            gobjectSourceOut: '',
+            encodedSizes: true,
+          ),
+        ),
+        root,
+        sink,
+        dartPackageName: DEFAULT_PACKAGE_NAME,
+      );
+      return sink.toString();
+    }
+
+    final String header = generate(FileType.header);
+    expect(
+      header,
+      contains(
+        'size_t test_package_parent_encoded_size(TestPackageParent* object, size_t offset);',
+      ),
+    );
+
+    final String code = generate(FileType.source);
+    expect(
+      code,
+      contains(
+        'size_t end = test_package_golub_message_codec_add_size_size(offset + 2, 3);',
+      ),
+    );
+    expect(code, contains('if (self->value != nullptr) {'));
+    expect(
+      code,
+      contains(
+        'end = test_package_golub_message_codec_typed_list_encoded_end(end, self->samples_length, sizeof(double));',
+      ),
+    );
+    expect(
+      code,
+      contains('end += test_package_child_encoded_size(self->child, end);'),
+    );
+    expect(
+      code,
+      contains(
+        'end += test_package_golub_message_codec_int_encoded_size(self->count);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'FL_MESSAGE_CODEC_CLASS(klass)->encode_message = test_package_golub_message_codec_encode_message_reserved;',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'GByteArray* buffer = g_byte_array_sized_new(test_package_golub_message_codec_value_encoded_size(message, 0));',
+      ),
+    );
+  });
+
+  test('instrumented Flutter APIs alone omit the shared codec', () {
+    final root = Root(
+      apis: <Api>[
+        AstFlutterApi(
+          name: 'FlutterApi',
+          methods: <Method>[
+            Method(
+              name: 'pong',
+              location: ApiLocation.flutter,
+              parameters: <Parameter>[],
+              returnType: const TypeDeclaration.voidDeclaration(),
+            ),
+          ],
+        ),
+      ],
+      classes: <Class>[],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.source,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+          includeInstrumentation: true,
+        ),
+      ),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains('test_package_golub_message_codec_get_instance_for_channel('),
+    );
+    expect(code, isNot(contains('_get_instance(')));
+  });
+
+  test('Typed numeric list fields are stored as typed arrays', () {
+    final root = Root(
+      apis: <Api>[],
+      classes: <Class>[
+        Class(
+          name: 'Sample',
+          fields: <NamedType>[
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Float64List',
+                isNullable: false,
+                typedListOf: 'double',
+              ),
+              name: 'times',
+            ),
+            NamedType(
+              type: const TypeDeclaration(
+                baseName: 'Uint8List',
+                isNullable: false,
+                typedListOf: 'bool',
+              ),
+              name: 'flags',
+            ),
+          ],
+        ),
+      ],
+      enums: <Enum>[],
+    );
+    final sink = StringBuffer();
+    const generator = GObjectGenerator();
+    generator.generate(
+      OutputFileOptions<InternalGObjectOptions>(
+        fileType: FileType.header,
+        languageOptions: const InternalGObjectOptions(
+          headerIncludePath: '',
+          gobjectHeaderOut: '',
+          gobjectSourceOut: '',
+        ),
+      ),
+      root,
+      sink,
+      dartPackageName: DEFAULT_PACKAGE_NAME,
+    );
+    final code = sink.toString();
+    expect(
+      code,
+      contains(
+        'const double* test_package_sample_get_times(TestPackageSample* object, size_t* length);',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        ' * Holds one byte, 0 or 1, per element of the declared `List<bool>`.',
+      ),
+    );
+    expect(
+      code,
+      contains(
+        'const uint8_t* test_package_sample_get_flags(TestPackageSample* object, size_t* length);',
+      ),
+    );
+  });
 }
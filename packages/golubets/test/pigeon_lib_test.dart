@@ -167,6 +167,57 @@ void main() {
     expect(opts.cppSourceOut, equals('foo.cpp'));
   });
 
+  test('parse args - cpp_bench_out', () {
+    final GolubetsOptions opts = Golubets.parseArgs(<String>[
+      '--cpp_bench_out',
+      'foo_bench.cpp',
+    ]);
+    expect(opts.cppBenchOut, equals('foo_bench.cpp'));
+  });
+
+  test('parse args - gobject_bench_out', () {
+    final GolubetsOptions opts = Golubets.parseArgs(<String>[
+      '--gobject_bench_out',
+      'foo_bench.cc',
+    ]);
+    expect(opts.gobjectBenchOut, equals('foo_bench.cc'));
+  });
+
+  test('bench outputs require header and source outputs', () {
+    final root = Root(apis: <Api>[], classes: <Class>[], enums: <Enum>[]);
+    const cppAdapter = CppBenchmarkGeneratorAdapter();
+    const gobjectAdapter = GObjectBenchmarkGeneratorAdapter();
+    final missing = InternalGolubetsOptions.fromGolubetsOptions(
+      const GolubetsOptions(
+        cppHeaderOut: 'foo.h',
+        cppBenchOut: 'foo_bench.cpp',
+        gobjectSourceOut: 'foo.cc',
+        gobjectBenchOut: 'foo_bench.cc',
+      ),
+    );
+    expect(missing.cppBenchOut, equals('foo_bench.cpp'));
+    expect(missing.gobjectBenchOut, equals('foo_bench.cc'));
+    final List<Error> cppErrors = cppAdapter.validate(missing, root);
+    expect(cppErrors, hasLength(1));
+    expect(cppErrors[0].message, contains('cpp_bench_out'));
+    final List<Error> gobjectErrors = gobjectAdapter.validate(missing, root);
+    expect(gobjectErrors, hasLength(1));
+    expect(gobjectErrors[0].message, contains('gobject_bench_out'));
+
+    final complete = InternalGolubetsOptions.fromGolubetsOptions(
+      const GolubetsOptions(
+        cppHeaderOut: 'foo.h',
+        cppSourceOut: 'foo.cpp',
+        cppBenchOut: 'foo_bench.cpp',
+        gobjectHeaderOut: 'foo.h',
+        gobjectSourceOut: 'foo.cc',
+        gobjectBenchOut: 'foo_bench.cc',
+      ),
+    );
+    expect(cppAdapter.validate(complete, root), isEmpty);
+    expect(gobjectAdapter.validate(complete, root), isEmpty);
+  });
+
   test('parse args - ast_out', () {
     final GolubetsOptions opts = Golubets.parseArgs(<String>[
       '--ast_out',
@@ -461,6 +512,31 @@ abstract class ApiWithMockDartClass {
     );
   });
 
+  test('multiplexed host api', () {
+    const code = '''
+@HostApi(multiplexed: true)
+abstract class MultiplexedApi {
+  void doit();
+}
+''';
+    final ParseResults results = parseSource(code);
+    expect(results.errors, isEmpty);
+    expect(results.root.apis, hasLength(1));
+    expect((results.root.apis[0] as AstHostApi).multiplexed, isTrue);
+
+    final options = InternalGolubetsOptions.fromGolubetsOptions(
+      const GolubetsOptions(kotlinOut: 'Foo.kt', cppHeaderOut: 'foo.h'),
+    );
+    expect(
+      const KotlinGeneratorAdapter().validate(options, results.root),
+      hasLength(1),
+    );
+    expect(
+      const CppGeneratorAdapter().validate(options, results.root),
+      isEmpty,
+    );
+  });
+
   test('only visible from nesting', () {
     const code = '''
 class OnlyVisibleFromNesting {
@@ -1905,4 +1981,233 @@ abstract class events {
       );
     });
   });
+
+  test('compact class rejects unsupported field types', () {
+    const source = '''
+@Compact()
+class Point {
+  Point(this.x, this.tags);
+  int x;
+  List<String?> tags;
+}
+
+@HostApi()
+abstract class Api {
+  void draw(Point point);
+}
+''';
+    final ParseResults results = parseSource(source);
+    expect(results.errors, hasLength(1));
+    expect(
+      results.errors[0].message,
+      contains('Compact class "Point" field "tags"'),
+    );
+    expect(results.root.classes[0].isCompact, isTrue);
+  });
+
+  test('FfiSync rejects unsupported types', () {
+    const source = '''
+@HostApi()
+abstract class Api {
+  @FfiSync()
+  int add(int x);
+
+  @FfiSync()
+  String? name();
+}
+''';
+    final ParseResults results = parseSource(source);
+    expect(results.errors, hasLength(1));
+    expect(results.errors[0].message, contains('FfiSync method "name"'));
+    expect(results.root.apis[0].methods[0].isFfiSync, isTrue);
+  });
+
+  test('RingBuffer requires a power of two capacity', () {
+    const source = '''
+@RingBuffer(capacity: 1000)
+class Point {
+  int x;
+  double y;
+}
+
+@RingBuffer(capacity: 1024)
+class Sample {
+  bool valid;
+}
+
+@HostApi()
+abstract class Api {
+  void send(Point point, Sample sample);
+}
+''';
+    final ParseResults results = parseSource(source);
+    expect(results.errors, hasLength(1));
+    expect(
+      results.errors[0].message,
+      contains('Ring buffer capacity of class "Point"'),
+    );
+    final Class sample = results.root.classes.firstWhere(
+      (Class classDefinition) => classDefinition.name == 'Sample',
+    );
+    expect(sample.ringBufferCapacity, 1024);
+  });
+
+  test('LargeBlob requires a Uint8List return type', () {
+    const source = '''
+@HostApi()
+abstract class Api {
+  @LargeBlob()
+  Uint8List document();
+
+  @LargeBlob(threshold: 4096)
+  String name();
+}
+''';
+    final ParseResults results = parseSource(source);
+    expect(results.errors, hasLength(1));
+    expect(results.errors[0].message, contains('in method "name"'));
+    expect(
+      results.root.apis[0].methods[0].largeBlobThreshold,
+      defaultLargeBlobThreshold,
+    );
+  });
+
+  test('Chunked is only supported on host methods', () {
+    const source = '''
+@HostApi()
+abstract class Api {
+  @Chunked()
+  Uint8List document();
+}
+
+@FlutterApi()
+abstract class Listener {
+  @Chunked(frameSize: 4096)
+  void onDocument(Uint8List document);
+}
+''';
+    final ParseResults results = parseSource(source);
+    expect(results.errors, hasLength(1));
+    expect(results.errors[0].message, contains('in method "onDocument"'));
+    expect(
+      results.root.apis[0].methods[0].chunkFrameSize,
+      defaultChunkFrameSize,
+    );
+  });
+
+  test('Packed classes only have fixed-size fields', () {
+    const source = '''
+@Packed()
+class Point {
+  int x;
+  double? y;
+}
+
+@Packed()
+class Sample {
+  bool valid;
+}
+
+@HostApi()
+abstract class Api {
+  void send(Point point, Sample sample);
+}
+''';
+    final ParseResults results = parseSource(source);
+    expect(results.errors, hasLength(1));
+    expect(
+      results.errors[0].message,
+      contains('Packed class "Point" field "y"'),
+    );
+    final Class sample = results.root.classes.firstWhere(
+      (Class classDefinition) => classDefinition.name == 'Sample',
+    );
+    expect(sample.isPacked, isTrue);
+  });
+
+  test('Columnar classes are sent as typed-list columns', () {
+    const source = '''
+@Columnar()
+class Sample {
+  double time;
+  bool valid;
+}
+
+@Columnar()
+class Labelled {
+  String label;
+}
+
+@HostApi()
+abstract class Api {
+  List<Sample> samples(List<Sample>? previous);
+}
+''';
+    final ParseResults results = parseSource(source);
+    expect(results.errors, hasLength(1));
+    expect(
+      results.errors[0].message,
+      contains('Columnar class "Labelled" field "label"'),
+    );
+    final Class columns = results.root.classes.firstWhere(
+      (Class classDefinition) => classDefinition.name == 'SampleColumns',
+    );
+    expect(columns.columnsOf?.name, 'Sample');
+    expect(columns.fields[0].type.baseName, 'Float64List');
+    expect(columns.fields[1].type.baseName, 'Uint8List');
+    final Method method = results.root.apis[0].methods[0];
+    expect(method.returnType.baseName, 'SampleColumns');
+    expect(method.parameters[0].type.baseName, 'SampleColumns');
+    expect(method.parameters[0].type.isNullable, isTrue);
+  });
+
+  test('parse args - typed_numeric_lists', () {
+    final GolubetsOptions opts = Golubets.parseArgs(<String>[
+      '--typed_numeric_lists',
+    ]);
+    expect(opts.typedNumericLists, isTrue);
+  });
+
+  test('Numeric list fields are sent as typed lists', () {
+    const source = '''
+class Sample {
+  List<double> times;
+  List<int>? counts;
+  List<bool> flags;
+  List<double?> gaps;
+  List<String> names;
+}
+
+@HostApi()
+abstract class Api {
+  void send(Sample sample, List<double> values);
+}
+''';
+    final ParseResults results = parseSource(source);
+    expect(results.errors, isEmpty);
+    sendNumericListsAsTypedLists(results.root);
+    final List<NamedType> fields = results.root.classes[0].fields;
+    expect(fields[0].type.baseName, 'Float64List');
+    expect(fields[0].type.typedListOf, 'double');
+    expect(fields[1].type.baseName, 'Int64List');
+    expect(fields[1].type.isNullable, isTrue);
+    expect(fields[2].type.baseName, 'Uint8List');
+    expect(fields[2].type.typedListOf, 'bool');
+    expect(fields[3].type.baseName, 'List');
+    expect(fields[4].type.baseName, 'List');
+    final Method method = results.root.apis[0].methods[0];
+    expect(method.parameters[1].type.baseName, 'List');
+
+    final options = InternalGolubetsOptions.fromGolubetsOptions(
+      const GolubetsOptions(swiftOut: 'Foo.swift', cppHeaderOut: 'foo.h'),
+    );
+    expect(
+      const SwiftGeneratorAdapter().validate(options, results.root),
+      hasLength(3),
+    );
+    expect(
+      const CppGeneratorAdapter().validate(options, results.root),
+      isEmpty,
+    );
+  });
 }